@@ -0,0 +1,143 @@
+/// Measures the recall and query time of RandomizedKdForestNearestNeighbors
+/// against exact search with KdTreeNearestNeighbors.
+///
+/// Usage: benchmark_NearestNeighbors [numStates] [numQueries] [k]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <aikido/distance/CartesianProductWeighted.hpp>
+#include <aikido/distance/KdTreeNearestNeighbors.hpp>
+#include <aikido/distance/RandomizedKdForestNearestNeighbors.hpp>
+#include <aikido/distance/SO2Angular.hpp>
+#include <aikido/statespace/CartesianProduct.hpp>
+
+using namespace aikido::distance;
+using namespace aikido::statespace;
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr std::size_t NUM_JOINTS = 7;
+
+//==============================================================================
+/// Returns the seconds elapsed since _start.
+double getSecondsSince(Clock::time_point _start)
+{
+  return std::chrono::duration<double>(Clock::now() - _start).count();
+}
+
+//==============================================================================
+/// Samples _numStates states of _space uniformly over the joint angles.
+std::vector<StateSpace::State*> sampleStates(
+    const StateSpace& _space, std::size_t _numStates)
+{
+  std::vector<StateSpace::State*> states;
+  states.reserve(_numStates);
+
+  Eigen::VectorXd tangent(_space.getDimension());
+  for (std::size_t i = 0; i < _numStates; ++i)
+  {
+    tangent.setRandom();
+    states.push_back(_space.allocateState());
+    _space.expMap(M_PI * tangent, states.back());
+  }
+  return states;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+  const std::size_t numStates = argc > 1 ? std::atol(argv[1]) : 100000;
+  const std::size_t numQueries = argc > 2 ? std::atol(argv[2]) : 1000;
+  const std::size_t k = argc > 3 ? std::atol(argv[3]) : 10;
+
+  // Joint space of a 7-DOF arm with continuous revolute joints.
+  std::vector<StateSpacePtr> subspaces;
+  std::vector<std::pair<DistanceMetricPtr, double>> metrics;
+  for (std::size_t i = 0; i < NUM_JOINTS; ++i)
+  {
+    auto so2 = std::make_shared<SO2>();
+    subspaces.push_back(so2);
+    metrics.emplace_back(std::make_shared<SO2Angular>(so2), 1.);
+  }
+  auto space = std::make_shared<CartesianProduct>(subspaces);
+  auto metric = std::make_shared<CartesianProductWeighted>(space, metrics);
+
+  const auto states = sampleStates(*space, numStates);
+  const auto queries = sampleStates(*space, numQueries);
+  const std::vector<const StateSpace::State*> constQueries(
+      queries.begin(), queries.end());
+
+  KdTreeNearestNeighbors exact(metric);
+  RandomizedKdForestNearestNeighbors forest(metric);
+
+  auto start = Clock::now();
+  for (const auto state : states)
+    exact.add(state);
+  std::cout << "KD-tree build:       " << getSecondsSince(start) << " s\n";
+
+  start = Clock::now();
+  for (const auto state : states)
+    forest.add(state);
+  forest.build();
+  std::cout << "KD-forest build:     " << getSecondsSince(start) << " s\n";
+
+  std::vector<std::vector<NearestNeighbors::Neighbor>> expected;
+  expected.reserve(numQueries);
+  start = Clock::now();
+  for (const auto query : queries)
+    expected.push_back(exact.nearestK(query, k));
+  const double exactTime = getSecondsSince(start);
+  std::cout << "KD-tree query:       " << 1e6 * exactTime / numQueries
+            << " us\n\n";
+
+  std::cout << std::setw(10) << "maxChecks" << std::setw(12) << "recall"
+            << std::setw(14) << "query (us)" << std::setw(14)
+            << "batch (us)" << std::setw(10) << "speedup" << "\n";
+
+  for (std::size_t maxChecks = 16; maxChecks <= 4096; maxChecks *= 2)
+  {
+    forest.setMaxChecks(maxChecks);
+
+    std::size_t numFound = 0;
+    start = Clock::now();
+    for (std::size_t i = 0; i < numQueries; ++i)
+    {
+      const auto neighbors = forest.nearestK(queries[i], k);
+      for (const auto& neighbor : expected[i])
+      {
+        for (const auto& candidate : neighbors)
+        {
+          if (candidate.first == neighbor.first)
+          {
+            ++numFound;
+            break;
+          }
+        }
+      }
+    }
+    const double queryTime = getSecondsSince(start);
+
+    start = Clock::now();
+    forest.nearestKBatch(constQueries.data(), numQueries, k);
+    const double batchTime = getSecondsSince(start);
+
+    std::cout << std::setw(10) << maxChecks << std::setw(12)
+              << static_cast<double>(numFound) / (numQueries * k)
+              << std::setw(14) << 1e6 * queryTime / numQueries
+              << std::setw(14) << 1e6 * batchTime / numQueries
+              << std::setw(10) << exactTime / queryTime << "\n";
+  }
+
+  for (const auto state : states)
+    space->freeState(state);
+  for (const auto query : queries)
+    space->freeState(query);
+
+  return 0;
+}
@@ -0,0 +1,768 @@
+/// Benchmarks the planners of aikido on reproducible scenes, in which a 7-DOF
+/// arm reaches over a table, into a shelf and through a narrow window in a
+/// wall. Every planner runs numTrials times per scene; the success rate, the
+/// percentiles of the planning time, the mean number of collision checks and
+/// the mean path length are written to stdout as JSON, to be compared between
+/// releases.
+///
+/// simplifyOMPL, computeParabolicTiming and doShortcutAndBlend post-process a
+/// path that is planned once per scene with RRTConnect.
+///
+/// Usage: benchmark_Planners [numTrials] [seed]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <dart/dart.hpp>
+#include <ompl/geometric/planners/kpiece/BKPIECE1.h>
+#include <ompl/geometric/planners/rrt/RRT.h>
+#include <ompl/geometric/planners/rrt/RRTConnect.h>
+#include <ompl/util/Console.h>
+#include <ompl/util/RandomNumbers.h>
+#include <aikido/common/RNG.hpp>
+#include <aikido/constraint/CollisionFree.hpp>
+#include <aikido/constraint/FiniteSampleable.hpp>
+#include <aikido/constraint/JointStateSpaceHelpers.hpp>
+#include <aikido/distance/defaults.hpp>
+#include <aikido/planner/PlanningResult.hpp>
+#include <aikido/planner/SnapPlanner.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+#include <aikido/planner/parabolic/ParabolicSmoother.hpp>
+#include <aikido/planner/parabolic/ParabolicTimer.hpp>
+#include <aikido/planner/vectorfield/VectorFieldPlanner.hpp>
+#include <aikido/statespace/GeodesicInterpolator.hpp>
+#include <aikido/statespace/dart/MetaSkeletonStateSpace.hpp>
+
+using aikido::common::RNGWrapper;
+using aikido::statespace::StateSpace;
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+using aikido::statespace::dart::MetaSkeletonStateSpacePtr;
+using aikido::trajectory::InterpolatedPtr;
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr std::size_t NUM_DOFS = 7;
+constexpr double LINK_LENGTH = 0.3;
+constexpr double LINK_WIDTH = 0.06;
+
+constexpr double MAX_PLAN_TIME = 10.;
+constexpr double COLLISION_RESOLUTION = 0.05;
+constexpr double GOAL_RADIUS = 0.1;
+constexpr double SIMPLIFY_TIME = 1.;
+constexpr std::size_t SIMPLIFY_MAX_EMPTY_STEPS = 100;
+constexpr double SHORTCUT_TIME = 1.;
+constexpr double OFFSET_DISTANCE = 0.15;
+constexpr std::size_t NUM_LENGTH_SAMPLES = 1000;
+
+/// Counts the states that a Testable checks.
+class CountingTestable : public aikido::constraint::Testable
+{
+public:
+  explicit CountingTestable(aikido::constraint::TestablePtr _testable)
+    : mTestable(std::move(_testable)), mNumChecks(0)
+  {
+  }
+
+  bool isSatisfied(const StateSpace::State* _state) const override
+  {
+    ++mNumChecks;
+    return mTestable->isSatisfied(_state);
+  }
+
+  aikido::statespace::StateSpacePtr getStateSpace() const override
+  {
+    return mTestable->getStateSpace();
+  }
+
+  /// Returns the number of checks since the last call.
+  std::size_t resetNumChecks()
+  {
+    return mNumChecks.exchange(0);
+  }
+
+private:
+  aikido::constraint::TestablePtr mTestable;
+  mutable std::atomic<std::size_t> mNumChecks;
+};
+
+/// Accepts states whose joint positions are within a radius of a goal.
+class GoalBall : public aikido::constraint::Testable
+{
+public:
+  GoalBall(
+      MetaSkeletonStateSpacePtr _stateSpace,
+      Eigen::VectorXd _goal,
+      double _radius)
+    : mStateSpace(std::move(_stateSpace))
+    , mGoal(std::move(_goal))
+    , mRadius(_radius)
+  {
+  }
+
+  bool isSatisfied(const StateSpace::State* _state) const override
+  {
+    Eigen::VectorXd positions;
+    mStateSpace->convertStateToPositions(
+        static_cast<const MetaSkeletonStateSpace::State*>(_state), positions);
+    return (positions - mGoal).norm() <= mRadius;
+  }
+
+  aikido::statespace::StateSpacePtr getStateSpace() const override
+  {
+    return mStateSpace;
+  }
+
+private:
+  MetaSkeletonStateSpacePtr mStateSpace;
+  Eigen::VectorXd mGoal;
+  double mRadius;
+};
+
+/// Obstacles around the arm, and the queries to plan in them.
+struct Scene
+{
+  std::string mName;
+  dart::dynamics::SkeletonPtr mObstacles;
+
+  /// Start and goal joint positions, both collision-free.
+  Eigen::VectorXd mStart;
+  Eigen::VectorXd mGoal;
+
+  /// Collision-free direction in which the end-effector can move by
+  /// OFFSET_DISTANCE from the goal.
+  Eigen::Vector3d mOffsetDirection;
+};
+
+/// The components shared by the planners in a scene.
+struct Problem
+{
+  dart::dynamics::SkeletonPtr mArm;
+  MetaSkeletonStateSpacePtr mStateSpace;
+  aikido::statespace::InterpolatorPtr mInterpolator;
+  aikido::distance::DistanceMetricPtr mDistanceMetric;
+  std::shared_ptr<CountingTestable> mCollisionConstraint;
+  aikido::constraint::TestablePtr mBoundsConstraint;
+  aikido::constraint::ProjectablePtr mBoundsProjector;
+  const Scene* mScene;
+
+  /// Path from the start to the goal, post-processed by the benchmarks of
+  /// simplifyOMPL, computeParabolicTiming and doShortcutAndBlend.
+  InterpolatedPtr mPath;
+};
+
+/// Outcome of a single run of a planner.
+struct Trial
+{
+  bool mSuccess;
+  double mTime;
+  std::size_t mNumCollisionChecks;
+  double mPathLength;
+};
+
+/// Runs a planner once on a Problem, seeding its randomness with the second
+/// argument.
+using Benchmark = std::function<Trial(Problem&, std::size_t)>;
+
+//==============================================================================
+/// Returns the seconds elapsed since _start.
+double getSecondsSince(Clock::time_point _start)
+{
+  return std::chrono::duration<double>(Clock::now() - _start).count();
+}
+
+//==============================================================================
+/// Creates an arm of NUM_DOFS revolute joints that alternate between the z
+/// and y axes, with box-shaped links.
+dart::dynamics::SkeletonPtr createArm()
+{
+  auto arm = dart::dynamics::Skeleton::create("arm");
+  auto linkShape = std::make_shared<dart::dynamics::BoxShape>(
+      Eigen::Vector3d(LINK_WIDTH, LINK_WIDTH, LINK_LENGTH));
+
+  dart::dynamics::BodyNode* parent = nullptr;
+  for (std::size_t i = 0; i < NUM_DOFS; ++i)
+  {
+    dart::dynamics::RevoluteJoint::Properties jointProperties;
+    jointProperties.mName = "joint" + std::to_string(i);
+    jointProperties.mAxis
+        = i % 2 == 0 ? Eigen::Vector3d::UnitZ() : Eigen::Vector3d::UnitY();
+    if (parent)
+      jointProperties.mT_ParentBodyToJoint.translation()
+          = Eigen::Vector3d(0., 0., LINK_LENGTH);
+
+    dart::dynamics::BodyNode::Properties bodyProperties;
+    bodyProperties.mName = "link" + std::to_string(i);
+
+    parent = arm->createJointAndBodyNodePair<dart::dynamics::RevoluteJoint>(
+                    parent, jointProperties, bodyProperties)
+                 .second;
+
+    auto shapeNode = parent->createShapeNodeWith<
+        dart::dynamics::VisualAspect,
+        dart::dynamics::CollisionAspect>(linkShape);
+    shapeNode->setRelativeTranslation(
+        Eigen::Vector3d(0., 0., LINK_LENGTH / 2.));
+
+    arm->setPositionLowerLimit(i, -M_PI);
+    arm->setPositionUpperLimit(i, M_PI);
+  }
+
+  return arm;
+}
+
+//==============================================================================
+/// Adds a box of _size centered at _position to _obstacles.
+void addBox(
+    const dart::dynamics::SkeletonPtr& _obstacles,
+    const Eigen::Vector3d& _size,
+    const Eigen::Vector3d& _position)
+{
+  dart::dynamics::WeldJoint::Properties jointProperties;
+  jointProperties.mName = "box" + std::to_string(_obstacles->getNumJoints());
+  jointProperties.mT_ParentBodyToJoint.translation() = _position;
+
+  auto body
+      = _obstacles
+            ->createJointAndBodyNodePair<dart::dynamics::WeldJoint>(
+                nullptr, jointProperties)
+            .second;
+  body->createShapeNodeWith<
+      dart::dynamics::VisualAspect,
+      dart::dynamics::CollisionAspect>(
+      std::make_shared<dart::dynamics::BoxShape>(_size));
+}
+
+//==============================================================================
+/// Creates the scenes. The arm starts upright, and its goals were found by
+/// optimizing the clearance of the links to the obstacles.
+std::vector<Scene> createScenes()
+{
+  std::vector<Scene> scenes(3);
+  for (auto& scene : scenes)
+  {
+    scene.mStart = Eigen::VectorXd::Zero(NUM_DOFS);
+    scene.mGoal.resize(NUM_DOFS);
+  }
+
+  // Reach over a table top, in front of the arm.
+  auto& table = scenes[0];
+  table.mName = "table";
+  table.mObstacles = dart::dynamics::Skeleton::create("table");
+  addBox(
+      table.mObstacles,
+      Eigen::Vector3d(0.8, 1.2, 0.04),
+      Eigen::Vector3d(0.9, 0., 0.7));
+  for (const double x : {0.55, 1.25})
+  {
+    for (const double y : {-0.55, 0.55})
+    {
+      addBox(
+          table.mObstacles,
+          Eigen::Vector3d(0.04, 0.04, 0.68),
+          Eigen::Vector3d(x, y, 0.34));
+    }
+  }
+  table.mGoal << -0.23, 0.66, -0.03, 0.17, 1.16, 1.96, -0.14;
+  table.mOffsetDirection = Eigen::Vector3d::UnitZ();
+
+  // Reach into the middle of three bays of a shelf.
+  auto& shelf = scenes[1];
+  shelf.mName = "shelf";
+  shelf.mObstacles = dart::dynamics::Skeleton::create("shelf");
+  for (const double z : {0.5, 0.9, 1.3, 1.7})
+  {
+    addBox(
+        shelf.mObstacles,
+        Eigen::Vector3d(0.4, 1.0, 0.03),
+        Eigen::Vector3d(0.95, 0., z));
+  }
+  for (const double y : {-0.5, 0.5})
+  {
+    addBox(
+        shelf.mObstacles,
+        Eigen::Vector3d(0.4, 0.03, 1.2),
+        Eigen::Vector3d(0.95, y, 1.1));
+  }
+  addBox(
+      shelf.mObstacles,
+      Eigen::Vector3d(0.03, 1.0, 1.2),
+      Eigen::Vector3d(1.165, 0., 1.1));
+  shelf.mGoal << -0.10, -0.39, 0.08, 1.75, -0.95, 0.01, 0.56;
+  shelf.mOffsetDirection = -Eigen::Vector3d::UnitX();
+
+  // Reach through a square window in a wall.
+  auto& wall = scenes[2];
+  wall.mName = "narrow_passage";
+  wall.mObstacles = dart::dynamics::Skeleton::create("wall");
+  const double windowHeight = 1.0;
+  const double halfWindow = 0.125;
+  const double wallHeight = 2.2;
+  addBox(
+      wall.mObstacles,
+      Eigen::Vector3d(0.05, 2.0, windowHeight - halfWindow),
+      Eigen::Vector3d(0.625, 0., (windowHeight - halfWindow) / 2.));
+  addBox(
+      wall.mObstacles,
+      Eigen::Vector3d(0.05, 2.0, wallHeight - windowHeight - halfWindow),
+      Eigen::Vector3d(
+          0.625, 0., (wallHeight + windowHeight + halfWindow) / 2.));
+  for (const double side : {-1., 1.})
+  {
+    addBox(
+        wall.mObstacles,
+        Eigen::Vector3d(0.05, 1.0 - halfWindow, 2. * halfWindow),
+        Eigen::Vector3d(
+            0.625, side * (1.0 + halfWindow) / 2., windowHeight));
+  }
+  wall.mGoal << 0.75, 1.11, 0.36, -1.71, -0.89, 1.77, 0.28;
+  wall.mOffsetDirection = -Eigen::Vector3d::UnitX();
+
+  return scenes;
+}
+
+//==============================================================================
+/// Creates the components shared by the planners in _scene.
+Problem createProblem(const Scene& _scene)
+{
+  Problem problem;
+  problem.mArm = createArm();
+  problem.mStateSpace = std::make_shared<MetaSkeletonStateSpace>(problem.mArm);
+  problem.mInterpolator
+      = std::make_shared<aikido::statespace::GeodesicInterpolator>(
+          problem.mStateSpace);
+  problem.mDistanceMetric
+      = aikido::distance::createDistanceMetric(problem.mStateSpace);
+
+  auto collisionDetector
+      = dart::collision::FCLCollisionDetector::create();
+  auto armGroup
+      = collisionDetector->createCollisionGroupAsSharedPtr(problem.mArm.get());
+  auto obstacleGroup = collisionDetector->createCollisionGroupAsSharedPtr(
+      _scene.mObstacles.get());
+  auto collisionFree = std::make_shared<aikido::constraint::CollisionFree>(
+      problem.mStateSpace, collisionDetector);
+  collisionFree->addPairwiseCheck(armGroup, obstacleGroup);
+  problem.mCollisionConstraint
+      = std::make_shared<CountingTestable>(collisionFree);
+
+  problem.mBoundsConstraint
+      = aikido::constraint::createTestableBounds(problem.mStateSpace);
+  problem.mBoundsProjector
+      = aikido::constraint::createProjectableBounds(problem.mStateSpace);
+  problem.mScene = &_scene;
+
+  return problem;
+}
+
+//==============================================================================
+/// Returns a sampler of the joint limits, seeded with _seed.
+aikido::constraint::SampleablePtr createSampler(
+    const Problem& _problem, std::size_t _seed)
+{
+  return aikido::constraint::createSampleableBounds(
+      _problem.mStateSpace,
+      std::unique_ptr<aikido::common::RNG>(
+          new RNGWrapper<std::mt19937>(_seed)));
+}
+
+//==============================================================================
+/// Returns the length of _trajectory under _metric, approximated by
+/// NUM_LENGTH_SAMPLES evaluations.
+double computePathLength(
+    const aikido::trajectory::Trajectory& _trajectory,
+    const aikido::distance::DistanceMetric& _metric)
+{
+  const auto stateSpace = _trajectory.getStateSpace();
+  auto previous = stateSpace->createState();
+  auto current = stateSpace->createState();
+
+  double length = 0.;
+  _trajectory.evaluate(_trajectory.getStartTime(), previous);
+  for (std::size_t i = 1; i <= NUM_LENGTH_SAMPLES; ++i)
+  {
+    const double time = _trajectory.getStartTime()
+                        + _trajectory.getDuration() * i / NUM_LENGTH_SAMPLES;
+    _trajectory.evaluate(time, current);
+    length += _metric.distance(previous, current);
+    stateSpace->copyState(current, previous);
+  }
+  return length;
+}
+
+//==============================================================================
+/// Times _plan, which returns a trajectory or nullptr on failure, and counts
+/// the collision checks it makes.
+template <typename PlanFunction>
+Trial runTrial(Problem& _problem, PlanFunction _plan)
+{
+  _problem.mCollisionConstraint->resetNumChecks();
+
+  const auto start = Clock::now();
+  auto trajectory = _plan();
+  const double time = getSecondsSince(start);
+
+  Trial trial;
+  trial.mSuccess = trajectory != nullptr;
+  trial.mTime = time;
+  trial.mNumCollisionChecks = _problem.mCollisionConstraint->resetNumChecks();
+  trial.mPathLength
+      = trajectory ? computePathLength(*trajectory, *_problem.mDistanceMetric)
+                   : std::numeric_limits<double>::quiet_NaN();
+  return trial;
+}
+
+//==============================================================================
+/// Returns a Benchmark of planOMPL with the template OMPL Planner type.
+template <class PlannerType>
+Benchmark benchmarkOMPL()
+{
+  return [](Problem& _problem, std::size_t _seed) {
+    auto startState = _problem.mStateSpace->createState();
+    _problem.mStateSpace->convertPositionsToState(
+        _problem.mScene->mStart, startState);
+    auto goalState = _problem.mStateSpace->createState();
+    _problem.mStateSpace->convertPositionsToState(
+        _problem.mScene->mGoal, goalState);
+    auto sampler = createSampler(_problem, _seed);
+
+    return runTrial(_problem, [&]() {
+      return aikido::planner::ompl::planOMPL<PlannerType>(
+          startState,
+          goalState,
+          _problem.mStateSpace,
+          _problem.mInterpolator,
+          _problem.mDistanceMetric,
+          sampler,
+          _problem.mCollisionConstraint,
+          _problem.mBoundsConstraint,
+          _problem.mBoundsProjector,
+          MAX_PLAN_TIME,
+          COLLISION_RESOLUTION);
+    });
+  };
+}
+
+//==============================================================================
+/// Returns a Benchmark of planCRRT, or of planCRRTConnect if _connect is
+/// true. The trajectory constraint only projects onto the joint limits, so
+/// the problems are the ones of planOMPL; the goal is a ball around the goal
+/// positions.
+Benchmark benchmarkCRRT(bool _connect)
+{
+  return [_connect](Problem& _problem, std::size_t _seed) {
+    auto startState = _problem.mStateSpace->createState();
+    _problem.mStateSpace->convertPositionsToState(
+        _problem.mScene->mStart, startState);
+    auto goalState = _problem.mStateSpace->createState();
+    _problem.mStateSpace->convertPositionsToState(
+        _problem.mScene->mGoal, goalState);
+
+    auto goalTestable = std::make_shared<GoalBall>(
+        _problem.mStateSpace, _problem.mScene->mGoal, GOAL_RADIUS);
+    auto goalSampler = std::make_shared<aikido::constraint::FiniteSampleable>(
+        _problem.mStateSpace, goalState);
+    auto sampler = createSampler(_problem, _seed);
+
+    return runTrial(_problem, [&]() {
+      if (_connect)
+      {
+        return aikido::planner::ompl::planCRRTConnect(
+            startState,
+            goalTestable,
+            goalSampler,
+            _problem.mBoundsProjector,
+            _problem.mStateSpace,
+            _problem.mInterpolator,
+            _problem.mDistanceMetric,
+            sampler,
+            _problem.mCollisionConstraint,
+            _problem.mBoundsConstraint,
+            _problem.mBoundsProjector,
+            MAX_PLAN_TIME,
+            std::numeric_limits<double>::infinity(),
+            0.1,
+            COLLISION_RESOLUTION,
+            0.1);
+      }
+
+      return aikido::planner::ompl::planCRRT(
+          startState,
+          goalTestable,
+          goalSampler,
+          _problem.mBoundsProjector,
+          _problem.mStateSpace,
+          _problem.mInterpolator,
+          _problem.mDistanceMetric,
+          sampler,
+          _problem.mCollisionConstraint,
+          _problem.mBoundsConstraint,
+          _problem.mBoundsProjector,
+          MAX_PLAN_TIME,
+          std::numeric_limits<double>::infinity(),
+          0.1,
+          COLLISION_RESOLUTION);
+    });
+  };
+}
+
+//==============================================================================
+Trial benchmarkSnap(Problem& _problem, std::size_t /*_seed*/)
+{
+  auto startState = _problem.mStateSpace->createState();
+  _problem.mStateSpace->convertPositionsToState(
+      _problem.mScene->mStart, startState);
+  auto goalState = _problem.mStateSpace->createState();
+  _problem.mStateSpace->convertPositionsToState(
+      _problem.mScene->mGoal, goalState);
+
+  aikido::planner::PlanningResult planningResult;
+  return runTrial(_problem, [&]() {
+    return aikido::planner::planSnap(
+        _problem.mStateSpace,
+        startState,
+        goalState,
+        _problem.mInterpolator,
+        _problem.mCollisionConstraint,
+        planningResult);
+  });
+}
+
+//==============================================================================
+Trial benchmarkSimplify(Problem& _problem, std::size_t _seed)
+{
+  auto sampler = createSampler(_problem, _seed);
+  return runTrial(_problem, [&]() {
+    return aikido::planner::ompl::simplifyOMPL(
+               _problem.mStateSpace,
+               _problem.mInterpolator,
+               _problem.mDistanceMetric,
+               sampler,
+               _problem.mCollisionConstraint,
+               _problem.mBoundsConstraint,
+               _problem.mBoundsProjector,
+               COLLISION_RESOLUTION,
+               SIMPLIFY_TIME,
+               SIMPLIFY_MAX_EMPTY_STEPS,
+               _problem.mPath)
+        .first;
+  });
+}
+
+//==============================================================================
+/// Velocity and acceleration limits of every joint.
+Eigen::VectorXd getMaxVelocity()
+{
+  return Eigen::VectorXd::Constant(NUM_DOFS, 1.);
+}
+
+Eigen::VectorXd getMaxAcceleration()
+{
+  return Eigen::VectorXd::Constant(NUM_DOFS, 2.);
+}
+
+//==============================================================================
+Trial benchmarkParabolicTiming(Problem& _problem, std::size_t /*_seed*/)
+{
+  return runTrial(_problem, [&]() {
+    return aikido::planner::parabolic::computeParabolicTiming(
+        *_problem.mPath, getMaxVelocity(), getMaxAcceleration());
+  });
+}
+
+//==============================================================================
+Trial benchmarkShortcutAndBlend(Problem& _problem, std::size_t _seed)
+{
+  auto timedPath = aikido::planner::parabolic::computeParabolicTiming(
+      *_problem.mPath, getMaxVelocity(), getMaxAcceleration());
+  RNGWrapper<std::mt19937> rng(_seed);
+
+  return runTrial(_problem, [&]() {
+    return aikido::planner::parabolic::doShortcutAndBlend(
+        *timedPath,
+        _problem.mCollisionConstraint,
+        getMaxVelocity(),
+        getMaxAcceleration(),
+        rng,
+        SHORTCUT_TIME);
+  });
+}
+
+//==============================================================================
+Trial benchmarkEndEffectorOffset(Problem& _problem, std::size_t /*_seed*/)
+{
+  // The vector field starts at the current positions of the arm.
+  _problem.mArm->setPositions(_problem.mScene->mGoal);
+
+  return runTrial(_problem, [&]() {
+    return aikido::planner::vectorfield::planToEndEffectorOffset(
+        _problem.mStateSpace,
+        _problem.mArm->getBodyNode(NUM_DOFS - 1),
+        _problem.mCollisionConstraint,
+        _problem.mScene->mOffsetDirection,
+        OFFSET_DISTANCE,
+        OFFSET_DISTANCE + 0.05,
+        0.01,
+        0.15,
+        0.001,
+        1e-3,
+        1e-3,
+        std::chrono::duration<double>(MAX_PLAN_TIME));
+  });
+}
+
+//==============================================================================
+/// Returns the _fraction percentile of the sorted _values, by nearest rank.
+double getPercentile(const std::vector<double>& _values, double _fraction)
+{
+  const auto rank = static_cast<std::size_t>(
+      std::ceil(_fraction * static_cast<double>(_values.size())));
+  return _values[std::max<std::size_t>(rank, 1) - 1];
+}
+
+//==============================================================================
+/// Writes _value as JSON, with null for values that are not finite.
+void writeNumber(double _value)
+{
+  if (std::isfinite(_value))
+    std::cout << _value;
+  else
+    std::cout << "null";
+}
+
+//==============================================================================
+/// Writes the statistics of _trials as a JSON object.
+void writeResult(
+    const std::string& _scene,
+    const std::string& _planner,
+    const std::vector<Trial>& _trials)
+{
+  std::vector<double> times;
+  std::size_t numSuccesses = 0;
+  double numCollisionChecks = 0.;
+  double pathLength = 0.;
+  for (const auto& trial : _trials)
+  {
+    times.push_back(trial.mTime);
+    numCollisionChecks += trial.mNumCollisionChecks;
+    if (trial.mSuccess)
+    {
+      ++numSuccesses;
+      pathLength += trial.mPathLength;
+    }
+  }
+  std::sort(times.begin(), times.end());
+
+  std::cout << "    {\"scene\": \"" << _scene << "\", \"planner\": \""
+            << _planner << "\", \"success_rate\": "
+            << static_cast<double>(numSuccesses) / _trials.size()
+            << ",\n     \"time\": {\"min\": " << times.front()
+            << ", \"p50\": " << getPercentile(times, 0.5)
+            << ", \"p90\": " << getPercentile(times, 0.9)
+            << ", \"p99\": " << getPercentile(times, 0.99)
+            << ", \"max\": " << times.back() << "},\n"
+            << "     \"collision_checks\": "
+            << numCollisionChecks / _trials.size() << ", \"path_length\": ";
+  writeNumber(
+      numSuccesses > 0 ? pathLength / numSuccesses
+                       : std::numeric_limits<double>::quiet_NaN());
+  std::cout << "}";
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+  const std::size_t numTrials = argc > 1 ? std::atol(argv[1]) : 10;
+  const std::size_t seed = argc > 2 ? std::atol(argv[2]) : 0;
+  if (numTrials == 0)
+  {
+    std::cerr << "Usage: benchmark_Planners [numTrials] [seed]\n";
+    return 1;
+  }
+
+  // The JSON report is the only output.
+  ::ompl::msg::noOutputHandler();
+  ::ompl::RNG::setSeed(seed);
+
+  const std::vector<std::pair<std::string, Benchmark>> planners{
+      {"planSnap", benchmarkSnap},
+      {"planOMPL/RRTConnect", benchmarkOMPL<::ompl::geometric::RRTConnect>()},
+      {"planOMPL/RRT", benchmarkOMPL<::ompl::geometric::RRT>()},
+      {"planOMPL/BKPIECE1", benchmarkOMPL<::ompl::geometric::BKPIECE1>()},
+      {"planCRRT", benchmarkCRRT(false)},
+      {"planCRRTConnect", benchmarkCRRT(true)},
+      {"planToEndEffectorOffset", benchmarkEndEffectorOffset}};
+  const std::vector<std::pair<std::string, Benchmark>> postProcessors{
+      {"simplifyOMPL", benchmarkSimplify},
+      {"computeParabolicTiming", benchmarkParabolicTiming},
+      {"doShortcutAndBlend", benchmarkShortcutAndBlend}};
+
+  const auto scenes = createScenes();
+
+  std::cout << "{\n  \"num_trials\": " << numTrials << ", \"seed\": " << seed
+            << ",\n  \"results\": [\n";
+  bool first = true;
+  const auto run = [&](Problem& _problem, const std::string& _planner,
+                       const Benchmark& _benchmark) {
+    std::vector<Trial> trials;
+    for (std::size_t i = 0; i < numTrials; ++i)
+      trials.push_back(_benchmark(_problem, seed + i));
+
+    if (!first)
+      std::cout << ",\n";
+    first = false;
+    writeResult(_problem.mScene->mName, _planner, trials);
+  };
+
+  for (const auto& scene : scenes)
+  {
+    auto problem = createProblem(scene);
+    for (const auto& planner : planners)
+      run(problem, planner.first, planner.second);
+
+    // Plan the path to post-process once, so that every trial starts from
+    // the same path.
+    auto startState = problem.mStateSpace->createState();
+    problem.mStateSpace->convertPositionsToState(scene.mStart, startState);
+    auto goalState = problem.mStateSpace->createState();
+    problem.mStateSpace->convertPositionsToState(scene.mGoal, goalState);
+    problem.mPath = aikido::planner::ompl::planOMPL<
+        ::ompl::geometric::RRTConnect>(
+        startState,
+        goalState,
+        problem.mStateSpace,
+        problem.mInterpolator,
+        problem.mDistanceMetric,
+        createSampler(problem, seed),
+        problem.mCollisionConstraint,
+        problem.mBoundsConstraint,
+        problem.mBoundsProjector,
+        MAX_PLAN_TIME,
+        COLLISION_RESOLUTION);
+    if (!problem.mPath)
+    {
+      std::cerr << "Failed to plan a path to post-process in scene '"
+                << scene.mName << "'.\n";
+      continue;
+    }
+
+    for (const auto& postProcessor : postProcessors)
+      run(problem, postProcessor.first, postProcessor.second);
+  }
+
+  std::cout << "\n  ]\n}\n";
+  return 0;
+}
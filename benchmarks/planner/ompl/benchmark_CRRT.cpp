@@ -0,0 +1,252 @@
+/// Counts the heap allocations and time of CRRT planning for a 7-DOF arm
+/// whose end-effector must stay upright at a constant height, a TSR
+/// constraint enforced by NewtonsMethodProjectable. Compares a new planner
+/// per query with a planner that is cleared and reused, whose motion pool no
+/// longer allocates once it has grown to the size of the tree.
+///
+/// Usage: benchmark_CRRT [numPlans]
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <random>
+#include <string>
+#include <dart/dart.hpp>
+#include <aikido/common/RNG.hpp>
+#include <aikido/constraint/FiniteSampleable.hpp>
+#include <aikido/constraint/FrameDifferentiable.hpp>
+#include <aikido/constraint/JointStateSpaceHelpers.hpp>
+#include <aikido/constraint/NewtonsMethodProjectable.hpp>
+#include <aikido/constraint/Satisfied.hpp>
+#include <aikido/constraint/TSR.hpp>
+#include <aikido/distance/defaults.hpp>
+#include <aikido/planner/ompl/CRRT.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+#include <aikido/statespace/GeodesicInterpolator.hpp>
+#include <aikido/statespace/dart/MetaSkeletonStateSpace.hpp>
+
+using aikido::common::RNGWrapper;
+using aikido::planner::ompl::CRRT;
+using aikido::planner::ompl::ompl_make_shared;
+using aikido::planner::ompl::ompl_static_pointer_cast;
+using aikido::statespace::StateSpace;
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+using aikido::statespace::dart::MetaSkeletonStateSpacePtr;
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::atomic<std::size_t> gNumAllocations(0);
+
+constexpr std::size_t NUM_DOFS = 7;
+constexpr double MAX_PLAN_TIME = 10.;
+
+/// Accepts states whose joint positions are within a radius of a goal.
+class GoalBall : public aikido::constraint::Testable
+{
+public:
+  GoalBall(
+      MetaSkeletonStateSpacePtr _stateSpace,
+      Eigen::VectorXd _goal,
+      double _radius)
+    : mStateSpace(std::move(_stateSpace))
+    , mGoal(std::move(_goal))
+    , mRadius(_radius)
+  {
+  }
+
+  bool isSatisfied(const StateSpace::State* _state) const override
+  {
+    Eigen::VectorXd positions;
+    mStateSpace->convertStateToPositions(
+        static_cast<const MetaSkeletonStateSpace::State*>(_state), positions);
+    return (positions - mGoal).norm() <= mRadius;
+  }
+
+  aikido::statespace::StateSpacePtr getStateSpace() const override
+  {
+    return mStateSpace;
+  }
+
+private:
+  MetaSkeletonStateSpacePtr mStateSpace;
+  Eigen::VectorXd mGoal;
+  double mRadius;
+};
+
+//==============================================================================
+/// Returns the seconds elapsed since _start.
+double getSecondsSince(Clock::time_point _start)
+{
+  return std::chrono::duration<double>(Clock::now() - _start).count();
+}
+
+//==============================================================================
+/// Creates an arm of NUM_DOFS revolute joints that alternate between the z
+/// and y axes.
+dart::dynamics::SkeletonPtr createArm()
+{
+  auto arm = dart::dynamics::Skeleton::create("arm");
+
+  dart::dynamics::BodyNode* parent = nullptr;
+  for (std::size_t i = 0; i < NUM_DOFS; ++i)
+  {
+    dart::dynamics::RevoluteJoint::Properties jointProperties;
+    jointProperties.mName = "joint" + std::to_string(i);
+    jointProperties.mAxis
+        = i % 2 == 0 ? Eigen::Vector3d::UnitZ() : Eigen::Vector3d::UnitY();
+    if (parent)
+      jointProperties.mT_ParentBodyToJoint.translation()
+          = Eigen::Vector3d(0., 0., 0.3);
+
+    dart::dynamics::BodyNode::Properties bodyProperties;
+    bodyProperties.mName = "link" + std::to_string(i);
+
+    parent = arm->createJointAndBodyNodePair<dart::dynamics::RevoluteJoint>(
+                    parent, jointProperties, bodyProperties)
+                 .second;
+
+    arm->setPositionLowerLimit(i, -M_PI);
+    arm->setPositionUpperLimit(i, M_PI);
+  }
+
+  return arm;
+}
+
+} // namespace
+
+//==============================================================================
+void* operator new(std::size_t _size)
+{
+  ++gNumAllocations;
+  if (void* memory = std::malloc(_size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+//==============================================================================
+void operator delete(void* _memory) noexcept
+{
+  std::free(_memory);
+}
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+  const std::size_t numPlans = argc > 1 ? std::atol(argv[1]) : 20;
+
+  auto arm = createArm();
+  auto endEffector = arm->getBodyNode(NUM_DOFS - 1);
+  auto stateSpace = std::make_shared<MetaSkeletonStateSpace>(arm);
+  auto interpolator
+      = std::make_shared<aikido::statespace::GeodesicInterpolator>(stateSpace);
+  auto dmetric = aikido::distance::createDistanceMetric(stateSpace);
+
+  // The end-effector keeps the height and upright orientation of the start
+  // pose, but may translate horizontally and rotate about the vertical axis.
+  Eigen::VectorXd startPositions(NUM_DOFS);
+  startPositions << 0., 0.6, 0., -1.2, 0., 0.6, 0.;
+  arm->setPositions(startPositions);
+
+  Eigen::Matrix<double, 6, 2> bounds = Eigen::Matrix<double, 6, 2>::Zero();
+  bounds.row(0) << -1., 1.;
+  bounds.row(1) << -1., 1.;
+  bounds.row(5) << -M_PI, M_PI;
+  auto tsr = std::make_shared<aikido::constraint::TSR>(
+      endEffector->getWorldTransform(), bounds);
+  auto projectable
+      = std::make_shared<aikido::constraint::NewtonsMethodProjectable>(
+          std::make_shared<aikido::constraint::FrameDifferentiable>(
+              stateSpace, endEffector, tsr),
+          std::vector<double>(6, 1e-4));
+
+  auto startState = stateSpace->createState();
+  stateSpace->convertPositionsToState(startPositions, startState);
+
+  // Project a goal configuration onto the constraint.
+  Eigen::VectorXd goalPositions(NUM_DOFS);
+  goalPositions << 1.2, 0.3, 0.4, -1.5, 0.2, 0.9, 0.1;
+  auto unprojectedGoalState = stateSpace->createState();
+  stateSpace->convertPositionsToState(goalPositions, unprojectedGoalState);
+  auto goalState = stateSpace->createState();
+  if (!projectable->project(unprojectedGoalState, goalState))
+  {
+    std::cerr << "Failed to project the goal onto the constraint.\n";
+    return 1;
+  }
+  stateSpace->convertStateToPositions(goalState, goalPositions);
+
+  auto si = aikido::planner::ompl::getSpaceInformation(
+      stateSpace,
+      interpolator,
+      dmetric,
+      aikido::constraint::createSampleableBounds(
+          stateSpace,
+          std::unique_ptr<aikido::common::RNG>(
+              new RNGWrapper<std::mt19937>(0))),
+      std::make_shared<aikido::constraint::Satisfied>(stateSpace),
+      aikido::constraint::createTestableBounds(stateSpace),
+      aikido::constraint::createProjectableBounds(stateSpace),
+      0.1);
+
+  auto sspace = ompl_static_pointer_cast<
+      aikido::planner::ompl::GeometricStateSpace>(si->getStateSpace());
+  auto pdef = ompl_make_shared<::ompl::base::ProblemDefinition>(si);
+  auto start = sspace->allocState(startState);
+  pdef->addStartState(start);
+  sspace->freeState(start);
+  pdef->setGoal(
+      aikido::planner::ompl::getGoalRegion(
+          si,
+          std::make_shared<GoalBall>(stateSpace, goalPositions, 0.1),
+          std::make_shared<aikido::constraint::FiniteSampleable>(
+              stateSpace, goalState)));
+
+  const auto createPlanner = [&]() {
+    auto planner = ompl_make_shared<CRRT>(si);
+    planner->setProblemDefinition(pdef);
+    planner->setPathConstraint(projectable);
+    planner->setRange(std::numeric_limits<double>::infinity());
+    planner->setProjectionResolution(0.1);
+    planner->setMinStateDifference(0.01);
+    planner->setNearestNeighbors(dmetric);
+    planner->setup();
+    return planner;
+  };
+
+  const auto benchmark = [&](const std::string& _label, bool _reusePlanner) {
+    auto planner = createPlanner();
+
+    std::size_t numSolved = 0;
+    const std::size_t numAllocations = gNumAllocations;
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < numPlans; ++i)
+    {
+      if (_reusePlanner)
+        planner->clear();
+      else
+        planner = createPlanner();
+
+      pdef->clearSolutionPaths();
+      if (planner->solve(MAX_PLAN_TIME)
+          == ::ompl::base::PlannerStatus::EXACT_SOLUTION)
+        ++numSolved;
+    }
+
+    std::cout << _label << numSolved << "/" << numPlans << " solved, "
+              << static_cast<double>(gNumAllocations - numAllocations)
+                     / numPlans
+              << " allocations/plan, "
+              << 1e3 * getSecondsSince(start) / numPlans << " ms/plan\n";
+  };
+
+  benchmark("new planner per plan: ", false);
+  benchmark("reused planner:       ", true);
+
+  return 0;
+}
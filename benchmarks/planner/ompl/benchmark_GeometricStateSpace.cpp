@@ -0,0 +1,188 @@
+/// Counts the heap allocations made by GeometricStateSpace when allocating
+/// and freeing states, compared with allocating the OMPL and aikido states
+/// separately, and during planning with RRTConnect.
+///
+/// Usage: benchmark_GeometricStateSpace [numPlans]
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <ompl/geometric/planners/rrt/RRTConnect.h>
+#include <aikido/common/RNG.hpp>
+#include <aikido/constraint/uniform/RnBoxConstraint.hpp>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/planner/ompl/GeometricStateSpace.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+#include <aikido/statespace/GeodesicInterpolator.hpp>
+#include <aikido/statespace/Rn.hpp>
+
+using aikido::common::RNGWrapper;
+using aikido::constraint::uniform::R3BoxConstraint;
+using aikido::planner::ompl::GeometricStateSpace;
+using aikido::statespace::R3;
+using aikido::statespace::StateSpace;
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::atomic<std::size_t> gNumAllocations(0);
+
+constexpr std::size_t NUM_STATES = 1000;
+constexpr std::size_t NUM_ROUNDS = 1000;
+
+/// Rejects states inside a wall at x = 0 with a narrow gap at y = 0.
+class WallConstraint : public aikido::constraint::Testable
+{
+public:
+  explicit WallConstraint(std::shared_ptr<R3> _space)
+    : mSpace(std::move(_space))
+  {
+  }
+
+  bool isSatisfied(const StateSpace::State* _state) const override
+  {
+    const auto value
+        = mSpace->getValue(static_cast<const R3::State*>(_state));
+    return std::abs(value[0]) > 0.1 || std::abs(value[1]) < 0.05;
+  }
+
+  aikido::statespace::StateSpacePtr getStateSpace() const override
+  {
+    return mSpace;
+  }
+
+private:
+  std::shared_ptr<R3> mSpace;
+};
+
+//==============================================================================
+/// Returns the seconds elapsed since _start.
+double getSecondsSince(Clock::time_point _start)
+{
+  return std::chrono::duration<double>(Clock::now() - _start).count();
+}
+
+//==============================================================================
+std::shared_ptr<R3BoxConstraint> createBounds(
+    std::shared_ptr<R3> _space, unsigned int _seed)
+{
+  return std::make_shared<R3BoxConstraint>(
+      _space,
+      std::unique_ptr<aikido::common::RNG>(
+          new RNGWrapper<std::mt19937>(_seed)),
+      Eigen::Vector3d(-1., -1., -1.),
+      Eigen::Vector3d(1., 1., 1.));
+}
+
+} // namespace
+
+//==============================================================================
+void* operator new(std::size_t _size)
+{
+  ++gNumAllocations;
+  if (void* memory = std::malloc(_size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+//==============================================================================
+void operator delete(void* _memory) noexcept
+{
+  std::free(_memory);
+}
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+  const std::size_t numPlans = argc > 1 ? std::atol(argv[1]) : 20;
+
+  auto space = std::make_shared<R3>();
+  auto bounds = createBounds(space, 0);
+  auto gSpace = std::make_shared<GeometricStateSpace>(
+      space,
+      std::make_shared<aikido::statespace::GeodesicInterpolator>(space),
+      std::make_shared<aikido::distance::R3Euclidean>(space),
+      bounds,
+      bounds,
+      bounds);
+
+  std::vector<::ompl::base::State*> states(NUM_STATES);
+
+  // Allocate the OMPL and aikido states separately, as GeometricStateSpace
+  // used to.
+  std::size_t numAllocations = gNumAllocations;
+  auto start = Clock::now();
+  for (std::size_t round = 0; round < NUM_ROUNDS; ++round)
+  {
+    for (auto& state : states)
+      state = new GeometricStateSpace::StateType(space->allocateState());
+    for (auto state : states)
+    {
+      auto st = static_cast<GeometricStateSpace::StateType*>(state);
+      space->freeState(st->mState);
+      delete st;
+    }
+  }
+  std::cout << "separate allocations: "
+            << static_cast<double>(gNumAllocations - numAllocations)
+                   / (NUM_ROUNDS * NUM_STATES)
+            << " allocations/state, "
+            << 1e9 * getSecondsSince(start) / (NUM_ROUNDS * NUM_STATES)
+            << " ns/state\n";
+
+  numAllocations = gNumAllocations;
+  start = Clock::now();
+  for (std::size_t round = 0; round < NUM_ROUNDS; ++round)
+  {
+    for (auto& state : states)
+      state = gSpace->allocState();
+    for (auto state : states)
+      gSpace->freeState(state);
+  }
+  std::cout << "pooled allocations:   "
+            << static_cast<double>(gNumAllocations - numAllocations)
+                   / (NUM_ROUNDS * NUM_STATES)
+            << " allocations/state, "
+            << 1e9 * getSecondsSince(start) / (NUM_ROUNDS * NUM_STATES)
+            << " ns/state\n";
+
+  // Plan through the gap in the wall.
+  auto startState = space->createState();
+  startState.setValue(Eigen::Vector3d(-0.8, 0.5, 0.));
+  auto goalState = space->createState();
+  goalState.setValue(Eigen::Vector3d(0.8, -0.5, 0.));
+
+  std::size_t numSolved = 0;
+  numAllocations = gNumAllocations;
+  start = Clock::now();
+  for (std::size_t i = 0; i < numPlans; ++i)
+  {
+    auto planBounds = createBounds(space, i);
+    auto trajectory
+        = aikido::planner::ompl::planOMPL<::ompl::geometric::RRTConnect>(
+            startState,
+            goalState,
+            space,
+            std::make_shared<aikido::statespace::GeodesicInterpolator>(space),
+            std::make_shared<aikido::distance::R3Euclidean>(space),
+            planBounds,
+            std::make_shared<WallConstraint>(space),
+            planBounds,
+            planBounds,
+            10.,
+            0.01);
+    if (trajectory)
+      ++numSolved;
+  }
+  std::cout << "RRTConnect:           " << numSolved << "/" << numPlans
+            << " solved, "
+            << static_cast<double>(gNumAllocations - numAllocations) / numPlans
+            << " allocations/plan, " << 1e3 * getSecondsSince(start) / numPlans
+            << " ms/plan\n";
+
+  return 0;
+}
@@ -1,7 +1,9 @@
+#include "constraint/AllowedCollisionMatrix.hpp"
 #include "constraint/CartesianProductProjectable.hpp"
 #include "constraint/CartesianProductSampleable.hpp"
 #include "constraint/CartesianProductTestable.hpp"
 #include "constraint/CollisionFree.hpp"
+#include "constraint/ContinuousCollisionFree.hpp"
 #include "constraint/CyclicSampleable.hpp"
 #include "constraint/Differentiable.hpp"
 #include "constraint/DifferentiableIntersection.hpp"
@@ -12,11 +14,15 @@
 #include "constraint/FrameTestable.hpp"
 #include "constraint/InverseKinematicsSampleable.hpp"
 #include "constraint/JointStateSpaceHelpers.hpp"
+#include "constraint/MetaSkeletonBoxConstraint.hpp"
+#include "constraint/MotionTestable.hpp"
 #include "constraint/NewtonsMethodProjectable.hpp"
 #include "constraint/Projectable.hpp"
 #include "constraint/RejectionSampleable.hpp"
 #include "constraint/Sampleable.hpp"
 #include "constraint/Satisfied.hpp"
+#include "constraint/SdfCollisionFree.hpp"
+#include "constraint/SignedDistanceField.hpp"
 #include "constraint/TSR.hpp"
 #include "constraint/Testable.hpp"
 #include "constraint/TestableIntersection.hpp"
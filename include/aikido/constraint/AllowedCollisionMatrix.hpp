@@ -0,0 +1,123 @@
+#ifndef AIKIDO_CONSTRAINT_ALLOWEDCOLLISIONMATRIX_HPP_
+#define AIKIDO_CONSTRAINT_ALLOWEDCOLLISIONMATRIX_HPP_
+
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <dart/collision/CollisionDetector.hpp>
+#include "../statespace/dart/MetaSkeletonStateSpace.hpp"
+#include "Sampleable.hpp"
+
+namespace aikido {
+namespace constraint {
+
+/// Classification of a pair of body nodes for self-collision checking.
+/// NEVER - the bodies were never observed in collision.
+/// ALWAYS - the bodies were observed in collision in every configuration.
+/// SOMETIMES - the bodies collide in some configurations only.
+/// ADJACENT - the bodies are connected by a joint.
+enum class CollisionPairType
+{
+  NEVER,
+  ALWAYS,
+  SOMETIMES,
+  ADJACENT
+};
+
+/// Classification of pairs of body nodes, identified by name, that tells
+/// CollisionFree which pairs are worth checking for self-collision.
+///
+/// Only SOMETIMES pairs need to be checked. Pairs that were never classified
+/// are treated as SOMETIMES, so a matrix never hides a collision between
+/// bodies it does not know about.
+class AllowedCollisionMatrix
+{
+public:
+  /// Sets the classification of a pair of body nodes. The order of the names
+  /// does not matter.
+  /// \param _bodyNode1 Name of the first body node.
+  /// \param _bodyNode2 Name of the second body node.
+  /// \param _type Classification of the pair.
+  /// \throw std::invalid_argument if the names are equal.
+  void setPairType(
+      const std::string& _bodyNode1,
+      const std::string& _bodyNode2,
+      CollisionPairType _type);
+
+  /// Returns the classification of a pair of body nodes, or SOMETIMES if the
+  /// pair was never classified.
+  /// \param _bodyNode1 Name of the first body node.
+  /// \param _bodyNode2 Name of the second body node.
+  CollisionPairType getPairType(
+      const std::string& _bodyNode1, const std::string& _bodyNode2) const;
+
+  /// Returns true if the pair has to be checked for collision, i.e. it is
+  /// classified as SOMETIMES.
+  /// \param _bodyNode1 Name of the first body node.
+  /// \param _bodyNode2 Name of the second body node.
+  bool needsCheck(
+      const std::string& _bodyNode1, const std::string& _bodyNode2) const;
+
+  /// Returns the number of classified pairs.
+  std::size_t getNumPairs() const;
+
+  /// Returns all pairs with the given classification, each ordered by name.
+  /// \param _type Classification of the returned pairs.
+  std::vector<std::pair<std::string, std::string>> getPairs(
+      CollisionPairType _type) const;
+
+  /// Writes this matrix to a binary stream. The format uses the native byte
+  /// order and is meant to be read back by loadBinary() on the same platform.
+  /// \param _stream Output stream, opened in binary mode.
+  /// \throw std::runtime_error if writing fails.
+  void saveBinary(std::ostream& _stream) const;
+
+  /// Reads a matrix written by saveBinary().
+  /// \param _stream Input stream, opened in binary mode.
+  /// \throw std::runtime_error if the stream does not contain a valid matrix.
+  static AllowedCollisionMatrix loadBinary(std::istream& _stream);
+
+private:
+  using Key = std::pair<std::string, std::string>;
+
+  /// Returns the key of a pair, ordered by name.
+  static Key makeKey(
+      const std::string& _bodyNode1, const std::string& _bodyNode2);
+
+  std::map<Key, CollisionPairType> mPairs;
+};
+
+using AllowedCollisionMatrixPtr = std::shared_ptr<AllowedCollisionMatrix>;
+
+/// Computes an AllowedCollisionMatrix for the body nodes of a MetaSkeleton by
+/// checking collisions between all of its body nodes in randomly sampled
+/// configurations. This is meant to be run offline; the result can be saved
+/// and passed to CollisionFree::setAllowedCollisionMatrix().
+///
+/// Pairs are classified as ADJACENT if one body node is the parent of the
+/// other, otherwise as NEVER, ALWAYS or SOMETIMES depending on how many of
+/// the samples they collided in. The positions of the MetaSkeleton are
+/// restored before returning.
+///
+/// \param _stateSpace State space of the MetaSkeleton. Its body nodes must
+///        have unique names.
+/// \param _collisionDetector Collision detector used to test for collision.
+/// \param _sampleable Sampleable used to generate configurations, e.g. the
+///        one returned by createSampleableBounds().
+/// \param _numSamples Number of configurations to check.
+/// \throw std::invalid_argument if an argument is nullptr, \c _numSamples is
+///        zero or two body nodes share a name.
+/// \throw std::runtime_error if \c _sampleable runs out of samples.
+AllowedCollisionMatrix computeAllowedCollisionMatrix(
+    statespace::dart::MetaSkeletonStateSpacePtr _stateSpace,
+    std::shared_ptr<dart::collision::CollisionDetector> _collisionDetector,
+    const Sampleable& _sampleable,
+    std::size_t _numSamples);
+
+} // namespace constraint
+} // namespace aikido
+
+#endif // AIKIDO_CONSTRAINT_ALLOWEDCOLLISIONMATRIX_HPP_
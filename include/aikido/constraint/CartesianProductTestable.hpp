@@ -28,6 +28,9 @@ public:
   bool isSatisfied(
       const aikido::statespace::StateSpace::State* _state) const override;
 
+  /// Returns the Testables, one per subspace.
+  const std::vector<TestablePtr>& getConstraints() const;
+
 private:
   std::shared_ptr<statespace::CartesianProduct> mStateSpace;
   std::vector<TestablePtr> mConstraints;
@@ -9,6 +9,7 @@
 #include <dart/collision/CollisionGroup.hpp>
 #include <dart/collision/CollisionOption.hpp>
 #include "../statespace/dart/MetaSkeletonStateSpace.hpp"
+#include "AllowedCollisionMatrix.hpp"
 #include "Testable.hpp"
 
 namespace aikido {
@@ -65,12 +66,27 @@ public:
   /// \param group Collision group.
   void removeSelfCheck(std::shared_ptr<dart::collision::CollisionGroup> _group);
 
+  /// Skips collision checks between body nodes of the metaskeleton that
+  /// \c _matrix does not classify as SOMETIMES, e.g. adjacent links or links
+  /// that can never touch. Pairs involving other body nodes are still checked
+  /// and the collision filter passed to the constructor is still applied.
+  /// \param _matrix Allowed collision matrix computed for the metaskeleton,
+  ///        or nullptr to check all pairs again.
+  void setAllowedCollisionMatrix(
+      std::shared_ptr<const AllowedCollisionMatrix> _matrix);
+
+  /// Returns the allowed collision matrix, or nullptr if none is set.
+  std::shared_ptr<const AllowedCollisionMatrix> getAllowedCollisionMatrix()
+      const;
+
 private:
   using CollisionGroup = dart::collision::CollisionGroup;
 
   std::shared_ptr<aikido::statespace::dart::MetaSkeletonStateSpace> mStatespace;
   std::shared_ptr<dart::collision::CollisionDetector> mCollisionDetector;
   dart::collision::CollisionOption mCollisionOptions;
+  std::shared_ptr<dart::collision::CollisionFilter> mBaseCollisionFilter;
+  std::shared_ptr<const AllowedCollisionMatrix> mAllowedCollisionMatrix;
   std::vector<std::pair<std::shared_ptr<CollisionGroup>,
                         std::shared_ptr<CollisionGroup>>>
       mGroupsToPairwiseCheck;
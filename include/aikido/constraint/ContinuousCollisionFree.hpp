@@ -0,0 +1,104 @@
+#ifndef AIKIDO_CONSTRAINT_CONTINUOUSCOLLISIONFREE_HPP_
+#define AIKIDO_CONSTRAINT_CONTINUOUSCOLLISIONFREE_HPP_
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include <dart/collision/CollisionDetector.hpp>
+#include <dart/collision/CollisionGroup.hpp>
+#include "../statespace/GeodesicInterpolator.hpp"
+#include "../statespace/dart/MetaSkeletonStateSpace.hpp"
+#include "MotionTestable.hpp"
+
+namespace aikido {
+namespace constraint {
+
+/// A motion testable that checks whether the geodesic between two
+/// metaskeleton states is free of collision with a set of collision groups,
+/// using conservative advancement.
+///
+/// For every body node moved by the metaskeleton, a bound on how far any
+/// point of its collision geometry can travel per unit of joint motion is
+/// precomputed from the kinematic tree. Starting at the beginning of the
+/// segment, the distance from every moving body node to the collision groups
+/// is queried and the segment is advanced by the largest step that cannot
+/// close any of these distances. The segment is rejected as soon as a
+/// distance falls below the tolerance, so unlike sampling at a fixed
+/// resolution no obstacle can be skipped.
+///
+/// Only revolute, prismatic, translational and weld joints are supported in
+/// the metaskeleton. Translational joints below it that are not part of the
+/// metaskeleton must have finite position limits. The collision detector
+/// must support distance queries, e.g. FCL. Self-collision is not checked.
+class ContinuousCollisionFree : public MotionTestable
+{
+public:
+  /// Constructs an empty constraint. You should call \c addPairwiseCheck to
+  /// register collision groups before calling \c isSatisfied.
+  ///
+  /// \param _statespace State space on which the constraint operates.
+  /// \param _collisionDetector Collision detector used for distance queries.
+  /// \param _distanceTolerance Distance below which a body node is considered
+  ///        in collision. Must be positive; it also bounds the number of
+  ///        steps taken near obstacles.
+  /// \param _maxNumSteps Maximum number of steps per segment. A segment that
+  ///        is not certified within this many steps is rejected.
+  /// \throw std::invalid_argument if an argument is invalid or the
+  ///        metaskeleton contains an unsupported joint.
+  ContinuousCollisionFree(
+      statespace::dart::MetaSkeletonStateSpacePtr _statespace,
+      std::shared_ptr<dart::collision::CollisionDetector> _collisionDetector,
+      double _distanceTolerance = 1e-3,
+      std::size_t _maxNumSteps = 10000);
+
+  // Documentation inherited.
+  statespace::StateSpacePtr getStateSpace() const override;
+
+  using MotionTestable::isSatisfied;
+
+  // Documentation inherited.
+  bool isSatisfied(
+      const statespace::StateSpace::State* _from,
+      const statespace::StateSpace::State* _to,
+      double& _lastValid) const override;
+
+  /// Checks collision between the metaskeleton and \c _group.
+  /// \param _group Collision group, e.g. containing the environment.
+  void addPairwiseCheck(
+      std::shared_ptr<dart::collision::CollisionGroup> _group);
+
+  /// Removes collision check between the metaskeleton and \c _group.
+  /// \param _group Collision group.
+  void removePairwiseCheck(
+      std::shared_ptr<dart::collision::CollisionGroup> _group);
+
+  /// Returns the number of body nodes whose motion is bounded and checked.
+  std::size_t getNumMovingBodyNodes() const;
+
+private:
+  /// A body node moved by the metaskeleton.
+  struct MovingBodyNode
+  {
+    /// Collision group containing the collision shapes of the body node.
+    std::shared_ptr<dart::collision::CollisionGroup> mGroup;
+
+    /// Pairs of tangent vector index and the maximum distance any point of
+    /// the body node travels per unit of motion of that coordinate.
+    std::vector<std::pair<std::size_t, double>> mMotionBounds;
+  };
+
+  statespace::dart::MetaSkeletonStateSpacePtr mStatespace;
+  std::shared_ptr<dart::collision::CollisionDetector> mCollisionDetector;
+  statespace::GeodesicInterpolator mInterpolator;
+  double mDistanceTolerance;
+  std::size_t mMaxNumSteps;
+  std::vector<MovingBodyNode> mMovingBodyNodes;
+  std::vector<std::shared_ptr<dart::collision::CollisionGroup>> mGroups;
+};
+
+using ContinuousCollisionFreePtr = std::shared_ptr<ContinuousCollisionFree>;
+
+} // namespace constraint
+} // namespace aikido
+
+#endif // AIKIDO_CONSTRAINT_CONTINUOUSCOLLISIONFREE_HPP_
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 #include "../statespace/StateSpace.hpp"
 
 namespace aikido {
@@ -57,6 +58,17 @@ public:
   virtual void getJacobian(
       const statespace::StateSpace::State* _s, Eigen::MatrixXd& _out) const = 0;
 
+  /// Get the jacobian of constraints evaluated at _s as a sparse matrix.
+  /// The dimension of _out is the same as in getJacobian. The default
+  /// implementation converts the dense jacobian returned by getJacobian;
+  /// constraints whose jacobian is mostly zero should override this to avoid
+  /// building the dense matrix.
+  /// \param _s State to be evaluated at.
+  /// \param[out] _out Sparse jacobian matrix.
+  virtual void getJacobianSparse(
+      const statespace::StateSpace::State* _s,
+      Eigen::SparseMatrix<double>& _out) const;
+
   /// Get both Value and Jacobian.
   /// \param _s State to be evaluated.
   /// \param[out] _val Value of constraints.
@@ -30,6 +30,13 @@ public:
       const statespace::StateSpace::State* _s,
       Eigen::MatrixXd& _out) const override;
 
+  /// Stacks the sparse jacobians of the constraints without forming the dense
+  /// matrix. Each constraint must return a jacobian with one column per
+  /// dimension of the shared state space.
+  void getJacobianSparse(
+      const statespace::StateSpace::State* _s,
+      Eigen::SparseMatrix<double>& _out) const override;
+
   // Documentation inherited.
   std::vector<ConstraintType> getConstraintTypes() const override;
 
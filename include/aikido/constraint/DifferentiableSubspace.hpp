@@ -41,6 +41,15 @@ public:
       const statespace::StateSpace::State* _s,
       Eigen::MatrixXd& _out) const override;
 
+  /// Get the jacobian of the constraint as a sparse matrix. Like
+  /// getJacobian, it is expressed in the tangent space of the subspace, and
+  /// uses the sparse jacobian of the constraint on the subspace.
+  /// \param _s State to be evaluated at.
+  /// \param[out] _out Sparse jacobian matrix.
+  void getJacobianSparse(
+      const statespace::StateSpace::State* _s,
+      Eigen::SparseMatrix<double>& _out) const override;
+
   // Documentation inherited.
   void getValueAndJacobian(
       const statespace::StateSpace::State* _s,
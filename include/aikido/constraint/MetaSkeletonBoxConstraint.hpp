@@ -0,0 +1,113 @@
+#ifndef AIKIDO_CONSTRAINT_METASKELETONBOXCONSTRAINT_HPP_
+#define AIKIDO_CONSTRAINT_METASKELETONBOXCONSTRAINT_HPP_
+
+#include <Eigen/Core>
+#include "../statespace/SO2.hpp"
+#include "../statespace/dart/MetaSkeletonStateSpace.hpp"
+#include "Projectable.hpp"
+#include "Sampleable.hpp"
+#include "Testable.hpp"
+
+namespace aikido {
+namespace constraint {
+
+/// Joint limits of a whole MetaSkeleton as a single constraint.
+///
+/// This is equivalent to the CartesianProductTestable, Projectable and
+/// Sampleable built from one box constraint per joint, but it reads the
+/// positions of all limited degrees of freedom directly from the compound
+/// state instead of dispatching to each subspace. Limited degrees of freedom
+/// that are adjacent in the state are checked and clamped as one Eigen
+/// segment. Unlimited SO2 joints and joints without degrees of freedom are
+/// skipped when testing and projecting.
+///
+/// Only MetaSkeletonStateSpaces made of RnJoint, SO2Joint and WeldJoint
+/// subspaces are supported; see isCompatible().
+class MetaSkeletonBoxConstraint : public Projectable,
+                                  public Sampleable,
+                                  public Testable
+{
+public:
+  using Projectable::project;
+
+  /// Constructor.
+  /// \param _metaSkeleton State space in which this constraint operates.
+  /// \param _rng Random number generator to be used for sampling. May be
+  ///        nullptr if this constraint is not used as a Sampleable.
+  /// \throw std::invalid_argument if \c _metaSkeleton is not compatible.
+  MetaSkeletonBoxConstraint(
+      statespace::dart::MetaSkeletonStateSpacePtr _metaSkeleton,
+      std::unique_ptr<common::RNG> _rng = nullptr);
+
+  /// Returns true if every subspace of \c _metaSkeleton is an RnJoint, an
+  /// unlimited SO2Joint or a WeldJoint.
+  /// \param _metaSkeleton State space to check.
+  static bool isCompatible(
+      const statespace::dart::MetaSkeletonStateSpace& _metaSkeleton);
+
+  // Documentation inherited.
+  statespace::StateSpacePtr getStateSpace() const override;
+
+  // Documentation inherited.
+  bool isSatisfied(const statespace::StateSpace::State* _state) const override;
+
+  // Documentation inherited.
+  bool project(
+      const statespace::StateSpace::State* _s,
+      statespace::StateSpace::State* _out) const override;
+
+  /// Creates a SampleGenerator that samples the real vector coordinates
+  /// uniformly within their limits and the SO2 joints uniformly.
+  /// \throw std::runtime_error if no RNG was given or any real vector
+  ///        coordinate is unbounded.
+  std::unique_ptr<SampleGenerator> createSampleGenerator() const override;
+
+  /// Returns true if every real vector coordinate has finite lower and upper
+  /// limits, i.e. this constraint can be sampled from.
+  bool isBounded() const;
+
+  /// Returns the number of degrees of freedom that have position limits.
+  std::size_t getNumLimitedDofs() const;
+
+  /// Returns the lower limits of the limited degrees of freedom, in the order
+  /// they appear in the state.
+  const Eigen::VectorXd& getLowerLimits() const;
+
+  /// Returns the upper limits of the limited degrees of freedom, in the order
+  /// they appear in the state.
+  const Eigen::VectorXd& getUpperLimits() const;
+
+private:
+  /// Run of limited degrees of freedom stored contiguously in the state.
+  struct Segment
+  {
+    /// Offset of the first value, in bytes, from the start of the state.
+    std::size_t mByteOffset;
+
+    /// Index of the first value in mLowerLimits and mUpperLimits.
+    std::size_t mLimitIndex;
+
+    /// Number of values.
+    std::size_t mLength;
+  };
+
+  statespace::dart::MetaSkeletonStateSpacePtr mStateSpace;
+  std::unique_ptr<common::RNG> mRng;
+
+  std::vector<Segment> mSegments;
+  Eigen::VectorXd mLowerLimits;
+  Eigen::VectorXd mUpperLimits;
+
+  /// Whether every real vector coordinate has finite limits.
+  bool mIsBounded;
+
+  /// Subspace indices of SO2 joints.
+  std::vector<std::size_t> mSO2Indices;
+
+  friend class MetaSkeletonBoxConstraintSampleGenerator;
+};
+
+} // namespace constraint
+} // namespace aikido
+
+#endif // AIKIDO_CONSTRAINT_METASKELETONBOXCONSTRAINT_HPP_
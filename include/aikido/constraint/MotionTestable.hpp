@@ -0,0 +1,50 @@
+#ifndef AIKIDO_CONSTRAINT_MOTIONTESTABLE_HPP_
+#define AIKIDO_CONSTRAINT_MOTIONTESTABLE_HPP_
+
+#include <memory>
+#include "../statespace/StateSpace.hpp"
+
+namespace aikido {
+namespace constraint {
+
+/// Constraint which can be tested on a whole motion segment at once, instead
+/// of on individual states sampled along it.
+///
+/// The segment between two states is the geodesic, i.e. the path followed by
+/// statespace::GeodesicInterpolator for parameters in [0, 1].
+class MotionTestable
+{
+public:
+  virtual ~MotionTestable() = default;
+
+  /// Returns StateSpace in which this constraint operates.
+  virtual statespace::StateSpacePtr getStateSpace() const = 0;
+
+  /// Returns true if every state on the geodesic from \c _from to \c _to
+  /// satisfies this constraint.
+  /// By default, this calls the three-parameter isSatisfied.
+  /// \param _from State at the start of the segment.
+  /// \param _to State at the end of the segment.
+  virtual bool isSatisfied(
+      const statespace::StateSpace::State* _from,
+      const statespace::StateSpace::State* _to) const;
+
+  /// Returns true if every state on the geodesic from \c _from to \c _to
+  /// satisfies this constraint.
+  /// \param _from State at the start of the segment.
+  /// \param _to State at the end of the segment.
+  /// \param[out] _lastValid Largest interpolation parameter in [0, 1] such
+  ///        that the segment up to it is known to satisfy this constraint.
+  ///        This is 1 if the function returns true.
+  virtual bool isSatisfied(
+      const statespace::StateSpace::State* _from,
+      const statespace::StateSpace::State* _to,
+      double& _lastValid) const = 0;
+};
+
+using MotionTestablePtr = std::shared_ptr<MotionTestable>;
+
+} // namespace constraint
+} // namespace aikido
+
+#endif // AIKIDO_CONSTRAINT_MOTIONTESTABLE_HPP_
@@ -21,11 +21,17 @@ public:
   ///        dimension.
   /// \param _maxIteration Max iteration for Newton's method.
   /// \param _minStepSize Minimum step size to be taken in Newton's method.
+  /// \param _useSparseJacobian If true, each step is computed from
+  ///        Differentiable::getJacobianSparse with a sparse least-squares
+  ///        solve instead of the pseudoinverse of the dense jacobian. This is
+  ///        faster when the jacobian is mostly zero, e.g. for an intersection
+  ///        of constraints that each apply to a few joints.
   NewtonsMethodProjectable(
       DifferentiablePtr _differentiable,
       std::vector<double> _tolerance,
       int _maxIteration = 1000,
-      double _minStepSize = 1e-5);
+      double _minStepSize = 1e-5,
+      bool _useSparseJacobian = false);
 
   // Documentation inherited.
   bool project(
@@ -40,9 +46,25 @@ private:
   std::vector<double> mTolerance;
   int mMaxIteration;
   double mMinStepSize;
+  bool mUseSparseJacobian;
   statespace::StateSpacePtr mStateSpace;
 
-  bool contains(const statespace::StateSpace::State* _s) const;
+  /// Returns whether constraint values are within the tolerances.
+  /// \param _values Values of the constraints.
+  /// \param _types Types of the constraints.
+  bool contains(
+      const Eigen::VectorXd& _values,
+      const std::vector<ConstraintType>& _types) const;
+
+  /// Computes the minimum-norm step that zeroes the linearization of the
+  /// constraints at _s, using the sparse jacobian.
+  /// \param _s State to be evaluated at.
+  /// \param _value Value of the constraints at _s.
+  /// \param[out] _step Step in the tangent space of the state space.
+  void computeSparseStep(
+      const statespace::StateSpace::State* _s,
+      const Eigen::VectorXd& _value,
+      Eigen::VectorXd& _step) const;
 };
 
 } // namespace constraint
@@ -0,0 +1,89 @@
+#ifndef AIKIDO_CONSTRAINT_SDFCOLLISIONFREE_HPP_
+#define AIKIDO_CONSTRAINT_SDFCOLLISIONFREE_HPP_
+
+#include <memory>
+#include <vector>
+#include <Eigen/Core>
+#include <dart/dynamics/dynamics.hpp>
+#include "../statespace/dart/MetaSkeletonStateSpace.hpp"
+#include "CollisionFree.hpp"
+#include "SignedDistanceField.hpp"
+#include "Testable.hpp"
+
+namespace aikido {
+namespace constraint {
+
+/// A testable that checks a metaskeleton state against a static environment
+/// using a precomputed signed distance field instead of a collision detector.
+///
+/// The collision shapes of the environment skeletons are voxelized once, at
+/// construction, into a SignedDistanceField. Every collision shape of the
+/// metaskeleton's body nodes is covered by a set of spheres, so checking a
+/// state only requires forward kinematics and one distance lookup per sphere.
+///
+/// Both approximations are conservative: a state is reported as satisfied
+/// only if every sphere clears the environment by more than the margin. When
+/// a sphere comes closer than that, the result is decided by the optional
+/// fallback CollisionFree constraint, or is false if there is none. The
+/// environment is assumed not to move after construction.
+class SdfCollisionFree : public Testable
+{
+public:
+  /// Constructor.
+  /// \param _statespace State space on which the constraint operates.
+  /// \param _environment Static skeletons whose collision shapes are
+  ///        voxelized into the signed distance field.
+  /// \param _resolution Edge length of a voxel of the signed distance field.
+  /// \param _sphereSpacing Maximum distance between neighboring sphere
+  ///        centers used to cover a collision shape of the metaskeleton.
+  /// \param _margin Clearance that every sphere must have for a state to be
+  ///        accepted without consulting \c _fallback.
+  /// \param _fallback Exact constraint used for states that are within
+  ///        \c _margin of the environment. May be nullptr, in which case such
+  ///        states are rejected.
+  /// \throw std::invalid_argument if \c _statespace is nullptr, a parameter
+  ///        is out of range or \c _fallback operates on another state space.
+  SdfCollisionFree(
+      statespace::dart::MetaSkeletonStateSpacePtr _statespace,
+      const std::vector<dart::dynamics::ConstSkeletonPtr>& _environment,
+      double _resolution,
+      double _sphereSpacing,
+      double _margin = 0.,
+      std::shared_ptr<CollisionFree> _fallback = nullptr);
+
+  // Documentation inherited.
+  statespace::StateSpacePtr getStateSpace() const override;
+
+  // Documentation inherited.
+  bool isSatisfied(const statespace::StateSpace::State* _state) const override;
+
+  /// Returns the signed distance field of the environment.
+  const SignedDistanceField& getSignedDistanceField() const;
+
+  /// Returns the number of spheres approximating the metaskeleton.
+  std::size_t getNumSpheres() const;
+
+  /// Returns the clearance required to accept a state without the fallback.
+  double getMargin() const;
+
+private:
+  /// Spheres covering the collision shapes of one body node, expressed in the
+  /// frame of the body node.
+  struct BodySpheres
+  {
+    const dart::dynamics::BodyNode* mBodyNode;
+    Eigen::Matrix3Xd mCenters;
+    Eigen::VectorXd mRadii;
+  };
+
+  statespace::dart::MetaSkeletonStateSpacePtr mStateSpace;
+  std::unique_ptr<SignedDistanceField> mSignedDistanceField;
+  std::vector<BodySpheres> mBodySpheres;
+  double mMargin;
+  std::shared_ptr<CollisionFree> mFallback;
+};
+
+} // namespace constraint
+} // namespace aikido
+
+#endif // AIKIDO_CONSTRAINT_SDFCOLLISIONFREE_HPP_
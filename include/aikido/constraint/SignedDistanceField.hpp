@@ -0,0 +1,111 @@
+#ifndef AIKIDO_CONSTRAINT_SIGNEDDISTANCEFIELD_HPP_
+#define AIKIDO_CONSTRAINT_SIGNEDDISTANCEFIELD_HPP_
+
+#include <vector>
+#include <Eigen/Core>
+
+namespace aikido {
+namespace constraint {
+
+/// Axis-aligned voxel grid storing the Euclidean signed distance from every
+/// voxel center to the nearest occupied voxel center.
+///
+/// Distances are positive in free space and negative inside occupied space.
+/// The field is only recomputed when update() is called, so occupancy may be
+/// set voxel by voxel before paying for the distance transform once.
+class SignedDistanceField
+{
+public:
+  /// Constructor. Every voxel is initially free.
+  /// \param _origin Minimum corner of the grid.
+  /// \param _resolution Edge length of a voxel.
+  /// \param _numVoxels Number of voxels along each axis.
+  /// \throw std::invalid_argument if \c _resolution is not positive or any
+  ///        axis has no voxels.
+  SignedDistanceField(
+      const Eigen::Vector3d& _origin,
+      double _resolution,
+      const Eigen::Vector3i& _numVoxels);
+
+  /// Returns the minimum corner of the grid.
+  const Eigen::Vector3d& getOrigin() const;
+
+  /// Returns the edge length of a voxel.
+  double getResolution() const;
+
+  /// Returns the number of voxels along each axis.
+  const Eigen::Vector3i& getNumVoxels() const;
+
+  /// Returns the index of the voxel whose center is nearest to \c _point.
+  /// Points outside of the grid are clamped to the nearest boundary voxel.
+  /// \param _point Point in the frame of the grid.
+  Eigen::Vector3i getVoxelIndex(const Eigen::Vector3d& _point) const;
+
+  /// Returns the center of a voxel.
+  /// \param _index Voxel index.
+  Eigen::Vector3d getVoxelCenter(const Eigen::Vector3i& _index) const;
+
+  /// Returns whether \c _index lies inside the grid.
+  /// \param _index Voxel index.
+  bool isValidIndex(const Eigen::Vector3i& _index) const;
+
+  /// Marks a voxel as occupied or free. Call update() afterwards to
+  /// recompute the distances.
+  /// \param _index Voxel index.
+  /// \param _occupied Whether the voxel is occupied.
+  /// \throw std::out_of_range if \c _index lies outside of the grid.
+  void setOccupied(const Eigen::Vector3i& _index, bool _occupied = true);
+
+  /// Returns whether a voxel is occupied.
+  /// \param _index Voxel index.
+  /// \throw std::out_of_range if \c _index lies outside of the grid.
+  bool isOccupied(const Eigen::Vector3i& _index) const;
+
+  /// Recomputes the signed distance of every voxel from the current
+  /// occupancy using an exact Euclidean distance transform.
+  void update();
+
+  /// Returns the signed distance stored at a voxel. This is infinite if the
+  /// grid has no occupied (or, inside an obstacle, no free) voxel.
+  /// \param _index Voxel index.
+  /// \throw std::out_of_range if \c _index lies outside of the grid.
+  double getSignedDistance(const Eigen::Vector3i& _index) const;
+
+  /// Returns a lower bound on the distance from \c _point to any geometry
+  /// that lies inside of the grid and was voxelized conservatively, i.e. such
+  /// that every voxel intersecting the geometry is occupied.
+  ///
+  /// The bound subtracts the distance from \c _point to the nearest voxel
+  /// center and half a voxel diagonal for the voxelization error from the
+  /// stored distance. Outside of the grid, the distance to the grid is used
+  /// if it is larger. A result that is not positive means \c _point may be
+  /// in collision.
+  /// \param _point Point in the frame of the grid.
+  double getDistanceLowerBound(const Eigen::Vector3d& _point) const;
+
+private:
+  /// Returns the linear index of a voxel.
+  std::size_t getLinearIndex(const Eigen::Vector3i& _index) const;
+
+  /// Throws std::out_of_range if \c _index lies outside of the grid.
+  void checkIndex(const Eigen::Vector3i& _index) const;
+
+  /// Computes the squared Euclidean distance, in voxels, from every voxel to
+  /// the nearest voxel whose occupancy equals \c _target.
+  void computeSquaredDistances(bool _target, std::vector<double>& _out) const;
+
+  Eigen::Vector3d mOrigin;
+  double mResolution;
+  Eigen::Vector3i mNumVoxels;
+
+  /// Half of the diagonal of a voxel.
+  double mHalfDiagonal;
+
+  std::vector<bool> mOccupancy;
+  std::vector<float> mDistances;
+};
+
+} // namespace constraint
+} // namespace aikido
+
+#endif // AIKIDO_CONSTRAINT_SIGNEDDISTANCEFIELD_HPP_
@@ -1,5 +1,9 @@
 #include "distance/CartesianProductWeighted.hpp"
 #include "distance/DistanceMetric.hpp"
+#include "distance/GNATNearestNeighbors.hpp"
+#include "distance/KdTreeNearestNeighbors.hpp"
+#include "distance/NearestNeighbors.hpp"
+#include "distance/RandomizedKdForestNearestNeighbors.hpp"
 #include "distance/RnEuclidean.hpp"
 #include "distance/SE2.hpp"
 #include "distance/SE2Weighted.hpp"
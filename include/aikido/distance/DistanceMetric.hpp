@@ -1,6 +1,7 @@
 #ifndef AIKIDO_DISTANCE_DISTANCEMETRIC_HPP_
 #define AIKIDO_DISTANCE_DISTANCEMETRIC_HPP_
 
+#include <vector>
 #include "../statespace/StateSpace.hpp"
 
 namespace aikido {
@@ -25,10 +26,74 @@ public:
   virtual double distance(
       const statespace::StateSpace::State* _state1,
       const statespace::StateSpace::State* _state2) const = 0;
+
+  /// Computes the square of the distance between two states. This orders
+  /// pairs of states the same way as distance(), so it can be used to compare
+  /// distances, e.g. in nearest neighbor queries, without taking square
+  /// roots. By default, this squares the result of distance().
+  ///
+  /// \param _state1 The first state
+  /// \param _state2 The second state
+  virtual double distanceSquared(
+      const statespace::StateSpace::State* _state1,
+      const statespace::StateSpace::State* _state2) const;
+
+  /// Computes the distances from one state to many states. This returns the
+  /// same values as calling distance() on every state, but lets metrics
+  /// amortize per-call overhead and vectorize over the states. By default,
+  /// this calls distance() in a loop.
+  ///
+  /// \param _query The state to compute distances from
+  /// \param _states Array of \c _numStates states
+  /// \param _numStates Number of states
+  /// \param[out] _distances Array of \c _numStates distances, where
+  ///        _distances[i] is the distance from \c _query to _states[i]
+  virtual void distanceBatch(
+      const statespace::StateSpace::State* _query,
+      const statespace::StateSpace::State* const* _states,
+      std::size_t _numStates,
+      double* _distances) const;
+
+  /// Computes the distances from one state to many states that are stored
+  /// back to back in a single buffer, each occupying
+  /// StateSpace::getStateSizeInBytes() bytes as created by
+  /// StateSpace::allocateStateInBuffer(). By default, this calls distance()
+  /// in a loop.
+  ///
+  /// \param _query The state to compute distances from
+  /// \param _buffer Buffer containing \c _numStates states
+  /// \param _numStates Number of states
+  /// \param[out] _distances Array of \c _numStates distances, where
+  ///        _distances[i] is the distance from \c _query to the i-th state
+  virtual void distanceBatchInBuffer(
+      const statespace::StateSpace::State* _query,
+      const void* _buffer,
+      std::size_t _numStates,
+      double* _distances) const;
 };
 
 using DistanceMetricPtr = std::shared_ptr<DistanceMetric>;
 
+/// Finds the \c _k states that are nearest to \c _query by brute force,
+/// using DistanceMetric::distanceBatch(). Ties are broken by index.
+///
+/// \param _metric The distance metric
+/// \param _query The state to find neighbors of
+/// \param _states Array of \c _numStates states to search
+/// \param _numStates Number of states
+/// \param _k Maximum number of neighbors to return
+/// \param[out] _distances If not nullptr, set to the distances of the returned
+///        neighbors
+/// \return Indices into \c _states of at most \c _k nearest states, ordered
+///         by increasing distance
+std::vector<std::size_t> findKNearest(
+    const DistanceMetric& _metric,
+    const statespace::StateSpace::State* _query,
+    const statespace::StateSpace::State* const* _states,
+    std::size_t _numStates,
+    std::size_t _k,
+    std::vector<double>* _distances = nullptr);
+
 } // namespace distance
 } // namespace aikido
 
@@ -0,0 +1,92 @@
+#ifndef AIKIDO_DISTANCE_GNATNEARESTNEIGHBORS_HPP_
+#define AIKIDO_DISTANCE_GNATNEARESTNEIGHBORS_HPP_
+
+#include "NearestNeighbors.hpp"
+
+namespace aikido {
+namespace distance {
+
+namespace detail {
+class NeighborCollector;
+} // namespace detail
+
+/// A Geometric Near-neighbor Access Tree (GNAT) over states under an
+/// arbitrary DistanceMetric.
+///
+/// Every internal node has up to \c _degree pivots and keeps, for every pair
+/// of pivot and child, the range of distances from the pivot to the states in
+/// the child. Subtrees are pruned with the triangle inequality. Leaves are
+/// split when they hold more than \c _maxLeafSize states, and their distances
+/// are computed with DistanceMetric::distanceBatch().
+class GNATNearestNeighbors : public NearestNeighbors
+{
+public:
+  /// Constructor.
+  /// \param _metric Distance metric
+  /// \param _degree Number of pivots of every internal node, at least 2
+  /// \param _maxLeafSize Maximum number of states in a leaf before it is
+  ///        split, at least \c _degree
+  /// \throw std::invalid_argument if an argument is invalid.
+  explicit GNATNearestNeighbors(
+      DistanceMetricPtr _metric,
+      std::size_t _degree = 8,
+      std::size_t _maxLeafSize = 50);
+
+  ~GNATNearestNeighbors();
+
+  // Documentation inherited.
+  DistanceMetricPtr getDistanceMetric() const override;
+
+  // Documentation inherited.
+  std::size_t add(const statespace::StateSpace::State* _state) override;
+
+  // Documentation inherited.
+  void clear() override;
+
+  // Documentation inherited.
+  std::size_t size() const override;
+
+  // Documentation inherited.
+  const statespace::StateSpace::State* getState(
+      std::size_t _index) const override;
+
+  // Documentation inherited.
+  Neighbor nearest(const statespace::StateSpace::State* _query) const override;
+
+  // Documentation inherited.
+  std::vector<Neighbor> nearestK(
+      const statespace::StateSpace::State* _query,
+      std::size_t _k) const override;
+
+  // Documentation inherited.
+  std::vector<Neighbor> nearestR(
+      const statespace::StateSpace::State* _query,
+      double _radius) const override;
+
+private:
+  struct Node;
+
+  /// Inserts the state with index _index into the subtree of _node.
+  void insert(Node& _node, std::size_t _index);
+
+  /// Turns the leaf _node into an internal node.
+  void split(Node& _node);
+
+  /// Visits all nodes that may contain a state closer than the bound of
+  /// _collector.
+  void search(
+      const Node& _node,
+      const statespace::StateSpace::State* _query,
+      detail::NeighborCollector& _collector) const;
+
+  DistanceMetricPtr mMetric;
+  std::size_t mDegree;
+  std::size_t mMaxLeafSize;
+  std::vector<const statespace::StateSpace::State*> mStates;
+  std::unique_ptr<Node> mRoot;
+};
+
+} // namespace distance
+} // namespace aikido
+
+#endif // AIKIDO_DISTANCE_GNATNEARESTNEIGHBORS_HPP_
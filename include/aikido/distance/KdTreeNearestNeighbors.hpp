@@ -0,0 +1,128 @@
+#ifndef AIKIDO_DISTANCE_KDTREENEARESTNEIGHBORS_HPP_
+#define AIKIDO_DISTANCE_KDTREENEARESTNEIGHBORS_HPP_
+
+#include <array>
+#include <Eigen/Core>
+#include "NearestNeighbors.hpp"
+
+namespace aikido {
+namespace distance {
+
+namespace detail {
+class NeighborCollector;
+} // namespace detail
+
+/// A KD-tree over states whose metric is a weighted sum of Euclidean and SO2
+/// distances, i.e. an REuclidean, an SO2Angular or a flattened
+/// CartesianProductWeighted of those.
+///
+/// Angles are normalized to [-pi, pi) on insertion, and the distance from a
+/// query to a cell accounts for wrap-around on SO2 coordinates, so queries are
+/// exact. The tree is built incrementally: leaves are split at the median of
+/// their widest coordinate when they overflow.
+class KdTreeNearestNeighbors : public NearestNeighbors
+{
+public:
+  /// Constructor.
+  /// \param _metric Distance metric
+  /// \throw std::invalid_argument if \c _metric is not supported.
+  explicit KdTreeNearestNeighbors(DistanceMetricPtr _metric);
+
+  /// Returns whether \c _metric is supported by this index.
+  /// \param _metric Distance metric
+  static bool isSupported(const DistanceMetric& _metric);
+
+  // Documentation inherited.
+  DistanceMetricPtr getDistanceMetric() const override;
+
+  // Documentation inherited.
+  std::size_t add(const statespace::StateSpace::State* _state) override;
+
+  // Documentation inherited.
+  void clear() override;
+
+  // Documentation inherited.
+  std::size_t size() const override;
+
+  // Documentation inherited.
+  const statespace::StateSpace::State* getState(
+      std::size_t _index) const override;
+
+  // Documentation inherited.
+  Neighbor nearest(const statespace::StateSpace::State* _query) const override;
+
+  // Documentation inherited.
+  std::vector<Neighbor> nearestK(
+      const statespace::StateSpace::State* _query,
+      std::size_t _k) const override;
+
+  // Documentation inherited.
+  std::vector<Neighbor> nearestR(
+      const statespace::StateSpace::State* _query,
+      double _radius) const override;
+
+private:
+  /// A component of the metric, i.e. a group of coordinates whose distance is
+  /// their weighted Euclidean norm.
+  struct Component
+  {
+    std::size_t mOffset;
+    std::size_t mDimension;
+    double mWeight;
+    bool mIsAngle;
+  };
+
+  /// A node of the tree. Leaves have no split coordinate.
+  struct Node
+  {
+    int mSplitCoordinate;
+    double mSplitValue;
+    std::array<std::size_t, 2> mChildren;
+    std::vector<std::size_t> mPoints;
+  };
+
+  /// Computes the components of _metric. Returns false if _metric is not
+  /// supported.
+  static bool computeComponents(
+      const DistanceMetric& _metric, std::vector<Component>& _components);
+
+  /// Returns the normalized coordinates of _state.
+  Eigen::VectorXd getCoordinates(
+      const statespace::StateSpace::State* _state) const;
+
+  /// Returns the distance between two normalized coordinate vectors.
+  double computeDistance(const double* _value1, const double* _value2) const;
+
+  /// Returns a lower bound on the distance implied by per-coordinate lower
+  /// bounds.
+  double computeLowerBound(const Eigen::VectorXd& _offsets) const;
+
+  /// Splits the leaf _node if it holds too many points.
+  void splitLeaf(std::size_t _node);
+
+  /// Visits all nodes that may contain a point closer than the bound of
+  /// _collector.
+  void search(
+      std::size_t _node,
+      const Eigen::VectorXd& _query,
+      Eigen::VectorXd& _offsets,
+      double _lowerBound,
+      detail::NeighborCollector& _collector) const;
+
+  DistanceMetricPtr mMetric;
+  std::vector<Component> mComponents;
+  std::size_t mNumCoordinates;
+
+  /// Whether each coordinate is an angle.
+  std::vector<bool> mIsAngle;
+
+  /// Normalized coordinates of all points, one point after another.
+  std::vector<double> mCoordinates;
+  std::vector<const statespace::StateSpace::State*> mStates;
+  std::vector<Node> mNodes;
+};
+
+} // namespace distance
+} // namespace aikido
+
+#endif // AIKIDO_DISTANCE_KDTREENEARESTNEIGHBORS_HPP_
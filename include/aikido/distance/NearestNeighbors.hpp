@@ -0,0 +1,83 @@
+#ifndef AIKIDO_DISTANCE_NEARESTNEIGHBORS_HPP_
+#define AIKIDO_DISTANCE_NEARESTNEIGHBORS_HPP_
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "../statespace/StateSpace.hpp"
+#include "DistanceMetric.hpp"
+
+namespace aikido {
+namespace distance {
+
+/// An index over a set of states that answers nearest neighbor queries under
+/// a DistanceMetric.
+///
+/// States are identified by the order in which they were added, starting at
+/// zero. The index does not take ownership of the states; they must outlive
+/// the index or until clear() is called.
+class NearestNeighbors
+{
+public:
+  /// Index of a state in the nearest neighbors index and its distance to the
+  /// query.
+  using Neighbor = std::pair<std::size_t, double>;
+
+  virtual ~NearestNeighbors() = default;
+
+  /// Returns the distance metric used by this index.
+  virtual DistanceMetricPtr getDistanceMetric() const = 0;
+
+  /// Adds a state to the index.
+  /// \param _state State to add. It must outlive the index.
+  /// \return Index of the state
+  virtual std::size_t add(const statespace::StateSpace::State* _state) = 0;
+
+  /// Removes all states from the index.
+  virtual void clear() = 0;
+
+  /// Returns the number of states in the index.
+  virtual std::size_t size() const = 0;
+
+  /// Returns the state with the given index.
+  /// \param _index Index returned by add()
+  virtual const statespace::StateSpace::State* getState(
+      std::size_t _index) const = 0;
+
+  /// Returns the state nearest to \c _query.
+  /// \param _query Query state
+  /// \throw std::runtime_error if the index is empty.
+  virtual Neighbor nearest(const statespace::StateSpace::State* _query) const
+      = 0;
+
+  /// Returns the \c _k states nearest to \c _query, ordered by increasing
+  /// distance. Fewer states are returned if the index contains fewer than
+  /// \c _k states.
+  /// \param _query Query state
+  /// \param _k Maximum number of neighbors
+  virtual std::vector<Neighbor> nearestK(
+      const statespace::StateSpace::State* _query, std::size_t _k) const = 0;
+
+  /// Returns all states within \c _radius of \c _query, ordered by increasing
+  /// distance.
+  /// \param _query Query state
+  /// \param _radius Maximum distance, inclusive
+  virtual std::vector<Neighbor> nearestR(
+      const statespace::StateSpace::State* _query, double _radius) const = 0;
+};
+
+using NearestNeighborsPtr = std::shared_ptr<NearestNeighbors>;
+
+/// Creates a nearest neighbors index that is appropriate for the metric:
+/// a KdTreeNearestNeighbors if it supports the metric, e.g. for
+/// MetaSkeletonStateSpaces of revolute and prismatic joints, and a
+/// GNATNearestNeighbors otherwise.
+/// \param _metric Distance metric
+/// \throw std::invalid_argument if \c _metric is nullptr.
+std::unique_ptr<NearestNeighbors> createNearestNeighbors(
+    DistanceMetricPtr _metric);
+
+} // namespace distance
+} // namespace aikido
+
+#endif // AIKIDO_DISTANCE_NEARESTNEIGHBORS_HPP_
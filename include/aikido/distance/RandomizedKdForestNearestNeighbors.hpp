@@ -0,0 +1,169 @@
+#ifndef AIKIDO_DISTANCE_RANDOMIZEDKDFORESTNEARESTNEIGHBORS_HPP_
+#define AIKIDO_DISTANCE_RANDOMIZEDKDFORESTNEARESTNEIGHBORS_HPP_
+
+#include <array>
+#include <functional>
+#include <random>
+#include <Eigen/Core>
+#include "NearestNeighbors.hpp"
+
+namespace aikido {
+namespace distance {
+
+namespace detail {
+class NeighborCollector;
+} // namespace detail
+
+/// An approximate nearest neighbors index for very large sets of states under
+/// an arbitrary DistanceMetric, based on a forest of randomized KD-trees.
+///
+/// Every state is indexed by its tangent coordinates StateSpace::logMap().
+/// Coordinates of SO2 subspaces, e.g. of revolute joints, are normalized to
+/// [-pi, pi) and wrap around during the search. Each tree splits on a
+/// coordinate chosen at random among those with the largest variance, so the
+/// trees partition the states differently. A query
+/// descends all trees at once, exploring cells in order of their distance to
+/// the query in tangent coordinates, and stops after computing the distance
+/// to \c _maxChecks states. Candidates are ranked with the DistanceMetric, so
+/// returned distances are exact, but a true neighbor may be missed. Raising
+/// the number of checks trades speed for recall; the search is exact once it
+/// is at least size().
+///
+/// New states are inserted into the leaves of every tree, and the forest is
+/// rebuilt in parallel whenever the number of states has doubled since the
+/// last build, or when build() is called, to keep the trees balanced.
+class RandomizedKdForestNearestNeighbors : public NearestNeighbors
+{
+public:
+  /// Constructor.
+  /// \param _metric Distance metric
+  /// \param _numTrees Number of randomized KD-trees, at least 1
+  /// \param _maxChecks Maximum number of distance computations per query
+  /// \param _numThreads Number of threads used to build the forest and to
+  ///        answer batch queries, or 0 to use one per hardware thread
+  /// \throw std::invalid_argument if an argument is invalid.
+  explicit RandomizedKdForestNearestNeighbors(
+      DistanceMetricPtr _metric,
+      std::size_t _numTrees = 4,
+      std::size_t _maxChecks = 128,
+      std::size_t _numThreads = 0);
+
+  /// Sets the maximum number of distance computations per query.
+  /// \param _maxChecks Maximum number of checks, at least 1
+  /// \throw std::invalid_argument if \c _maxChecks is zero.
+  void setMaxChecks(std::size_t _maxChecks);
+
+  /// Returns the maximum number of distance computations per query.
+  std::size_t getMaxChecks() const;
+
+  /// Rebuilds the forest over all states in the index.
+  void build();
+
+  // Documentation inherited.
+  DistanceMetricPtr getDistanceMetric() const override;
+
+  // Documentation inherited.
+  std::size_t add(const statespace::StateSpace::State* _state) override;
+
+  // Documentation inherited.
+  void clear() override;
+
+  // Documentation inherited.
+  std::size_t size() const override;
+
+  // Documentation inherited.
+  const statespace::StateSpace::State* getState(
+      std::size_t _index) const override;
+
+  // Documentation inherited.
+  Neighbor nearest(const statespace::StateSpace::State* _query) const override;
+
+  // Documentation inherited.
+  std::vector<Neighbor> nearestK(
+      const statespace::StateSpace::State* _query,
+      std::size_t _k) const override;
+
+  // Documentation inherited.
+  std::vector<Neighbor> nearestR(
+      const statespace::StateSpace::State* _query,
+      double _radius) const override;
+
+  /// Answers nearestK() for many queries in parallel.
+  /// \param _queries Array of \c _numQueries query states
+  /// \param _numQueries Number of queries
+  /// \param _k Maximum number of neighbors per query
+  /// \return Neighbors of every query
+  std::vector<std::vector<Neighbor>> nearestKBatch(
+      const statespace::StateSpace::State* const* _queries,
+      std::size_t _numQueries,
+      std::size_t _k) const;
+
+private:
+  /// A node of a tree. Leaves have no split coordinate.
+  struct Node
+  {
+    int mSplitCoordinate;
+    double mSplitValue;
+    std::array<std::size_t, 2> mChildren;
+    std::vector<std::size_t> mPoints;
+  };
+
+  /// A randomized KD-tree.
+  struct Tree
+  {
+    std::vector<Node> mNodes;
+
+    /// Random engine used to choose split coordinates.
+    std::mt19937 mEngine;
+  };
+
+  /// Resets _tree to an empty leaf.
+  /// \param _seed Seed of the random choice of split coordinates
+  static void resetTree(Tree& _tree, unsigned int _seed);
+
+  /// Turns the leaf _node of _tree into a subtree over the states
+  /// _indices[_begin, _end).
+  void buildNode(
+      Tree& _tree,
+      std::size_t _node,
+      std::vector<std::size_t>& _indices,
+      std::size_t _begin,
+      std::size_t _end) const;
+
+  /// Returns the tangent coordinates of _state.
+  Eigen::VectorXd getCoordinates(
+      const statespace::StateSpace::State* _state) const;
+
+  /// Offers approximate neighbors from the forest to _collector.
+  void search(
+      const statespace::StateSpace::State* _query,
+      detail::NeighborCollector& _collector) const;
+
+  /// Runs _function(i) for i in [0, _numTasks) on up to mNumThreads threads.
+  void parallelFor(
+      std::size_t _numTasks,
+      const std::function<void(std::size_t)>& _function) const;
+
+  DistanceMetricPtr mMetric;
+  statespace::StateSpacePtr mStateSpace;
+  std::size_t mNumTrees;
+  std::size_t mMaxChecks;
+  std::size_t mNumThreads;
+  std::size_t mDimension;
+
+  /// Whether each tangent coordinate is an angle.
+  std::vector<bool> mIsAngle;
+
+  /// Tangent coordinates of all states, one state after another.
+  std::vector<double> mCoordinates;
+  std::vector<const statespace::StateSpace::State*> mStates;
+
+  /// Number of states when the forest was last built.
+  std::size_t mNumBuilt;
+  std::vector<Tree> mTrees;
+};
+
+} // namespace distance
+} // namespace aikido
+
+#endif // AIKIDO_DISTANCE_RANDOMIZEDKDFORESTNEARESTNEIGHBORS_HPP_
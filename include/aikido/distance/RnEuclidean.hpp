@@ -26,6 +26,27 @@ public:
       const statespace::StateSpace::State* _state1,
       const statespace::StateSpace::State* _state2) const override;
 
+  /// Computes squared Euclidean distance between two states.
+  /// \param _state1 The first state (type Rn::State)
+  /// \param _state2 The second state (type Rn::State)
+  double distanceSquared(
+      const statespace::StateSpace::State* _state1,
+      const statespace::StateSpace::State* _state2) const override;
+
+  // Documentation inherited
+  void distanceBatch(
+      const statespace::StateSpace::State* _query,
+      const statespace::StateSpace::State* const* _states,
+      std::size_t _numStates,
+      double* _distances) const override;
+
+  // Documentation inherited
+  void distanceBatchInBuffer(
+      const statespace::StateSpace::State* _query,
+      const void* _buffer,
+      std::size_t _numStates,
+      double* _distances) const override;
+
 private:
   std::shared_ptr<statespace::R<N>> mStateSpace;
 };
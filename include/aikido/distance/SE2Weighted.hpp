@@ -37,7 +37,32 @@ public:
       const statespace::StateSpace::State* state1,
       const statespace::StateSpace::State* state2) const override;
 
+  // Documentation inherited
+  void distanceBatch(
+      const statespace::StateSpace::State* query,
+      const statespace::StateSpace::State* const* states,
+      std::size_t numStates,
+      double* distances) const override;
+
+  // Documentation inherited
+  void distanceBatchInBuffer(
+      const statespace::StateSpace::State* query,
+      const void* buffer,
+      std::size_t numStates,
+      double* distances) const override;
+
 private:
+  /// Returns the angle and translation of an SE2 pose.
+  static Eigen::Vector3d getPose(
+      const statespace::SE2::State::Isometry2d& pose);
+
+  /// Computes the distances from query to poses given as angle and
+  /// translation, one per column.
+  void computeDistances(
+      const statespace::StateSpace::State* query,
+      const Eigen::Matrix3Xd& poses,
+      double* distances) const;
+
   std::shared_ptr<statespace::SE2> mStateSpace;
 
   Eigen::Vector2d mWeights;
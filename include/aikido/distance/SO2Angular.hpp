@@ -26,6 +26,20 @@ public:
       const statespace::StateSpace::State* _state1,
       const statespace::StateSpace::State* _state2) const override;
 
+  // Documentation inherited
+  void distanceBatch(
+      const statespace::StateSpace::State* _query,
+      const statespace::StateSpace::State* const* _states,
+      std::size_t _numStates,
+      double* _distances) const override;
+
+  // Documentation inherited
+  void distanceBatchInBuffer(
+      const statespace::StateSpace::State* _query,
+      const void* _buffer,
+      std::size_t _numStates,
+      double* _distances) const override;
+
 private:
   std::shared_ptr<statespace::SO2> mStateSpace;
 };
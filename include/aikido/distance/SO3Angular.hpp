@@ -25,7 +25,28 @@ public:
       const statespace::StateSpace::State* _state1,
       const statespace::StateSpace::State* _state2) const override;
 
+  // Documentation inherited
+  void distanceBatch(
+      const statespace::StateSpace::State* _query,
+      const statespace::StateSpace::State* const* _states,
+      std::size_t _numStates,
+      double* _distances) const override;
+
+  // Documentation inherited
+  void distanceBatchInBuffer(
+      const statespace::StateSpace::State* _query,
+      const void* _buffer,
+      std::size_t _numStates,
+      double* _distances) const override;
+
 private:
+  /// Computes the distances from _query to rotations given as the
+  /// coefficients of quaternions, one per column.
+  void computeDistances(
+      const statespace::StateSpace::State* _query,
+      const Eigen::Matrix4Xd& _quaternions,
+      double* _distances) const;
+
   std::shared_ptr<statespace::SO3> mStateSpace;
 };
 
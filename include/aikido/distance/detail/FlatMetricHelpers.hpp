@@ -0,0 +1,34 @@
+#ifndef AIKIDO_DISTANCE_DETAIL_FLATMETRICHELPERS_HPP_
+#define AIKIDO_DISTANCE_DETAIL_FLATMETRICHELPERS_HPP_
+
+#include "../../statespace/SO2.hpp"
+#include "../DistanceMetric.hpp"
+#include "../RnEuclidean.hpp"
+
+namespace aikido {
+namespace distance {
+namespace detail {
+
+// Flat representations read every component of a state as contiguous
+// doubles, which requires SO2 states to consist of their angle only.
+static_assert(
+    sizeof(statespace::SO2::State) == sizeof(double),
+    "SO2::State must contain exactly one double.");
+
+/// Returns true if _metric is the Euclidean distance over a real vector
+/// space, i.e. one of the REuclidean metrics.
+inline bool isEuclidean(const DistanceMetric& _metric)
+{
+  return dynamic_cast<const R0Euclidean*>(&_metric)
+         || dynamic_cast<const R1Euclidean*>(&_metric)
+         || dynamic_cast<const R2Euclidean*>(&_metric)
+         || dynamic_cast<const R3Euclidean*>(&_metric)
+         || dynamic_cast<const R6Euclidean*>(&_metric)
+         || dynamic_cast<const RnEuclidean*>(&_metric);
+}
+
+} // namespace detail
+} // namespace distance
+} // namespace aikido
+
+#endif // AIKIDO_DISTANCE_DETAIL_FLATMETRICHELPERS_HPP_
@@ -0,0 +1,88 @@
+#ifndef AIKIDO_DISTANCE_DETAIL_NEIGHBORCOLLECTOR_HPP_
+#define AIKIDO_DISTANCE_DETAIL_NEIGHBORCOLLECTOR_HPP_
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "../NearestNeighbors.hpp"
+
+namespace aikido {
+namespace distance {
+namespace detail {
+
+/// Collects the nearest neighbors found during a search, keeping at most a
+/// fixed number of neighbors within a fixed radius. Ties in distance are
+/// broken by index.
+class NeighborCollector
+{
+public:
+  using Neighbor = NearestNeighbors::Neighbor;
+
+  /// Constructor.
+  /// \param _maxNumNeighbors Maximum number of neighbors to keep
+  /// \param _radius Maximum distance of a neighbor, inclusive
+  NeighborCollector(std::size_t _maxNumNeighbors, double _radius)
+    : mMaxNumNeighbors(_maxNumNeighbors), mRadius(_radius)
+  {
+  }
+
+  /// Returns the distance above which candidates are rejected. Subtrees whose
+  /// lower bound exceeds this can be pruned.
+  double getBound() const
+  {
+    if (mNeighbors.size() < mMaxNumNeighbors)
+      return mRadius;
+
+    return mNeighbors.front().second;
+  }
+
+  /// Offers a candidate neighbor.
+  /// \param _index Index of the state
+  /// \param _distance Distance from the query to the state
+  void add(std::size_t _index, double _distance)
+  {
+    if (mMaxNumNeighbors == 0 || !(_distance <= mRadius))
+      return;
+
+    const Neighbor neighbor(_index, _distance);
+    if (mNeighbors.size() < mMaxNumNeighbors)
+    {
+      mNeighbors.push_back(neighbor);
+      std::push_heap(mNeighbors.begin(), mNeighbors.end(), &isCloser);
+    }
+    else if (isCloser(neighbor, mNeighbors.front()))
+    {
+      std::pop_heap(mNeighbors.begin(), mNeighbors.end(), &isCloser);
+      mNeighbors.back() = neighbor;
+      std::push_heap(mNeighbors.begin(), mNeighbors.end(), &isCloser);
+    }
+  }
+
+  /// Returns the collected neighbors ordered by increasing distance.
+  std::vector<Neighbor> getNeighbors() const
+  {
+    std::vector<Neighbor> neighbors(mNeighbors);
+    std::sort(neighbors.begin(), neighbors.end(), &isCloser);
+    return neighbors;
+  }
+
+private:
+  static bool isCloser(const Neighbor& _neighbor1, const Neighbor& _neighbor2)
+  {
+    return _neighbor1.second < _neighbor2.second
+           || (_neighbor1.second == _neighbor2.second
+               && _neighbor1.first < _neighbor2.first);
+  }
+
+  std::size_t mMaxNumNeighbors;
+  double mRadius;
+
+  /// Max-heap of the neighbors found so far, farthest first.
+  std::vector<Neighbor> mNeighbors;
+};
+
+} // namespace detail
+} // namespace distance
+} // namespace aikido
+
+#endif // AIKIDO_DISTANCE_DETAIL_NEIGHBORCOLLECTOR_HPP_
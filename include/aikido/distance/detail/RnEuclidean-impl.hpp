@@ -47,5 +47,59 @@ double REuclidean<N>::distance(
   return (v2 - v1).norm();
 }
 
+//==============================================================================
+template <int N>
+double REuclidean<N>::distanceSquared(
+    const statespace::StateSpace::State* _state1,
+    const statespace::StateSpace::State* _state2) const
+{
+  auto v1 = mStateSpace->getValue(
+      static_cast<const typename statespace::R<N>::State*>(_state1));
+  auto v2 = mStateSpace->getValue(
+      static_cast<const typename statespace::R<N>::State*>(_state2));
+  return (v2 - v1).squaredNorm();
+}
+
+//==============================================================================
+template <int N>
+void REuclidean<N>::distanceBatch(
+    const statespace::StateSpace::State* _query,
+    const statespace::StateSpace::State* const* _states,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  using State = typename statespace::R<N>::State;
+
+  auto query = mStateSpace->getValue(static_cast<const State*>(_query));
+  for (std::size_t i = 0; i < _numStates; ++i)
+  {
+    _distances[i]
+        = (mStateSpace->getValue(static_cast<const State*>(_states[i])) - query)
+              .norm();
+  }
+}
+
+//==============================================================================
+template <int N>
+void REuclidean<N>::distanceBatchInBuffer(
+    const statespace::StateSpace::State* _query,
+    const void* _buffer,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  using State = typename statespace::R<N>::State;
+
+  // States of R<N> are stored as contiguous doubles, so the buffer is a
+  // column-major matrix with one state per column.
+  const Eigen::Map<const Eigen::Matrix<double, N, Eigen::Dynamic>> values(
+      static_cast<const double*>(_buffer),
+      mStateSpace->getDimension(),
+      _numStates);
+  Eigen::Map<Eigen::RowVectorXd> distances(_distances, _numStates);
+
+  auto query = mStateSpace->getValue(static_cast<const State*>(_query));
+  distances = (values.colwise() - query).colwise().norm();
+}
+
 } // namespace distance
 } // namespace aikido
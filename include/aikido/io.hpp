@@ -1,3 +1,4 @@
+#include "io/AllowedCollisionMatrix.hpp"
 #include "io/CatkinResourceRetriever.hpp"
 #include "io/KinBodyParser.hpp"
 #include "io/yaml.hpp"
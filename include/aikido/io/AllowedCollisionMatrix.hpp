@@ -0,0 +1,121 @@
+#ifndef AIKIDO_IO_ALLOWEDCOLLISIONMATRIX_HPP_
+#define AIKIDO_IO_ALLOWEDCOLLISIONMATRIX_HPP_
+
+#include <string>
+#include <yaml-cpp/yaml.h>
+#include "../constraint/AllowedCollisionMatrix.hpp"
+
+namespace YAML {
+
+//==============================================================================
+// Specialization for aikido::constraint::AllowedCollisionMatrix. This enables
+// to use YAML::Node with AllowedCollisionMatrix as `Node(matrix)` and
+// `node.as<AllowedCollisionMatrix>()`. The matrix is stored as a map from
+// pair type to a sequence of body node name pairs:
+//
+//   adjacent: [[link1, link2], [link2, link3]]
+//   always: []
+//   never: [[link1, link3]]
+//   sometimes: []
+template <>
+struct convert<aikido::constraint::AllowedCollisionMatrix>
+{
+  using AllowedCollisionMatrix = aikido::constraint::AllowedCollisionMatrix;
+  using CollisionPairType = aikido::constraint::CollisionPairType;
+
+  static Node encode(const AllowedCollisionMatrix& matrix)
+  {
+    Node node(NodeType::Map);
+
+    for (const auto type : getTypes())
+    {
+      Node pairs(NodeType::Sequence);
+      for (const auto& pair : matrix.getPairs(type))
+      {
+        Node names(NodeType::Sequence);
+        names.push_back(pair.first);
+        names.push_back(pair.second);
+        pairs.push_back(names);
+      }
+
+      node[getName(type)] = pairs;
+    }
+
+    return node;
+  }
+
+  static bool decode(const Node& node, AllowedCollisionMatrix& matrix)
+  {
+    if (!node.IsMap())
+      return false;
+
+    matrix = AllowedCollisionMatrix();
+
+    for (const auto& it : node)
+    {
+      CollisionPairType type;
+      if (!getType(it.first.as<std::string>(), type))
+        return false;
+
+      if (!it.second.IsSequence())
+        return false;
+
+      for (const auto& names : it.second)
+      {
+        if (!names.IsSequence() || names.size() != 2)
+          return false;
+
+        const auto name1 = names[0].as<std::string>();
+        const auto name2 = names[1].as<std::string>();
+        if (name1 == name2)
+          return false;
+
+        matrix.setPairType(name1, name2, type);
+      }
+    }
+
+    return true;
+  }
+
+private:
+  static std::vector<CollisionPairType> getTypes()
+  {
+    return {CollisionPairType::ADJACENT,
+            CollisionPairType::ALWAYS,
+            CollisionPairType::NEVER,
+            CollisionPairType::SOMETIMES};
+  }
+
+  static std::string getName(CollisionPairType type)
+  {
+    switch (type)
+    {
+      case CollisionPairType::NEVER:
+        return "never";
+      case CollisionPairType::ALWAYS:
+        return "always";
+      case CollisionPairType::SOMETIMES:
+        return "sometimes";
+      case CollisionPairType::ADJACENT:
+        return "adjacent";
+    }
+    return "";
+  }
+
+  static bool getType(const std::string& name, CollisionPairType& type)
+  {
+    for (const auto candidate : getTypes())
+    {
+      if (getName(candidate) == name)
+      {
+        type = candidate;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+} // namespace YAML
+
+#endif // AIKIDO_IO_ALLOWEDCOLLISIONMATRIX_HPP_
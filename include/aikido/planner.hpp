@@ -1,15 +1,22 @@
+#include "planner/PersistentRoadmap.hpp"
 #include "planner/PlanningResult.hpp"
 #include "planner/SnapPlanner.hpp"
 #include "planner/World.hpp"
+#include "planner/ompl/AnytimePlanner.hpp"
 #include "planner/ompl/BackwardCompatibility.hpp"
 #include "planner/ompl/CRRT.hpp"
 #include "planner/ompl/CRRTConnect.hpp"
+#include "planner/ompl/ExperienceLibrary.hpp"
 #include "planner/ompl/GeometricStateSpace.hpp"
 #include "planner/ompl/GoalRegion.hpp"
+#include "planner/ompl/InformedPathLengthObjective.hpp"
+#include "planner/ompl/LazySP.hpp"
 #include "planner/ompl/MotionValidator.hpp"
 #include "planner/ompl/Planner.hpp"
+#include "planner/ompl/PlanningContext.hpp"
 #include "planner/ompl/StateSampler.hpp"
 #include "planner/ompl/StateValidityChecker.hpp"
+#include "planner/ompl/TangentSpaceInformedSampler.hpp"
 #include "planner/ompl/dart.hpp"
 #include "planner/parabolic/ParabolicSmoother.hpp"
 #include "planner/parabolic/ParabolicTimer.hpp"
@@ -0,0 +1,307 @@
+#ifndef AIKIDO_PLANNER_PERSISTENTROADMAP_HPP_
+#define AIKIDO_PLANNER_PERSISTENTROADMAP_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../constraint/Sampleable.hpp"
+#include "../constraint/Testable.hpp"
+#include "../distance/DistanceMetric.hpp"
+#include "../distance/NearestNeighbors.hpp"
+#include "../statespace/Interpolator.hpp"
+#include "../statespace/dart/MetaSkeletonStateSpace.hpp"
+#include "../trajectory/Interpolated.hpp"
+#include "PlanningResult.hpp"
+
+namespace aikido {
+namespace planner {
+
+/// A probabilistic roadmap (PRM) stored in a memory-mapped file, so that it
+/// can be reused by many queries and across process restarts.
+///
+/// The file holds the DART positions of all vertices contiguously, the edges
+/// and the validity of every edge. Vertices and edges are added without
+/// being checked. A query connects the start and the goal to their nearest
+/// vertices, then repeatedly finds the shortest path through the roadmap that
+/// avoids edges known to be invalid and checks the unevaluated edges of that
+/// path, until a path is valid or there is none.
+///
+/// Validity is tracked per collision group. Group zero is the validity
+/// constraint passed to the constructor; more groups, e.g. one constraint per
+/// movable object of the environment, are registered with
+/// addCollisionGroup(). Each edge records the groups it was found valid
+/// against and the group it was found invalid against. When part of the
+/// environment changes, invalidateCollisionGroup() forgets only what was
+/// learned about the corresponding group: edges that are invalid against
+/// another group stay invalid, and valid edges are only checked against that
+/// group again.
+///
+/// Cached validity survives process restarts. The names of the groups are
+/// stored in the file, so a group registered with the same name after a
+/// restart reuses its cached validity; a group must therefore be given a new
+/// name whenever its constraint changes while no process has the roadmap
+/// open. Group zero is named by the constructor, and its validity is
+/// forgotten when the roadmap is opened with another name. The file also
+/// stores a fingerprint of the DOFs of the skeleton, so that a roadmap is
+/// never reused for another skeleton.
+///
+/// A roadmap holds an exclusive lock on its file while it is open, so a file
+/// is used by at most one PersistentRoadmap at a time, in this or any other
+/// process.
+class PersistentRoadmap
+{
+public:
+  /// Maximum number of collision groups, including group zero.
+  static constexpr std::size_t MAX_COLLISION_GROUPS = 64;
+
+  /// Maximum length of the name of a collision group.
+  static constexpr std::size_t MAX_COLLISION_GROUP_NAME_LENGTH = 63;
+
+  /// Constructor. Opens the roadmap in \c _filename, or creates an empty one
+  /// if the file does not exist or is empty.
+  /// \param _stateSpace The StateSpace of the roadmap
+  /// \param _interpolator An Interpolator defined on the StateSpace, used to
+  /// interpolate along edges
+  /// \param _dmetric A distance metric defined on the StateSpace
+  /// \param _sampler A Sampleable that samples the vertices of the roadmap
+  /// \param _validityConstraint Constraint of collision group zero, e.g. joint
+  /// limits and self collision
+  /// \param _validityConstraintName Name of collision group zero. It should
+  /// change whenever \c _validityConstraint does, e.g. with the joint limits
+  /// or the collision geometry of the robot.
+  /// \param _maxDistanceBtwValidityChecks The maximum distance (under
+  /// \c _dmetric) between two successive validity checks along an edge
+  /// \param _filename Path of the roadmap file
+  /// \param _numNeighbors Number of nearest vertices each new vertex, start
+  /// and goal is connected to
+  /// \throw std::invalid_argument if an argument is invalid.
+  /// \throw std::runtime_error if the file cannot be mapped, is open in
+  /// another PersistentRoadmap, or holds a roadmap of another skeleton.
+  PersistentRoadmap(
+      statespace::dart::MetaSkeletonStateSpacePtr _stateSpace,
+      statespace::InterpolatorPtr _interpolator,
+      distance::DistanceMetricPtr _dmetric,
+      constraint::SampleablePtr _sampler,
+      constraint::TestablePtr _validityConstraint,
+      const std::string& _validityConstraintName,
+      double _maxDistanceBtwValidityChecks,
+      const std::string& _filename,
+      std::size_t _numNeighbors = 10);
+
+  /// Destructor. Flushes the roadmap to its file.
+  ~PersistentRoadmap();
+
+  PersistentRoadmap(const PersistentRoadmap&) = delete;
+  PersistentRoadmap& operator=(const PersistentRoadmap&) = delete;
+
+  /// Registers a collision group. Edges are valid only if they satisfy the
+  /// constraints of all registered groups.
+  /// \param _name Name of the group, unique within the file
+  /// \param _constraint Constraint of the group
+  /// \return Index of the group
+  /// \throw std::invalid_argument if an argument is invalid, if the group is
+  /// already registered or if there are too many groups.
+  std::size_t addCollisionGroup(
+      const std::string& _name, constraint::TestablePtr _constraint);
+
+  /// Forgets the validity of all edges against a collision group, e.g.
+  /// because the objects it checks moved.
+  /// \param _name Name of the group, which may be group zero
+  /// \throw std::invalid_argument if no group has this name.
+  void invalidateCollisionGroup(const std::string& _name);
+
+  /// Forgets the validity of all edges against all collision groups.
+  void invalidateAll();
+
+  /// Adds vertices sampled from the Sampleable to the roadmap and connects
+  /// each of them to its nearest vertices. Samples that coincide with a
+  /// vertex are skipped, so the Sampleable should not repeat the samples of
+  /// a previous process.
+  /// \param _numVertices Number of samples to draw
+  /// \return Number of vertices added
+  std::size_t grow(std::size_t _numVertices);
+
+  /// Plans a trajectory from \c _start to \c _goal through the roadmap.
+  /// Returns nullptr if the start or goal is invalid or if no path through
+  /// the roadmap is valid.
+  /// \param _start The start state
+  /// \param _goal The goal state
+  /// \param[out] _planningResult Information about failure, if not nullptr
+  trajectory::InterpolatedPtr plan(
+      const statespace::StateSpace::State* _start,
+      const statespace::StateSpace::State* _goal,
+      PlanningResult* _planningResult = nullptr);
+
+  /// Writes the changes to the roadmap to its file.
+  void flush();
+
+  /// Returns the path of the roadmap file.
+  const std::string& getFilename() const;
+
+  /// Returns the number of vertices in the roadmap.
+  std::size_t getNumVertices() const;
+
+  /// Returns the number of edges in the roadmap.
+  std::size_t getNumEdges() const;
+
+  /// Returns the number of edges known to be valid against all registered
+  /// collision groups.
+  std::size_t getNumValidEdges() const;
+
+  /// Returns the number of edge checks since the roadmap was opened.
+  std::size_t getNumEdgeChecks() const;
+
+private:
+  /// Layout of the beginning of the file.
+  struct FileHeader
+  {
+    char mMagic[8];
+    std::uint32_t mVersion;
+    std::uint32_t mDimension;
+    std::uint64_t mNumVertices;
+    std::uint64_t mVertexCapacity;
+    std::uint64_t mNumEdges;
+    std::uint64_t mEdgeCapacity;
+
+    /// Hash of the names and joint types of the DOFs of the skeleton
+    std::uint64_t mSkeletonFingerprint;
+
+    char mGroupNames[MAX_COLLISION_GROUPS]
+                    [MAX_COLLISION_GROUP_NAME_LENGTH + 1];
+  };
+
+  /// Layout of an edge in the file. Query edges, which connect the start and
+  /// goal to the roadmap, use the same layout but are not stored.
+  struct Edge
+  {
+    std::uint64_t mSource;
+    std::uint64_t mTarget;
+    double mLength;
+
+    /// Groups the edge is known to satisfy
+    std::uint64_t mValidGroups;
+
+    /// Groups the edge is known to violate
+    std::uint64_t mInvalidGroups;
+  };
+
+  /// Maps the file, creating or validating its header. Forgets the validity
+  /// against group zero if the file names it differently.
+  /// \param _validityConstraintName Name of collision group zero
+  void open(const std::string& _validityConstraintName);
+
+  /// Returns the size of a file with room for the given numbers of vertices
+  /// and edges.
+  std::size_t getFileSize(
+      std::size_t _vertexCapacity, std::size_t _edgeCapacity) const;
+
+  /// Maps the first _size bytes of the file, growing it if needed.
+  void map(std::size_t _size);
+
+  /// Maps the file with room for the given numbers of vertices and edges,
+  /// moving the edges to their new offset.
+  void reserve(std::size_t _vertexCapacity, std::size_t _edgeCapacity);
+
+  /// Unmaps the file.
+  void close();
+
+  /// Returns the DART positions of vertex _vertex in the file.
+  double* getPositions(std::size_t _vertex) const;
+
+  /// Returns the edges stored in the file.
+  Edge* getEdges() const;
+
+  /// Returns the edge with index _edge, which is a query edge if _edge is
+  /// at least the number of edges in the file.
+  Edge& getEdge(std::size_t _edge);
+
+  /// Returns the edge with index _edge, which is a query edge if _edge is
+  /// at least the number of edges in the file.
+  const Edge& getEdge(std::size_t _edge) const;
+
+  /// Loads the vertices and edges of the file into the nearest neighbors
+  /// index and the adjacency lists.
+  void load();
+
+  /// Appends a vertex to the file. Returns its index.
+  std::size_t addVertex(const statespace::StateSpace::State* _state);
+
+  /// Appends an edge between two vertices to the file.
+  void addEdge(std::size_t _source, std::size_t _target, double _length);
+
+  /// Connects a temporary query vertex to its nearest vertices with query
+  /// edges. Returns the index of the vertex.
+  std::size_t addQueryVertex(const statespace::StateSpace::State* _state);
+
+  /// Removes the query vertices and edges.
+  void clearQuery();
+
+  /// Finds the shortest path from vertex _start to vertex _goal over edges
+  /// not known to be invalid. Returns false if there is none.
+  /// \param[out] _vertices Vertices of the path
+  /// \param[out] _edges Edges of the path
+  bool findShortestPath(
+      std::size_t _start,
+      std::size_t _goal,
+      std::vector<std::size_t>& _vertices,
+      std::vector<std::size_t>& _edges) const;
+
+  /// Forgets the validity of all edges against the groups in the bit mask
+  /// _groups.
+  void forgetGroups(std::uint64_t _groups);
+
+  /// Returns whether edge _edge is known to violate a registered group.
+  bool isKnownInvalid(const Edge& _edge) const;
+
+  /// Checks the edge _edge from vertex _from to vertex _to against the
+  /// registered groups it is not known to satisfy. Returns its validity.
+  bool evaluateEdge(std::size_t _edge, std::size_t _from, std::size_t _to);
+
+  /// Returns whether _state satisfies the constraints of all registered
+  /// groups.
+  bool isValid(const statespace::StateSpace::State* _state) const;
+
+  /// Returns the index of the group named _name, or MAX_COLLISION_GROUPS if
+  /// no group has this name.
+  std::size_t findCollisionGroup(const std::string& _name) const;
+
+  statespace::dart::MetaSkeletonStateSpacePtr mStateSpace;
+  statespace::InterpolatorPtr mInterpolator;
+  distance::DistanceMetricPtr mDistanceMetric;
+  std::unique_ptr<constraint::SampleGenerator> mSampleGenerator;
+  double mMaxDistanceBtwValidityChecks;
+  std::string mFilename;
+  std::size_t mNumNeighbors;
+  std::size_t mDimension;
+  std::uint64_t mSkeletonFingerprint;
+
+  /// Constraints of the collision groups, nullptr if not registered
+  std::vector<constraint::TestablePtr> mConstraints;
+
+  /// Bit mask of the registered collision groups
+  std::uint64_t mRegisteredGroups;
+
+  int mFileDescriptor;
+  void* mData;
+  std::size_t mDataSize;
+  FileHeader* mHeader;
+
+  /// States of the vertices, followed by the query vertices
+  std::vector<statespace::StateSpace::State*> mStates;
+
+  /// Indices of the edges incident to each vertex
+  std::vector<std::vector<std::size_t>> mAdjacency;
+
+  std::unique_ptr<distance::NearestNeighbors> mNearestNeighbors;
+
+  /// Edges connecting the query vertices to the roadmap
+  std::vector<Edge> mQueryEdges;
+
+  std::size_t mNumEdgeChecks;
+};
+
+} // namespace planner
+} // namespace aikido
+
+#endif // AIKIDO_PLANNER_PERSISTENTROADMAP_HPP_
@@ -2,6 +2,7 @@
 #define AIKIDO_PLANNER_PLANNINGRESULT_HPP_
 
 #include <string>
+#include <vector>
 
 namespace aikido {
 namespace planner {
@@ -10,6 +11,12 @@ struct PlanningResult
 {
   // TODO fill out
   std::string message;
+
+  /// Name of the planner that found the solution, when several planners race
+  std::string plannerName;
+
+  /// Time, in seconds, that each of the racing planners ran
+  std::vector<double> plannerTimes;
 };
 
 } // namespace planner
@@ -0,0 +1,133 @@
+#ifndef AIKIDO_PLANNER_OMPL_ANYTIMEPLANNER_HPP_
+#define AIKIDO_PLANNER_OMPL_ANYTIMEPLANNER_HPP_
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <ompl/base/Planner.h>
+#include <ompl/base/ProblemDefinition.h>
+#include "../../statespace/Interpolator.hpp"
+#include "../../statespace/StateSpace.hpp"
+#include "../../trajectory/Interpolated.hpp"
+#include "BackwardCompatibility.hpp"
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+/// Runs an OMPL planner on a background thread and reports every solution
+/// that improves on the best one found so far, so that a caller can start
+/// executing the first feasible path and adopt better ones as they appear.
+///
+/// The planner is run in slices of at most the report period. A slice also
+/// ends as soon as the planner reports an intermediate solution, so that
+/// asymptotically-optimal planners, e.g. RRTstar, deliver improvements without
+/// waiting for the end of the slice. After every slice, the best exact
+/// solution of the ProblemDefinition is compared to the best reported one
+/// under the optimization objective, and is only converted to an Interpolated
+/// trajectory if it is better.
+///
+/// The planner must keep its data structures across calls to solve(), as the
+/// planners of OMPL do until they are cleared.
+class AnytimePlanner
+{
+public:
+  /// Called with every solution that improves on the previous ones, on the
+  /// planning thread. The trajectory has arbitrary timing, as the one of
+  /// planOMPL().
+  using SolutionCallback
+      = std::function<void(trajectory::InterpolatedPtr _trajectory,
+                           double _cost)>;
+
+  /// Constructor.
+  /// \param _planner The planner to run
+  /// \param _pdef The ProblemDefinition, with the start and goal conditions.
+  /// If it has no optimization objective, the path length is optimized.
+  /// \param _sspace The aikido StateSpace to plan against. Used for
+  /// constructing the solution trajectories.
+  /// \param _interpolator An aikido interpolator that can be used with the
+  /// _sspace.
+  /// \param _callback Called with every improved solution, may be empty
+  /// \param _reportPeriod Maximum time, in seconds, between two checks for an
+  /// improved solution
+  /// \throw std::invalid_argument if an argument is nullptr or _reportPeriod
+  /// is not positive.
+  AnytimePlanner(
+      ::ompl::base::PlannerPtr _planner,
+      ::ompl::base::ProblemDefinitionPtr _pdef,
+      statespace::StateSpacePtr _sspace,
+      statespace::InterpolatorPtr _interpolator,
+      SolutionCallback _callback = SolutionCallback(),
+      double _reportPeriod = 0.1);
+
+  /// Cancels planning and waits for the planning thread to finish. Errors
+  /// raised while planning are discarded; call wait() to receive them.
+  ~AnytimePlanner();
+
+  AnytimePlanner(const AnytimePlanner&) = delete;
+  AnytimePlanner& operator=(const AnytimePlanner&) = delete;
+
+  /// Starts planning on a background thread. Planning continues from the
+  /// data of the previous run, but solutions are only reported if they
+  /// improve on the ones reported in this run.
+  /// \param _maxPlanTime The maximum time to allow the planner to search for
+  /// better solutions
+  /// \throw std::runtime_error if planning is running.
+  void start(double _maxPlanTime);
+
+  /// Asks the planner to stop. Returns immediately; call wait() to wait for
+  /// the planning thread.
+  void cancel();
+
+  /// Returns true if the planning thread is running.
+  bool isRunning() const;
+
+  /// Waits until the planner finds an optimal solution, runs out of time or
+  /// is cancelled. Returns the best solution, or nullptr if none was found.
+  /// \param _cost Set to the cost of the best solution, if not nullptr
+  /// \throw std::exception raised by the planner, if any.
+  trajectory::InterpolatedPtr wait(double* _cost = nullptr);
+
+  /// Returns the best solution found so far, or nullptr if none was found.
+  /// \param _cost Set to the cost of the best solution, if not nullptr
+  trajectory::InterpolatedPtr getBestSolution(double* _cost = nullptr) const;
+
+private:
+  /// Runs slices of planning until the planning time is over.
+  void plan(double _maxPlanTime);
+
+  /// Converts the solution of the ProblemDefinition to a trajectory and
+  /// reports it if it is better than the best solution. Returns true if the
+  /// best solution satisfies the optimization objective.
+  bool reportSolution();
+
+  ::ompl::base::PlannerPtr mPlanner;
+  ::ompl::base::ProblemDefinitionPtr mProblemDefinition;
+  statespace::StateSpacePtr mStateSpace;
+  statespace::InterpolatorPtr mInterpolator;
+  SolutionCallback mCallback;
+  double mReportPeriod;
+
+  std::thread mThread;
+  std::atomic<bool> mRunning;
+  std::atomic<bool> mCancelled;
+
+  /// Set when the planner reports an intermediate solution, to end the
+  /// current slice.
+  std::atomic<bool> mImproved;
+
+  std::exception_ptr mException;
+
+  /// Protects the best solution, which the planning thread updates.
+  mutable std::mutex mMutex;
+  trajectory::InterpolatedPtr mBestSolution;
+  ::ompl::base::Cost mBestCost;
+};
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#endif // AIKIDO_PLANNER_OMPL_ANYTIMEPLANNER_HPP_
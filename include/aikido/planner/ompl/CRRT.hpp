@@ -1,11 +1,13 @@
 #ifndef AIKIDO_PLANNER_OMPL_CRRT_HPP_
 #define AIKIDO_PLANNER_OMPL_CRRT_HPP_
 
+#include <deque>
 #include <ompl/base/Planner.h>
 #include <ompl/datastructures/NearestNeighbors.h>
 #include <ompl/geometric/planners/PlannerIncludes.h>
 
 #include "../../constraint/Projectable.hpp"
+#include "../../distance/DistanceMetric.hpp"
 #include "../../planner/ompl/BackwardCompatibility.hpp"
 
 namespace aikido {
@@ -111,6 +113,11 @@ public:
   template <template <typename T> class NN>
   void setNearestNeighbors();
 
+  /// Set a nearest neighbors data structure that indexes the aikido states of
+  /// the tree under \c _metric, see distance::createNearestNeighbors.
+  /// \param _metric The distance metric of the planning StateSpace
+  virtual void setNearestNeighbors(distance::DistanceMetricPtr _metric);
+
   /// Perform extra configuration steps, if needed. This call will also issue a
   /// call to ompl::base::SpaceInformation::setup() if needed. This must be
   /// called before solving.
@@ -148,7 +155,50 @@ protected:
     Motion* parent;
   };
 
-  /// Free the memory allocated by this planner
+  /// Pool of motions and their states. Motions are reused after reset()
+  /// instead of being freed, so extending a tree does not allocate once the
+  /// pool has grown to the size of the trees. A pool must only be used by one
+  /// thread at a time.
+  class MotionPool
+  {
+  public:
+    /// Constructor
+    /// \param _si Information about the planning space, used to allocate and
+    /// free states
+    explicit MotionPool(const ::ompl::base::SpaceInformationPtr& _si);
+
+    /// Destructor. Frees all motions.
+    ~MotionPool();
+
+    MotionPool(const MotionPool&) = delete;
+    MotionPool& operator=(const MotionPool&) = delete;
+
+    /// Returns an unused motion without a parent, allocating a new motion if
+    /// all motions are in use.
+    Motion* allocate();
+
+    /// Returns the most recently allocated motion to the pool.
+    void releaseLast();
+
+    /// Marks all motions as unused, without freeing them.
+    void reset();
+
+    /// Returns the number of motions in use.
+    std::size_t size() const;
+
+  private:
+    ::ompl::base::SpaceInformationPtr mSi;
+
+    /// Motions in order of allocation. A deque keeps the motions in place as
+    /// the pool grows.
+    std::deque<Motion> mMotions;
+
+    /// Number of motions in use, at the front of mMotions
+    std::size_t mNumUsed;
+  };
+
+  /// Return the motions of the tree to the motion pool. The memory of the
+  /// motions is freed when the planner is destroyed.
   virtual void freeMemory();
 
   /// Compute distance between motions (actually distance between contained
@@ -186,6 +236,43 @@ protected:
       double& dist,
       bool& foundgoal);
 
+  /// Perform an extension that projects to a constraint, using the given
+  /// SpaceInformation and constraint instead of those of the planner
+  /// \param ptc Planner termination conditions. Used to stop extending if
+  /// planning time expires.
+  /// \param si Information about the planning space, used to check and
+  /// allocate states
+  /// \param cons The constraint to project to, or nullptr
+  /// \param pool The pool to allocate the motions of the extension from
+  /// \param tree The tree to extend
+  /// \param nmotion The node in the tree to extend from
+  /// \param gstate The state the extension aims to reach
+  /// \param xstate A temporary state that can be used during extension
+  /// \param goal The goal of the planning instance, or nullptr to not check
+  /// the extension against the goal
+  /// \param returnlast If true, return the last node added to the tree,
+  /// otherwise return the node added that was nearest the goal
+  /// \param[out] dist The closest distance this extension got to the goal
+  /// \param[out] True if the extension reached the goal.
+  /// \return fmotion If returnlast is true, the last node on the extension,
+  /// otherwise the closest node along the extension to the goal
+  Motion* constrainedExtend(
+      const ::ompl::base::PlannerTerminationCondition& ptc,
+      const ::ompl::base::SpaceInformationPtr& si,
+      const constraint::ProjectablePtr& cons,
+      MotionPool& pool,
+      TreeData& tree,
+      Motion* nmotion,
+      ::ompl::base::State* gstate,
+      ::ompl::base::State* xstate,
+      ::ompl::base::Goal* goal,
+      bool returnlast,
+      double& dist,
+      bool& foundgoal);
+
+  /// Pool of the motions of the tree
+  MotionPool mMotionPool;
+
   /// State sampler
   ::ompl::base::StateSamplerPtr mSampler;
 
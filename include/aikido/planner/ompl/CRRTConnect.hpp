@@ -1,6 +1,8 @@
 #ifndef AIKIDO_PLANNER_OMPL_CRRTCONNECT_HPP_
 #define AIKIDO_PLANNER_OMPL_CRRTCONNECT_HPP_
 
+#include <memory>
+#include <ompl/base/goals/GoalSampleableRegion.h>
 #include <ompl/datastructures/NearestNeighbors.h>
 #include <ompl/geometric/planners/PlannerIncludes.h>
 #include <aikido/planner/ompl/CRRT.hpp>
@@ -56,19 +58,81 @@ public:
   /// Get the connection radius the planner is using
   double getConnectionRadius() const;
 
+  /// Grow the start and goal trees concurrently, each on its own thread. The
+  /// start tree is grown with the SpaceInformation and path constraint of the
+  /// planner, and the goal tree with \c _goalTreeSi and
+  /// \c _goalTreeConstraint, so the threads share no validity checker, state
+  /// sampler or projector. Each thread only adds motions to its own tree and
+  /// extends it towards the nearest motion of the other tree, which it looks
+  /// up under a lock.
+  ///
+  /// Constraints on a MetaSkeletonStateSpace set the state of its skeleton,
+  /// so \c _goalTreeSi must be built on a MetaSkeletonStateSpace of a clone of
+  /// the skeleton. The motions of the goal tree are states of \c _goalTreeSi,
+  /// and are converted through the tangent space whenever they are compared
+  /// to motions of the start tree or added to the solution path. Goals are
+  /// sampled on the thread of the start tree, since the goal may use the
+  /// StateSpace of the planner, and handed to the goal tree.
+  ///
+  /// By default, or if \c _goalTreeSi is nullptr, both trees are grown in
+  /// turn on the calling thread. The trees of a previous run are cleared.
+  /// \param _goalTreeSi Information about the planning space of the goal
+  /// tree, whose StateSpace has the same structure as that of the planner
+  /// \param _goalTreeConstraint The constraint to be applied throughout the
+  /// goal tree, see setPathConstraint()
+  /// \throw std::invalid_argument if \c _goalTreeSi is the SpaceInformation
+  /// of the planner, if either StateSpace is not a GeometricStateSpace, or if
+  /// their StateSpaces have different structures.
+  void setThreaded(
+      ::ompl::base::SpaceInformationPtr _goalTreeSi,
+      constraint::ProjectablePtr _goalTreeConstraint);
+
+  /// Returns whether the start and goal trees are grown on separate threads.
+  bool isThreaded() const;
+
   /// Set a nearest neighbors data structure for both the start and goal trees
   template <template <typename T> class NN>
   void setNearestNeighbors();
 
+  /// Set an aikido nearest neighbors data structure for both the start and
+  /// goal trees. When the trees are grown on separate threads, the goal tree
+  /// uses the DistanceMetric of its own StateSpace instead of \c _metric.
+  /// \param _metric Distance metric used by the start tree
+  void setNearestNeighbors(distance::DistanceMetricPtr _metric) override;
+
   /// Perform extra configuration steps, if needed. This call will also issue a
   /// call to ompl::base::SpaceInformation::setup() if needed. This must be
   /// called before solving.
   void setup() override;
 
 protected:
-  /// Free the memory allocated by this planner
+  // Documentation inherited.
   void freeMemory() override;
 
+  /// Grow the start and goal trees on separate threads until they are
+  /// connected or \c _ptc is true. Returns whether a solution was found.
+  /// \param _ptc Conditions for terminating planning
+  /// \param _goal The goal of the planning instance
+  bool solveThreaded(
+      const ::ompl::base::PlannerTerminationCondition& _ptc,
+      ::ompl::base::GoalSampleableRegion* _goal);
+
+  /// Compute distance between motions of the goal tree, in the StateSpace of
+  /// the goal tree.
+  double goalTreeDistanceFunction(const Motion* a, const Motion* b) const;
+
+  /// Add the path through two connected motions as a solution.
+  /// \param _startMotion The connected motion of the start tree
+  /// \param _goalMotion The connected motion of the goal tree
+  /// \param _treeDistance Distance between the two motions
+  /// \param _goal The goal of the planning instance
+  /// \return False if the start and goal of the path are not a valid pair
+  bool addSolutionPath(
+      Motion* _startMotion,
+      Motion* _goalMotion,
+      double _treeDistance,
+      ::ompl::base::GoalSampleableRegion* _goal);
+
   /// The goal tree
   TreeData mGoalTree;
 
@@ -78,6 +142,18 @@ protected:
   /// The pair of states in each tree connected during planning.  Use for
   /// PlannerData computation
   std::pair<::ompl::base::State*, ::ompl::base::State*> mConnectionPoint;
+
+  /// Information about the planning space of the goal tree when the trees are
+  /// grown on separate threads, or nullptr
+  ::ompl::base::SpaceInformationPtr mGoalTreeSi;
+
+  /// The constraint applied throughout the goal tree when the trees are grown
+  /// on separate threads
+  constraint::ProjectablePtr mGoalTreeCons;
+
+  /// Pool of the motions of the goal tree when the trees are grown on
+  /// separate threads, or nullptr
+  std::unique_ptr<MotionPool> mGoalTreeMotionPool;
 };
 
 } // namespace ompl
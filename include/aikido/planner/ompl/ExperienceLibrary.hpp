@@ -0,0 +1,279 @@
+#ifndef AIKIDO_PLANNER_OMPL_EXPERIENCELIBRARY_HPP_
+#define AIKIDO_PLANNER_OMPL_EXPERIENCELIBRARY_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../constraint/Projectable.hpp"
+#include "../../constraint/Sampleable.hpp"
+#include "../../constraint/Testable.hpp"
+#include "../../distance/DistanceMetric.hpp"
+#include "../../statespace/Interpolator.hpp"
+#include "../../statespace/StateSpace.hpp"
+#include "../../trajectory/Interpolated.hpp"
+#include "../PlanningResult.hpp"
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+/// A library of previously planned paths, for planning repeated tasks by
+/// retrieving and repairing past experience instead of planning from scratch.
+///
+/// Each path is keyed by its first and last waypoints. A query retrieves the
+/// stored paths whose start and goal are nearest to its own, replaces their
+/// endpoints with the query's start and goal, and checks the resulting path
+/// segment by segment against the current validity constraint. Runs of
+/// invalid segments and waypoints are replaced with paths from a local
+/// planner between the nearest valid waypoints around them, with a bounded
+/// planning time. Only if no stored path can be repaired is the query planned
+/// from scratch. Repaired and newly planned paths are added to the library.
+///
+/// The library holds at most getCapacity() paths and evicts the least
+/// recently used path when it is full. It can be saved to and loaded from a
+/// binary file; waypoints are stored as StateSpace::logMap() coordinates.
+class ExperienceLibrary
+{
+public:
+  /// Plans a path between two states in a given time. Returns nullptr on
+  /// failure.
+  using LocalPlanner = std::function<trajectory::InterpolatedPtr(
+      const statespace::StateSpace::State* _start,
+      const statespace::StateSpace::State* _goal,
+      double _maxPlanTime)>;
+
+  /// Constructor.
+  /// \param _stateSpace The StateSpace of the paths
+  /// \param _interpolator An Interpolator defined on the StateSpace
+  /// \param _dmetric A distance metric defined on the StateSpace, used to
+  /// rank stored paths and to space validity checks
+  /// \param _capacity Maximum number of stored paths, at least 1
+  /// \throw std::invalid_argument if an argument is invalid.
+  ExperienceLibrary(
+      statespace::StateSpacePtr _stateSpace,
+      statespace::InterpolatorPtr _interpolator,
+      distance::DistanceMetricPtr _dmetric,
+      std::size_t _capacity = 1000);
+
+  /// Returns the StateSpace of the paths.
+  statespace::StateSpacePtr getStateSpace() const;
+
+  /// Returns the Interpolator of the paths.
+  statespace::InterpolatorPtr getInterpolator() const;
+
+  /// Returns the distance metric used to rank stored paths.
+  distance::DistanceMetricPtr getDistanceMetric() const;
+
+  /// Sets the maximum number of stored paths, evicting the least recently
+  /// used paths if there are more.
+  /// \param _capacity Maximum number of stored paths, at least 1
+  /// \throw std::invalid_argument if \c _capacity is zero.
+  void setCapacity(std::size_t _capacity);
+
+  /// Returns the maximum number of stored paths.
+  std::size_t getCapacity() const;
+
+  /// Returns the number of stored paths.
+  std::size_t size() const;
+
+  /// Removes all stored paths.
+  void clear();
+
+  /// Adds a copy of a path to the library, evicting the least recently used
+  /// path if the library is full.
+  /// \param _path Path with at least two waypoints
+  /// \throw std::invalid_argument if \c _path has another StateSpace or fewer
+  /// than two waypoints.
+  void addPath(const trajectory::Interpolated& _path);
+
+  /// Returns the stored paths whose start and goal are nearest to \c _start
+  /// and \c _goal, by increasing sum of the two distances.
+  /// \param _start Start state of the query
+  /// \param _goal Goal state of the query
+  /// \param _numPaths Maximum number of paths
+  std::vector<std::shared_ptr<const trajectory::Interpolated>> retrieve(
+      const statespace::StateSpace::State* _start,
+      const statespace::StateSpace::State* _goal,
+      std::size_t _numPaths) const;
+
+  /// Returns the stored paths that end in the goal region \c _goalTestable,
+  /// e.g. a TSR, by increasing distance of their start to \c _start.
+  /// \param _start Start state of the query
+  /// \param _goalTestable Testable that determines if a state is a goal
+  /// \param _numPaths Maximum number of paths
+  std::vector<std::shared_ptr<const trajectory::Interpolated>> retrieve(
+      const statespace::StateSpace::State* _start,
+      const constraint::Testable& _goalTestable,
+      std::size_t _numPaths) const;
+
+  /// Plans a path from \c _start to \c _goal by repairing the nearest stored
+  /// paths. Falls back to planning with \c _localPlanner from \c _start to
+  /// \c _goal if no stored path can be repaired.
+  /// \param _start The start state
+  /// \param _goal The goal state
+  /// \param _localPlanner Planner used to repair paths and as the fallback
+  /// \param _validityConstraint The constraint that paths must satisfy
+  /// \param _maxDistanceBtwValidityChecks The maximum distance (under the
+  /// distance metric) between two successive validity checks along a segment
+  /// \param _maxRepairTime The maximum time of each repair
+  /// \param _maxPlanTime The maximum time of the fallback
+  /// \param _numCandidates Number of stored paths to try repairing
+  /// \param[out] _planningResult Information about the result, if not nullptr
+  /// \return Path, or nullptr on planning failure
+  /// \throw std::invalid_argument if an argument is invalid.
+  trajectory::InterpolatedPtr plan(
+      const statespace::StateSpace::State* _start,
+      const statespace::StateSpace::State* _goal,
+      const LocalPlanner& _localPlanner,
+      constraint::TestablePtr _validityConstraint,
+      double _maxDistanceBtwValidityChecks,
+      double _maxRepairTime,
+      double _maxPlanTime,
+      std::size_t _numCandidates = 3,
+      PlanningResult* _planningResult = nullptr);
+
+  /// Plans a path from \c _start to the goal region \c _goalTestable by
+  /// repairing the nearest stored paths that end in the region. Each
+  /// candidate keeps its own goal. Returns nullptr if no stored path ends in
+  /// the region or can be repaired; the caller then plans from scratch.
+  /// \param _start The start state
+  /// \param _goalTestable Testable that determines if a state is a goal
+  /// \param _localPlanner Planner used to repair paths
+  /// \param _validityConstraint The constraint that paths must satisfy
+  /// \param _maxDistanceBtwValidityChecks The maximum distance (under the
+  /// distance metric) between two successive validity checks along a segment
+  /// \param _maxRepairTime The maximum time of each repair
+  /// \param _numCandidates Number of stored paths to try repairing
+  /// \param[out] _planningResult Information about the result, if not nullptr
+  /// \return Path, or nullptr on failure
+  /// \throw std::invalid_argument if an argument is invalid.
+  trajectory::InterpolatedPtr plan(
+      const statespace::StateSpace::State* _start,
+      const constraint::Testable& _goalTestable,
+      const LocalPlanner& _localPlanner,
+      constraint::TestablePtr _validityConstraint,
+      double _maxDistanceBtwValidityChecks,
+      double _maxRepairTime,
+      std::size_t _numCandidates = 3,
+      PlanningResult* _planningResult = nullptr);
+
+  /// Writes all stored paths to a binary file.
+  /// \param _filename Path of the file
+  /// \throw std::runtime_error if the file cannot be written.
+  void save(const std::string& _filename) const;
+
+  /// Replaces the stored paths with the paths of a file written by save().
+  /// Paths beyond the capacity are evicted.
+  /// \param _filename Path of the file
+  /// \throw std::runtime_error if the file cannot be read, is corrupt, e.g.
+  /// holds a path with fewer than two waypoints, or was written for a
+  /// StateSpace of another dimension.
+  void load(const std::string& _filename);
+
+private:
+  /// A stored path.
+  struct Entry
+  {
+    std::shared_ptr<const trajectory::Interpolated> mPath;
+
+    /// Value of mClock when the path was added or last reused
+    std::uint64_t mLastUsed;
+  };
+
+  /// Returns the indices of the stored paths with the lowest cost, by
+  /// increasing cost.
+  std::vector<std::size_t> findNearest(
+      const std::function<double(const trajectory::Interpolated&)>& _cost,
+      std::size_t _numPaths) const;
+
+  /// Tries repairing the stored path _index between _start and _goal, or
+  /// its own goal if _goal is nullptr. Returns nullptr on failure.
+  /// \param[out] _numRepairs Number of local planner calls
+  trajectory::InterpolatedPtr repair(
+      std::size_t _index,
+      const statespace::StateSpace::State* _start,
+      const statespace::StateSpace::State* _goal,
+      const LocalPlanner& _localPlanner,
+      const constraint::Testable& _validityConstraint,
+      double _maxDistanceBtwValidityChecks,
+      double _maxRepairTime,
+      std::size_t& _numRepairs) const;
+
+  /// Returns whether the interior of the segment from _from to _to satisfies
+  /// _validityConstraint.
+  bool isSegmentValid(
+      const statespace::StateSpace::State* _from,
+      const statespace::StateSpace::State* _to,
+      const constraint::Testable& _validityConstraint,
+      double _maxDistanceBtwValidityChecks) const;
+
+  /// Retrieves and repairs the candidates _candidates. Returns nullptr if
+  /// none can be repaired.
+  trajectory::InterpolatedPtr repairCandidates(
+      const std::vector<std::size_t>& _candidates,
+      const statespace::StateSpace::State* _start,
+      const statespace::StateSpace::State* _goal,
+      const LocalPlanner& _localPlanner,
+      const constraint::Testable& _validityConstraint,
+      double _maxDistanceBtwValidityChecks,
+      double _maxRepairTime,
+      PlanningResult* _planningResult);
+
+  /// Evicts the least recently used paths until at most _size remain.
+  void evict(std::size_t _size);
+
+  statespace::StateSpacePtr mStateSpace;
+  statespace::InterpolatorPtr mInterpolator;
+  distance::DistanceMetricPtr mDistanceMetric;
+  std::size_t mCapacity;
+  std::vector<Entry> mEntries;
+  std::uint64_t mClock;
+};
+
+using ExperienceLibraryPtr = std::shared_ptr<ExperienceLibrary>;
+
+/// Plans a trajectory from the start to the goal state with an
+/// ExperienceLibrary, repairing stored paths and planning from scratch with
+/// the template OMPL Planner type. See ExperienceLibrary::plan().
+/// \param _library The library of stored paths, which also provides the
+/// StateSpace, Interpolator and distance metric
+/// \param _start The start state
+/// \param _goal The goal state
+/// \param _sampler A Sampleable that can sample states from the StateSpace
+/// \param _validityConstraint A constraint used to test validity during
+/// planning
+/// \param _boundsConstraint A constraint used to determine whether states
+/// encountered during planning fall within any bounds specified on the
+/// StateSpace
+/// \param _boundsProjector A Projectable that projects a state back within
+/// valid bounds defined on the StateSpace
+/// \param _maxRepairTime The maximum time of each repair
+/// \param _maxPlanTime The maximum time of planning from scratch
+/// \param _maxDistanceBtwValidityChecks The maximum distance (under dmetric)
+/// between validity checking two successive points on a tree extension
+/// \param _numCandidates Number of stored paths to try repairing
+/// \param[out] _planningResult Information about the result, if not nullptr
+template <class PlannerType>
+trajectory::InterpolatedPtr planOMPLWithExperience(
+    ExperienceLibrary& _library,
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    constraint::SampleablePtr _sampler,
+    constraint::TestablePtr _validityConstraint,
+    constraint::TestablePtr _boundsConstraint,
+    constraint::ProjectablePtr _boundsProjector,
+    double _maxRepairTime,
+    double _maxPlanTime,
+    double _maxDistanceBtwValidityChecks,
+    std::size_t _numCandidates = 3,
+    PlanningResult* _planningResult = nullptr);
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#include "detail/ExperienceLibrary-impl.hpp"
+
+#endif // AIKIDO_PLANNER_OMPL_EXPERIENCELIBRARY_HPP_
@@ -1,6 +1,9 @@
 #ifndef AIKIDO_OMPL_AIKIDOGEOMETRICSTATESPACE_HPP_
 #define AIKIDO_OMPL_AIKIDOGEOMETRICSTATESPACE_HPP_
 
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <ompl/base/StateSpace.h>
 #include "aikido/planner/ompl/BackwardCompatibility.hpp"
 #include "../../constraint/Projectable.hpp"
@@ -59,15 +62,26 @@ public:
       constraint::TestablePtr _boundsConstraint,
       constraint::ProjectablePtr _boundsProjection);
 
+  /// Frees the states held by the pool of this space.
+  ~GeometricStateSpace() override;
+
   /// Get the dimension of the space.
   unsigned int getDimension() const override;
 
   /// Get the maximum value a call to distance() can return (or an upper bound).
-  /// For unbounded state spaces, this function can return infinity.
+  /// This is derived from the bounds constraint and the distance metric:
+  /// the diagonal of the box for real vector spaces with box bounds or joint
+  /// limits, pi for SO2 and SO3, and the weighted sum of these for a
+  /// CartesianProductWeighted metric. Returns infinity if the space is
+  /// unbounded or its bounds or metric are of another type.
   double getMaximumExtent() const override;
 
 #if OMPL_VERSION_AT_LEAST(1, 0, 0)
-  /// Get a measure of the space.
+  /// Get a measure of the space, i.e. its volume under the distance metric.
+  /// This is the volume of the box for real vector spaces, 2 pi for SO2,
+  /// pi^2 for SO3 and the product of these for a CartesianProductWeighted
+  /// metric, where a subspace of dimension n and weight w is scaled by w^n.
+  /// Returns infinity whenever getMaximumExtent() does.
   double getMeasure() const override;
 #else
   double getMeasure() const;
@@ -121,7 +135,11 @@ public:
   /// Allocate an instance of the state sampler for this space.
   ::ompl::base::StateSamplerPtr allocDefaultStateSampler() const override;
 
-  /// Allocate a state that can store a point in the described space
+  /// Allocate a state that can store a point in the described space. The
+  /// StateType and the aikido state it wraps are taken from a pool owned by
+  /// this space, so states that are allocated and freed repeatedly do not
+  /// touch the heap. The aikido state is allocated by the aikido StateSpace,
+  /// and may be freed separately with statespace::StateSpace::freeState().
   ::ompl::base::State* allocState() const override;
 
   /// Allocate a state constaining a copy of the aikido state
@@ -130,13 +148,21 @@ public:
       const statespace::StateSpace::State* _state) const;
 
   /// Free the memory of the allocated state. This also frees the memory of the
-  /// wrapped aikido state.
+  /// wrapped aikido state, which must have been allocated by the aikido
+  /// StateSpace. A caller that frees the aikido state itself must set mState to
+  /// nullptr first. The memory is returned to the pool of this space.
   /// \param _state The state to free.
   void freeState(::ompl::base::State* _state) const override;
 
   /// Return the Aikido StateSpace that this OMPL StateSpace wraps
   statespace::StateSpacePtr getAikidoStateSpace() const;
 
+  /// Return the Aikido Interpolator used by interpolate()
+  statespace::InterpolatorPtr getInterpolator() const;
+
+  /// Return the distance metric used by distance()
+  distance::DistanceMetricPtr getDistanceMetric() const;
+
 private:
   statespace::StateSpacePtr mStateSpace;
   statespace::InterpolatorPtr mInterpolator;
@@ -144,6 +170,22 @@ private:
   constraint::SampleablePtr mSampler;
   constraint::TestablePtr mBoundsConstraint;
   constraint::ProjectablePtr mBoundsProjection;
+
+  /// Computed from the bounds and the metric at construction.
+  double mMaximumExtent;
+  double mMeasure;
+
+  /// Protects the pool.
+  mutable std::mutex mPoolMutex;
+
+  /// Memory of all StateTypes, allocated in chunks of several StateTypes.
+  mutable std::vector<std::unique_ptr<char[]>> mChunks;
+
+  /// Memory of StateTypes that are not in use.
+  mutable std::vector<void*> mFreeBlocks;
+
+  /// Aikido states of freed states, which are reused by allocState().
+  mutable std::vector<statespace::StateSpace::State*> mFreeStates;
 };
 
 using GeometricStateSpacePtr = std::shared_ptr<GeometricStateSpace>;
@@ -1,6 +1,11 @@
 #ifndef AIKIDO_OMPL_GOALREGION_HPP_
 #define AIKIDO_OMPL_GOALREGION_HPP_
 
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <ompl/base/goals/GoalSampleableRegion.h>
 #include "../../constraint/Sampleable.hpp"
 #include "../../constraint/Testable.hpp"
@@ -9,7 +14,12 @@ namespace aikido {
 namespace planner {
 namespace ompl {
 
-/// Exposes a Testable/Sampleable constraint pair as a goal to OMPL planners
+/// Exposes a Testable/Sampleable constraint pair as a goal to OMPL planners.
+///
+/// By default, goals are sampled synchronously in sampleGoal(). Goal samplers
+/// that are slow, e.g. inverse kinematics over a TSR, can instead run on a
+/// background thread that fills a lock-free queue of goal states; see
+/// startBackgroundSampling().
 class GoalRegion : public ::ompl::base::GoalSampleableRegion
 {
 public:
@@ -25,16 +35,61 @@ public:
       constraint::TestablePtr _goalTestable,
       std::unique_ptr<constraint::SampleGenerator> _generator);
 
+  /// Stops background sampling, if running.
+  ~GoalRegion() override;
+
+  /// Start sampling goals on a background thread. Sampled states that satisfy
+  /// \c _goalTestable are pushed into a queue that sampleGoal() pops from
+  /// without blocking. Constraints on a MetaSkeletonStateSpace set the state
+  /// of its skeleton, so the background thread uses its own SampleGenerator
+  /// and Testable, defined on a StateSpace of the same structure as the
+  /// planning StateSpace, e.g. a MetaSkeletonStateSpace of a clone of the
+  /// skeleton. Queued goal states are converted into the planning StateSpace
+  /// through the tangent space. Only one thread may call sampleGoal() at a
+  /// time.
+  /// \param _queueCapacity Maximum number of goal states waiting in the queue
+  /// \param _generator A SampleGenerator that returns states in this
+  /// GoalRegion, used only by the background thread
+  /// \param _goalTestable A Testable that is satisfied for all states in this
+  /// GoalRegion, used only by the background thread
+  /// \throws std::invalid_argument if _queueCapacity is zero, _generator or
+  /// _goalTestable is null, they are defined on different StateSpaces, or
+  /// their StateSpace is the planning StateSpace or has another structure
+  /// \throws std::runtime_error if background sampling is already running
+  void startBackgroundSampling(
+      std::size_t _queueCapacity,
+      std::unique_ptr<constraint::SampleGenerator> _generator,
+      constraint::TestablePtr _goalTestable);
+
+  /// Stop sampling goals on the background thread and discard the goal states
+  /// left in the queue. sampleGoal() samples synchronously again afterwards.
+  /// Does nothing if background sampling is not running.
+  ///
+  /// An exception on the background thread only ends goal sampling, so the
+  /// planner may still have found a path to a goal sampled before. The
+  /// exception is returned instead of thrown, so the caller can decide
+  /// whether it matters.
+  /// \return The exception thrown by the SampleGenerator or goal Testable on
+  /// the background thread, or nullptr
+  std::exception_ptr stopBackgroundSampling();
+
+  /// Return true if goals are sampled on a background thread
+  bool isBackgroundSampling() const;
+
   /// Sample a state in the goal region using the SampleGenerator defined on the
-  /// class
+  /// class. With background sampling, pop the next goal state from the queue
+  /// instead, or mark _state as invalid if the queue is empty.
   /// \param[out] _state The sampled state
   void sampleGoal(::ompl::base::State* _state) const override;
 
   /// Return the maximum number of samples that can
-  ///  be asked for before repeating
+  ///  be asked for before repeating. With background sampling, this is the
+  /// number of goal states that have been pushed into the queue so far.
   unsigned int maxSampleCount() const override;
 
-  /// Return true if the SampleGenerator can generate more samples
+  /// Return true if the SampleGenerator can generate more samples. With
+  /// background sampling, return true while the background thread is
+  /// sampling or the queue holds goal states.
   bool couldSample() const override;
 
   /// Return 0 if the goal is satisfied or inf otherwise
@@ -46,8 +101,37 @@ public:
   bool isSatisfied(const ::ompl::base::State* _state) const override;
 
 private:
+  /// Sample goal states into the queue until stopped or the SampleGenerator
+  /// is exhausted. Runs on the background thread.
+  void sampleInBackground();
+
   constraint::TestablePtr mTestable;
   std::unique_ptr<constraint::SampleGenerator> mSampleGenerator;
+
+  /// Goal constraints used only by the background thread.
+  constraint::TestablePtr mBackgroundTestable;
+  std::unique_ptr<constraint::SampleGenerator> mBackgroundSampleGenerator;
+
+  /// Background thread sampling goals into mQueue.
+  std::thread mSamplingThread;
+
+  /// Ring of preallocated goal states of the StateSpace of
+  /// mBackgroundSampleGenerator. The background thread is the only producer
+  /// and sampleGoal() the only consumer.
+  std::vector<statespace::StateSpace::State*> mQueue;
+
+  /// Number of goal states pushed into and popped from mQueue.
+  std::atomic<std::size_t> mNumPushed;
+  mutable std::atomic<std::size_t> mNumPopped;
+
+  /// True while the background thread may push more goal states.
+  std::atomic<bool> mSampling;
+
+  /// Set to ask the background thread to stop.
+  std::atomic<bool> mStopSampling;
+
+  /// Exception thrown on the background thread, if any.
+  std::exception_ptr mSamplingException;
 };
 
 } // namespace ompl
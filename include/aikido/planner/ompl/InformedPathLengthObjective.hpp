@@ -0,0 +1,43 @@
+#ifndef AIKIDO_OMPL_INFORMEDPATHLENGTHOBJECTIVE_HPP_
+#define AIKIDO_OMPL_INFORMEDPATHLENGTHOBJECTIVE_HPP_
+
+#include "../../planner/ompl/BackwardCompatibility.hpp"
+
+#if OMPL_VERSION_AT_LEAST(1, 2, 0)
+
+#include <ompl/base/objectives/PathLengthOptimizationObjective.h>
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+/// Path length objective whose informed sampler works in a
+/// GeometricStateSpace. OMPL's default informed sampler for path length only
+/// supports real vector, SE2 and SE3 spaces; this objective allocates a
+/// TangentSpaceInformedSampler instead, so informed planners such as
+/// Informed RRT* and BIT* can be used with aikido state spaces.
+class InformedPathLengthObjective
+    : public ::ompl::base::PathLengthOptimizationObjective
+{
+public:
+  /// Constructor.
+  /// \param _si The SpaceInformation of the problem. Its StateSpace must be a
+  /// GeometricStateSpace.
+  explicit InformedPathLengthObjective(
+      const ::ompl::base::SpaceInformationPtr& _si);
+
+  /// Allocate a TangentSpaceInformedSampler for _problem.
+  /// \param _problem The problem to sample for
+  /// \param _maxNumberCalls Maximum number of attempts to draw a sample
+  ::ompl::base::InformedSamplerPtr allocInformedStateSampler(
+      const ::ompl::base::ProblemDefinitionPtr& _problem,
+      unsigned int _maxNumberCalls) const override;
+};
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#endif // OMPL_VERSION_AT_LEAST(1, 2, 0)
+
+#endif // AIKIDO_OMPL_INFORMEDPATHLENGTHOBJECTIVE_HPP_
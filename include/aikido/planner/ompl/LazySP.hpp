@@ -0,0 +1,238 @@
+#ifndef AIKIDO_PLANNER_OMPL_LAZYSP_HPP_
+#define AIKIDO_PLANNER_OMPL_LAZYSP_HPP_
+
+#include <string>
+#include <vector>
+#include <ompl/base/Planner.h>
+#include <ompl/datastructures/NearestNeighbors.h>
+#include <ompl/geometric/planners/PlannerIncludes.h>
+
+#include "../../planner/World.hpp"
+#include "../../planner/ompl/BackwardCompatibility.hpp"
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+/// Implements the Lazy Shortest Path (LazySP) planner on a probabilistic
+/// roadmap.
+///
+/// Vertices and edges are added to the roadmap without checking them. Each
+/// iteration finds the shortest path through the roadmap that avoids the
+/// vertices and edges known to be invalid, then checks the unevaluated edges
+/// of that path, in the order given by the EdgeSelector, until one is
+/// invalid. Only the edges on candidate paths are ever checked, with the
+/// MotionValidator of the SpaceInformation, and their validity is cached.
+///
+/// The roadmap and the validity cache persist across queries: clear() only
+/// removes the start and goal vertices of the current query. The cached
+/// validity of vertices and edges is discarded by clearValidityCache(), or
+/// automatically when the World set with setWorld() changes between queries.
+/// Use it with a PlanningContext to reuse the roadmap for many queries.
+class LazySP : public ::ompl::base::Planner
+{
+public:
+  /// Order in which the unevaluated edges of a candidate path are checked.
+  enum class EdgeSelector
+  {
+    /// From the start to the goal.
+    FORWARD,
+
+    /// Alternately from the start and from the goal.
+    ALTERNATE,
+
+    /// Bisecting the path in VanDerCorput order, middle edge first.
+    BISECTION
+  };
+
+  /// Constructor
+  /// \param _si Information about the planning space
+  explicit LazySP(const ::ompl::base::SpaceInformationPtr& _si);
+
+  /// Constructor
+  /// \param _si Information about the planning space
+  /// \param _name A name for this planner
+  LazySP(
+      const ::ompl::base::SpaceInformationPtr& _si, const std::string& _name);
+
+  /// Destructor
+  virtual ~LazySP();
+
+  // Documentation inherited.
+  void getPlannerData(::ompl::base::PlannerData& _data) const override;
+
+  /// Searches the roadmap for a valid path, growing the roadmap whenever the
+  /// start and goal are disconnected, until \c _ptc terminates.
+  /// \param _ptc Conditions for terminating planning before a solution is
+  /// found
+  ::ompl::base::PlannerStatus solve(
+      const ::ompl::base::PlannerTerminationCondition& _ptc) override;
+
+  /// Removes the start and goal vertices of the current query, and their
+  /// edges, from the roadmap. The rest of the roadmap and the validity cache
+  /// are kept.
+  void clear() override;
+
+  /// Removes all vertices and edges from the roadmap.
+  void clearRoadmap();
+
+  /// Marks the validity of all vertices and edges as unknown, and clears the
+  /// edge cache of the MotionValidator, if it is a MotionValidator.
+  void clearValidityCache();
+
+  /// Discards the validity cache whenever the configuration of a skeleton in
+  /// \c _world has changed since the previous call to solve().
+  /// \param _world World whose state determines validity, or nullptr
+  /// \param _ignoredSkeletons Names of skeletons whose configurations are
+  /// ignored, e.g. the robot, whose configuration is set by the checks
+  void setWorld(
+      WorldPtr _world, std::vector<std::string> _ignoredSkeletons = {});
+
+  /// Set the order in which the edges of a candidate path are checked.
+  /// \param _selector The edge selector
+  void setEdgeSelector(EdgeSelector _selector);
+
+  /// Get the order in which the edges of a candidate path are checked.
+  EdgeSelector getEdgeSelector() const;
+
+  /// Set the maximum length of an edge of the roadmap.
+  /// \param _distance The maximum length of an edge
+  void setRange(double _distance);
+
+  /// Get the maximum length of an edge of the roadmap.
+  double getRange() const;
+
+  /// Set the number of nearest neighbors each new vertex is connected to.
+  /// \param _numNeighbors The number of neighbors
+  void setNumNeighbors(unsigned int _numNeighbors);
+
+  /// Get the number of nearest neighbors each new vertex is connected to.
+  unsigned int getNumNeighbors() const;
+
+  /// Set the number of vertices added each time the roadmap is grown.
+  /// \param _batchSize The number of vertices, at least 1
+  void setBatchSize(unsigned int _batchSize);
+
+  /// Get the number of vertices added each time the roadmap is grown.
+  unsigned int getBatchSize() const;
+
+  /// Get the number of vertices in the roadmap.
+  std::size_t getNumVertices() const;
+
+  /// Get the number of edges in the roadmap.
+  std::size_t getNumEdges() const;
+
+  /// Get the number of edges whose validity is cached.
+  std::size_t getNumEvaluatedEdges() const;
+
+  /// Get the number of edges checked with the MotionValidator since the
+  /// planner was created.
+  std::size_t getNumEdgeChecks() const;
+
+  /// Perform extra configuration steps, if needed. This call will also issue a
+  /// call to ompl::base::SpaceInformation::setup() if needed. This must be
+  /// called before solving.
+  void setup() override;
+
+private:
+  /// Validity of a vertex or an edge.
+  enum class Status
+  {
+    UNKNOWN,
+    VALID,
+    INVALID
+  };
+
+  /// A vertex of the roadmap.
+  struct Vertex
+  {
+    ::ompl::base::State* mState;
+    Status mStatus;
+
+    /// Indices of the incident edges.
+    std::vector<std::size_t> mEdges;
+  };
+
+  /// An undirected edge of the roadmap.
+  struct Edge
+  {
+    std::size_t mSource;
+    std::size_t mTarget;
+    double mLength;
+    Status mStatus;
+  };
+
+  /// Adds a copy of _state to the roadmap and connects it to its nearest
+  /// neighbors. Returns the index of the new vertex.
+  std::size_t addVertex(const ::ompl::base::State* _state);
+
+  /// Removes the start and goal vertices of the current query and their edges,
+  /// and renumbers the remaining vertices and edges.
+  void removeQueryVertices();
+
+  /// Adds mBatchSize uniformly sampled vertices to the roadmap.
+  void growRoadmap(const ::ompl::base::PlannerTerminationCondition& _ptc);
+
+  /// Finds the shortest path from a start to a goal vertex that avoids
+  /// invalid vertices and edges. Returns false if there is none.
+  /// \param[out] _vertices Vertices of the path
+  /// \param[out] _edges Edges of the path
+  bool findShortestPath(
+      std::vector<std::size_t>& _vertices,
+      std::vector<std::size_t>& _edges) const;
+
+  /// Returns the order in which the edges of a path are checked.
+  /// \param _numEdges Number of edges of the path
+  std::vector<std::size_t> getEdgeOrder(std::size_t _numEdges) const;
+
+  /// Checks the unevaluated edges of a path in the order of mEdgeSelector.
+  /// Returns false when an edge is invalid.
+  bool evaluatePath(
+      const std::vector<std::size_t>& _vertices,
+      const std::vector<std::size_t>& _edges);
+
+  /// Checks vertex _vertex if its validity is unknown. Returns its validity.
+  bool evaluateVertex(std::size_t _vertex);
+
+  /// Checks the edge _edge from vertex _from to vertex _to if its validity is
+  /// unknown. Returns its validity.
+  bool evaluateEdge(std::size_t _edge, std::size_t _from, std::size_t _to);
+
+  /// Discards the validity cache if the World changed.
+  void synchronizeWorld();
+
+  /// Compute distance between the states of two vertices.
+  double distanceFunction(std::size_t _a, std::size_t _b) const;
+
+  /// State sampler
+  ::ompl::base::StateSamplerPtr mSampler;
+
+  /// Nearest neighbors structure over vertex indices
+  ompl_shared_ptr<::ompl::NearestNeighbors<std::size_t>> mNearestNeighbors;
+
+  std::vector<Vertex> mVertices;
+  std::vector<Edge> mEdges;
+
+  /// Start and goal vertices of the current query
+  std::vector<std::size_t> mStartVertices;
+  std::vector<std::size_t> mGoalVertices;
+
+  EdgeSelector mEdgeSelector;
+  double mMaxDistance;
+  unsigned int mNumNeighbors;
+  unsigned int mBatchSize;
+  std::size_t mNumEdgeChecks;
+
+  WorldPtr mWorld;
+  std::vector<std::string> mIgnoredSkeletons;
+
+  /// State of mWorld when the validity cache was last used
+  World::State mWorldState;
+  bool mHasWorldState;
+};
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#endif // AIKIDO_PLANNER_OMPL_LAZYSP_HPP_
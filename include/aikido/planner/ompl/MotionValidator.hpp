@@ -1,7 +1,20 @@
 #ifndef AIKIDO_PLANNER_OMPL_MOTIONVALIDATOR_HPP_
 #define AIKIDO_PLANNER_OMPL_MOTIONVALIDATOR_HPP_
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Core>
 #include <ompl/base/MotionValidator.h>
+#include "../../common/VanDerCorput.hpp"
+#include "../../constraint/MotionTestable.hpp"
+#include "../../statespace/GeodesicInterpolator.hpp"
 
 namespace aikido {
 namespace planner {
@@ -9,6 +22,21 @@ namespace ompl {
 
 /// Implement an OMPL MotionValidator.  This class checks the validity
 ///  of path segments between states.
+///
+/// States along a segment are interpolated in scratch states that are reused
+/// across calls. If the planning StateSpace is a GeometricStateSpace with a
+/// GeodesicInterpolator, the tangent of each segment is computed once instead
+/// of once per sample.
+///
+/// The results of recent checks can be cached, keyed on the values of the
+/// endpoint states, so segments that are checked repeatedly, e.g. by
+/// PathSimplifier or CRRTConnect, are only checked once. The cache is disabled
+/// by default, see setEdgeCacheSize(). Once enabled, it must be cleared with
+/// clearEdgeCache() whenever the validity of states changes, for example
+/// because obstacles moved; PlanningContext does so on every query.
+///
+/// Long segments can be checked in parallel by a pool of worker threads, see
+/// setParallelValidityCheckers().
 class MotionValidator : public ::ompl::base::MotionValidator
 {
 public:
@@ -22,6 +50,27 @@ public:
       const ::ompl::base::SpaceInformationPtr& _si,
       double _maxDistBtwValidityChecks);
 
+  /// Constructs a MotionValidator that checks each path segment as a whole
+  /// with a MotionTestable, e.g. constraint::ContinuousCollisionFree, instead
+  /// of testing states sampled along it.
+  ///
+  /// The interpolator of the planning StateSpace must be geodesic. Only the
+  /// end state of each segment is checked with the StateValidityChecker, so
+  /// any constraint that is not covered by \c _motionTestable is checked at
+  /// the segment endpoints only.
+  /// \param _si The SpaceInformation describing the planning space where this
+  /// MotionValidator will be used
+  /// \param _motionTestable Constraint used to check whole segments. It must
+  /// operate on the aikido StateSpace wrapped by the planning StateSpace.
+  /// \throw std::invalid_argument if \c _motionTestable does not operate on
+  /// the planning StateSpace, or its interpolator is not a
+  /// GeodesicInterpolator.
+  MotionValidator(
+      const ::ompl::base::SpaceInformationPtr& _si,
+      constraint::MotionTestablePtr _motionTestable);
+
+  ~MotionValidator() override;
+
   /// Check if the path between two states, _s1 and _s2, is valid.  This
   /// function assumes _s1 is valid.
   /// \param _s1 The state at the start of the segment
@@ -43,8 +92,165 @@ public:
       const ::ompl::base::State* _s2,
       std::pair<::ompl::base::State*, double>& _lastValid) const override;
 
+  /// Sets the maximum number of segments whose validity is cached. The cache
+  /// is emptied when it is full. Zero, the default, disables caching.
+  /// \param _size Maximum number of cached segments
+  void setEdgeCacheSize(std::size_t _size);
+
+  /// Returns the maximum number of segments whose validity is cached.
+  std::size_t getEdgeCacheSize() const;
+
+  /// Removes all cached segments.
+  void clearEdgeCache();
+
+  /// Checks the samples of long segments in parallel in checkMotion() without
+  /// a last valid state. The calling thread and one worker thread per
+  /// additional checker each validate samples with their own checker, and all
+  /// of them stop at the first invalid sample. The checkers must not share
+  /// state that is unsafe to use concurrently, e.g. collision detectors.
+  /// Segments are checked serially with the SpaceInformation while another
+  /// thread uses the workers.
+  /// \param _validityCheckers One validity checker per thread, or none to
+  ///        check all segments serially
+  /// \throw std::invalid_argument if a checker is nullptr.
+  void setParallelValidityCheckers(
+      std::vector<::ompl::base::StateValidityCheckerPtr> _validityCheckers);
+
+  /// Returns the number of threads that check a segment in parallel, or 1 if
+  /// segments are checked serially.
+  std::size_t getNumParallelThreads() const;
+
 private:
+  /// Memory used to interpolate along a segment.
+  struct Scratch
+  {
+    /// Interpolated state.
+    ::ompl::base::State* mState;
+
+    /// State relative to the start of the segment.
+    statespace::StateSpace::State* mRelativeState;
+
+    /// Tangent vector of the segment.
+    Eigen::VectorXd mTangent;
+  };
+
+  /// Result of checking a segment.
+  struct EdgeResult
+  {
+    bool mValid;
+
+    /// Time of the last valid state, or NaN if it is unknown.
+    double mLastValidTime;
+  };
+
+  /// A segment whose samples are checked in parallel.
+  struct ParallelJob
+  {
+    const ::ompl::base::State* mS1;
+    const ::ompl::base::State* mS2;
+
+    /// Interpolation times of the samples.
+    std::vector<double> mTimes;
+
+    /// Index of the next sample to check.
+    std::atomic<std::size_t> mNextSample;
+
+    /// Whether an invalid sample was found, which cancels all workers.
+    std::atomic<bool> mInvalid;
+
+    /// First exception thrown by a validity checker.
+    std::exception_ptr mException;
+  };
+
+  /// Caches the aikido StateSpace and its interpolator.
+  void initialize();
+
+  /// Checks the samples at _times of the segment from _s1 to _s2 in parallel.
+  /// Returns false if the workers are busy with another segment.
+  bool checkMotionParallel(
+      const ::ompl::base::State* _s1,
+      const ::ompl::base::State* _s2,
+      const aikido::common::VanDerCorput& _times,
+      bool& _valid) const;
+
+  /// Checks samples of mJob with _validityChecker until none are left or one
+  /// is invalid.
+  void runJob(const ::ompl::base::StateValidityChecker& _validityChecker) const;
+
+  /// Main loop of the worker thread that uses checker _index, which waits for
+  /// jobs after _jobId.
+  void runWorker(std::size_t _index, std::size_t _jobId);
+
+  /// Stops and joins all worker threads.
+  void stopWorkers();
+
+  /// Returns unused scratch memory, allocating it if necessary.
+  std::unique_ptr<Scratch> acquireScratch() const;
+
+  /// Returns scratch memory obtained from acquireScratch().
+  void releaseScratch(std::unique_ptr<Scratch> _scratch) const;
+
+  /// Prepares _scratch to interpolate between _s1 and _s2.
+  void setSegment(
+      Scratch& _scratch,
+      const ::ompl::base::State* _s1,
+      const ::ompl::base::State* _s2) const;
+
+  /// Sets the state of _scratch to the state at time _t on the segment from
+  /// _s1 to _s2, after calling setSegment().
+  void interpolate(
+      Scratch& _scratch,
+      const ::ompl::base::State* _s1,
+      const ::ompl::base::State* _s2,
+      double _t) const;
+
+  /// Returns the key of the segment from _s1 to _s2 in the edge cache.
+  std::string getEdgeKey(
+      const ::ompl::base::State* _s1, const ::ompl::base::State* _s2) const;
+
+  /// Looks up the segment with key _key in the edge cache.
+  bool findEdge(const std::string& _key, EdgeResult& _result) const;
+
+  /// Stores the result of checking the segment with key _key.
+  void storeEdge(const std::string& _key, const EdgeResult& _result) const;
+
+  /// Checks the segment from _s1 to _s2 with mMotionTestable.
+  bool checkMotionTestable(
+      const ::ompl::base::State* _s1,
+      const ::ompl::base::State* _s2,
+      double& _lastValidTime) const;
+
   double mSequenceResolution;
+  constraint::MotionTestablePtr mMotionTestable;
+
+  /// The aikido StateSpace, or nullptr if the planning StateSpace is not a
+  /// GeometricStateSpace.
+  statespace::StateSpacePtr mAikidoStateSpace;
+
+  /// The interpolator of the planning StateSpace if it is geodesic.
+  std::shared_ptr<statespace::GeodesicInterpolator> mGeodesicInterpolator;
+
+  mutable std::mutex mScratchMutex;
+  mutable std::vector<std::unique_ptr<Scratch>> mScratch;
+
+  std::atomic<std::size_t> mEdgeCacheSize;
+  mutable std::mutex mEdgeCacheMutex;
+  mutable std::unordered_map<std::string, EdgeResult> mEdgeCache;
+
+  std::vector<::ompl::base::StateValidityCheckerPtr> mValidityCheckers;
+  std::vector<std::thread> mWorkers;
+
+  /// Held by the thread whose segment the workers are checking.
+  mutable std::mutex mJobMutex;
+  mutable ParallelJob mJob;
+
+  /// Protects the fields below, which signal the workers.
+  mutable std::mutex mWorkerMutex;
+  mutable std::condition_variable mJobStarted;
+  mutable std::condition_variable mJobFinished;
+  mutable std::size_t mJobId;
+  mutable std::size_t mNumBusyWorkers;
+  bool mStopWorkers;
 };
 
 } // namespace ompl
@@ -0,0 +1,137 @@
+#ifndef AIKIDO_PLANNER_OMPL_NEARESTNEIGHBORSADAPTER_HPP_
+#define AIKIDO_PLANNER_OMPL_NEARESTNEIGHBORSADAPTER_HPP_
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <ompl/datastructures/NearestNeighbors.h>
+#include "../../distance/NearestNeighbors.hpp"
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+/// Implements an OMPL NearestNeighbors data structure with an aikido
+/// distance::NearestNeighbors index, so OMPL planners use an index that
+/// understands the aikido DistanceMetric, e.g. KD-trees with SO2 wrap-around.
+///
+/// Distances are computed with the aikido DistanceMetric; the OMPL distance
+/// function is ignored.
+template <typename T>
+class NearestNeighborsAdapter : public ::ompl::NearestNeighbors<T>
+{
+public:
+  /// Function that returns the aikido state of an element.
+  using StateFunction
+      = std::function<const statespace::StateSpace::State*(const T&)>;
+
+  /// Constructor.
+  /// \param _metric Distance metric used by the index
+  /// \param _stateFunction Returns the aikido state of an element
+  NearestNeighborsAdapter(
+      distance::DistanceMetricPtr _metric, StateFunction _stateFunction)
+    : mIndex(distance::createNearestNeighbors(std::move(_metric)))
+    , mStateFunction(std::move(_stateFunction))
+  {
+    // Do nothing
+  }
+
+  // Documentation inherited.
+  bool reportsSortedResults() const override
+  {
+    return true;
+  }
+
+  // Documentation inherited.
+  void clear() override
+  {
+    mIndex->clear();
+    mData.clear();
+  }
+
+  // Documentation inherited.
+  void add(const T& _data) override
+  {
+    mIndex->add(mStateFunction(_data));
+    mData.push_back(_data);
+  }
+
+  // Documentation inherited.
+  void add(const std::vector<T>& _data) override
+  {
+    for (const auto& data : _data)
+      add(data);
+  }
+
+  // Documentation inherited.
+  bool remove(const T& _data) override
+  {
+    const auto it = std::find(mData.begin(), mData.end(), _data);
+    if (it == mData.end())
+      return false;
+
+    // The index does not support removal, so rebuild it.
+    mData.erase(it);
+    mIndex->clear();
+    for (const auto& data : mData)
+      mIndex->add(mStateFunction(data));
+    return true;
+  }
+
+  // Documentation inherited.
+  T nearest(const T& _data) const override
+  {
+    return mData[mIndex->nearest(mStateFunction(_data)).first];
+  }
+
+  // Documentation inherited.
+  void nearestK(const T& _data, std::size_t _k, std::vector<T>& _nbh)
+      const override
+  {
+    toData(mIndex->nearestK(mStateFunction(_data), _k), _nbh);
+  }
+
+  // Documentation inherited.
+  void nearestR(const T& _data, double _radius, std::vector<T>& _nbh)
+      const override
+  {
+    toData(mIndex->nearestR(mStateFunction(_data), _radius), _nbh);
+  }
+
+  // Documentation inherited.
+  std::size_t size() const override
+  {
+    return mData.size();
+  }
+
+  // Documentation inherited.
+  void list(std::vector<T>& _data) const override
+  {
+    _data = mData;
+  }
+
+private:
+  /// Looks up the elements of _neighbors.
+  void toData(
+      const std::vector<distance::NearestNeighbors::Neighbor>& _neighbors,
+      std::vector<T>& _nbh) const
+  {
+    _nbh.clear();
+    _nbh.reserve(_neighbors.size());
+    for (const auto& neighbor : _neighbors)
+      _nbh.push_back(mData[neighbor.first]);
+  }
+
+  std::unique_ptr<distance::NearestNeighbors> mIndex;
+  StateFunction mStateFunction;
+
+  /// Elements in the order in which they were added to mIndex.
+  std::vector<T> mData;
+};
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#endif // AIKIDO_PLANNER_OMPL_NEARESTNEIGHBORSADAPTER_HPP_
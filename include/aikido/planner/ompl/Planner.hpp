@@ -2,12 +2,17 @@
 #define AIKIDO_OMPL_OMPLPLANNER_HPP_
 
 #include <chrono>
+#include <functional>
+#include <string>
 #include <utility> // std::pair
+#include <vector>
 
+#include "../../common/RNG.hpp"
 #include "../../constraint/Projectable.hpp"
 #include "../../constraint/Sampleable.hpp"
 #include "../../constraint/Testable.hpp"
 #include "../../distance/DistanceMetric.hpp"
+#include "../../planner/PlanningResult.hpp"
 #include "../../planner/ompl/BackwardCompatibility.hpp"
 #include "../../planner/ompl/GeometricStateSpace.hpp"
 #include "../../statespace/Interpolator.hpp"
@@ -91,6 +96,20 @@ trajectory::InterpolatedPtr planOMPL(
 /// solution
 /// \param _maxDistanceBtwValidityChecks The maximum distance (under dmetric)
 /// between validity checking two successive points on a tree extension
+/// \param _goalQueueCapacity If positive, goals are sampled on a background
+/// thread into a queue of this capacity while the planner runs (see
+/// GoalRegion::startBackgroundSampling)
+/// \param _backgroundGoalSampler Sampleable used by the background thread in
+/// place of _goalSampler, defined on a StateSpace of the same structure as
+/// _stateSpace, e.g. of a clone of the skeleton
+/// \param _backgroundGoalTestable Testable used by the background thread in
+/// place of _goalTestable, defined on the StateSpace of
+/// _backgroundGoalSampler
+/// \throw std::invalid_argument if _goalQueueCapacity is positive and the
+/// background goal constraints are null or not defined on a separate
+/// StateSpace of the same structure as _stateSpace
+/// \throw Any exception thrown on the background thread, if no trajectory was
+/// found
 template <class PlannerType>
 trajectory::InterpolatedPtr planOMPL(
     const statespace::StateSpace::State* _start,
@@ -104,7 +123,10 @@ trajectory::InterpolatedPtr planOMPL(
     constraint::TestablePtr _boundsConstraint,
     constraint::ProjectablePtr _boundsProjector,
     double _maxPlanTime,
-    double _maxDistanceBtwValidityChecks);
+    double _maxDistanceBtwValidityChecks,
+    std::size_t _goalQueueCapacity = 0,
+    constraint::SampleablePtr _backgroundGoalSampler = nullptr,
+    constraint::TestablePtr _backgroundGoalTestable = nullptr);
 
 /// Use the CRRT planner to plan a trajectory that moves from the
 /// start to a goal region while respecting a constraint
@@ -139,6 +161,10 @@ trajectory::InterpolatedPtr planOMPL(
 /// extension
 /// \param _minStepsize The minimum distance between two states for the them to
 /// be considered "different"
+/// \param _useNativeNearestNeighbors If true, the tree indexes its aikido
+/// states under _dmetric with distance::createNearestNeighbors, see
+/// CRRT::setNearestNeighbors. Otherwise, it uses the default nearest
+/// neighbors structure of OMPL.
 trajectory::InterpolatedPtr planCRRT(
     const statespace::StateSpace::State* _start,
     constraint::TestablePtr _goalTestable,
@@ -154,7 +180,8 @@ trajectory::InterpolatedPtr planCRRT(
     double _maxPlanTime,
     double _maxExtensionDistance,
     double _maxDistanceBtwProjections,
-    double _minStepsize);
+    double _minStepsize,
+    bool _useNativeNearestNeighbors = false);
 
 /// Use the CRRT planner to plan a trajectory that moves from the
 /// start to a goal region while respecting a constraint
@@ -191,6 +218,10 @@ trajectory::InterpolatedPtr planCRRT(
 /// goal tree to consider them connected
 /// \param _minStepsize The minimum distance between two states for the them to
 /// be considered "different"
+/// \param _useNativeNearestNeighbors If true, the tree indexes its aikido
+/// states under _dmetric with distance::createNearestNeighbors, see
+/// CRRT::setNearestNeighbors. Otherwise, it uses the default nearest
+/// neighbors structure of OMPL.
 trajectory::InterpolatedPtr planCRRTConnect(
     const statespace::StateSpace::State* _start,
     constraint::TestablePtr _goalTestable,
@@ -207,7 +238,104 @@ trajectory::InterpolatedPtr planCRRTConnect(
     double _maxExtensionDistance,
     double _maxDistanceBtwProjections,
     double _minStepsize,
-    double _minTreeConnectionDistance);
+    double _minTreeConnectionDistance,
+    bool _useNativeNearestNeighbors = false);
+
+/// An OMPL planner raced by planOMPLPortfolio().
+struct PortfolioPlanner
+{
+  /// Name reported in the PlanningResult if this planner wins
+  std::string mName;
+
+  /// Creates the planner for a SpaceInformation
+  ::ompl::base::PlannerAllocator mAllocator;
+};
+
+/// Create a PortfolioPlanner that runs the template OMPL Planner type.
+/// \param _name Name of the planner
+template <class PlannerType>
+PortfolioPlanner createPortfolioPlanner(std::string _name);
+
+/// Components used by one planner of planOMPLPortfolio(). Every planner runs
+/// on its own thread, so the components of different planners must not share
+/// state that is unsafe to use concurrently. In particular, constraints on a
+/// MetaSkeletonStateSpace set the state of its skeleton, so every planner
+/// needs its own skeleton, e.g. a clone of the planning skeleton, with its own
+/// MetaSkeletonStateSpace, collision detector and constraints.
+struct PortfolioComponents
+{
+  /// The StateSpace that the planner plans within. It must have the same
+  /// structure as the StateSpace passed to planOMPLPortfolio().
+  statespace::StateSpacePtr mStateSpace;
+
+  /// An Interpolator defined on mStateSpace
+  statespace::InterpolatorPtr mInterpolator;
+
+  /// A valid distance metric defined on mStateSpace
+  distance::DistanceMetricPtr mDistanceMetric;
+
+  /// A Sampleable that can sample states from mStateSpace
+  constraint::SampleablePtr mSampler;
+
+  /// A constraint used to test validity during planning
+  constraint::TestablePtr mValidityConstraint;
+
+  /// A constraint used to determine whether states are within bounds
+  constraint::TestablePtr mBoundsConstraint;
+
+  /// A Projectable that projects a state back within bounds
+  constraint::ProjectablePtr mBoundsProjector;
+
+  /// A Testable that determines if a state is a goal state, only used when
+  /// planning to a goal region
+  constraint::TestablePtr mGoalTestable;
+
+  /// A Sampleable that samples goal states, only used when planning to a goal
+  /// region
+  constraint::SampleablePtr mGoalSampler;
+};
+
+/// Creates the components of the planner with index _index in the portfolio.
+/// Samplers should draw from _rng, which generates a different stream for
+/// every planner.
+using PortfolioComponentsFactory = std::function<PortfolioComponents(
+    std::size_t _index, std::unique_ptr<common::RNG> _rng)>;
+
+/// Race several OMPL planners on the same problem, each on its own thread with
+/// its own components, and return the trajectory of the first planner that
+/// finds an exact solution. Finding a solution terminates the other planners.
+/// The start and goal are converted into the StateSpace of each planner, and
+/// the solution back into _stateSpace. An exception of a planner is only
+/// rethrown if no planner finds a solution.
+/// \param _start The start state
+/// \param _goal The goal state, or nullptr to plan to the goal region given by
+/// the components of each planner
+/// \param _planners The planners to race
+/// \param _stateSpace The StateSpace of the start, goal and returned trajectory
+/// \param _interpolator An Interpolator defined on the StateSpace, used by the
+/// returned trajectory
+/// \param _componentsFactory Creates the components of each planner
+/// \param _rng Random engine used to seed the RNG of each planner
+/// \param _maxPlanTime The maximum time to allow the planners to search for a
+/// solution
+/// \param _maxDistanceBtwValidityChecks The maximum distance (under the
+/// distance metric of each planner) between validity checking two successive
+/// points on a tree extension
+/// \param[out] _planningResult Name of the planner that found the trajectory,
+/// if any, and time each planner ran
+/// \throw std::invalid_argument if the StateSpace of a planner has a different
+/// structure than _stateSpace.
+trajectory::InterpolatedPtr planOMPLPortfolio(
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    const std::vector<PortfolioPlanner>& _planners,
+    statespace::StateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator,
+    const PortfolioComponentsFactory& _componentsFactory,
+    common::RNG* _rng,
+    double _maxPlanTime,
+    double _maxDistanceBtwValidityChecks,
+    PlanningResult* _planningResult = nullptr);
 
 /// Generate an OMPL SpaceInformation from aikido components
 /// \param _statespace The StateSpace that the SpaceInformation operates on
@@ -312,6 +440,85 @@ std::pair<std::unique_ptr<trajectory::Interpolated>, bool> simplifyOMPL(
     std::size_t _maxEmptySteps,
     trajectory::InterpolatedPtr _originalTraj);
 
+/// Take in an aikido trajectory and simplify it using OMPL methods in an
+/// existing SpaceInformation
+/// \param _si The SpaceInformation used to check the shortened path
+/// \param _interpolator An Interpolator defined on the StateSpace. This is used
+/// to interpolate between two points within the space.
+/// \param _timeout Timeout, in seconds, after which the simplifier terminates
+/// to return possibly shortened path
+/// \param _maxEmptySteps Maximum number of consecutive failed attempts at
+/// shortening before simplification terminates. Default 0, equal to number
+/// of states in the path
+/// \param _originalTraj The untimed trajectory obtained from the planner,
+/// needs simplifying.
+std::pair<std::unique_ptr<trajectory::Interpolated>, bool> simplifyOMPL(
+    const ::ompl::base::SpaceInformationPtr& _si,
+    statespace::InterpolatorPtr _interpolator,
+    double _timeout,
+    std::size_t _maxEmptySteps,
+    trajectory::InterpolatedPtr _originalTraj);
+
+/// Take in an aikido trajectory and shorten it with random shortcuts proposed
+/// in parallel. A pool of worker threads, one per validity constraint, is
+/// started once. In every round, each worker attempts several shortcuts
+/// between two random points on different segments of the path and checks
+/// them with its own validity constraint. The valid shortcuts that shorten the
+/// path are then applied greedily by decreasing improvement, skipping those
+/// whose segments overlap a shortcut already applied in the round.
+///
+/// Simplification stops when the timeout or the attempt budget is reached, or
+/// after \c _maxEmptySteps consecutive failed attempts. With an infinite
+/// timeout and an attempt budget, the result depends only on the seed of
+/// \c _rng and the number of workers, which makes it reproducible.
+///
+/// Constraints that set the state of a skeleton, e.g. collision constraints,
+/// must each be defined on their own StateSpace, e.g. a MetaSkeletonStateSpace
+/// of a clone of the skeleton. States are converted into the StateSpace of
+/// each constraint before they are checked. The StateSpace, interpolator,
+/// distance metric and bounds constraint are used concurrently by all
+/// workers, so they must be safe to use from multiple threads.
+///
+/// \param _stateSpace The StateSpace that the planner must plan within
+/// \param _interpolator An Interpolator defined on the StateSpace. This is used
+/// to interpolate between two points within the space.
+/// \param _dmetric A valid distance metric defined on the StateSpace
+/// \param _validityConstraints One validity constraint per worker thread. Each
+/// constraint is used by a single thread, and its StateSpace must have the
+/// same structure as \c _stateSpace.
+/// \param _boundsConstraint A constraint used to determine whether states
+/// encountered during simplification fall within any bounds specified on the
+/// StateSpace
+/// \param _rng Random number generator used to seed the workers
+/// \param _maxDistanceBtwValidityChecks The maximum distance (under dmetric)
+/// between validity checking two successive points on a shortcut
+/// \param _timeout Timeout, in seconds, after which the simplifier terminates
+/// to return possibly shortened path. Infinity disables the timeout.
+/// \param _maxAttempts Maximum number of shortcut attempts. Default 0 disables
+/// the budget.
+/// \param _maxEmptySteps Maximum number of consecutive failed attempts at
+/// shortening before simplification terminates. Default 0, equal to number
+/// of states in the path
+/// \param _originalTraj The untimed trajectory obtained from the planner,
+/// needs simplifying.
+/// \return Simplified trajectory, and whether it was shortened
+/// \throw std::invalid_argument if an argument is invalid, or if the
+/// StateSpace of a validity constraint has a different structure than
+/// \c _stateSpace.
+std::pair<std::unique_ptr<trajectory::Interpolated>, bool>
+simplifyOMPLParallel(
+    statespace::StateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator,
+    distance::DistanceMetricPtr _dmetric,
+    const std::vector<constraint::TestablePtr>& _validityConstraints,
+    constraint::TestablePtr _boundsConstraint,
+    common::RNG* _rng,
+    double _maxDistanceBtwValidityChecks,
+    double _timeout,
+    std::size_t _maxAttempts,
+    std::size_t _maxEmptySteps,
+    trajectory::InterpolatedPtr _originalTraj);
+
 /// Take an interpolated trajectory and convert it into OMPL geometric path
 /// \param _interpolatedTraj the interpolated trajectory to be converted
 /// \param _sspace The space information pointer.
@@ -329,6 +536,18 @@ std::unique_ptr<trajectory::Interpolated> toInterpolatedTrajectory(
     const ::ompl::geometric::PathGeometric& _path,
     statespace::InterpolatorPtr _interpolator);
 
+/// Take an OMPL geometric path and convert it into an interpolated trajectory
+/// without copying its states. If the path is defined on the StateSpace of
+/// \c _interpolator, the trajectory takes over the aikido states of the path,
+/// which must only be destroyed afterwards. Otherwise the states are copied.
+/// \param _path The OMPL geometric path
+/// \param _interpolator An Interpolator defined on the StateSpace. This is used
+/// to interpolate between two points within the space.
+/// returns the corresponding interpolated trajectory
+std::unique_ptr<trajectory::Interpolated> toInterpolatedTrajectory(
+    ::ompl::geometric::PathGeometric&& _path,
+    statespace::InterpolatorPtr _interpolator);
+
 } // namespace ompl
 } // namespace planner
 } // namespace aikido
@@ -0,0 +1,148 @@
+#ifndef AIKIDO_PLANNER_OMPL_PLANNINGCONTEXT_HPP_
+#define AIKIDO_PLANNER_OMPL_PLANNINGCONTEXT_HPP_
+
+#include <memory>
+#include <utility>
+#include <ompl/base/Planner.h>
+#include <ompl/base/ProblemDefinition.h>
+#include <ompl/base/SpaceInformation.h>
+#include "../../constraint/Projectable.hpp"
+#include "../../constraint/Sampleable.hpp"
+#include "../../constraint/Testable.hpp"
+#include "../../distance/DistanceMetric.hpp"
+#include "../../statespace/Interpolator.hpp"
+#include "../../statespace/StateSpace.hpp"
+#include "../../trajectory/Interpolated.hpp"
+#include "BackwardCompatibility.hpp"
+#include "GeometricStateSpace.hpp"
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+/// Components for planning repeatedly in the same StateSpace under the same
+/// constraints.
+///
+/// The SpaceInformation, with its GeometricStateSpace, StateValidityChecker
+/// and MotionValidator, is created and set up once. The planner is set up on
+/// the first query and only cleared between queries, so it keeps the data
+/// structures it allocated, e.g. its nearest neighbor trees, and the
+/// GeometricStateSpace keeps its pool of states. Each query only resets the
+/// start and goal of a ProblemDefinition that is also reused.
+///
+/// The MotionValidator caches the validity of segments. The validity of
+/// states may change between queries, e.g. because obstacles moved, so the
+/// cache is cleared on every query.
+class PlanningContext
+{
+public:
+  /// Constructor.
+  /// \param _stateSpace The StateSpace that the planner must plan within
+  /// \param _interpolator An Interpolator defined on the StateSpace. This is
+  /// used to interpolate between two points within the space.
+  /// \param _dmetric A valid distance metric defined on the StateSpace
+  /// \param _sampler A Sampleable that can sample states from the
+  /// StateSpace
+  /// \param _validityConstraint A constraint used to test validity during
+  /// planning
+  /// \param _boundsConstraint A constraint used to determine whether states
+  /// encountered during planning fall within any bounds specified on the
+  /// StateSpace
+  /// \param _boundsProjector A Projectable that projects a state back within
+  /// valid bounds defined on the StateSpace
+  /// \param _maxDistanceBtwValidityChecks The maximum distance (under dmetric)
+  /// between validity checking two successive points on a tree extension
+  /// \throw std::invalid_argument if an argument is invalid, as in
+  /// getSpaceInformation().
+  PlanningContext(
+      statespace::StateSpacePtr _stateSpace,
+      statespace::InterpolatorPtr _interpolator,
+      distance::DistanceMetricPtr _dmetric,
+      constraint::SampleablePtr _sampler,
+      constraint::TestablePtr _validityConstraint,
+      constraint::TestablePtr _boundsConstraint,
+      constraint::ProjectablePtr _boundsProjector,
+      double _maxDistanceBtwValidityChecks);
+
+  /// Returns the SpaceInformation shared by all queries.
+  ::ompl::base::SpaceInformationPtr getSpaceInformation() const;
+
+  /// Sets the planner used by plan().
+  /// \param _planner Planner created on getSpaceInformation()
+  /// \throw std::invalid_argument if \c _planner is nullptr or uses another
+  /// SpaceInformation.
+  void setPlanner(::ompl::base::PlannerPtr _planner);
+
+  /// Sets the planner used by plan() to a new planner of the template OMPL
+  /// Planner type.
+  template <class PlannerType>
+  void setPlanner();
+
+  /// Returns the planner used by plan(), or nullptr if none is set.
+  ::ompl::base::PlannerPtr getPlanner() const;
+
+  /// Plans a trajectory that moves from the start to the goal state. Returns
+  /// nullptr on planning failure.
+  /// \param _start The start state
+  /// \param _goal The goal state
+  /// \param _maxPlanTime The maximum time to allow the planner to search for a
+  /// solution
+  /// \throw std::runtime_error if no planner is set.
+  trajectory::InterpolatedPtr plan(
+      const statespace::StateSpace::State* _start,
+      const statespace::StateSpace::State* _goal,
+      double _maxPlanTime);
+
+  /// Plans a trajectory that moves from the start to a goal region. Returns
+  /// nullptr on planning failure.
+  /// \param _start The start state
+  /// \param _goalTestable A Testable constraint that can determine if a given
+  /// state is a goal state
+  /// \param _goalSampler A Sampleable capable of sampling states that satisfy
+  /// _goalTestable
+  /// \param _maxPlanTime The maximum time to allow the planner to search for a
+  /// solution
+  /// \throw std::runtime_error if no planner is set.
+  trajectory::InterpolatedPtr plan(
+      const statespace::StateSpace::State* _start,
+      constraint::TestablePtr _goalTestable,
+      constraint::SampleablePtr _goalSampler,
+      double _maxPlanTime);
+
+  /// Simplifies a trajectory with OMPL methods, see simplifyOMPL().
+  /// \param _timeout Timeout, in seconds, after which the simplifier
+  /// terminates to return possibly shortened path
+  /// \param _maxEmptySteps Maximum number of consecutive failed attempts at
+  /// shortening before simplification terminates
+  /// \param _originalTraj The untimed trajectory to simplify
+  std::pair<std::unique_ptr<trajectory::Interpolated>, bool> simplify(
+      double _timeout,
+      std::size_t _maxEmptySteps,
+      trajectory::InterpolatedPtr _originalTraj);
+
+private:
+  /// Removes the start, goal and solutions of the previous query, and clears
+  /// the planner data.
+  void resetProblem();
+
+  /// Runs the planner on the current ProblemDefinition.
+  trajectory::InterpolatedPtr solve(double _maxPlanTime);
+
+  /// Empties the edge cache of the MotionValidator, if it has one.
+  void clearEdgeCache();
+
+  statespace::StateSpacePtr mStateSpace;
+  statespace::InterpolatorPtr mInterpolator;
+  ::ompl::base::SpaceInformationPtr mSpaceInformation;
+  ompl_shared_ptr<GeometricStateSpace> mGeometricStateSpace;
+  ::ompl::base::ProblemDefinitionPtr mProblemDefinition;
+  ::ompl::base::PlannerPtr mPlanner;
+};
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#include "detail/PlanningContext-impl.hpp"
+
+#endif // AIKIDO_PLANNER_OMPL_PLANNINGCONTEXT_HPP_
@@ -0,0 +1,114 @@
+#ifndef AIKIDO_OMPL_TANGENTSPACEINFORMEDSAMPLER_HPP_
+#define AIKIDO_OMPL_TANGENTSPACEINFORMEDSAMPLER_HPP_
+
+#include <Eigen/Core>
+#include "../../planner/ompl/BackwardCompatibility.hpp"
+
+#if OMPL_VERSION_AT_LEAST(1, 2, 0)
+
+#include <ompl/base/samplers/InformedStateSampler.h>
+#include <ompl/util/RandomNumbers.h>
+#include "../../distance/DistanceMetric.hpp"
+#include "../../statespace/StateSpace.hpp"
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+/// Informed sampler for path length objectives in a GeometricStateSpace.
+///
+/// States whose path through them from the start to the goal could be
+/// shorter than the current solution lie in a prolate hyperspheroid with the
+/// start and the goal as foci. This sampler samples that hyperspheroid in the
+/// tangent space at the start state, i.e. in the coordinates given by the
+/// log map of the aikido StateSpace, and maps the samples to states with the
+/// exponential map. Every tangent coordinate is scaled by the weight of its
+/// subspace in the distance metric, so the hyperspheroid contains every state
+/// that can improve the solution when the metric is a weighted sum of
+/// Euclidean distances; samples that can't are rejected.
+///
+/// Informed sampling requires a single start state, a single goal state and
+/// a Euclidean metric or a CartesianProductWeighted of them. Angular metrics
+/// are not supported, since the hyperspheroid in the tangent space at the
+/// start misses states that are closer through wrap-around or curvature.
+/// Otherwise, states are sampled uniformly and rejected if they can't improve
+/// the solution.
+class TangentSpaceInformedSampler : public ::ompl::base::InformedSampler
+{
+public:
+  /// Constructor.
+  /// \param _problem The problem to sample for. Its SpaceInformation must use
+  /// a GeometricStateSpace.
+  /// \param _maxNumberCalls Maximum number of attempts to draw a sample
+  /// \throws std::invalid_argument if the problem is not defined on a
+  /// GeometricStateSpace
+  TangentSpaceInformedSampler(
+      const ::ompl::base::ProblemDefinitionPtr& _problem,
+      unsigned int _maxNumberCalls);
+
+  ~TangentSpaceInformedSampler() override;
+
+  // Documentation inherited.
+  bool sampleUniform(
+      ::ompl::base::State* _state, const ::ompl::base::Cost& _maxCost) override;
+
+  // Documentation inherited.
+  bool sampleUniform(
+      ::ompl::base::State* _state,
+      const ::ompl::base::Cost& _minCost,
+      const ::ompl::base::Cost& _maxCost) override;
+
+  /// Return true if samples are drawn from the prolate hyperspheroid.
+  bool hasInformedMeasure() const override;
+
+  /// Return the measure of the prolate hyperspheroid of paths shorter than
+  /// _currentCost, or the measure of the space if that is smaller or
+  /// sampling is not informed.
+  /// \param _currentCost The cost of the current solution
+  double getInformedMeasure(
+      const ::ompl::base::Cost& _currentCost) const override;
+
+private:
+  /// Returns the cost of the shortest path from the start to the goal that
+  /// passes through _state.
+  ::ompl::base::Cost computeHeuristicCost(
+      const ::ompl::base::State* _state) const;
+
+  /// Samples a state in the prolate hyperspheroid of paths of length
+  /// _maxCost, within the bounds of the space.
+  bool sampleInformed(::ompl::base::State* _state, double _maxCost);
+
+  ::ompl::base::SpaceInformationPtr mSpaceInformation;
+  ::ompl::base::OptimizationObjectivePtr mObjective;
+  ::ompl::base::StateSamplerPtr mUniformSampler;
+  ::ompl::RNG mRng;
+
+  statespace::StateSpacePtr mStateSpace;
+
+  /// Start and goal states, owned by this sampler.
+  ::ompl::base::State* mStart;
+  ::ompl::base::State* mGoal;
+
+  /// Whether samples are drawn from the prolate hyperspheroid.
+  bool mIsInformed;
+
+  /// Scale of each tangent coordinate under the distance metric.
+  Eigen::VectorXd mWeights;
+
+  /// Scaled tangent vector from the start to the goal.
+  Eigen::VectorXd mGoalTangent;
+
+  /// Reflection that maps the first axis onto mGoalTangent.
+  Eigen::MatrixXd mRotation;
+
+  /// Scratch state for the exponential map.
+  statespace::StateSpace::State* mTangentState;
+};
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#endif // OMPL_VERSION_AT_LEAST(1, 2, 0)
+
+#endif // AIKIDO_OMPL_TANGENTSPACEINFORMEDSAMPLER_HPP_
@@ -0,0 +1,71 @@
+#include "../../../constraint/TestableIntersection.hpp"
+#include "../Planner.hpp"
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+//==============================================================================
+template <class PlannerType>
+trajectory::InterpolatedPtr planOMPLWithExperience(
+    ExperienceLibrary& _library,
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    constraint::SampleablePtr _sampler,
+    constraint::TestablePtr _validityConstraint,
+    constraint::TestablePtr _boundsConstraint,
+    constraint::ProjectablePtr _boundsProjector,
+    double _maxRepairTime,
+    double _maxPlanTime,
+    double _maxDistanceBtwValidityChecks,
+    std::size_t _numCandidates,
+    PlanningResult* _planningResult)
+{
+  if (!_validityConstraint)
+    throw std::invalid_argument("Validity constraint is nullptr.");
+
+  if (!_boundsConstraint)
+    throw std::invalid_argument("Bounds constraint is nullptr.");
+
+  auto stateSpace = _library.getStateSpace();
+  auto interpolator = _library.getInterpolator();
+  auto dmetric = _library.getDistanceMetric();
+
+  // Stored paths must also be within bounds.
+  std::vector<constraint::TestablePtr> constraints{_validityConstraint,
+                                                   _boundsConstraint};
+  auto pathConstraint = std::make_shared<constraint::TestableIntersection>(
+      stateSpace, constraints);
+
+  auto localPlanner = [&](const statespace::StateSpace::State* _localStart,
+                          const statespace::StateSpace::State* _localGoal,
+                          double _maxLocalPlanTime) {
+    return planOMPL<PlannerType>(
+        _localStart,
+        _localGoal,
+        stateSpace,
+        interpolator,
+        dmetric,
+        _sampler,
+        _validityConstraint,
+        _boundsConstraint,
+        _boundsProjector,
+        _maxLocalPlanTime,
+        _maxDistanceBtwValidityChecks);
+  };
+
+  return _library.plan(
+      _start,
+      _goal,
+      localPlanner,
+      std::move(pathConstraint),
+      _maxDistanceBtwValidityChecks,
+      _maxRepairTime,
+      _maxPlanTime,
+      _numCandidates,
+      _planningResult);
+}
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
@@ -3,6 +3,7 @@
 #include "../../../trajectory/Interpolated.hpp"
 #include "../GeometricStateSpace.hpp"
 #include "../GoalRegion.hpp"
+#include "../InformedPathLengthObjective.hpp"
 #include "../StateValidityChecker.hpp"
 
 namespace aikido {
@@ -48,6 +49,12 @@ trajectory::InterpolatedPtr planOMPL(
   sspace->freeState(start);
   sspace->freeState(goal);
 
+#if OMPL_VERSION_AT_LEAST(1, 2, 0)
+  // Lets informed planners sample the aikido StateSpace.
+  pdef->setOptimizationObjective(
+      ompl_make_shared<InformedPathLengthObjective>(si));
+#endif
+
   auto planner = ompl_make_shared<PlannerType>(si);
   return planOMPL(
       planner,
@@ -71,7 +78,10 @@ trajectory::InterpolatedPtr planOMPL(
     constraint::TestablePtr _boundsConstraint,
     constraint::ProjectablePtr _boundsProjector,
     double _maxPlanTime,
-    double _maxDistanceBtwValidityChecks)
+    double _maxDistanceBtwValidityChecks,
+    std::size_t _goalQueueCapacity,
+    constraint::SampleablePtr _backgroundGoalSampler,
+    constraint::TestablePtr _backgroundGoalTestable)
 {
   if (_goalTestable == nullptr)
   {
@@ -115,13 +125,52 @@ trajectory::InterpolatedPtr planOMPL(
       si, std::move(_goalTestable), _goalSampler->createSampleGenerator());
   pdef->setGoal(goalRegion);
 
+#if OMPL_VERSION_AT_LEAST(1, 2, 0)
+  // Lets informed planners sample the aikido StateSpace.
+  pdef->setOptimizationObjective(
+      ompl_make_shared<InformedPathLengthObjective>(si));
+#endif
+
+  if (_goalQueueCapacity > 0)
+  {
+    if (_backgroundGoalSampler == nullptr)
+    {
+      throw std::invalid_argument("Background Sampleable goal is nullptr.");
+    }
+
+    goalRegion->startBackgroundSampling(
+        _goalQueueCapacity,
+        _backgroundGoalSampler->createSampleGenerator(),
+        std::move(_backgroundGoalTestable));
+  }
+
   auto planner = ompl_make_shared<PlannerType>(si);
-  return planOMPL(
+  auto trajectory = planOMPL(
       planner,
       pdef,
       std::move(_stateSpace),
       std::move(_interpolator),
       _maxPlanTime);
+
+  // A failure of background goal sampling only matters if it prevented the
+  // planner from finding a trajectory.
+  const auto exception = goalRegion->stopBackgroundSampling();
+  if (!trajectory && exception)
+    std::rethrow_exception(exception);
+
+  return trajectory;
+}
+
+//==============================================================================
+template <class PlannerType>
+PortfolioPlanner createPortfolioPlanner(std::string _name)
+{
+  PortfolioPlanner planner;
+  planner.mName = std::move(_name);
+  planner.mAllocator = [](const ::ompl::base::SpaceInformationPtr& _si) {
+    return ::ompl::base::PlannerPtr(ompl_make_shared<PlannerType>(_si));
+  };
+  return planner;
 }
 
 } // namespace ompl
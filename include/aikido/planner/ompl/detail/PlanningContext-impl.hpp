@@ -0,0 +1,14 @@
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+//==============================================================================
+template <class PlannerType>
+void PlanningContext::setPlanner()
+{
+  setPlanner(ompl_make_shared<PlannerType>(mSpaceInformation));
+}
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
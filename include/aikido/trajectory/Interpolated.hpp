@@ -1,6 +1,7 @@
 #ifndef AIKIDO_TRAJECTORY_PIECEWISELINEAR_TRAJECTORY_HPP_
 #define AIKIDO_TRAJECTORY_PIECEWISELINEAR_TRAJECTORY_HPP_
 
+#include <vector>
 #include "../statespace/GeodesicInterpolator.hpp"
 #include "Trajectory.hpp"
 
@@ -26,6 +27,26 @@ public:
   void addWaypoint(
       double _t, const aikido::statespace::StateSpace::State* _state);
 
+  /// Add waypoints after the last waypoint of the trajectory, in O(n) for n
+  /// waypoints instead of a sorted insertion for each waypoint.
+  ///
+  /// \param _times times of the waypoints, in increasing order
+  /// \param _states states at the waypoints
+  /// \throw std::invalid_argument if the numbers of times and states differ,
+  /// or if the times are not increasing or not after the last waypoint.
+  void addWaypoints(
+      const std::vector<double>& _times,
+      const std::vector<const aikido::statespace::StateSpace::State*>&
+          _states);
+
+  /// Add a waypoint to the trajectory at the given time without copying its
+  /// state. The trajectory takes ownership of \c _state, which must have
+  /// been allocated with \c allocateState() of its StateSpace.
+  ///
+  /// \param _t time of the waypoint
+  /// \param _state state at the waypoint
+  void adoptWaypoint(double _t, aikido::statespace::StateSpace::State* _state);
+
   /// Gets a waypoint.
   ///
   /// \param _index waypoint index
@@ -89,6 +110,9 @@ private:
   /// trajectory.
   int getWaypointIndexAfterTime(double _t) const;
 
+  /// Inserts a waypoint that owns _state, keeping the waypoints sorted.
+  void insertWaypoint(double _t, aikido::statespace::StateSpace::State* _state);
+
   aikido::statespace::StateSpacePtr mStateSpace;
   aikido::statespace::InterpolatorPtr mInterpolator;
   std::vector<Waypoint> mWaypoints;
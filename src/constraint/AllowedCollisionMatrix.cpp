@@ -0,0 +1,311 @@
+#include <aikido/constraint/AllowedCollisionMatrix.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <dart/collision/CollisionGroup.hpp>
+#include <dart/collision/CollisionObject.hpp>
+#include <dart/collision/CollisionOption.hpp>
+#include <dart/collision/CollisionResult.hpp>
+#include "detail/CollisionObjectHelpers.hpp"
+
+namespace aikido {
+namespace constraint {
+
+namespace {
+
+/// Identifies a stream written by AllowedCollisionMatrix::saveBinary().
+constexpr std::uint32_t kBinaryMagic = 0x4d434141; // "AACM"
+constexpr std::uint32_t kBinaryVersion = 1;
+
+//==============================================================================
+template <typename T>
+void writeValue(std::ostream& _stream, const T& _value)
+{
+  _stream.write(reinterpret_cast<const char*>(&_value), sizeof(T));
+}
+
+//==============================================================================
+template <typename T>
+T readValue(std::istream& _stream)
+{
+  T value;
+  if (!_stream.read(reinterpret_cast<char*>(&value), sizeof(T)))
+    throw std::runtime_error("Unexpected end of AllowedCollisionMatrix data.");
+  return value;
+}
+
+//==============================================================================
+void writeString(std::ostream& _stream, const std::string& _value)
+{
+  writeValue<std::uint64_t>(_stream, _value.size());
+  _stream.write(_value.data(), _value.size());
+}
+
+//==============================================================================
+std::string readString(std::istream& _stream)
+{
+  const auto size = readValue<std::uint64_t>(_stream);
+  std::string value(size, '\0');
+  if (size > 0 && !_stream.read(&value[0], size))
+    throw std::runtime_error("Unexpected end of AllowedCollisionMatrix data.");
+  return value;
+}
+
+} // namespace
+
+//==============================================================================
+void AllowedCollisionMatrix::setPairType(
+    const std::string& _bodyNode1,
+    const std::string& _bodyNode2,
+    CollisionPairType _type)
+{
+  if (_bodyNode1 == _bodyNode2)
+  {
+    std::stringstream msg;
+    msg << "Cannot classify body node '" << _bodyNode1
+        << "' against itself.";
+    throw std::invalid_argument(msg.str());
+  }
+
+  mPairs[makeKey(_bodyNode1, _bodyNode2)] = _type;
+}
+
+//==============================================================================
+CollisionPairType AllowedCollisionMatrix::getPairType(
+    const std::string& _bodyNode1, const std::string& _bodyNode2) const
+{
+  const auto it = mPairs.find(makeKey(_bodyNode1, _bodyNode2));
+  if (it == mPairs.end())
+    return CollisionPairType::SOMETIMES;
+
+  return it->second;
+}
+
+//==============================================================================
+bool AllowedCollisionMatrix::needsCheck(
+    const std::string& _bodyNode1, const std::string& _bodyNode2) const
+{
+  return getPairType(_bodyNode1, _bodyNode2) == CollisionPairType::SOMETIMES;
+}
+
+//==============================================================================
+std::size_t AllowedCollisionMatrix::getNumPairs() const
+{
+  return mPairs.size();
+}
+
+//==============================================================================
+std::vector<std::pair<std::string, std::string>>
+AllowedCollisionMatrix::getPairs(CollisionPairType _type) const
+{
+  std::vector<std::pair<std::string, std::string>> pairs;
+  for (const auto& pair : mPairs)
+  {
+    if (pair.second == _type)
+      pairs.emplace_back(pair.first);
+  }
+  return pairs;
+}
+
+//==============================================================================
+void AllowedCollisionMatrix::saveBinary(std::ostream& _stream) const
+{
+  writeValue(_stream, kBinaryMagic);
+  writeValue(_stream, kBinaryVersion);
+  writeValue<std::uint64_t>(_stream, mPairs.size());
+
+  for (const auto& pair : mPairs)
+  {
+    writeString(_stream, pair.first.first);
+    writeString(_stream, pair.first.second);
+    writeValue<std::uint8_t>(_stream, static_cast<std::uint8_t>(pair.second));
+  }
+
+  if (!_stream)
+    throw std::runtime_error("Failed writing AllowedCollisionMatrix.");
+}
+
+//==============================================================================
+AllowedCollisionMatrix AllowedCollisionMatrix::loadBinary(std::istream& _stream)
+{
+  if (readValue<std::uint32_t>(_stream) != kBinaryMagic)
+  {
+    throw std::runtime_error(
+        "Stream does not contain an AllowedCollisionMatrix.");
+  }
+
+  const auto version = readValue<std::uint32_t>(_stream);
+  if (version != kBinaryVersion)
+  {
+    std::stringstream msg;
+    msg << "Unsupported AllowedCollisionMatrix version " << version
+        << ", expected " << kBinaryVersion << ".";
+    throw std::runtime_error(msg.str());
+  }
+
+  AllowedCollisionMatrix matrix;
+  const auto numPairs = readValue<std::uint64_t>(_stream);
+  for (std::uint64_t i = 0; i < numPairs; ++i)
+  {
+    const auto bodyNode1 = readString(_stream);
+    const auto bodyNode2 = readString(_stream);
+    const auto type = readValue<std::uint8_t>(_stream);
+
+    if (type > static_cast<std::uint8_t>(CollisionPairType::ADJACENT))
+    {
+      std::stringstream msg;
+      msg << "Invalid collision pair type " << static_cast<int>(type)
+          << " for pair ('" << bodyNode1 << "', '" << bodyNode2 << "').";
+      throw std::runtime_error(msg.str());
+    }
+
+    matrix.setPairType(
+        bodyNode1, bodyNode2, static_cast<CollisionPairType>(type));
+  }
+
+  return matrix;
+}
+
+//==============================================================================
+AllowedCollisionMatrix::Key AllowedCollisionMatrix::makeKey(
+    const std::string& _bodyNode1, const std::string& _bodyNode2)
+{
+  if (_bodyNode1 < _bodyNode2)
+    return Key(_bodyNode1, _bodyNode2);
+  else
+    return Key(_bodyNode2, _bodyNode1);
+}
+
+//==============================================================================
+AllowedCollisionMatrix computeAllowedCollisionMatrix(
+    statespace::dart::MetaSkeletonStateSpacePtr _stateSpace,
+    std::shared_ptr<dart::collision::CollisionDetector> _collisionDetector,
+    const Sampleable& _sampleable,
+    std::size_t _numSamples)
+{
+  if (!_stateSpace)
+    throw std::invalid_argument("_stateSpace is nullptr.");
+
+  if (!_collisionDetector)
+    throw std::invalid_argument("_collisionDetector is nullptr.");
+
+  if (_numSamples == 0)
+    throw std::invalid_argument("_numSamples must be positive.");
+
+  if (_sampleable.getStateSpace() != _stateSpace)
+    throw std::invalid_argument("_sampleable does not match _stateSpace.");
+
+  const auto metaSkeleton = _stateSpace->getMetaSkeleton();
+  const std::size_t numBodyNodes = metaSkeleton->getNumBodyNodes();
+
+  std::set<std::string> names;
+  auto group = _collisionDetector->createCollisionGroup();
+  for (std::size_t i = 0; i < numBodyNodes; ++i)
+  {
+    const auto bodyNode = metaSkeleton->getBodyNode(i);
+    if (!names.insert(bodyNode->getName()).second)
+    {
+      std::stringstream msg;
+      msg << "Body node name '" << bodyNode->getName()
+          << "' is not unique in MetaSkeleton '" << metaSkeleton->getName()
+          << "'.";
+      throw std::invalid_argument(msg.str());
+    }
+
+    group->addShapeFramesOf(bodyNode);
+  }
+
+  // Report every colliding pair instead of stopping at the first contact,
+  // and bypass the default filter that ignores adjacent body nodes.
+  const dart::collision::CollisionOption option(
+      false, std::numeric_limits<std::size_t>::max(), nullptr);
+
+  std::vector<std::size_t> collisionCounts(numBodyNodes * numBodyNodes, 0);
+  std::vector<bool> isColliding(numBodyNodes * numBodyNodes);
+
+  const Eigen::VectorXd savedPositions = metaSkeleton->getPositions();
+  auto generator = _sampleable.createSampleGenerator();
+  auto state = _stateSpace->createState();
+
+  for (std::size_t isample = 0; isample < _numSamples; ++isample)
+  {
+    if (!generator->canSample() || !generator->sample(state))
+    {
+      metaSkeleton->setPositions(savedPositions);
+
+      std::stringstream msg;
+      msg << "Failed to sample configuration " << isample << " of "
+          << _numSamples << ".";
+      throw std::runtime_error(msg.str());
+    }
+
+    _stateSpace->setState(state);
+
+    dart::collision::CollisionResult result;
+    _collisionDetector->collide(group.get(), option, &result);
+
+    // A pair may produce several contacts; count it once per sample.
+    std::fill(isColliding.begin(), isColliding.end(), false);
+    for (std::size_t icontact = 0; icontact < result.getNumContacts();
+         ++icontact)
+    {
+      const auto& contact = result.getContact(icontact);
+      const auto bodyNode1 = detail::getBodyNode(contact.collisionObject1);
+      const auto bodyNode2 = detail::getBodyNode(contact.collisionObject2);
+      if (!bodyNode1 || !bodyNode2 || bodyNode1 == bodyNode2)
+        continue;
+
+      const auto index1 = metaSkeleton->getIndexOf(bodyNode1, false);
+      const auto index2 = metaSkeleton->getIndexOf(bodyNode2, false);
+      if (index1 == dart::dynamics::INVALID_INDEX
+          || index2 == dart::dynamics::INVALID_INDEX)
+        continue;
+
+      const auto pairIndex = std::min(index1, index2) * numBodyNodes
+                             + std::max(index1, index2);
+      if (!isColliding[pairIndex])
+      {
+        isColliding[pairIndex] = true;
+        ++collisionCounts[pairIndex];
+      }
+    }
+  }
+
+  metaSkeleton->setPositions(savedPositions);
+
+  AllowedCollisionMatrix matrix;
+  for (std::size_t i = 0; i < numBodyNodes; ++i)
+  {
+    const auto bodyNode1 = metaSkeleton->getBodyNode(i);
+
+    for (std::size_t j = i + 1; j < numBodyNodes; ++j)
+    {
+      const auto bodyNode2 = metaSkeleton->getBodyNode(j);
+      const auto count = collisionCounts[i * numBodyNodes + j];
+
+      CollisionPairType type;
+      if (bodyNode1->getParentBodyNode() == bodyNode2
+          || bodyNode2->getParentBodyNode() == bodyNode1)
+        type = CollisionPairType::ADJACENT;
+      else if (count == 0)
+        type = CollisionPairType::NEVER;
+      else if (count == _numSamples)
+        type = CollisionPairType::ALWAYS;
+      else
+        type = CollisionPairType::SOMETIMES;
+
+      matrix.setPairType(bodyNode1->getName(), bodyNode2->getName(), type);
+    }
+  }
+
+  return matrix;
+}
+
+} // namespace constraint
+} // namespace aikido
@@ -67,5 +67,11 @@ bool CartesianProductTestable::isSatisfied(
   return true;
 }
 
+//==============================================================================
+const std::vector<TestablePtr>& CartesianProductTestable::getConstraints() const
+{
+  return mConstraints;
+}
+
 } // namespace constraint
 } // namespace aikido
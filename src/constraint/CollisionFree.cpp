@@ -1,8 +1,67 @@
 #include <aikido/constraint/CollisionFree.hpp>
 
+#include <set>
+#include <dart/collision/CollisionObject.hpp>
+#include "detail/CollisionObjectHelpers.hpp"
+
 namespace aikido {
 namespace constraint {
 
+namespace {
+
+using BodyNodePair = std::pair<const dart::dynamics::BodyNode*,
+                               const dart::dynamics::BodyNode*>;
+
+//==============================================================================
+BodyNodePair makeBodyNodePair(
+    const dart::dynamics::BodyNode* _bodyNode1,
+    const dart::dynamics::BodyNode* _bodyNode2)
+{
+  if (_bodyNode1 < _bodyNode2)
+    return BodyNodePair(_bodyNode1, _bodyNode2);
+  else
+    return BodyNodePair(_bodyNode2, _bodyNode1);
+}
+
+//==============================================================================
+/// Collision filter that rejects a fixed set of body node pairs in addition
+/// to the pairs rejected by another filter.
+class AllowedCollisionFilter : public dart::collision::CollisionFilter
+{
+public:
+  AllowedCollisionFilter(
+      std::shared_ptr<dart::collision::CollisionFilter> _baseFilter,
+      std::set<BodyNodePair> _skippedPairs)
+    : mBaseFilter(std::move(_baseFilter))
+    , mSkippedPairs(std::move(_skippedPairs))
+  {
+    // Do nothing
+  }
+
+  // Documentation inherited.
+  bool needCollision(
+      const dart::collision::CollisionObject* _object1,
+      const dart::collision::CollisionObject* _object2) const override
+  {
+    if (mBaseFilter && !mBaseFilter->needCollision(_object1, _object2))
+      return false;
+
+    const auto bodyNode1 = detail::getBodyNode(_object1);
+    const auto bodyNode2 = detail::getBodyNode(_object2);
+    if (!bodyNode1 || !bodyNode2)
+      return true;
+
+    return mSkippedPairs.find(makeBodyNodePair(bodyNode1, bodyNode2))
+           == mSkippedPairs.end();
+  }
+
+private:
+  std::shared_ptr<dart::collision::CollisionFilter> mBaseFilter;
+  std::set<BodyNodePair> mSkippedPairs;
+};
+
+} // namespace
+
 //==============================================================================
 CollisionFree::CollisionFree(
     statespace::dart::MetaSkeletonStateSpacePtr _statespace,
@@ -11,6 +70,7 @@ CollisionFree::CollisionFree(
   : mStatespace(std::move(_statespace))
   , mCollisionDetector(std::move(_collisionDetector))
   , mCollisionOptions(std::move(_collisionOptions))
+  , mBaseCollisionFilter(mCollisionOptions.collisionFilter)
 {
   if (!mStatespace)
     throw std::invalid_argument("_statespace is nullptr.");
@@ -104,5 +164,46 @@ void CollisionFree::removeSelfCheck(
       mGroupsToSelfCheck.end());
 }
 
+//==============================================================================
+void CollisionFree::setAllowedCollisionMatrix(
+    std::shared_ptr<const AllowedCollisionMatrix> _matrix)
+{
+  mAllowedCollisionMatrix = std::move(_matrix);
+
+  if (!mAllowedCollisionMatrix)
+  {
+    mCollisionOptions.collisionFilter = mBaseCollisionFilter;
+    return;
+  }
+
+  // Resolve the names in the matrix once so the filter only compares
+  // pointers while checking for collision.
+  const auto metaSkeleton = mStatespace->getMetaSkeleton();
+  std::set<BodyNodePair> skippedPairs;
+  for (std::size_t i = 0; i < metaSkeleton->getNumBodyNodes(); ++i)
+  {
+    const dart::dynamics::BodyNode* bodyNode1 = metaSkeleton->getBodyNode(i);
+
+    for (std::size_t j = i + 1; j < metaSkeleton->getNumBodyNodes(); ++j)
+    {
+      const dart::dynamics::BodyNode* bodyNode2 = metaSkeleton->getBodyNode(j);
+
+      if (!mAllowedCollisionMatrix->needsCheck(
+              bodyNode1->getName(), bodyNode2->getName()))
+        skippedPairs.insert(makeBodyNodePair(bodyNode1, bodyNode2));
+    }
+  }
+
+  mCollisionOptions.collisionFilter = std::make_shared<AllowedCollisionFilter>(
+      mBaseCollisionFilter, std::move(skippedPairs));
+}
+
+//==============================================================================
+std::shared_ptr<const AllowedCollisionMatrix>
+CollisionFree::getAllowedCollisionMatrix() const
+{
+  return mAllowedCollisionMatrix;
+}
+
 } // namespace constraint
 } // namespace aikido
@@ -0,0 +1,296 @@
+#include <aikido/constraint/ContinuousCollisionFree.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <dart/collision/DistanceOption.hpp>
+
+namespace aikido {
+namespace constraint {
+
+using statespace::dart::JointStateSpace;
+using statespace::dart::MetaSkeletonStateSpace;
+using dart::dynamics::BodyNode;
+using dart::dynamics::CollisionAspect;
+using dart::dynamics::Joint;
+
+namespace {
+
+//==============================================================================
+template <class T>
+bool isJointOfType(const Joint* _joint)
+{
+  // It's safe to do a pointer comparison here, since getType is guaranteed to
+  // return the same reference to the corresponding getTypeStatic method.
+  return &_joint->getType() == &T::getStaticType();
+}
+
+//==============================================================================
+/// Returns the radius of a sphere centered at the origin of _bodyNode that
+/// contains all of its collision shapes.
+double getCollisionRadius(const BodyNode* _bodyNode)
+{
+  double radius = 0.;
+  for (const auto shapeNode : _bodyNode->getShapeNodesWith<CollisionAspect>())
+  {
+    const auto& boundingBox = shapeNode->getShape()->getBoundingBox();
+    const Eigen::Isometry3d& transform = shapeNode->getRelativeTransform();
+
+    for (int corner = 0; corner < 8; ++corner)
+    {
+      const Eigen::Vector3d point(
+          (corner & 1) ? boundingBox.getMax()[0] : boundingBox.getMin()[0],
+          (corner & 2) ? boundingBox.getMax()[1] : boundingBox.getMin()[1],
+          (corner & 4) ? boundingBox.getMax()[2] : boundingBox.getMin()[2]);
+      radius = std::max(radius, (transform * point).norm());
+    }
+  }
+  return radius;
+}
+
+//==============================================================================
+/// Returns an upper bound on the distance between the origins of the parent
+/// and child body nodes of _joint over all of its positions.
+double getJointLengthBound(const Joint* _joint)
+{
+  double length = _joint->getTransformFromParentBodyNode().translation().norm()
+                  + _joint->getTransformFromChildBodyNode().translation().norm();
+
+  // Rotational joints do not change the distance between the joint frames.
+  if (isJointOfType<dart::dynamics::RevoluteJoint>(_joint)
+      || isJointOfType<dart::dynamics::WeldJoint>(_joint)
+      || isJointOfType<dart::dynamics::BallJoint>(_joint)
+      || isJointOfType<dart::dynamics::UniversalJoint>(_joint)
+      || isJointOfType<dart::dynamics::EulerJoint>(_joint))
+    return length;
+
+  // Otherwise bound the translation by the position limits. This is loose for
+  // joints that also rotate, but never too small.
+  double travelSquared = 0.;
+  for (std::size_t idof = 0; idof < _joint->getNumDofs(); ++idof)
+  {
+    const double travel = std::max(
+        std::abs(_joint->getPositionLowerLimit(idof)),
+        std::abs(_joint->getPositionUpperLimit(idof)));
+    travelSquared += travel * travel;
+  }
+
+  if (isJointOfType<dart::dynamics::ScrewJoint>(_joint))
+  {
+    const auto screw = static_cast<const dart::dynamics::ScrewJoint*>(_joint);
+    return length + std::abs(screw->getPitch()) * std::sqrt(travelSquared);
+  }
+
+  return length + std::sqrt(travelSquared);
+}
+
+} // namespace
+
+//==============================================================================
+ContinuousCollisionFree::ContinuousCollisionFree(
+    statespace::dart::MetaSkeletonStateSpacePtr _statespace,
+    std::shared_ptr<dart::collision::CollisionDetector> _collisionDetector,
+    double _distanceTolerance,
+    std::size_t _maxNumSteps)
+  : mStatespace(std::move(_statespace))
+  , mCollisionDetector(std::move(_collisionDetector))
+  , mInterpolator(mStatespace)
+  , mDistanceTolerance(_distanceTolerance)
+  , mMaxNumSteps(_maxNumSteps)
+{
+  // mInterpolator already rejects a nullptr _statespace.
+  if (!mCollisionDetector)
+    throw std::invalid_argument("_collisionDetector is nullptr.");
+
+  if (!(mDistanceTolerance > 0.))
+  {
+    std::stringstream msg;
+    msg << "Distance tolerance must be positive, got " << mDistanceTolerance
+        << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  if (mMaxNumSteps == 0)
+    throw std::invalid_argument("Maximum number of steps must be positive.");
+
+  std::map<const BodyNode*, std::size_t> bodyNodeIndices;
+
+  std::size_t tangentIndex = 0;
+  for (std::size_t i = 0; i < mStatespace->getNumSubspaces(); ++i)
+  {
+    const auto subspace = mStatespace->getSubspace<JointStateSpace>(i);
+    const auto joint = subspace->getJoint();
+
+    bool isRotational;
+    if (isJointOfType<dart::dynamics::WeldJoint>(joint))
+      continue;
+    else if (isJointOfType<dart::dynamics::RevoluteJoint>(joint))
+      isRotational = true;
+    else if (
+        isJointOfType<dart::dynamics::PrismaticJoint>(joint)
+        || isJointOfType<dart::dynamics::TranslationalJoint>(joint))
+      isRotational = false;
+    else
+    {
+      std::stringstream msg;
+      msg << "Joint '" << joint->getName() << "' has unsupported type '"
+          << joint->getType() << "'.";
+      throw std::invalid_argument(msg.str());
+    }
+
+    const double jointOffset
+        = joint->getTransformFromChildBodyNode().translation().norm();
+
+    // Walk the subtree moved by this joint, accumulating a bound on the
+    // distance from the origin of its child body node.
+    std::vector<std::pair<const BodyNode*, double>> stack{
+        {joint->getChildBodyNode(), 0.}};
+
+    while (!stack.empty())
+    {
+      const auto bodyNode = stack.back().first;
+      const double chainLength = stack.back().second;
+      stack.pop_back();
+
+      for (std::size_t ichild = 0; ichild < bodyNode->getNumChildBodyNodes();
+           ++ichild)
+      {
+        const auto child = bodyNode->getChildBodyNode(ichild);
+        stack.emplace_back(
+            child, chainLength + getJointLengthBound(child->getParentJoint()));
+      }
+
+      if (bodyNode->getNumShapeNodesWith<CollisionAspect>() == 0)
+        continue;
+
+      const double bound
+          = isRotational
+                ? jointOffset + chainLength + getCollisionRadius(bodyNode)
+                : 1.;
+
+      if (!std::isfinite(bound))
+      {
+        std::stringstream msg;
+        msg << "Unable to bound the motion of BodyNode '"
+            << bodyNode->getName() << "' about Joint '" << joint->getName()
+            << "' because a joint between them has infinite position limits.";
+        throw std::invalid_argument(msg.str());
+      }
+
+      auto it = bodyNodeIndices.find(bodyNode);
+      if (it == bodyNodeIndices.end())
+      {
+        it = bodyNodeIndices.emplace(bodyNode, mMovingBodyNodes.size()).first;
+
+        MovingBodyNode movingBodyNode;
+        movingBodyNode.mGroup
+            = mCollisionDetector->createCollisionGroupAsSharedPtr(bodyNode);
+        mMovingBodyNodes.emplace_back(std::move(movingBodyNode));
+      }
+
+      auto& motionBounds = mMovingBodyNodes[it->second].mMotionBounds;
+      for (std::size_t idof = 0; idof < joint->getNumDofs(); ++idof)
+        motionBounds.emplace_back(tangentIndex + idof, bound);
+    }
+
+    tangentIndex += subspace->getDimension();
+  }
+}
+
+//==============================================================================
+statespace::StateSpacePtr ContinuousCollisionFree::getStateSpace() const
+{
+  return mStatespace;
+}
+
+//==============================================================================
+bool ContinuousCollisionFree::isSatisfied(
+    const statespace::StateSpace::State* _from,
+    const statespace::StateSpace::State* _to,
+    double& _lastValid) const
+{
+  _lastValid = 0.;
+
+  const Eigen::VectorXd tangent = mInterpolator.getTangentVector(_from, _to);
+
+  // Maximum distance travelled by any point of each body node per unit of
+  // the interpolation parameter.
+  std::vector<double> speeds;
+  speeds.reserve(mMovingBodyNodes.size());
+  for (const auto& movingBodyNode : mMovingBodyNodes)
+  {
+    double speed = 0.;
+    for (const auto& motionBound : movingBodyNode.mMotionBounds)
+      speed += motionBound.second * std::abs(tangent[motionBound.first]);
+    speeds.emplace_back(speed);
+  }
+
+  const dart::collision::DistanceOption option(
+      false, mDistanceTolerance, nullptr);
+
+  auto relativeState = mStatespace->createState();
+  auto state = mStatespace->createState();
+
+  double t = 0.;
+  for (std::size_t istep = 0; istep < mMaxNumSteps; ++istep)
+  {
+    mStatespace->expMap(t * tangent, relativeState);
+    mStatespace->compose(_from, relativeState, state);
+    mStatespace->setState(state);
+
+    // No point of a body node can travel farther than its distance to the
+    // obstacles before the parameter advances by distance / speed.
+    double step = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < mMovingBodyNodes.size(); ++i)
+    {
+      for (const auto& group : mGroups)
+      {
+        const double distance = mCollisionDetector->distance(
+            mMovingBodyNodes[i].mGroup.get(), group.get(), option);
+
+        if (distance <= mDistanceTolerance)
+          return false;
+
+        if (speeds[i] > 0.)
+          step = std::min(step, distance / speeds[i]);
+      }
+    }
+
+    if (t + step >= 1.)
+    {
+      _lastValid = 1.;
+      return true;
+    }
+
+    t += step;
+    _lastValid = t;
+  }
+
+  return false;
+}
+
+//==============================================================================
+void ContinuousCollisionFree::addPairwiseCheck(
+    std::shared_ptr<dart::collision::CollisionGroup> _group)
+{
+  mGroups.emplace_back(std::move(_group));
+}
+
+//==============================================================================
+void ContinuousCollisionFree::removePairwiseCheck(
+    std::shared_ptr<dart::collision::CollisionGroup> _group)
+{
+  mGroups.erase(
+      std::remove(mGroups.begin(), mGroups.end(), _group), mGroups.end());
+}
+
+//==============================================================================
+std::size_t ContinuousCollisionFree::getNumMovingBodyNodes() const
+{
+  return mMovingBodyNodes.size();
+}
+
+} // namespace constraint
+} // namespace aikido
@@ -13,5 +13,15 @@ void Differentiable::getValueAndJacobian(
   getJacobian(_s, _jac);
 }
 
+//==============================================================================
+void Differentiable::getJacobianSparse(
+    const statespace::StateSpace::State* _s,
+    Eigen::SparseMatrix<double>& _out) const
+{
+  Eigen::MatrixXd jac;
+  getJacobian(_s, jac);
+  _out = jac.sparseView();
+}
+
 } // namespace constraint
 } // namespace aikido
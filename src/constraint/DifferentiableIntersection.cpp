@@ -1,5 +1,7 @@
 #include <aikido/constraint/DifferentiableIntersection.hpp>
 
+#include <sstream>
+
 namespace aikido {
 namespace constraint {
 
@@ -80,6 +82,44 @@ void DifferentiableIntersection::getJacobian(
   }
 }
 
+//==============================================================================
+void DifferentiableIntersection::getJacobianSparse(
+    const statespace::StateSpace::State* _s,
+    Eigen::SparseMatrix<double>& _out) const
+{
+  const int constraintsDim = getConstraintDimension();
+  const int statesDim = mStateSpace->getDimension();
+
+  std::vector<Eigen::Triplet<double>> triplets;
+
+  int index = 0;
+  Eigen::SparseMatrix<double> jac;
+  for (auto constraint : mConstraints)
+  {
+    constraint->getJacobianSparse(_s, jac);
+
+    if (jac.cols() != statesDim)
+    {
+      std::stringstream msg;
+      msg << "Jacobian of constraint has " << jac.cols()
+          << " columns, expected " << statesDim << ".";
+      throw std::runtime_error(msg.str());
+    }
+
+    triplets.reserve(triplets.size() + jac.nonZeros());
+    for (int k = 0; k < jac.outerSize(); ++k)
+    {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(jac, k); it; ++it)
+        triplets.emplace_back(index + it.row(), it.col(), it.value());
+    }
+
+    index += jac.rows();
+  }
+
+  _out.resize(constraintsDim, statesDim);
+  _out.setFromTriplets(triplets.begin(), triplets.end());
+}
+
 //==============================================================================
 void DifferentiableIntersection::getValueAndJacobian(
     const statespace::StateSpace::State* _s,
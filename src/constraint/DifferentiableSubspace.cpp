@@ -70,6 +70,16 @@ void DifferentiableSubspace::getJacobian(
   return mConstraint->getJacobian(substate, _out);
 }
 
+//==============================================================================
+void DifferentiableSubspace::getJacobianSparse(
+    const statespace::StateSpace::State* _s,
+    Eigen::SparseMatrix<double>& _out) const
+{
+  auto state = static_cast<const statespace::CartesianProduct::State*>(_s);
+  auto substate = mStateSpace->getSubState<>(state, mIndex);
+  mConstraint->getJacobianSparse(substate, _out);
+}
+
 //==============================================================================
 void DifferentiableSubspace::getValueAndJacobian(
     const statespace::StateSpace::State* _s,
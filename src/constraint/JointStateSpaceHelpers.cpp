@@ -6,6 +6,7 @@
 #include <aikido/constraint/CartesianProductTestable.hpp>
 #include <aikido/constraint/DifferentiableIntersection.hpp>
 #include <aikido/constraint/DifferentiableSubspace.hpp>
+#include <aikido/constraint/MetaSkeletonBoxConstraint.hpp>
 #include <aikido/constraint/TestableIntersection.hpp>
 
 namespace aikido {
@@ -67,6 +68,12 @@ std::unique_ptr<Projectable> createProjectableBounds(
 std::unique_ptr<Projectable> createProjectableBounds(
     statespace::dart::MetaSkeletonStateSpacePtr _metaSkeleton)
 {
+  if (!_metaSkeleton)
+    throw std::invalid_argument("MetaSkeletonStateSpace is nullptr.");
+
+  if (MetaSkeletonBoxConstraint::isCompatible(*_metaSkeleton))
+    return make_unique<MetaSkeletonBoxConstraint>(std::move(_metaSkeleton));
+
   const auto n = _metaSkeleton->getNumSubspaces();
 
   std::vector<ProjectablePtr> constraints;
@@ -99,6 +106,12 @@ std::unique_ptr<Testable> createTestableBounds(
 std::unique_ptr<Testable> createTestableBounds(
     statespace::dart::MetaSkeletonStateSpacePtr _metaSkeleton)
 {
+  if (!_metaSkeleton)
+    throw std::invalid_argument("MetaSkeletonStateSpace is nullptr.");
+
+  if (MetaSkeletonBoxConstraint::isCompatible(*_metaSkeleton))
+    return make_unique<MetaSkeletonBoxConstraint>(std::move(_metaSkeleton));
+
   const auto n = _metaSkeleton->getNumSubspaces();
 
   std::vector<std::shared_ptr<Testable>> constraints;
@@ -133,6 +146,22 @@ std::unique_ptr<Sampleable> createSampleableBounds(
     statespace::dart::MetaSkeletonStateSpacePtr _metaSkeleton,
     std::unique_ptr<common::RNG> _rng)
 {
+  if (!_metaSkeleton)
+    throw std::invalid_argument("MetaSkeletonStateSpace is nullptr.");
+
+  if (MetaSkeletonBoxConstraint::isCompatible(*_metaSkeleton))
+  {
+    auto constraint = make_unique<MetaSkeletonBoxConstraint>(
+        _metaSkeleton, std::move(_rng));
+
+    // Unbounded joints are reported when the Sampleable is created, as in
+    // the per-joint constraints below.
+    if (!constraint->isBounded())
+      throw std::runtime_error("Unable to create Sampleable for unbounded Rn.");
+
+    return std::move(constraint);
+  }
+
   const auto n = _metaSkeleton->getNumSubspaces();
 
   // Create a new RNG for each subspace.
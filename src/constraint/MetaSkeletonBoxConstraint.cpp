@@ -0,0 +1,361 @@
+#include <aikido/constraint/MetaSkeletonBoxConstraint.hpp>
+
+#include <cmath>
+#include <sstream>
+#include <aikido/statespace/dart/RnJoint.hpp>
+#include <aikido/statespace/dart/SO2Joint.hpp>
+
+namespace aikido {
+namespace constraint {
+
+using statespace::dart::JointStateSpace;
+using statespace::dart::MetaSkeletonStateSpace;
+using statespace::dart::MetaSkeletonStateSpacePtr;
+
+namespace {
+
+//==============================================================================
+bool isRJoint(const JointStateSpace* _space)
+{
+  using statespace::dart::RJoint;
+
+  return dynamic_cast<const RJoint<1>*>(_space) != nullptr
+         || dynamic_cast<const RJoint<2>*>(_space) != nullptr
+         || dynamic_cast<const RJoint<3>*>(_space) != nullptr
+         || dynamic_cast<const RJoint<6>*>(_space) != nullptr;
+}
+
+//==============================================================================
+bool isSO2Joint(const JointStateSpace* _space)
+{
+  return dynamic_cast<const statespace::dart::SO2Joint*>(_space) != nullptr;
+}
+
+//==============================================================================
+bool hasAnyPositionLimit(const dart::dynamics::Joint* _joint)
+{
+  for (std::size_t i = 0; i < _joint->getNumDofs(); ++i)
+  {
+    if (_joint->hasPositionLimit(i))
+      return true;
+  }
+  return false;
+}
+
+} // namespace
+
+//==============================================================================
+class MetaSkeletonBoxConstraintSampleGenerator : public SampleGenerator
+{
+public:
+  // Documentation inherited.
+  statespace::StateSpacePtr getStateSpace() const override;
+
+  // Documentation inherited.
+  bool sample(statespace::StateSpace::State* _state) override;
+
+  // Documentation inherited.
+  int getNumSamples() const override;
+
+  // Documentation inherited.
+  bool canSample() const override;
+
+private:
+  MetaSkeletonBoxConstraintSampleGenerator(
+      const MetaSkeletonBoxConstraint& _constraint,
+      std::unique_ptr<common::RNG> _rng);
+
+  MetaSkeletonStateSpacePtr mStateSpace;
+  std::unique_ptr<common::RNG> mRng;
+  std::vector<MetaSkeletonBoxConstraint::Segment> mSegments;
+  Eigen::VectorXd mLowerLimits;
+  Eigen::VectorXd mRanges;
+  std::vector<std::pair<std::size_t, std::shared_ptr<statespace::SO2>>>
+      mSO2Subspaces;
+  std::uniform_real_distribution<double> mUnitDistribution;
+  std::uniform_real_distribution<double> mAngleDistribution;
+
+  friend class MetaSkeletonBoxConstraint;
+};
+
+//==============================================================================
+MetaSkeletonBoxConstraintSampleGenerator::
+    MetaSkeletonBoxConstraintSampleGenerator(
+        const MetaSkeletonBoxConstraint& _constraint,
+        std::unique_ptr<common::RNG> _rng)
+  : mStateSpace(_constraint.mStateSpace)
+  , mRng(std::move(_rng))
+  , mSegments(_constraint.mSegments)
+  , mLowerLimits(_constraint.mLowerLimits)
+  , mRanges(_constraint.mUpperLimits - _constraint.mLowerLimits)
+  , mUnitDistribution(0., 1.)
+  , mAngleDistribution(-M_PI, M_PI)
+{
+  mSO2Subspaces.reserve(_constraint.mSO2Indices.size());
+  for (const auto index : _constraint.mSO2Indices)
+  {
+    mSO2Subspaces.emplace_back(
+        index, mStateSpace->getSubspace<statespace::SO2>(index));
+  }
+}
+
+//==============================================================================
+statespace::StateSpacePtr
+MetaSkeletonBoxConstraintSampleGenerator::getStateSpace() const
+{
+  return mStateSpace;
+}
+
+//==============================================================================
+bool MetaSkeletonBoxConstraintSampleGenerator::sample(
+    statespace::StateSpace::State* _state)
+{
+  auto buffer = reinterpret_cast<unsigned char*>(_state);
+
+  for (const auto& segment : mSegments)
+  {
+    auto values = reinterpret_cast<double*>(buffer + segment.mByteOffset);
+
+    for (std::size_t i = 0; i < segment.mLength; ++i)
+    {
+      const auto index = segment.mLimitIndex + i;
+      values[i]
+          = mLowerLimits[index] + mRanges[index] * mUnitDistribution(*mRng);
+    }
+  }
+
+  auto state = static_cast<MetaSkeletonStateSpace::State*>(_state);
+  for (const auto& so2 : mSO2Subspaces)
+  {
+    so2.second->setAngle(
+        mStateSpace->getSubState<statespace::SO2>(state, so2.first),
+        mAngleDistribution(*mRng));
+  }
+
+  return true;
+}
+
+//==============================================================================
+int MetaSkeletonBoxConstraintSampleGenerator::getNumSamples() const
+{
+  return NO_LIMIT;
+}
+
+//==============================================================================
+bool MetaSkeletonBoxConstraintSampleGenerator::canSample() const
+{
+  return true;
+}
+
+//==============================================================================
+MetaSkeletonBoxConstraint::MetaSkeletonBoxConstraint(
+    MetaSkeletonStateSpacePtr _metaSkeleton, std::unique_ptr<common::RNG> _rng)
+  : mStateSpace(std::move(_metaSkeleton))
+  , mRng(std::move(_rng))
+  , mIsBounded(true)
+{
+  if (!mStateSpace)
+    throw std::invalid_argument("MetaSkeletonStateSpace is nullptr.");
+
+  if (!isCompatible(*mStateSpace))
+  {
+    throw std::invalid_argument(
+        "MetaSkeletonStateSpace contains a joint that is not supported by"
+        " MetaSkeletonBoxConstraint.");
+  }
+
+  // Find the location of every substate in the compound state. RnJoint
+  // stores its values as a contiguous array of doubles.
+  auto scratch = mStateSpace->createState();
+  const auto base = reinterpret_cast<const unsigned char*>(scratch.getState());
+
+  std::vector<double> lowerLimits;
+  std::vector<double> upperLimits;
+
+  for (std::size_t i = 0; i < mStateSpace->getNumSubspaces(); ++i)
+  {
+    const auto subspace = mStateSpace->getSubspace<JointStateSpace>(i);
+    const auto joint = subspace->getJoint();
+
+    if (isSO2Joint(subspace.get()))
+    {
+      mSO2Indices.emplace_back(i);
+      continue;
+    }
+
+    if (!isRJoint(subspace.get()))
+      continue;
+
+    const auto substate = reinterpret_cast<const unsigned char*>(
+        mStateSpace->getSubState<>(scratch.getState(), i));
+    const std::size_t substateOffset = substate - base;
+
+    for (std::size_t idof = 0; idof < joint->getNumDofs(); ++idof)
+    {
+      const double lower = joint->getPositionLowerLimit(idof);
+      const double upper = joint->getPositionUpperLimit(idof);
+
+      if (!std::isfinite(lower) || !std::isfinite(upper))
+        mIsBounded = false;
+
+      if (!joint->hasPositionLimit(idof))
+        continue;
+
+      const std::size_t byteOffset = substateOffset + idof * sizeof(double);
+
+      // Extend the previous segment if this value immediately follows it.
+      if (!mSegments.empty())
+      {
+        auto& last = mSegments.back();
+        if (last.mByteOffset + last.mLength * sizeof(double) == byteOffset)
+        {
+          ++last.mLength;
+          lowerLimits.emplace_back(lower);
+          upperLimits.emplace_back(upper);
+          continue;
+        }
+      }
+
+      mSegments.push_back(Segment{byteOffset, lowerLimits.size(), 1});
+      lowerLimits.emplace_back(lower);
+      upperLimits.emplace_back(upper);
+    }
+  }
+
+  mLowerLimits = Eigen::Map<Eigen::VectorXd>(
+      lowerLimits.data(), lowerLimits.size());
+  mUpperLimits = Eigen::Map<Eigen::VectorXd>(
+      upperLimits.data(), upperLimits.size());
+
+  for (std::size_t i = 0; i < getNumLimitedDofs(); ++i)
+  {
+    if (mLowerLimits[i] > mUpperLimits[i])
+    {
+      std::stringstream msg;
+      msg << "Lower limit exceeds upper limit on limited DOF " << i << ": "
+          << mLowerLimits[i] << " > " << mUpperLimits[i] << ".";
+      throw std::invalid_argument(msg.str());
+    }
+  }
+}
+
+//==============================================================================
+bool MetaSkeletonBoxConstraint::isCompatible(
+    const MetaSkeletonStateSpace& _metaSkeleton)
+{
+  for (std::size_t i = 0; i < _metaSkeleton.getNumSubspaces(); ++i)
+  {
+    const auto subspace = _metaSkeleton.getSubspace<JointStateSpace>(i);
+    const auto joint = subspace->getJoint();
+
+    if (joint->getNumDofs() == 0 || isRJoint(subspace.get()))
+      continue;
+
+    if (isSO2Joint(subspace.get()) && !hasAnyPositionLimit(joint))
+      continue;
+
+    return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+statespace::StateSpacePtr MetaSkeletonBoxConstraint::getStateSpace() const
+{
+  return mStateSpace;
+}
+
+//==============================================================================
+bool MetaSkeletonBoxConstraint::isSatisfied(
+    const statespace::StateSpace::State* _state) const
+{
+  const auto buffer = reinterpret_cast<const unsigned char*>(_state);
+
+  for (const auto& segment : mSegments)
+  {
+    const Eigen::Map<const Eigen::ArrayXd> values(
+        reinterpret_cast<const double*>(buffer + segment.mByteOffset),
+        segment.mLength);
+
+    const auto start = segment.mLimitIndex;
+    const auto length = segment.mLength;
+
+    if ((values < mLowerLimits.segment(start, length).array()).any()
+        || (values > mUpperLimits.segment(start, length).array()).any())
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool MetaSkeletonBoxConstraint::project(
+    const statespace::StateSpace::State* _s,
+    statespace::StateSpace::State* _out) const
+{
+  if (_s != _out)
+    mStateSpace->copyState(_s, _out);
+
+  const auto buffer = reinterpret_cast<unsigned char*>(_out);
+
+  for (const auto& segment : mSegments)
+  {
+    Eigen::Map<Eigen::ArrayXd> values(
+        reinterpret_cast<double*>(buffer + segment.mByteOffset),
+        segment.mLength);
+
+    const auto start = segment.mLimitIndex;
+    const auto length = segment.mLength;
+
+    values = values.max(mLowerLimits.segment(start, length).array())
+                 .min(mUpperLimits.segment(start, length).array());
+  }
+
+  return true;
+}
+
+//==============================================================================
+std::unique_ptr<SampleGenerator>
+MetaSkeletonBoxConstraint::createSampleGenerator() const
+{
+  if (!mRng)
+    throw std::runtime_error("mRng is null.");
+
+  if (!mIsBounded)
+  {
+    throw std::runtime_error(
+        "Unable to sample from MetaSkeletonStateSpace because a real vector"
+        " coordinate is unbounded.");
+  }
+
+  return std::unique_ptr<MetaSkeletonBoxConstraintSampleGenerator>(
+      new MetaSkeletonBoxConstraintSampleGenerator(*this, mRng->clone()));
+}
+
+//==============================================================================
+bool MetaSkeletonBoxConstraint::isBounded() const
+{
+  return mIsBounded;
+}
+
+//==============================================================================
+std::size_t MetaSkeletonBoxConstraint::getNumLimitedDofs() const
+{
+  return static_cast<std::size_t>(mLowerLimits.size());
+}
+
+//==============================================================================
+const Eigen::VectorXd& MetaSkeletonBoxConstraint::getLowerLimits() const
+{
+  return mLowerLimits;
+}
+
+//==============================================================================
+const Eigen::VectorXd& MetaSkeletonBoxConstraint::getUpperLimits() const
+{
+  return mUpperLimits;
+}
+
+} // namespace constraint
+} // namespace aikido
@@ -0,0 +1,16 @@
+#include <aikido/constraint/MotionTestable.hpp>
+
+namespace aikido {
+namespace constraint {
+
+//==============================================================================
+bool MotionTestable::isSatisfied(
+    const statespace::StateSpace::State* _from,
+    const statespace::StateSpace::State* _to) const
+{
+  double lastValid;
+  return isSatisfied(_from, _to, lastValid);
+}
+
+} // namespace constraint
+} // namespace aikido
@@ -14,11 +14,13 @@ NewtonsMethodProjectable::NewtonsMethodProjectable(
     DifferentiablePtr _differentiable,
     std::vector<double> _tolerance,
     int _maxIteration,
-    double _minStepSize)
+    double _minStepSize,
+    bool _useSparseJacobian)
   : mDifferentiable(std::move(_differentiable))
   , mTolerance(std::move(_tolerance))
   , mMaxIteration(_maxIteration)
   , mMinStepSize(_minStepSize)
+  , mUseSparseJacobian(_useSparseJacobian)
 {
   if (!mDifferentiable)
     throw std::invalid_argument("_differentiable is nullptr.");
@@ -49,23 +51,20 @@ NewtonsMethodProjectable::NewtonsMethodProjectable(
 
 //==============================================================================
 bool NewtonsMethodProjectable::contains(
-    const statespace::StateSpace::State* _s) const
+    const Eigen::VectorXd& _values,
+    const std::vector<ConstraintType>& _types) const
 {
-  Eigen::VectorXd values;
-  mDifferentiable->getValue(_s, values);
-  std::vector<ConstraintType> types = mDifferentiable->getConstraintTypes();
-
-  for (int i = 0; i < values.size(); i++)
+  for (int i = 0; i < _values.size(); i++)
   {
-    if (types.at(i) == ConstraintType::EQUALITY)
+    if (_types.at(i) == ConstraintType::EQUALITY)
     {
-      if (std::abs(values(i)) > mTolerance.at(i))
+      if (std::abs(_values(i)) > mTolerance.at(i))
         return false;
     }
     else
     {
       // Inequality constraints are satisfied when value <= 0.
-      if (values(i) > mTolerance.at(i))
+      if (_values(i) > mTolerance.at(i))
         return false;
     }
   }
@@ -85,20 +84,32 @@ bool NewtonsMethodProjectable::project(
   // Initialize _out.
   mStateSpace->copyState(_s, _out);
 
+  // Buffers are reused by all iterations, so the loop itself does not
+  // allocate except in the pseudoinverse.
   StateSpace::ScopedState step(mStateSpace.get());
+  const std::vector<ConstraintType> types
+      = mDifferentiable->getConstraintTypes();
+  Eigen::VectorXd value;
+  Eigen::VectorXd tangentStep;
+  Eigen::MatrixXd jac;
+
+  mDifferentiable->getValue(_out, value);
 
   /// Newton's method on mDifferentiable
-  while (!contains(_out) && iteration < mMaxIteration)
+  while (!contains(value, types) && iteration < mMaxIteration)
   {
     iteration++;
 
-    Eigen::VectorXd value;
-    mDifferentiable->getValue(_out, value);
-    Eigen::MatrixXd jac;
-    mDifferentiable->getJacobian(_out, jac);
-
     // Minimization step in tangent space.
-    Eigen::VectorXd tangentStep = -1 * common::pseudoinverse(jac) * value;
+    if (mUseSparseJacobian)
+    {
+      computeSparseStep(_out, value, tangentStep);
+    }
+    else
+    {
+      mDifferentiable->getJacobian(_out, jac);
+      tangentStep.noalias() = -1 * common::pseudoinverse(jac) * value;
+    }
 
     // Break if tangent step is too small.
     if (tangentStep.maxCoeff() < mMinStepSize
@@ -108,14 +119,45 @@ bool NewtonsMethodProjectable::project(
     // Minimization step in state space.
     mStateSpace->expMap(tangentStep, step);
     mStateSpace->compose(_out, step);
+    mDifferentiable->getValue(_out, value);
   }
 
-  if (!contains(_out))
+  if (!contains(value, types))
     return false;
 
   return true;
 }
 
+//==============================================================================
+void NewtonsMethodProjectable::computeSparseStep(
+    const statespace::StateSpace::State* _s,
+    const Eigen::VectorXd& _value,
+    Eigen::VectorXd& _step) const
+{
+  Eigen::SparseMatrix<double> jac;
+  mDifferentiable->getJacobianSparse(_s, jac);
+
+  // The minimum-norm solution of J * step = -value is step = -J^T y with
+  // (J * J^T) y = value. J * J^T is small (constraints x constraints) and
+  // stays sparse when the constraints touch disjoint sets of coordinates.
+  const Eigen::SparseMatrix<double> jacT = jac.transpose();
+  const Eigen::SparseMatrix<double> normal = jac * jacT;
+
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(normal);
+  if (solver.info() == Eigen::Success)
+  {
+    const Eigen::VectorXd y = solver.solve(_value);
+    if (solver.info() == Eigen::Success && y.allFinite())
+    {
+      _step = -1 * (jacT * y);
+      return;
+    }
+  }
+
+  // Rank-deficient jacobian; fall back to the dense pseudoinverse.
+  _step = -1 * common::pseudoinverse(Eigen::MatrixXd(jac)) * _value;
+}
+
 //==============================================================================
 statespace::StateSpacePtr NewtonsMethodProjectable::getStateSpace() const
 {
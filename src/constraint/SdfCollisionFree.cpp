@@ -0,0 +1,350 @@
+#include <aikido/constraint/SdfCollisionFree.hpp>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <dart/common/StlHelpers.hpp>
+
+namespace aikido {
+namespace constraint {
+
+using statespace::dart::MetaSkeletonStateSpace;
+using dart::dynamics::CollisionAspect;
+using dart::dynamics::CylinderShape;
+using dart::dynamics::Shape;
+using dart::dynamics::SphereShape;
+
+namespace {
+
+//==============================================================================
+/// Returns the axis-aligned bounding box of a shape in the world frame.
+void getWorldBoundingBox(
+    const Shape& _shape,
+    const Eigen::Isometry3d& _transform,
+    Eigen::Vector3d& _min,
+    Eigen::Vector3d& _max)
+{
+  const auto& boundingBox = _shape.getBoundingBox();
+  const Eigen::Vector3d center
+      = 0.5 * (boundingBox.getMin() + boundingBox.getMax());
+  const Eigen::Vector3d halfExtents
+      = 0.5 * (boundingBox.getMax() - boundingBox.getMin());
+
+  const Eigen::Vector3d worldCenter = _transform * center;
+  const Eigen::Vector3d worldHalfExtents
+      = _transform.linear().cwiseAbs() * halfExtents;
+
+  _min = worldCenter - worldHalfExtents;
+  _max = worldCenter + worldHalfExtents;
+}
+
+//==============================================================================
+/// Returns true if _point, in the frame of _shape, is within _distance of
+/// _shape. Shapes without a dedicated test are replaced by their bounding box,
+/// so this may return true for points farther than _distance but never the
+/// opposite.
+bool isWithinDistance(
+    const Shape& _shape, const Eigen::Vector3d& _point, double _distance)
+{
+  if (_shape.is<SphereShape>())
+  {
+    const auto& sphere = static_cast<const SphereShape&>(_shape);
+    return _point.norm() <= sphere.getRadius() + _distance;
+  }
+
+  if (_shape.is<CylinderShape>())
+  {
+    // The maximum of the radial and axial distances never exceeds the true
+    // distance to the cylinder.
+    const auto& cylinder = static_cast<const CylinderShape&>(_shape);
+    const double radial = _point.head<2>().norm() - cylinder.getRadius();
+    const double axial = std::abs(_point[2]) - 0.5 * cylinder.getHeight();
+    return std::max(radial, axial) <= _distance;
+  }
+
+  const auto& boundingBox = _shape.getBoundingBox();
+  const Eigen::Vector3d center
+      = 0.5 * (boundingBox.getMin() + boundingBox.getMax());
+  const Eigen::Vector3d halfExtents
+      = 0.5 * (boundingBox.getMax() - boundingBox.getMin());
+  const Eigen::Vector3d outside
+      = ((_point - center).cwiseAbs() - halfExtents).cwiseMax(0.);
+  return outside.norm() <= _distance;
+}
+
+//==============================================================================
+/// Appends spheres covering _shape, expressed in the frame given by
+/// _transform, to _centers and _radii.
+void coverWithSpheres(
+    const Shape& _shape,
+    const Eigen::Isometry3d& _transform,
+    double _spacing,
+    std::vector<Eigen::Vector3d>& _centers,
+    std::vector<double>& _radii)
+{
+  if (_shape.is<SphereShape>())
+  {
+    _centers.emplace_back(_transform.translation());
+    _radii.emplace_back(static_cast<const SphereShape&>(_shape).getRadius());
+    return;
+  }
+
+  // Split the bounding box into cells no longer than _spacing and cover each
+  // cell by its circumscribed sphere.
+  const auto& boundingBox = _shape.getBoundingBox();
+  const Eigen::Vector3d extents = boundingBox.getMax() - boundingBox.getMin();
+
+  Eigen::Vector3i numCells;
+  for (int i = 0; i < 3; ++i)
+  {
+    numCells[i]
+        = std::max(1, static_cast<int>(std::ceil(extents[i] / _spacing)));
+  }
+
+  const Eigen::Vector3d cellSize
+      = extents.cwiseQuotient(numCells.cast<double>());
+  const double radius = 0.5 * cellSize.norm();
+
+  for (int x = 0; x < numCells[0]; ++x)
+  {
+    for (int y = 0; y < numCells[1]; ++y)
+    {
+      for (int z = 0; z < numCells[2]; ++z)
+      {
+        const Eigen::Vector3d offset(x + 0.5, y + 0.5, z + 0.5);
+        const Eigen::Vector3d cellCenter
+            = boundingBox.getMin() + cellSize.cwiseProduct(offset);
+        _centers.emplace_back(_transform * cellCenter);
+        _radii.emplace_back(radius);
+      }
+    }
+  }
+}
+
+} // namespace
+
+//==============================================================================
+SdfCollisionFree::SdfCollisionFree(
+    statespace::dart::MetaSkeletonStateSpacePtr _statespace,
+    const std::vector<dart::dynamics::ConstSkeletonPtr>& _environment,
+    double _resolution,
+    double _sphereSpacing,
+    double _margin,
+    std::shared_ptr<CollisionFree> _fallback)
+  : mStateSpace(std::move(_statespace))
+  , mMargin(_margin)
+  , mFallback(std::move(_fallback))
+{
+  if (!mStateSpace)
+    throw std::invalid_argument("_statespace is nullptr.");
+
+  if (!(_resolution > 0.))
+  {
+    std::stringstream msg;
+    msg << "Resolution must be positive, got " << _resolution << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  if (!(_sphereSpacing > 0.))
+  {
+    std::stringstream msg;
+    msg << "Sphere spacing must be positive, got " << _sphereSpacing << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  if (!(mMargin >= 0.))
+  {
+    std::stringstream msg;
+    msg << "Margin must be non-negative, got " << mMargin << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  if (mFallback && mFallback->getStateSpace() != mStateSpace)
+  {
+    throw std::invalid_argument(
+        "Fallback constraint does not operate on _statespace.");
+  }
+
+  // Collect the collision shapes of the environment.
+  std::vector<const dart::dynamics::ShapeNode*> environmentShapes;
+  Eigen::Vector3d environmentMin
+      = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+  Eigen::Vector3d environmentMax = -environmentMin;
+
+  for (const auto& skeleton : _environment)
+  {
+    if (!skeleton)
+      throw std::invalid_argument("Environment skeleton is nullptr.");
+
+    for (std::size_t i = 0; i < skeleton->getNumBodyNodes(); ++i)
+    {
+      const auto bodyNode = skeleton->getBodyNode(i);
+      for (const auto shapeNode :
+           bodyNode->getShapeNodesWith<CollisionAspect>())
+      {
+        Eigen::Vector3d shapeMin;
+        Eigen::Vector3d shapeMax;
+        getWorldBoundingBox(
+            *shapeNode->getShape(),
+            shapeNode->getWorldTransform(),
+            shapeMin,
+            shapeMax);
+        environmentMin = environmentMin.cwiseMin(shapeMin);
+        environmentMax = environmentMax.cwiseMax(shapeMax);
+
+        environmentShapes.emplace_back(shapeNode);
+      }
+    }
+  }
+
+  // Voxelize the environment conservatively: a voxel is occupied if its
+  // center is within half a diagonal of a shape, which includes every voxel
+  // that the shape intersects.
+  if (environmentShapes.empty())
+  {
+    mSignedDistanceField = dart::common::make_unique<SignedDistanceField>(
+        Eigen::Vector3d::Zero(), _resolution, Eigen::Vector3i::Ones());
+  }
+  else
+  {
+    const double padding = 2. * _resolution;
+    const Eigen::Vector3d origin
+        = environmentMin - Eigen::Vector3d::Constant(padding);
+    const Eigen::Vector3d extents
+        = environmentMax - environmentMin
+          + Eigen::Vector3d::Constant(2. * padding);
+
+    Eigen::Vector3i numVoxels;
+    for (int i = 0; i < 3; ++i)
+      numVoxels[i] = static_cast<int>(std::ceil(extents[i] / _resolution));
+
+    mSignedDistanceField = dart::common::make_unique<SignedDistanceField>(
+        origin, _resolution, numVoxels);
+  }
+
+  auto& field = *mSignedDistanceField;
+  const double halfDiagonal = 0.5 * std::sqrt(3.) * _resolution;
+
+  for (const auto shapeNode : environmentShapes)
+  {
+    const auto& shape = *shapeNode->getShape();
+    const Eigen::Isometry3d& transform = shapeNode->getWorldTransform();
+    const Eigen::Isometry3d inverse = transform.inverse();
+
+    Eigen::Vector3d shapeMin;
+    Eigen::Vector3d shapeMax;
+    getWorldBoundingBox(shape, transform, shapeMin, shapeMax);
+    const Eigen::Vector3i first = field.getVoxelIndex(
+        shapeMin - Eigen::Vector3d::Constant(halfDiagonal));
+    const Eigen::Vector3i last = field.getVoxelIndex(
+        shapeMax + Eigen::Vector3d::Constant(halfDiagonal));
+
+    for (int x = first[0]; x <= last[0]; ++x)
+    {
+      for (int y = first[1]; y <= last[1]; ++y)
+      {
+        for (int z = first[2]; z <= last[2]; ++z)
+        {
+          const Eigen::Vector3i index(x, y, z);
+          const Eigen::Vector3d center = inverse * field.getVoxelCenter(index);
+          if (isWithinDistance(shape, center, halfDiagonal))
+            field.setOccupied(index);
+        }
+      }
+    }
+  }
+
+  field.update();
+
+  // Cover the collision shapes of the metaskeleton with spheres.
+  const auto metaSkeleton = mStateSpace->getMetaSkeleton();
+  for (std::size_t i = 0; i < metaSkeleton->getNumBodyNodes(); ++i)
+  {
+    const dart::dynamics::BodyNode* bodyNode = metaSkeleton->getBodyNode(i);
+
+    std::vector<Eigen::Vector3d> centers;
+    std::vector<double> radii;
+    for (const auto shapeNode : bodyNode->getShapeNodesWith<CollisionAspect>())
+    {
+      coverWithSpheres(
+          *shapeNode->getShape(),
+          shapeNode->getRelativeTransform(),
+          _sphereSpacing,
+          centers,
+          radii);
+    }
+
+    if (centers.empty())
+      continue;
+
+    BodySpheres bodySpheres;
+    bodySpheres.mBodyNode = bodyNode;
+    bodySpheres.mCenters.resize(3, centers.size());
+    bodySpheres.mRadii.resize(radii.size());
+    for (std::size_t j = 0; j < centers.size(); ++j)
+    {
+      bodySpheres.mCenters.col(j) = centers[j];
+      bodySpheres.mRadii[j] = radii[j];
+    }
+
+    mBodySpheres.emplace_back(std::move(bodySpheres));
+  }
+}
+
+//==============================================================================
+statespace::StateSpacePtr SdfCollisionFree::getStateSpace() const
+{
+  return mStateSpace;
+}
+
+//==============================================================================
+bool SdfCollisionFree::isSatisfied(
+    const statespace::StateSpace::State* _state) const
+{
+  auto skelstate = static_cast<const MetaSkeletonStateSpace::State*>(_state);
+  mStateSpace->setState(skelstate);
+
+  for (const auto& bodySpheres : mBodySpheres)
+  {
+    const Eigen::Isometry3d& transform
+        = bodySpheres.mBodyNode->getWorldTransform();
+
+    for (int i = 0; i < bodySpheres.mCenters.cols(); ++i)
+    {
+      const Eigen::Vector3d center = transform * bodySpheres.mCenters.col(i);
+      const double clearance
+          = mSignedDistanceField->getDistanceLowerBound(center)
+            - bodySpheres.mRadii[i];
+
+      if (clearance <= mMargin)
+        return mFallback && mFallback->isSatisfied(_state);
+    }
+  }
+
+  return true;
+}
+
+//==============================================================================
+const SignedDistanceField& SdfCollisionFree::getSignedDistanceField() const
+{
+  return *mSignedDistanceField;
+}
+
+//==============================================================================
+std::size_t SdfCollisionFree::getNumSpheres() const
+{
+  std::size_t numSpheres = 0;
+  for (const auto& bodySpheres : mBodySpheres)
+    numSpheres += bodySpheres.mRadii.size();
+  return numSpheres;
+}
+
+//==============================================================================
+double SdfCollisionFree::getMargin() const
+{
+  return mMargin;
+}
+
+} // namespace constraint
+} // namespace aikido
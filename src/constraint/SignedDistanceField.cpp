@@ -0,0 +1,302 @@
+#include <aikido/constraint/SignedDistanceField.hpp>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace aikido {
+namespace constraint {
+
+namespace {
+
+/// Squared distance assigned to voxels that have no target voxel. This is
+/// finite so the lower envelope computation below never produces NaNs.
+constexpr double kUnreachable = 1e20;
+
+//==============================================================================
+/// Returns the abscissa at which the parabolas rooted at samples _q and _p
+/// of _f intersect.
+inline double intersectParabolas(const double* _f, int _q, int _p)
+{
+  return ((_f[_q] + _q * _q) - (_f[_p] + _p * _p)) / (2. * (_q - _p));
+}
+
+//==============================================================================
+/// One dimensional squared Euclidean distance transform of a sampled
+/// function (Felzenszwalb and Huttenlocher), in linear time.
+/// \param _f Sampled function, length _n.
+/// \param _n Number of samples.
+/// \param[out] _d Output distances, length _n.
+/// \param _v Scratch buffer of parabola locations, length _n.
+/// \param _z Scratch buffer of parabola boundaries, length _n + 1.
+void distanceTransform(
+    const double* _f, int _n, double* _d, int* _v, double* _z)
+{
+  const double infinity = std::numeric_limits<double>::infinity();
+
+  int k = 0;
+  _v[0] = 0;
+  _z[0] = -infinity;
+  _z[1] = infinity;
+
+  // Lower envelope of the parabolas rooted at every sample. _z[0] is -inf and
+  // s is always finite, so the inner loop stops at k == 0 at the latest.
+  for (int q = 1; q < _n; ++q)
+  {
+    double s = intersectParabolas(_f, q, _v[k]);
+    while (s <= _z[k])
+    {
+      --k;
+      s = intersectParabolas(_f, q, _v[k]);
+    }
+
+    ++k;
+    _v[k] = q;
+    _z[k] = s;
+    _z[k + 1] = infinity;
+  }
+
+  k = 0;
+  for (int q = 0; q < _n; ++q)
+  {
+    while (_z[k + 1] < q)
+      ++k;
+    const int p = _v[k];
+    _d[q] = (q - p) * (q - p) + _f[p];
+  }
+}
+
+} // namespace
+
+//==============================================================================
+SignedDistanceField::SignedDistanceField(
+    const Eigen::Vector3d& _origin,
+    double _resolution,
+    const Eigen::Vector3i& _numVoxels)
+  : mOrigin(_origin), mResolution(_resolution), mNumVoxels(_numVoxels)
+{
+  if (!(mResolution > 0.))
+  {
+    std::stringstream msg;
+    msg << "Resolution must be positive, got " << mResolution << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  if ((mNumVoxels.array() <= 0).any())
+  {
+    std::stringstream msg;
+    msg << "Number of voxels must be positive along every axis, got ["
+        << mNumVoxels.transpose() << "].";
+    throw std::invalid_argument(msg.str());
+  }
+
+  mHalfDiagonal = 0.5 * std::sqrt(3.) * mResolution;
+
+  const std::size_t numVoxels = static_cast<std::size_t>(mNumVoxels[0])
+                                * mNumVoxels[1] * mNumVoxels[2];
+  mOccupancy.assign(numVoxels, false);
+  mDistances.assign(numVoxels, std::numeric_limits<float>::infinity());
+}
+
+//==============================================================================
+const Eigen::Vector3d& SignedDistanceField::getOrigin() const
+{
+  return mOrigin;
+}
+
+//==============================================================================
+double SignedDistanceField::getResolution() const
+{
+  return mResolution;
+}
+
+//==============================================================================
+const Eigen::Vector3i& SignedDistanceField::getNumVoxels() const
+{
+  return mNumVoxels;
+}
+
+//==============================================================================
+Eigen::Vector3i SignedDistanceField::getVoxelIndex(
+    const Eigen::Vector3d& _point) const
+{
+  Eigen::Vector3i index;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double coordinate
+        = std::floor((_point[i] - mOrigin[i]) / mResolution);
+    const double clamped = std::max(
+        0., std::min(coordinate, static_cast<double>(mNumVoxels[i] - 1)));
+    index[i] = static_cast<int>(clamped);
+  }
+  return index;
+}
+
+//==============================================================================
+Eigen::Vector3d SignedDistanceField::getVoxelCenter(
+    const Eigen::Vector3i& _index) const
+{
+  return mOrigin
+         + mResolution * (_index.cast<double>().array() + 0.5).matrix();
+}
+
+//==============================================================================
+bool SignedDistanceField::isValidIndex(const Eigen::Vector3i& _index) const
+{
+  return (_index.array() >= 0).all()
+         && (_index.array() < mNumVoxels.array()).all();
+}
+
+//==============================================================================
+void SignedDistanceField::setOccupied(
+    const Eigen::Vector3i& _index, bool _occupied)
+{
+  checkIndex(_index);
+  mOccupancy[getLinearIndex(_index)] = _occupied;
+}
+
+//==============================================================================
+bool SignedDistanceField::isOccupied(const Eigen::Vector3i& _index) const
+{
+  checkIndex(_index);
+  return mOccupancy[getLinearIndex(_index)];
+}
+
+//==============================================================================
+void SignedDistanceField::update()
+{
+  std::vector<double> outside;
+  std::vector<double> inside;
+  computeSquaredDistances(true, outside);
+  computeSquaredDistances(false, inside);
+
+  const float infinity = std::numeric_limits<float>::infinity();
+
+  for (std::size_t i = 0; i < mDistances.size(); ++i)
+  {
+    if (mOccupancy[i])
+    {
+      mDistances[i] = inside[i] >= kUnreachable
+                          ? -infinity
+                          : static_cast<float>(
+                                -mResolution * std::sqrt(inside[i]));
+    }
+    else
+    {
+      mDistances[i] = outside[i] >= kUnreachable
+                          ? infinity
+                          : static_cast<float>(
+                                mResolution * std::sqrt(outside[i]));
+    }
+  }
+}
+
+//==============================================================================
+double SignedDistanceField::getSignedDistance(
+    const Eigen::Vector3i& _index) const
+{
+  checkIndex(_index);
+  return mDistances[getLinearIndex(_index)];
+}
+
+//==============================================================================
+double SignedDistanceField::getDistanceLowerBound(
+    const Eigen::Vector3d& _point) const
+{
+  const Eigen::Vector3i index = getVoxelIndex(_point);
+  const double distance = mDistances[getLinearIndex(index)];
+  const double offset = (_point - getVoxelCenter(index)).norm();
+
+  // The distance function is 1-Lipschitz, so moving from the voxel center to
+  // _point loses at most offset. Conservative voxelization places every
+  // point of the geometry within half a diagonal of an occupied center.
+  const double bound = distance - mHalfDiagonal - offset;
+
+  // Far outside of the grid the distance to the grid itself is tighter.
+  const Eigen::Vector3d gridMax
+      = mOrigin + mResolution * mNumVoxels.cast<double>();
+  const double gridDistance
+      = (mOrigin - _point).cwiseMax(_point - gridMax).cwiseMax(0.).norm();
+
+  return std::max(bound, gridDistance);
+}
+
+//==============================================================================
+std::size_t SignedDistanceField::getLinearIndex(
+    const Eigen::Vector3i& _index) const
+{
+  return static_cast<std::size_t>(_index[0])
+         + static_cast<std::size_t>(mNumVoxels[0])
+               * (_index[1]
+                  + static_cast<std::size_t>(mNumVoxels[1]) * _index[2]);
+}
+
+//==============================================================================
+void SignedDistanceField::checkIndex(const Eigen::Vector3i& _index) const
+{
+  if (!isValidIndex(_index))
+  {
+    std::stringstream msg;
+    msg << "Voxel index [" << _index.transpose()
+        << "] is outside of a grid of size [" << mNumVoxels.transpose()
+        << "].";
+    throw std::out_of_range(msg.str());
+  }
+}
+
+//==============================================================================
+void SignedDistanceField::computeSquaredDistances(
+    bool _target, std::vector<double>& _out) const
+{
+  _out.resize(mOccupancy.size());
+  for (std::size_t i = 0; i < mOccupancy.size(); ++i)
+    _out[i] = mOccupancy[i] == _target ? 0. : kUnreachable;
+
+  const int maxLength = mNumVoxels.maxCoeff();
+  std::vector<double> line(maxLength);
+  std::vector<double> transformed(maxLength);
+  std::vector<int> locations(maxLength);
+  std::vector<double> boundaries(maxLength + 1);
+
+  const std::size_t strides[3]
+      = {1u,
+         static_cast<std::size_t>(mNumVoxels[0]),
+         static_cast<std::size_t>(mNumVoxels[0]) * mNumVoxels[1]};
+
+  // The squared Euclidean distance transform is separable: transform every
+  // line along x, then y, then z.
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    const int length = mNumVoxels[axis];
+    const int other1 = mNumVoxels[(axis + 1) % 3];
+    const int other2 = mNumVoxels[(axis + 2) % 3];
+    const std::size_t stride = strides[axis];
+    const std::size_t stride1 = strides[(axis + 1) % 3];
+    const std::size_t stride2 = strides[(axis + 2) % 3];
+
+    for (int j = 0; j < other2; ++j)
+    {
+      for (int i = 0; i < other1; ++i)
+      {
+        const std::size_t start = i * stride1 + j * stride2;
+
+        for (int k = 0; k < length; ++k)
+          line[k] = _out[start + k * stride];
+
+        distanceTransform(
+            line.data(),
+            length,
+            transformed.data(),
+            locations.data(),
+            boundaries.data());
+
+        for (int k = 0; k < length; ++k)
+          _out[start + k * stride] = std::min(transformed[k], kUnreachable);
+      }
+    }
+  }
+}
+
+} // namespace constraint
+} // namespace aikido
@@ -0,0 +1,30 @@
+#ifndef AIKIDO_CONSTRAINT_DETAIL_COLLISIONOBJECTHELPERS_HPP_
+#define AIKIDO_CONSTRAINT_DETAIL_COLLISIONOBJECTHELPERS_HPP_
+
+#include <dart/collision/CollisionObject.hpp>
+#include <dart/dynamics/BodyNode.hpp>
+#include <dart/dynamics/ShapeNode.hpp>
+
+namespace aikido {
+namespace constraint {
+namespace detail {
+
+/// Returns the body node that owns the shape of a collision object, or
+/// nullptr if the shape frame is not a ShapeNode.
+inline const dart::dynamics::BodyNode* getBodyNode(
+    const dart::collision::CollisionObject* _object)
+{
+  const auto shapeNode = dynamic_cast<const dart::dynamics::ShapeNode*>(
+      _object->getShapeFrame());
+  if (!shapeNode)
+    return nullptr;
+
+  const dart::dynamics::BodyNode* bodyNode = shapeNode->getBodyNodePtr();
+  return bodyNode;
+}
+
+} // namespace detail
+} // namespace constraint
+} // namespace aikido
+
+#endif // AIKIDO_CONSTRAINT_DETAIL_COLLISIONOBJECTHELPERS_HPP_
@@ -1,5 +1,12 @@
 #include <aikido/distance/CartesianProductWeighted.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/distance/SO2Angular.hpp>
+#include <aikido/distance/detail/FlatMetricHelpers.hpp>
+#include <aikido/statespace/SO2.hpp>
+
 namespace aikido {
 namespace distance {
 
@@ -7,7 +14,7 @@ namespace distance {
 CartesianProductWeighted::CartesianProductWeighted(
     std::shared_ptr<statespace::CartesianProduct> _space,
     std::vector<DistanceMetricPtr> _metrics)
-  : mStateSpace(std::move(_space))
+  : mStateSpace(std::move(_space)), mIsFlattened(false)
 {
   if (mStateSpace == nullptr)
   {
@@ -43,13 +50,17 @@ CartesianProductWeighted::CartesianProductWeighted(
     }
     mMetrics.emplace_back(std::move(_metrics[i]), 1);
   }
+
+  flatten();
 }
 
 //==============================================================================
 CartesianProductWeighted::CartesianProductWeighted(
     std::shared_ptr<statespace::CartesianProduct> _space,
     std::vector<std::pair<DistanceMetricPtr, double>> _metrics)
-  : mStateSpace(std::move(_space)), mMetrics(std::move(_metrics))
+  : mStateSpace(std::move(_space))
+  , mMetrics(std::move(_metrics))
+  , mIsFlattened(false)
 {
   if (mStateSpace == nullptr)
   {
@@ -89,6 +100,8 @@ CartesianProductWeighted::CartesianProductWeighted(
       throw std::invalid_argument(msg.str());
     }
   }
+
+  flatten();
 }
 
 //==============================================================================
@@ -102,6 +115,13 @@ double CartesianProductWeighted::distance(
     const aikido::statespace::StateSpace::State* _state1,
     const aikido::statespace::StateSpace::State* _state2) const
 {
+  if (mIsFlattened)
+  {
+    return flatDistance(
+        reinterpret_cast<const double*>(_state1),
+        reinterpret_cast<const double*>(_state2));
+  }
+
   auto state1
       = static_cast<const statespace::CartesianProduct::State*>(_state1);
   auto state2
@@ -118,5 +138,238 @@ double CartesianProductWeighted::distance(
   return dist;
 }
 
+//==============================================================================
+double CartesianProductWeighted::distanceSquared(
+    const aikido::statespace::StateSpace::State* _state1,
+    const aikido::statespace::StateSpace::State* _state2) const
+{
+  // A single Euclidean component needs no square root at all.
+  if (mIsFlattened && mBlocks.size() == 1 && mFlatWeights.isZero(0.))
+  {
+    const Block& block = mBlocks.front();
+    const Eigen::Map<const Eigen::VectorXd> value1(
+        reinterpret_cast<const double*>(_state1) + block.mOffset,
+        block.mDimension);
+    const Eigen::Map<const Eigen::VectorXd> value2(
+        reinterpret_cast<const double*>(_state2) + block.mOffset,
+        block.mDimension);
+    return block.mWeight * block.mWeight * (value1 - value2).squaredNorm();
+  }
+
+  const double dist = distance(_state1, _state2);
+  return dist * dist;
+}
+
+//==============================================================================
+void CartesianProductWeighted::distanceBatch(
+    const aikido::statespace::StateSpace::State* _query,
+    const aikido::statespace::StateSpace::State* const* _states,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  if (mIsFlattened)
+  {
+    const auto numCoordinates = mFlatWeights.size();
+
+    Eigen::MatrixXd values(numCoordinates, _numStates);
+    for (std::size_t i = 0; i < _numStates; ++i)
+    {
+      values.col(i) = Eigen::Map<const Eigen::VectorXd>(
+          reinterpret_cast<const double*>(_states[i]), numCoordinates);
+    }
+
+    flatDistances(
+        reinterpret_cast<const double*>(_query), values, _distances);
+    return;
+  }
+
+  // Make one batch call per component instead of one call per component and
+  // state.
+  auto query = static_cast<const statespace::CartesianProduct::State*>(_query);
+
+  std::vector<const statespace::StateSpace::State*> subStates(_numStates);
+  std::vector<double> subDistances(_numStates);
+  std::fill(_distances, _distances + _numStates, 0.0);
+
+  for (std::size_t i = 0; i < mMetrics.size(); ++i)
+  {
+    for (std::size_t j = 0; j < _numStates; ++j)
+    {
+      subStates[j] = mStateSpace->getSubState<>(
+          static_cast<const statespace::CartesianProduct::State*>(_states[j]),
+          i);
+    }
+
+    mMetrics[i].first->distanceBatch(
+        mStateSpace->getSubState<>(query, i),
+        subStates.data(),
+        _numStates,
+        subDistances.data());
+
+    for (std::size_t j = 0; j < _numStates; ++j)
+      _distances[j] += mMetrics[i].second * subDistances[j];
+  }
+}
+
+//==============================================================================
+void CartesianProductWeighted::distanceBatchInBuffer(
+    const aikido::statespace::StateSpace::State* _query,
+    const void* _buffer,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  if (mIsFlattened)
+  {
+    flatDistances(
+        reinterpret_cast<const double*>(_query),
+        Eigen::Map<const Eigen::MatrixXd>(
+            static_cast<const double*>(_buffer),
+            mFlatWeights.size(),
+            _numStates),
+        _distances);
+    return;
+  }
+
+  const auto stateSize = mStateSpace->getStateSizeInBytes();
+  const auto buffer = static_cast<const unsigned char*>(_buffer);
+
+  std::vector<const statespace::StateSpace::State*> states(_numStates);
+  for (std::size_t i = 0; i < _numStates; ++i)
+  {
+    states[i] = reinterpret_cast<const statespace::StateSpace::State*>(
+        buffer + i * stateSize);
+  }
+
+  distanceBatch(_query, states.data(), _numStates, _distances);
+}
+
+//==============================================================================
+const std::vector<std::pair<DistanceMetricPtr, double>>&
+CartesianProductWeighted::getMetrics() const
+{
+  return mMetrics;
+}
+
+//==============================================================================
+bool CartesianProductWeighted::isFlattened() const
+{
+  return mIsFlattened;
+}
+
+//==============================================================================
+void CartesianProductWeighted::flatten()
+{
+  mIsFlattened = false;
+
+  std::size_t numCoordinates = 0;
+  for (const auto& metric : mMetrics)
+  {
+    if (!detail::isEuclidean(*metric.first)
+        && !dynamic_cast<const SO2Angular*>(metric.first.get()))
+      return;
+
+    numCoordinates += metric.first->getStateSpace()->getDimension();
+  }
+
+  // Every component must be stored as contiguous doubles for the flat state
+  // to line up with the coordinates.
+  if (mStateSpace->getStateSizeInBytes() != numCoordinates * sizeof(double))
+    return;
+
+  mFlatWeights = Eigen::ArrayXd::Zero(numCoordinates);
+  mFlatWrapMask.setConstant(numCoordinates, false);
+  mBlocks.clear();
+
+  std::size_t offset = 0;
+  for (const auto& metric : mMetrics)
+  {
+    const std::size_t dimension
+        = metric.first->getStateSpace()->getDimension();
+
+    if (dimension == 1)
+    {
+      mFlatWeights[offset] = metric.second;
+      mFlatWrapMask[offset]
+          = dynamic_cast<const SO2Angular*>(metric.first.get()) != nullptr;
+    }
+    else if (dimension > 1)
+    {
+      mBlocks.push_back(Block{offset, dimension, metric.second});
+    }
+
+    offset += dimension;
+  }
+
+  mIsFlattened = true;
+}
+
+//==============================================================================
+double CartesianProductWeighted::flatDistance(
+    const double* _value1, const double* _value2) const
+{
+  double dist = 0.0;
+
+  for (Eigen::Index i = 0; i < mFlatWeights.size(); ++i)
+  {
+    double diff = std::abs(_value1[i] - _value2[i]);
+
+    // Same as SO2Angular for the wrapped coordinates: reduce the absolute
+    // difference modulo 2 pi and take the shorter way around the circle.
+    if (mFlatWrapMask[i])
+    {
+      diff -= (2.0 * M_PI) * std::floor(diff * (0.5 / M_PI));
+      diff = std::min(diff, 2.0 * M_PI - diff);
+    }
+
+    dist += mFlatWeights[i] * diff;
+  }
+
+  for (const auto& block : mBlocks)
+  {
+    double squaredNorm = 0.0;
+    for (std::size_t i = block.mOffset; i < block.mOffset + block.mDimension;
+         ++i)
+    {
+      const double diff = _value1[i] - _value2[i];
+      squaredNorm += diff * diff;
+    }
+    dist += block.mWeight * std::sqrt(squaredNorm);
+  }
+
+  return dist;
+}
+
+//==============================================================================
+void CartesianProductWeighted::flatDistances(
+    const double* _query,
+    const Eigen::Ref<const Eigen::MatrixXd>& _values,
+    double* _distances) const
+{
+  const auto numStates = _values.cols();
+  const Eigen::Map<const Eigen::VectorXd> query(_query, mFlatWeights.size());
+
+  // Same as flatDistance(), with one state per column.
+  const Eigen::ArrayXXd diff = (_values.colwise() - query).array().abs();
+  const Eigen::ArrayXXd wrapped
+      = diff - (2.0 * M_PI) * (diff * (0.5 / M_PI)).floor();
+  const Eigen::ArrayXXd angular = wrapped.min(2.0 * M_PI - wrapped);
+
+  Eigen::Map<Eigen::RowVectorXd> distances(_distances, numStates);
+  distances = mFlatWeights.matrix().transpose()
+              * mFlatWrapMask.replicate(1, numStates)
+                    .select(angular, diff)
+                    .matrix();
+
+  for (const auto& block : mBlocks)
+  {
+    distances += block.mWeight
+                 * (_values.middleRows(block.mOffset, block.mDimension)
+                        .colwise()
+                    - query.segment(block.mOffset, block.mDimension))
+                       .colwise()
+                       .norm();
+  }
+}
+
 } // namespace distance
 } // namespace aikido
@@ -0,0 +1,85 @@
+#include <aikido/distance/DistanceMetric.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace aikido {
+namespace distance {
+
+//==============================================================================
+double DistanceMetric::distanceSquared(
+    const statespace::StateSpace::State* _state1,
+    const statespace::StateSpace::State* _state2) const
+{
+  const double dist = distance(_state1, _state2);
+  return dist * dist;
+}
+
+//==============================================================================
+void DistanceMetric::distanceBatch(
+    const statespace::StateSpace::State* _query,
+    const statespace::StateSpace::State* const* _states,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  for (std::size_t i = 0; i < _numStates; ++i)
+    _distances[i] = distance(_query, _states[i]);
+}
+
+//==============================================================================
+void DistanceMetric::distanceBatchInBuffer(
+    const statespace::StateSpace::State* _query,
+    const void* _buffer,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  const auto stateSize = getStateSpace()->getStateSizeInBytes();
+  const auto buffer = static_cast<const unsigned char*>(_buffer);
+
+  for (std::size_t i = 0; i < _numStates; ++i)
+  {
+    _distances[i] = distance(
+        _query,
+        reinterpret_cast<const statespace::StateSpace::State*>(
+            buffer + i * stateSize));
+  }
+}
+
+//==============================================================================
+std::vector<std::size_t> findKNearest(
+    const DistanceMetric& _metric,
+    const statespace::StateSpace::State* _query,
+    const statespace::StateSpace::State* const* _states,
+    std::size_t _numStates,
+    std::size_t _k,
+    std::vector<double>* _distances)
+{
+  std::vector<double> distances(_numStates);
+  _metric.distanceBatch(_query, _states, _numStates, distances.data());
+
+  std::vector<std::size_t> indices(_numStates);
+  std::iota(indices.begin(), indices.end(), 0);
+
+  const auto isCloser = [&distances](std::size_t _i, std::size_t _j) {
+    return distances[_i] < distances[_j]
+           || (distances[_i] == distances[_j] && _i < _j);
+  };
+
+  const auto numNeighbors = std::min(_k, _numStates);
+  std::partial_sort(
+      indices.begin(), indices.begin() + numNeighbors, indices.end(), isCloser);
+  indices.resize(numNeighbors);
+
+  if (_distances)
+  {
+    _distances->clear();
+    _distances->reserve(numNeighbors);
+    for (const auto index : indices)
+      _distances->push_back(distances[index]);
+  }
+
+  return indices;
+}
+
+} // namespace distance
+} // namespace aikido
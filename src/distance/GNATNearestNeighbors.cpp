@@ -0,0 +1,323 @@
+#include <aikido/distance/GNATNearestNeighbors.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <aikido/distance/detail/NeighborCollector.hpp>
+
+namespace aikido {
+namespace distance {
+
+//==============================================================================
+struct GNATNearestNeighbors::Node
+{
+  /// Indices of the states in a leaf. Empty for internal nodes.
+  std::vector<std::size_t> mPoints;
+
+  /// Indices of the pivot states of an internal node. Empty for leaves.
+  std::vector<std::size_t> mPivots;
+
+  /// Children of an internal node. The i-th child holds the states that are
+  /// closer to the i-th pivot than to any other pivot.
+  std::vector<std::unique_ptr<Node>> mChildren;
+
+  /// Range of distances from the i-th pivot to the states of the j-th child,
+  /// stored at index i * mPivots.size() + j.
+  std::vector<std::pair<double, double>> mRanges;
+};
+
+//==============================================================================
+GNATNearestNeighbors::GNATNearestNeighbors(
+    DistanceMetricPtr _metric, std::size_t _degree, std::size_t _maxLeafSize)
+  : mMetric(std::move(_metric)), mDegree(_degree), mMaxLeafSize(_maxLeafSize)
+{
+  if (!mMetric)
+    throw std::invalid_argument("DistanceMetric is nullptr.");
+
+  if (mDegree < 2)
+  {
+    std::stringstream msg;
+    msg << "Degree must be at least 2, got " << mDegree << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  if (mMaxLeafSize < mDegree)
+  {
+    std::stringstream msg;
+    msg << "Maximum leaf size must be at least the degree " << mDegree
+        << ", got " << mMaxLeafSize << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  clear();
+}
+
+//==============================================================================
+GNATNearestNeighbors::~GNATNearestNeighbors() = default;
+
+//==============================================================================
+DistanceMetricPtr GNATNearestNeighbors::getDistanceMetric() const
+{
+  return mMetric;
+}
+
+//==============================================================================
+std::size_t GNATNearestNeighbors::add(
+    const statespace::StateSpace::State* _state)
+{
+  const std::size_t index = mStates.size();
+  mStates.push_back(_state);
+  insert(*mRoot, index);
+  return index;
+}
+
+//==============================================================================
+void GNATNearestNeighbors::clear()
+{
+  mStates.clear();
+  mRoot.reset(new Node);
+}
+
+//==============================================================================
+std::size_t GNATNearestNeighbors::size() const
+{
+  return mStates.size();
+}
+
+//==============================================================================
+const statespace::StateSpace::State* GNATNearestNeighbors::getState(
+    std::size_t _index) const
+{
+  return mStates.at(_index);
+}
+
+//==============================================================================
+auto GNATNearestNeighbors::nearest(
+    const statespace::StateSpace::State* _query) const -> Neighbor
+{
+  if (mStates.empty())
+    throw std::runtime_error("Nearest neighbors index is empty.");
+
+  return nearestK(_query, 1).front();
+}
+
+//==============================================================================
+auto GNATNearestNeighbors::nearestK(
+    const statespace::StateSpace::State* _query, std::size_t _k) const
+    -> std::vector<Neighbor>
+{
+  detail::NeighborCollector collector(
+      _k, std::numeric_limits<double>::infinity());
+  search(*mRoot, _query, collector);
+  return collector.getNeighbors();
+}
+
+//==============================================================================
+auto GNATNearestNeighbors::nearestR(
+    const statespace::StateSpace::State* _query, double _radius) const
+    -> std::vector<Neighbor>
+{
+  detail::NeighborCollector collector(
+      std::numeric_limits<std::size_t>::max(), _radius);
+  search(*mRoot, _query, collector);
+  return collector.getNeighbors();
+}
+
+//==============================================================================
+void GNATNearestNeighbors::insert(Node& _node, std::size_t _index)
+{
+  if (_node.mPivots.empty())
+  {
+    _node.mPoints.push_back(_index);
+    if (_node.mPoints.size() > mMaxLeafSize)
+      split(_node);
+    return;
+  }
+
+  const std::size_t numPivots = _node.mPivots.size();
+
+  std::vector<const statespace::StateSpace::State*> pivots;
+  pivots.reserve(numPivots);
+  for (const auto pivot : _node.mPivots)
+    pivots.push_back(mStates[pivot]);
+
+  std::vector<double> distances(numPivots);
+  mMetric->distanceBatch(
+      mStates[_index], pivots.data(), numPivots, distances.data());
+
+  const std::size_t child
+      = std::min_element(distances.begin(), distances.end())
+        - distances.begin();
+
+  for (std::size_t i = 0; i < numPivots; ++i)
+  {
+    auto& range = _node.mRanges[i * numPivots + child];
+    range.first = std::min(range.first, distances[i]);
+    range.second = std::max(range.second, distances[i]);
+  }
+
+  insert(*_node.mChildren[child], _index);
+}
+
+//==============================================================================
+void GNATNearestNeighbors::split(Node& _node)
+{
+  const std::vector<std::size_t>& points = _node.mPoints;
+  const std::size_t numPoints = points.size();
+
+  std::vector<const statespace::StateSpace::State*> states;
+  states.reserve(numPoints);
+  for (const auto point : points)
+    states.push_back(mStates[point]);
+
+  // Choose pivots that are far apart: every pivot is the point that is
+  // farthest from all previous pivots.
+  std::vector<std::size_t> pivots{0};
+  std::vector<std::vector<double>> pivotDistances;
+  std::vector<double> minDistances(
+      numPoints, std::numeric_limits<double>::infinity());
+
+  while (true)
+  {
+    pivotDistances.emplace_back(numPoints);
+    mMetric->distanceBatch(
+        states[pivots.back()],
+        states.data(),
+        numPoints,
+        pivotDistances.back().data());
+
+    for (std::size_t j = 0; j < numPoints; ++j)
+      minDistances[j] = std::min(minDistances[j], pivotDistances.back()[j]);
+
+    if (pivots.size() == mDegree)
+      break;
+
+    const std::size_t farthest
+        = std::max_element(minDistances.begin(), minDistances.end())
+          - minDistances.begin();
+
+    // The remaining points coincide with a pivot.
+    if (!(minDistances[farthest] > 0.))
+      break;
+
+    pivots.push_back(farthest);
+  }
+
+  // All points coincide, so they cannot be separated.
+  if (pivots.size() < 2)
+    return;
+
+  const std::size_t numPivots = pivots.size();
+
+  _node.mChildren.clear();
+  for (std::size_t i = 0; i < numPivots; ++i)
+    _node.mChildren.emplace_back(new Node);
+
+  _node.mRanges.assign(
+      numPivots * numPivots,
+      std::make_pair(
+          std::numeric_limits<double>::infinity(),
+          -std::numeric_limits<double>::infinity()));
+
+  for (std::size_t j = 0; j < numPoints; ++j)
+  {
+    std::size_t child = 0;
+    for (std::size_t i = 1; i < numPivots; ++i)
+    {
+      if (pivotDistances[i][j] < pivotDistances[child][j])
+        child = i;
+    }
+
+    for (std::size_t i = 0; i < numPivots; ++i)
+    {
+      auto& range = _node.mRanges[i * numPivots + child];
+      range.first = std::min(range.first, pivotDistances[i][j]);
+      range.second = std::max(range.second, pivotDistances[i][j]);
+    }
+
+    _node.mChildren[child]->mPoints.push_back(points[j]);
+  }
+
+  _node.mPivots.clear();
+  for (const auto pivot : pivots)
+    _node.mPivots.push_back(points[pivot]);
+
+  _node.mPoints.clear();
+  _node.mPoints.shrink_to_fit();
+
+  // Every child holds at least its pivot, so it holds fewer points than this
+  // node did and splitting terminates.
+  for (const auto& child : _node.mChildren)
+  {
+    if (child->mPoints.size() > mMaxLeafSize)
+      split(*child);
+  }
+}
+
+//==============================================================================
+void GNATNearestNeighbors::search(
+    const Node& _node,
+    const statespace::StateSpace::State* _query,
+    detail::NeighborCollector& _collector) const
+{
+  if (_node.mPivots.empty())
+  {
+    const std::size_t numPoints = _node.mPoints.size();
+
+    std::vector<const statespace::StateSpace::State*> states;
+    states.reserve(numPoints);
+    for (const auto point : _node.mPoints)
+      states.push_back(mStates[point]);
+
+    std::vector<double> distances(numPoints);
+    mMetric->distanceBatch(
+        _query, states.data(), numPoints, distances.data());
+
+    for (std::size_t j = 0; j < numPoints; ++j)
+      _collector.add(_node.mPoints[j], distances[j]);
+    return;
+  }
+
+  const std::size_t numPivots = _node.mPivots.size();
+
+  std::vector<const statespace::StateSpace::State*> pivots;
+  pivots.reserve(numPivots);
+  for (const auto pivot : _node.mPivots)
+    pivots.push_back(mStates[pivot]);
+
+  std::vector<double> distances(numPivots);
+  mMetric->distanceBatch(_query, pivots.data(), numPivots, distances.data());
+
+  // By the triangle inequality, no state in the j-th child is closer to the
+  // query than |d(query, pivot i) - d(pivot i, state)| for any pivot i.
+  std::vector<double> lowerBounds(numPivots, 0.);
+  for (std::size_t i = 0; i < numPivots; ++i)
+  {
+    for (std::size_t j = 0; j < numPivots; ++j)
+    {
+      const auto& range = _node.mRanges[i * numPivots + j];
+      lowerBounds[j] = std::max(
+          lowerBounds[j],
+          std::max(range.first - distances[i], distances[i] - range.second));
+    }
+  }
+
+  // Visit the children closest to the query first to shrink the bound.
+  std::vector<std::size_t> order(numPivots);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(
+      order.begin(), order.end(), [&](std::size_t _left, std::size_t _right) {
+        return distances[_left] < distances[_right];
+      });
+
+  for (const auto child : order)
+  {
+    if (lowerBounds[child] <= _collector.getBound())
+      search(*_node.mChildren[child], _query, _collector);
+  }
+}
+
+} // namespace distance
+} // namespace aikido
@@ -0,0 +1,398 @@
+#include <aikido/distance/KdTreeNearestNeighbors.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <aikido/distance/CartesianProductWeighted.hpp>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/distance/SO2Angular.hpp>
+#include <aikido/distance/detail/FlatMetricHelpers.hpp>
+#include <aikido/distance/detail/NeighborCollector.hpp>
+
+namespace aikido {
+namespace distance {
+
+namespace {
+
+/// Maximum number of points in a leaf before it is split.
+constexpr std::size_t kMaxLeafSize = 16;
+
+/// Marks a node as a leaf.
+constexpr int kLeaf = -1;
+
+//==============================================================================
+/// Returns _angle wrapped into [-pi, pi).
+double normalizeAngle(double _angle)
+{
+  return _angle - 2.0 * M_PI * std::floor((_angle + M_PI) / (2.0 * M_PI));
+}
+
+} // namespace
+
+//==============================================================================
+KdTreeNearestNeighbors::KdTreeNearestNeighbors(DistanceMetricPtr _metric)
+  : mMetric(std::move(_metric)), mNumCoordinates(0)
+{
+  if (!mMetric)
+    throw std::invalid_argument("DistanceMetric is nullptr.");
+
+  if (!computeComponents(*mMetric, mComponents))
+  {
+    throw std::invalid_argument(
+        "KdTreeNearestNeighbors only supports REuclidean, SO2Angular and "
+        "flattened CartesianProductWeighted metrics.");
+  }
+
+  for (const auto& component : mComponents)
+  {
+    mNumCoordinates += component.mDimension;
+    mIsAngle.insert(mIsAngle.end(), component.mDimension, component.mIsAngle);
+  }
+
+  clear();
+}
+
+//==============================================================================
+bool KdTreeNearestNeighbors::isSupported(const DistanceMetric& _metric)
+{
+  std::vector<Component> components;
+  return computeComponents(_metric, components);
+}
+
+//==============================================================================
+DistanceMetricPtr KdTreeNearestNeighbors::getDistanceMetric() const
+{
+  return mMetric;
+}
+
+//==============================================================================
+std::size_t KdTreeNearestNeighbors::add(
+    const statespace::StateSpace::State* _state)
+{
+  const std::size_t index = mStates.size();
+  const Eigen::VectorXd coordinates = getCoordinates(_state);
+
+  mStates.push_back(_state);
+  mCoordinates.insert(
+      mCoordinates.end(),
+      coordinates.data(),
+      coordinates.data() + mNumCoordinates);
+
+  std::size_t node = 0;
+  while (mNodes[node].mSplitCoordinate != kLeaf)
+  {
+    const Node& internal = mNodes[node];
+    node = internal.mChildren
+        [coordinates[internal.mSplitCoordinate] < internal.mSplitValue ? 0 : 1];
+  }
+
+  mNodes[node].mPoints.push_back(index);
+  if (mNodes[node].mPoints.size() > kMaxLeafSize)
+    splitLeaf(node);
+
+  return index;
+}
+
+//==============================================================================
+void KdTreeNearestNeighbors::clear()
+{
+  mCoordinates.clear();
+  mStates.clear();
+
+  mNodes.clear();
+  mNodes.push_back(Node{kLeaf, 0., {{0, 0}}, {}});
+}
+
+//==============================================================================
+std::size_t KdTreeNearestNeighbors::size() const
+{
+  return mStates.size();
+}
+
+//==============================================================================
+const statespace::StateSpace::State* KdTreeNearestNeighbors::getState(
+    std::size_t _index) const
+{
+  return mStates.at(_index);
+}
+
+//==============================================================================
+auto KdTreeNearestNeighbors::nearest(
+    const statespace::StateSpace::State* _query) const -> Neighbor
+{
+  if (mStates.empty())
+    throw std::runtime_error("Nearest neighbors index is empty.");
+
+  return nearestK(_query, 1).front();
+}
+
+//==============================================================================
+auto KdTreeNearestNeighbors::nearestK(
+    const statespace::StateSpace::State* _query, std::size_t _k) const
+    -> std::vector<Neighbor>
+{
+  detail::NeighborCollector collector(
+      _k, std::numeric_limits<double>::infinity());
+
+  const Eigen::VectorXd query = getCoordinates(_query);
+  Eigen::VectorXd offsets = Eigen::VectorXd::Zero(mNumCoordinates);
+  search(0, query, offsets, 0., collector);
+
+  return collector.getNeighbors();
+}
+
+//==============================================================================
+auto KdTreeNearestNeighbors::nearestR(
+    const statespace::StateSpace::State* _query, double _radius) const
+    -> std::vector<Neighbor>
+{
+  detail::NeighborCollector collector(
+      std::numeric_limits<std::size_t>::max(), _radius);
+
+  const Eigen::VectorXd query = getCoordinates(_query);
+  Eigen::VectorXd offsets = Eigen::VectorXd::Zero(mNumCoordinates);
+  search(0, query, offsets, 0., collector);
+
+  return collector.getNeighbors();
+}
+
+//==============================================================================
+bool KdTreeNearestNeighbors::computeComponents(
+    const DistanceMetric& _metric, std::vector<Component>& _components)
+{
+  _components.clear();
+
+  if (auto product = dynamic_cast<const CartesianProductWeighted*>(&_metric))
+  {
+    if (!product->isFlattened())
+      return false;
+
+    std::size_t offset = 0;
+    for (const auto& metric : product->getMetrics())
+    {
+      const std::size_t dimension
+          = metric.first->getStateSpace()->getDimension();
+      const bool isAngle
+          = dynamic_cast<const SO2Angular*>(metric.first.get()) != nullptr;
+
+      _components.push_back(
+          Component{offset, dimension, metric.second, isAngle});
+      offset += dimension;
+    }
+    return true;
+  }
+
+  if (dynamic_cast<const SO2Angular*>(&_metric))
+  {
+    _components.push_back(Component{0, 1, 1., true});
+    return true;
+  }
+
+  if (detail::isEuclidean(_metric))
+  {
+    _components.push_back(
+        Component{0, _metric.getStateSpace()->getDimension(), 1., false});
+    return true;
+  }
+
+  return false;
+}
+
+//==============================================================================
+Eigen::VectorXd KdTreeNearestNeighbors::getCoordinates(
+    const statespace::StateSpace::State* _state) const
+{
+  Eigen::VectorXd coordinates = Eigen::Map<const Eigen::VectorXd>(
+      reinterpret_cast<const double*>(_state), mNumCoordinates);
+
+  for (std::size_t i = 0; i < mNumCoordinates; ++i)
+  {
+    if (mIsAngle[i])
+      coordinates[i] = normalizeAngle(coordinates[i]);
+  }
+
+  return coordinates;
+}
+
+//==============================================================================
+double KdTreeNearestNeighbors::computeDistance(
+    const double* _value1, const double* _value2) const
+{
+  double distance = 0.;
+  for (const auto& component : mComponents)
+  {
+    if (component.mDimension == 1)
+    {
+      double diff = std::abs(
+          _value1[component.mOffset] - _value2[component.mOffset]);
+
+      // Normalized angles differ by less than 2 pi.
+      if (component.mIsAngle)
+        diff = std::min(diff, 2.0 * M_PI - diff);
+
+      distance += component.mWeight * diff;
+    }
+    else if (component.mDimension > 1)
+    {
+      distance += component.mWeight
+                  * (Eigen::Map<const Eigen::VectorXd>(
+                         _value1 + component.mOffset, component.mDimension)
+                     - Eigen::Map<const Eigen::VectorXd>(
+                           _value2 + component.mOffset, component.mDimension))
+                        .norm();
+    }
+  }
+  return distance;
+}
+
+//==============================================================================
+double KdTreeNearestNeighbors::computeLowerBound(
+    const Eigen::VectorXd& _offsets) const
+{
+  double bound = 0.;
+  for (const auto& component : mComponents)
+  {
+    bound += component.mWeight
+             * _offsets.segment(component.mOffset, component.mDimension)
+                   .norm();
+  }
+  return bound;
+}
+
+//==============================================================================
+void KdTreeNearestNeighbors::splitLeaf(std::size_t _node)
+{
+  std::vector<std::size_t> points = mNodes[_node].mPoints;
+
+  // Split along the coordinate with the largest weighted spread.
+  int splitCoordinate = kLeaf;
+  double maxSpread = 0.;
+  for (const auto& component : mComponents)
+  {
+    for (std::size_t i = component.mOffset;
+         i < component.mOffset + component.mDimension;
+         ++i)
+    {
+      double min = std::numeric_limits<double>::infinity();
+      double max = -std::numeric_limits<double>::infinity();
+      for (const auto point : points)
+      {
+        min = std::min(min, mCoordinates[point * mNumCoordinates + i]);
+        max = std::max(max, mCoordinates[point * mNumCoordinates + i]);
+      }
+
+      const double spread = component.mWeight * (max - min);
+      if (spread > maxSpread)
+      {
+        maxSpread = spread;
+        splitCoordinate = static_cast<int>(i);
+      }
+    }
+  }
+
+  // All points coincide, so splitting would not separate them.
+  if (splitCoordinate == kLeaf)
+    return;
+
+  std::vector<double> values;
+  values.reserve(points.size());
+  for (const auto point : points)
+    values.push_back(mCoordinates[point * mNumCoordinates + splitCoordinate]);
+  std::sort(values.begin(), values.end());
+
+  // Split at the median, but make sure that both children receive points.
+  double splitValue = values[values.size() / 2];
+  if (splitValue == values.front())
+    splitValue = *std::upper_bound(values.begin(), values.end(), splitValue);
+
+  Node left{kLeaf, 0., {{0, 0}}, {}};
+  Node right{kLeaf, 0., {{0, 0}}, {}};
+  for (const auto point : points)
+  {
+    if (mCoordinates[point * mNumCoordinates + splitCoordinate] < splitValue)
+      left.mPoints.push_back(point);
+    else
+      right.mPoints.push_back(point);
+  }
+
+  const std::size_t leftIndex = mNodes.size();
+  mNodes.push_back(std::move(left));
+  mNodes.push_back(std::move(right));
+
+  Node& node = mNodes[_node];
+  node.mSplitCoordinate = splitCoordinate;
+  node.mSplitValue = splitValue;
+  node.mChildren = {{leftIndex, leftIndex + 1}};
+  node.mPoints.clear();
+  node.mPoints.shrink_to_fit();
+}
+
+//==============================================================================
+void KdTreeNearestNeighbors::search(
+    std::size_t _node,
+    const Eigen::VectorXd& _query,
+    Eigen::VectorXd& _offsets,
+    double _lowerBound,
+    detail::NeighborCollector& _collector) const
+{
+  if (_lowerBound > _collector.getBound())
+    return;
+
+  const Node& node = mNodes[_node];
+  if (node.mSplitCoordinate == kLeaf)
+  {
+    for (const auto point : node.mPoints)
+    {
+      _collector.add(
+          point,
+          computeDistance(
+              _query.data(), &mCoordinates[point * mNumCoordinates]));
+    }
+    return;
+  }
+
+  const auto coordinate = node.mSplitCoordinate;
+  const double query = _query[coordinate];
+  const double split = node.mSplitValue;
+  const std::size_t nearChild = query < split ? 0 : 1;
+
+  search(node.mChildren[nearChild], _query, _offsets, _lowerBound, _collector);
+
+  // Distance along this coordinate from the query to the far half-space. On
+  // an SO2 coordinate the far side may also be reached across +/- pi.
+  double offset = std::abs(query - split);
+  if (mIsAngle[coordinate])
+  {
+    if (nearChild == 0)
+      offset = std::min(offset, query + M_PI);
+    else
+      offset = std::min(offset, M_PI - query);
+  }
+
+  const double previousOffset = _offsets[coordinate];
+  if (offset > previousOffset)
+  {
+    _offsets[coordinate] = offset;
+    search(
+        node.mChildren[1 - nearChild],
+        _query,
+        _offsets,
+        computeLowerBound(_offsets),
+        _collector);
+    _offsets[coordinate] = previousOffset;
+  }
+  else
+  {
+    search(
+        node.mChildren[1 - nearChild],
+        _query,
+        _offsets,
+        _lowerBound,
+        _collector);
+  }
+}
+
+} // namespace distance
+} // namespace aikido
@@ -0,0 +1,28 @@
+#include <aikido/distance/NearestNeighbors.hpp>
+
+#include <stdexcept>
+#include <aikido/distance/GNATNearestNeighbors.hpp>
+#include <aikido/distance/KdTreeNearestNeighbors.hpp>
+
+namespace aikido {
+namespace distance {
+
+//==============================================================================
+std::unique_ptr<NearestNeighbors> createNearestNeighbors(
+    DistanceMetricPtr _metric)
+{
+  if (!_metric)
+    throw std::invalid_argument("DistanceMetric is nullptr.");
+
+  if (KdTreeNearestNeighbors::isSupported(*_metric))
+  {
+    return std::unique_ptr<NearestNeighbors>(
+        new KdTreeNearestNeighbors(std::move(_metric)));
+  }
+
+  return std::unique_ptr<NearestNeighbors>(
+      new GNATNearestNeighbors(std::move(_metric)));
+}
+
+} // namespace distance
+} // namespace aikido
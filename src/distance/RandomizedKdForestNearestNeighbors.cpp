@@ -0,0 +1,509 @@
+#include <aikido/distance/RandomizedKdForestNearestNeighbors.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <aikido/distance/detail/NeighborCollector.hpp>
+#include <aikido/statespace/CartesianProduct.hpp>
+#include <aikido/statespace/SO2.hpp>
+
+namespace aikido {
+namespace distance {
+
+namespace {
+
+/// Maximum number of points in a leaf before it is split.
+constexpr std::size_t kMaxLeafSize = 16;
+
+/// Marks a node as a leaf.
+constexpr int kLeaf = -1;
+
+/// Number of states sampled to estimate the variance of every coordinate.
+constexpr std::size_t kNumVarianceSamples = 100;
+
+/// Number of highest-variance coordinates among which split coordinates are
+/// chosen at random.
+constexpr std::size_t kNumSplitCandidates = 5;
+
+/// Minimum number of states before the forest is rebuilt.
+constexpr std::size_t kMinBuildSize = 1024;
+
+/// A subtree that has not been explored yet.
+struct Branch
+{
+  /// Lower bound on the squared tangent distance from the query to the cell.
+  double mKey;
+  std::size_t mTree;
+  std::size_t mNode;
+
+  bool operator>(const Branch& _other) const
+  {
+    return mKey > _other.mKey;
+  }
+};
+
+//==============================================================================
+/// Appends whether each tangent coordinate of _space is an SO2 angle to
+/// _isAngle.
+void findAngles(
+    const statespace::StateSpace& _space, std::vector<bool>& _isAngle)
+{
+  if (dynamic_cast<const statespace::SO2*>(&_space))
+  {
+    _isAngle.push_back(true);
+  }
+  else if (
+      auto product = dynamic_cast<const statespace::CartesianProduct*>(&_space))
+  {
+    for (std::size_t i = 0; i < product->getNumSubspaces(); ++i)
+      findAngles(*product->getSubspace<>(i), _isAngle);
+  }
+  else
+  {
+    _isAngle.insert(_isAngle.end(), _space.getDimension(), false);
+  }
+}
+
+} // namespace
+
+//==============================================================================
+RandomizedKdForestNearestNeighbors::RandomizedKdForestNearestNeighbors(
+    DistanceMetricPtr _metric,
+    std::size_t _numTrees,
+    std::size_t _maxChecks,
+    std::size_t _numThreads)
+  : mMetric(std::move(_metric))
+  , mNumTrees(_numTrees)
+  , mNumThreads(_numThreads)
+  , mNumBuilt(0)
+{
+  if (!mMetric)
+    throw std::invalid_argument("DistanceMetric is nullptr.");
+
+  if (mNumTrees == 0)
+    throw std::invalid_argument("Number of trees must be positive.");
+
+  setMaxChecks(_maxChecks);
+
+  if (mNumThreads == 0)
+    mNumThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  mStateSpace = mMetric->getStateSpace();
+  mDimension = mStateSpace->getDimension();
+  findAngles(*mStateSpace, mIsAngle);
+
+  mTrees.resize(mNumTrees);
+  clear();
+}
+
+//==============================================================================
+void RandomizedKdForestNearestNeighbors::setMaxChecks(std::size_t _maxChecks)
+{
+  if (_maxChecks == 0)
+    throw std::invalid_argument("Maximum number of checks must be positive.");
+
+  mMaxChecks = _maxChecks;
+}
+
+//==============================================================================
+std::size_t RandomizedKdForestNearestNeighbors::getMaxChecks() const
+{
+  return mMaxChecks;
+}
+
+//==============================================================================
+void RandomizedKdForestNearestNeighbors::build()
+{
+  const std::size_t numStates = mStates.size();
+
+  parallelFor(mNumTrees, [&](std::size_t _tree) {
+    Tree& tree = mTrees[_tree];
+    resetTree(tree, _tree);
+
+    std::vector<std::size_t> indices(numStates);
+    std::iota(indices.begin(), indices.end(), 0);
+    buildNode(tree, 0, indices, 0, numStates);
+  });
+
+  mNumBuilt = numStates;
+}
+
+//==============================================================================
+DistanceMetricPtr RandomizedKdForestNearestNeighbors::getDistanceMetric() const
+{
+  return mMetric;
+}
+
+//==============================================================================
+std::size_t RandomizedKdForestNearestNeighbors::add(
+    const statespace::StateSpace::State* _state)
+{
+  const std::size_t index = mStates.size();
+
+  const Eigen::VectorXd coordinates = getCoordinates(_state);
+
+  mStates.push_back(_state);
+  mCoordinates.insert(
+      mCoordinates.end(), coordinates.data(), coordinates.data() + mDimension);
+
+  if (mStates.size() >= kMinBuildSize && mStates.size() >= 2 * mNumBuilt)
+  {
+    build();
+    return index;
+  }
+
+  for (auto& tree : mTrees)
+  {
+    std::size_t node = 0;
+    while (tree.mNodes[node].mSplitCoordinate != kLeaf)
+    {
+      const Node& internal = tree.mNodes[node];
+      node = internal.mChildren
+          [coordinates[internal.mSplitCoordinate] < internal.mSplitValue ? 0
+                                                                          : 1];
+    }
+
+    tree.mNodes[node].mPoints.push_back(index);
+    if (tree.mNodes[node].mPoints.size() > kMaxLeafSize)
+    {
+      std::vector<std::size_t> points = tree.mNodes[node].mPoints;
+      buildNode(tree, node, points, 0, points.size());
+    }
+  }
+
+  return index;
+}
+
+//==============================================================================
+void RandomizedKdForestNearestNeighbors::clear()
+{
+  mCoordinates.clear();
+  mStates.clear();
+  mNumBuilt = 0;
+
+  for (std::size_t i = 0; i < mTrees.size(); ++i)
+    resetTree(mTrees[i], i);
+}
+
+//==============================================================================
+std::size_t RandomizedKdForestNearestNeighbors::size() const
+{
+  return mStates.size();
+}
+
+//==============================================================================
+const statespace::StateSpace::State*
+RandomizedKdForestNearestNeighbors::getState(std::size_t _index) const
+{
+  return mStates.at(_index);
+}
+
+//==============================================================================
+auto RandomizedKdForestNearestNeighbors::nearest(
+    const statespace::StateSpace::State* _query) const -> Neighbor
+{
+  if (mStates.empty())
+    throw std::runtime_error("Nearest neighbors index is empty.");
+
+  return nearestK(_query, 1).front();
+}
+
+//==============================================================================
+auto RandomizedKdForestNearestNeighbors::nearestK(
+    const statespace::StateSpace::State* _query, std::size_t _k) const
+    -> std::vector<Neighbor>
+{
+  detail::NeighborCollector collector(
+      _k, std::numeric_limits<double>::infinity());
+  search(_query, collector);
+  return collector.getNeighbors();
+}
+
+//==============================================================================
+auto RandomizedKdForestNearestNeighbors::nearestR(
+    const statespace::StateSpace::State* _query, double _radius) const
+    -> std::vector<Neighbor>
+{
+  detail::NeighborCollector collector(
+      std::numeric_limits<std::size_t>::max(), _radius);
+  search(_query, collector);
+  return collector.getNeighbors();
+}
+
+//==============================================================================
+auto RandomizedKdForestNearestNeighbors::nearestKBatch(
+    const statespace::StateSpace::State* const* _queries,
+    std::size_t _numQueries,
+    std::size_t _k) const -> std::vector<std::vector<Neighbor>>
+{
+  std::vector<std::vector<Neighbor>> neighbors(_numQueries);
+  parallelFor(_numQueries, [&](std::size_t _query) {
+    neighbors[_query] = nearestK(_queries[_query], _k);
+  });
+  return neighbors;
+}
+
+//==============================================================================
+void RandomizedKdForestNearestNeighbors::resetTree(
+    Tree& _tree, unsigned int _seed)
+{
+  _tree.mNodes.clear();
+  _tree.mNodes.push_back(Node{kLeaf, 0., {{0, 0}}, {}});
+  _tree.mEngine.seed(_seed);
+}
+
+//==============================================================================
+void RandomizedKdForestNearestNeighbors::buildNode(
+    Tree& _tree,
+    std::size_t _node,
+    std::vector<std::size_t>& _indices,
+    std::size_t _begin,
+    std::size_t _end) const
+{
+  const std::size_t numPoints = _end - _begin;
+
+  const auto coordinate = [&](std::size_t _index, std::size_t _coordinate) {
+    return mCoordinates[_index * mDimension + _coordinate];
+  };
+
+  const auto makeLeaf = [&]() {
+    Node& node = _tree.mNodes[_node];
+    node.mSplitCoordinate = kLeaf;
+    node.mPoints.assign(_indices.begin() + _begin, _indices.begin() + _end);
+  };
+
+  if (numPoints <= kMaxLeafSize)
+  {
+    makeLeaf();
+    return;
+  }
+
+  // Estimate the mean and variance of every coordinate from a sample.
+  const std::size_t stride = std::max<std::size_t>(
+      1, numPoints / kNumVarianceSamples);
+  Eigen::VectorXd mean = Eigen::VectorXd::Zero(mDimension);
+  Eigen::VectorXd meanSquared = Eigen::VectorXd::Zero(mDimension);
+  std::size_t numSamples = 0;
+  for (std::size_t i = _begin; i < _end; i += stride)
+  {
+    for (std::size_t j = 0; j < mDimension; ++j)
+    {
+      const double value = coordinate(_indices[i], j);
+      mean[j] += value;
+      meanSquared[j] += value * value;
+    }
+    ++numSamples;
+  }
+  mean /= static_cast<double>(numSamples);
+  const Eigen::VectorXd variance
+      = meanSquared / static_cast<double>(numSamples)
+        - mean.cwiseProduct(mean);
+
+  // Choose the split coordinate at random among the coordinates with the
+  // largest variance.
+  std::vector<std::size_t> candidates(mDimension);
+  std::iota(candidates.begin(), candidates.end(), 0);
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [&](std::size_t _left, std::size_t _right) {
+        return variance[_left] > variance[_right];
+      });
+
+  std::size_t numCandidates = 0;
+  while (numCandidates < std::min(kNumSplitCandidates, mDimension)
+         && variance[candidates[numCandidates]] > 0.)
+    ++numCandidates;
+
+  // All sampled states coincide, so splitting is unlikely to separate them.
+  if (numCandidates == 0)
+  {
+    makeLeaf();
+    return;
+  }
+
+  std::uniform_int_distribution<std::size_t> distribution(
+      0, numCandidates - 1);
+  const std::size_t splitCoordinate = candidates[distribution(_tree.mEngine)];
+
+  const auto begin = _indices.begin() + _begin;
+  const auto end = _indices.begin() + _end;
+
+  double splitValue = mean[splitCoordinate];
+  auto middle = std::partition(begin, end, [&](std::size_t _index) {
+    return coordinate(_index, splitCoordinate) < splitValue;
+  });
+
+  // Fall back to the median if the mean does not separate the states.
+  if (middle == begin || middle == end)
+  {
+    middle = begin + numPoints / 2;
+    std::nth_element(
+        begin, middle, end, [&](std::size_t _left, std::size_t _right) {
+          return coordinate(_left, splitCoordinate)
+                 < coordinate(_right, splitCoordinate);
+        });
+    splitValue = coordinate(*middle, splitCoordinate);
+  }
+
+  const std::size_t leftChild = _tree.mNodes.size();
+  _tree.mNodes.push_back(Node{kLeaf, 0., {{0, 0}}, {}});
+  _tree.mNodes.push_back(Node{kLeaf, 0., {{0, 0}}, {}});
+
+  Node& node = _tree.mNodes[_node];
+  node.mSplitCoordinate = static_cast<int>(splitCoordinate);
+  node.mSplitValue = splitValue;
+  node.mChildren = {{leftChild, leftChild + 1}};
+  node.mPoints.clear();
+  node.mPoints.shrink_to_fit();
+
+  const std::size_t middleIndex = middle - _indices.begin();
+  buildNode(_tree, leftChild, _indices, _begin, middleIndex);
+  buildNode(_tree, leftChild + 1, _indices, middleIndex, _end);
+}
+
+//==============================================================================
+Eigen::VectorXd RandomizedKdForestNearestNeighbors::getCoordinates(
+    const statespace::StateSpace::State* _state) const
+{
+  Eigen::VectorXd coordinates;
+  mStateSpace->logMap(_state, coordinates);
+
+  for (std::size_t i = 0; i < mDimension; ++i)
+  {
+    if (mIsAngle[i])
+    {
+      coordinates[i] -= 2.0 * M_PI
+                        * std::floor((coordinates[i] + M_PI) / (2.0 * M_PI));
+    }
+  }
+  return coordinates;
+}
+
+//==============================================================================
+void RandomizedKdForestNearestNeighbors::search(
+    const statespace::StateSpace::State* _query,
+    detail::NeighborCollector& _collector) const
+{
+  const Eigen::VectorXd query = getCoordinates(_query);
+
+  std::priority_queue<Branch, std::vector<Branch>, std::greater<Branch>>
+      branches;
+  for (std::size_t i = 0; i < mTrees.size(); ++i)
+    branches.push(Branch{0., i, 0});
+
+  // States may be found in several trees, but are only checked once. The
+  // search visits about mMaxChecks states, so they are remembered in a hash
+  // set rather than a flag per indexed state, which would cost O(size()) per
+  // query.
+  std::unordered_set<std::size_t> isChecked;
+  isChecked.reserve(std::min(mMaxChecks, mStates.size()));
+  std::vector<const statespace::StateSpace::State*> states;
+  std::vector<std::size_t> indices;
+  std::vector<double> distances;
+
+  std::size_t numChecks = 0;
+  while (!branches.empty() && numChecks < mMaxChecks)
+  {
+    const Branch branch = branches.top();
+    branches.pop();
+
+    // Descend to the leaf containing the query, remembering the other side
+    // of every split.
+    const auto& nodes = mTrees[branch.mTree].mNodes;
+    std::size_t node = branch.mNode;
+    while (nodes[node].mSplitCoordinate != kLeaf)
+    {
+      const Node& internal = nodes[node];
+      const auto coordinate = internal.mSplitCoordinate;
+      const double value = query[coordinate];
+      const std::size_t nearChild = value < internal.mSplitValue ? 0 : 1;
+
+      // An angle may reach the other side of the split across +/- pi.
+      double offset = std::abs(value - internal.mSplitValue);
+      if (mIsAngle[coordinate])
+        offset = std::min(offset, nearChild == 0 ? value + M_PI : M_PI - value);
+
+      branches.push(
+          Branch{branch.mKey + offset * offset,
+                 branch.mTree,
+                 internal.mChildren[1 - nearChild]});
+      node = internal.mChildren[nearChild];
+    }
+
+    states.clear();
+    indices.clear();
+    for (const auto point : nodes[node].mPoints)
+    {
+      if (!isChecked.insert(point).second)
+        continue;
+
+      indices.push_back(point);
+      states.push_back(mStates[point]);
+    }
+
+    distances.resize(states.size());
+    mMetric->distanceBatch(
+        _query, states.data(), states.size(), distances.data());
+
+    for (std::size_t i = 0; i < indices.size(); ++i)
+      _collector.add(indices[i], distances[i]);
+
+    numChecks += indices.size();
+  }
+}
+
+//==============================================================================
+void RandomizedKdForestNearestNeighbors::parallelFor(
+    std::size_t _numTasks,
+    const std::function<void(std::size_t)>& _function) const
+{
+  const std::size_t numThreads = std::min(mNumThreads, _numTasks);
+  if (numThreads <= 1)
+  {
+    for (std::size_t i = 0; i < _numTasks; ++i)
+      _function(i);
+    return;
+  }
+
+  std::atomic<std::size_t> nextTask(0);
+  std::exception_ptr exception;
+  std::mutex exceptionMutex;
+
+  const auto worker = [&]() {
+    try
+    {
+      for (std::size_t i = nextTask++; i < _numTasks; i = nextTask++)
+        _function(i);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(exceptionMutex);
+      if (!exception)
+        exception = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (std::size_t i = 1; i < numThreads; ++i)
+    threads.emplace_back(worker);
+  worker();
+
+  for (auto& thread : threads)
+    thread.join();
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+} // namespace distance
+} // namespace aikido
@@ -66,5 +66,75 @@ double SE2Weighted::distance(
   return mWeights[0] * angularDistance + mWeights[1] * (linearDistance.norm());
 }
 
+//==============================================================================
+void SE2Weighted::distanceBatch(
+    const aikido::statespace::StateSpace::State* query,
+    const aikido::statespace::StateSpace::State* const* states,
+    std::size_t numStates,
+    double* distances) const
+{
+  Eigen::Matrix3Xd poses(3, numStates);
+  for (std::size_t i = 0; i < numStates; ++i)
+  {
+    poses.col(i) = getPose(mStateSpace->getIsometry(
+        static_cast<const statespace::SE2::State*>(states[i])));
+  }
+
+  computeDistances(query, poses, distances);
+}
+
+//==============================================================================
+void SE2Weighted::distanceBatchInBuffer(
+    const aikido::statespace::StateSpace::State* query,
+    const void* buffer,
+    std::size_t numStates,
+    double* distances) const
+{
+  const auto states = static_cast<const statespace::SE2::State*>(buffer);
+
+  Eigen::Matrix3Xd poses(3, numStates);
+  for (std::size_t i = 0; i < numStates; ++i)
+    poses.col(i) = getPose(mStateSpace->getIsometry(&states[i]));
+
+  computeDistances(query, poses, distances);
+}
+
+//==============================================================================
+Eigen::Vector3d SE2Weighted::getPose(
+    const statespace::SE2::State::Isometry2d& pose)
+{
+  // Same as SE2::logMap(), without allocating a tangent vector.
+  return Eigen::Vector3d(
+      std::atan2(pose.linear()(1, 0), pose.linear()(0, 0)),
+      pose.translation()[0],
+      pose.translation()[1]);
+}
+
+//==============================================================================
+void SE2Weighted::computeDistances(
+    const aikido::statespace::StateSpace::State* query,
+    const Eigen::Matrix3Xd& poses,
+    double* distances) const
+{
+  const Eigen::Vector3d queryPose = getPose(mStateSpace->getIsometry(
+      static_cast<const statespace::SE2::State*>(query)));
+
+  const Eigen::ArrayXd angularDiff
+      = (poses.row(0).transpose().array() - queryPose[0]).abs();
+  const Eigen::ArrayXd wrapped
+      = angularDiff - (2.0 * M_PI) * (angularDiff * (0.5 / M_PI)).floor();
+  const Eigen::ArrayXd angularDistances = wrapped.min(2.0 * M_PI - wrapped);
+
+  const Eigen::ArrayXd linearDistances
+      = (poses.bottomRows<2>().colwise() - queryPose.tail<2>())
+            .colwise()
+            .norm()
+            .transpose()
+            .array();
+
+  Eigen::Map<Eigen::ArrayXd>(distances, poses.cols())
+      = mWeights[0] * angularDistances + mWeights[1] * linearDistances;
+}
+
 } // namespace distance
 } // namespace aikido
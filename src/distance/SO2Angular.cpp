@@ -3,6 +3,26 @@
 namespace aikido {
 namespace distance {
 
+namespace {
+
+//==============================================================================
+/// Computes the shortest distances between _query and each of _angles, in the
+/// same way as SO2Angular::distance().
+void computeAngularDistances(
+    double _query,
+    const Eigen::Ref<const Eigen::ArrayXd>& _angles,
+    double* _distances)
+{
+  const Eigen::ArrayXd diff = (_angles - _query).abs();
+  const Eigen::ArrayXd wrapped
+      = diff - (2.0 * M_PI) * (diff * (0.5 / M_PI)).floor();
+
+  Eigen::Map<Eigen::ArrayXd>(_distances, _angles.size())
+      = wrapped.min(2.0 * M_PI - wrapped);
+}
+
+} // namespace
+
 //==============================================================================
 SO2Angular::SO2Angular(std::shared_ptr<statespace::SO2> _space)
   : mStateSpace(std::move(_space))
@@ -35,5 +55,46 @@ double SO2Angular::distance(
   return std::fabs(diff);
 }
 
+//==============================================================================
+void SO2Angular::distanceBatch(
+    const statespace::StateSpace::State* _query,
+    const statespace::StateSpace::State* const* _states,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  Eigen::ArrayXd angles(_numStates);
+  for (std::size_t i = 0; i < _numStates; ++i)
+  {
+    angles[i] = mStateSpace->getAngle(
+        static_cast<const statespace::SO2::State*>(_states[i]));
+  }
+
+  computeAngularDistances(
+      mStateSpace->getAngle(
+          static_cast<const statespace::SO2::State*>(_query)),
+      angles,
+      _distances);
+}
+
+//==============================================================================
+void SO2Angular::distanceBatchInBuffer(
+    const statespace::StateSpace::State* _query,
+    const void* _buffer,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  const auto states = static_cast<const statespace::SO2::State*>(_buffer);
+
+  Eigen::ArrayXd angles(_numStates);
+  for (std::size_t i = 0; i < _numStates; ++i)
+    angles[i] = mStateSpace->getAngle(&states[i]);
+
+  computeAngularDistances(
+      mStateSpace->getAngle(
+          static_cast<const statespace::SO2::State*>(_query)),
+      angles,
+      _distances);
+}
+
 } // namespace distance
 } // namespace aikido
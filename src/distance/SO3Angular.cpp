@@ -30,5 +30,69 @@ double SO3Angular::distance(
       mStateSpace->getQuaternion(state2));
 }
 
+//==============================================================================
+void SO3Angular::distanceBatch(
+    const statespace::StateSpace::State* _query,
+    const statespace::StateSpace::State* const* _states,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  Eigen::Matrix4Xd quaternions(4, _numStates);
+  for (std::size_t i = 0; i < _numStates; ++i)
+  {
+    quaternions.col(i) = mStateSpace
+                             ->getQuaternion(
+                                 static_cast<const statespace::SO3::State*>(
+                                     _states[i]))
+                             .coeffs();
+  }
+
+  computeDistances(_query, quaternions, _distances);
+}
+
+//==============================================================================
+void SO3Angular::distanceBatchInBuffer(
+    const statespace::StateSpace::State* _query,
+    const void* _buffer,
+    std::size_t _numStates,
+    double* _distances) const
+{
+  const auto states = static_cast<const statespace::SO3::State*>(_buffer);
+
+  Eigen::Matrix4Xd quaternions(4, _numStates);
+  for (std::size_t i = 0; i < _numStates; ++i)
+    quaternions.col(i) = mStateSpace->getQuaternion(&states[i]).coeffs();
+
+  computeDistances(_query, quaternions, _distances);
+}
+
+//==============================================================================
+void SO3Angular::computeDistances(
+    const statespace::StateSpace::State* _query,
+    const Eigen::Matrix4Xd& _quaternions,
+    double* _distances) const
+{
+  const Eigen::Vector4d query
+      = mStateSpace
+            ->getQuaternion(static_cast<const statespace::SO3::State*>(_query))
+            .coeffs();
+
+  // Equivalent to Quaternion::angularDistance(), which computes
+  // 2 atan2(|v|, |w|) of the relative rotation. For the relative rotation
+  // |w| is the dot product of the quaternions and |v|^2 + w^2 is the product
+  // of their squared norms.
+  const Eigen::ArrayXd dots
+      = (_quaternions.transpose() * query).array().abs();
+  const Eigen::ArrayXd norms
+      = (_quaternions.colwise().squaredNorm().transpose().array()
+         * query.squaredNorm()
+         - dots.square())
+            .max(0.)
+            .sqrt();
+
+  for (Eigen::Index i = 0; i < dots.size(); ++i)
+    _distances[i] = 2. * std::atan2(norms[i], dots[i]);
+}
+
 } // namespace distance
 } // namespace aikido
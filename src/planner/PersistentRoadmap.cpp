@@ -0,0 +1,935 @@
+#include "aikido/planner/PersistentRoadmap.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dart/dynamics/DegreeOfFreedom.hpp>
+#include <dart/dynamics/Joint.hpp>
+#include "aikido/common/VanDerCorput.hpp"
+
+namespace aikido {
+namespace planner {
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'A', 'I', 'K', 'I', 'D', 'O', 'R', 'M'};
+constexpr std::uint32_t FILE_VERSION = 2;
+
+/// Number of vertices or edges the file makes room for when it is first grown
+constexpr std::size_t MIN_CAPACITY = 64;
+
+//==============================================================================
+std::uint64_t getGroupBit(std::size_t _group)
+{
+  return static_cast<std::uint64_t>(1) << _group;
+}
+
+//==============================================================================
+void checkGroupName(const std::string& _name, std::size_t _maxLength)
+{
+  if (_name.empty())
+    throw std::invalid_argument("Collision group name is empty.");
+
+  if (_name.size() > _maxLength)
+  {
+    std::stringstream ss;
+    ss << "Collision group name '" << _name << "' is longer than "
+       << _maxLength << " characters.";
+    throw std::invalid_argument(ss.str());
+  }
+}
+
+//==============================================================================
+/// Returns the FNV-1a hash of the names and joint types of the DOFs of
+/// _skeleton, which identifies the meaning of the positions of a vertex.
+std::uint64_t getSkeletonFingerprint(
+    const dart::dynamics::MetaSkeleton& _skeleton)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  const auto addString = [&hash](const std::string& _string) {
+    // The terminating null character separates consecutive strings.
+    for (const char c : _string + '\0')
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ull;
+    }
+  };
+
+  for (std::size_t i = 0; i < _skeleton.getNumDofs(); ++i)
+  {
+    const auto dof = _skeleton.getDof(i);
+    addString(dof->getName());
+    addString(dof->getJoint()->getType());
+  }
+  return hash;
+}
+
+//==============================================================================
+std::runtime_error makeFileError(
+    const std::string& _what, const std::string& _filename)
+{
+  std::stringstream ss;
+  ss << _what << " roadmap file '" << _filename
+     << "': " << std::strerror(errno);
+  return std::runtime_error(ss.str());
+}
+
+} // namespace
+
+constexpr std::size_t PersistentRoadmap::MAX_COLLISION_GROUPS;
+constexpr std::size_t PersistentRoadmap::MAX_COLLISION_GROUP_NAME_LENGTH;
+
+//==============================================================================
+PersistentRoadmap::PersistentRoadmap(
+    statespace::dart::MetaSkeletonStateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator,
+    distance::DistanceMetricPtr _dmetric,
+    constraint::SampleablePtr _sampler,
+    constraint::TestablePtr _validityConstraint,
+    const std::string& _validityConstraintName,
+    double _maxDistanceBtwValidityChecks,
+    const std::string& _filename,
+    std::size_t _numNeighbors)
+  : mStateSpace(std::move(_stateSpace))
+  , mInterpolator(std::move(_interpolator))
+  , mDistanceMetric(std::move(_dmetric))
+  , mMaxDistanceBtwValidityChecks(_maxDistanceBtwValidityChecks)
+  , mFilename(_filename)
+  , mNumNeighbors(_numNeighbors)
+  , mDimension(0)
+  , mSkeletonFingerprint(0)
+  , mConstraints(MAX_COLLISION_GROUPS)
+  , mRegisteredGroups(getGroupBit(0))
+  , mFileDescriptor(-1)
+  , mData(nullptr)
+  , mDataSize(0)
+  , mHeader(nullptr)
+  , mNumEdgeChecks(0)
+{
+  static_assert(
+      sizeof(FileHeader) % alignof(Edge) == 0,
+      "Edges following the header must be aligned");
+
+  if (!mStateSpace)
+    throw std::invalid_argument("StateSpace is nullptr.");
+
+  if (!mInterpolator)
+    throw std::invalid_argument("Interpolator is nullptr.");
+
+  if (mInterpolator->getStateSpace() != mStateSpace)
+    throw std::invalid_argument("Interpolator does not match StateSpace.");
+
+  if (!mDistanceMetric)
+    throw std::invalid_argument("DistanceMetric is nullptr.");
+
+  if (mDistanceMetric->getStateSpace() != mStateSpace)
+    throw std::invalid_argument("DistanceMetric does not match StateSpace.");
+
+  if (!_sampler)
+    throw std::invalid_argument("Sampler is nullptr.");
+
+  if (_sampler->getStateSpace() != mStateSpace)
+    throw std::invalid_argument("Sampler does not match StateSpace.");
+
+  if (!_validityConstraint)
+    throw std::invalid_argument("Validity constraint is nullptr.");
+
+  if (_validityConstraint->getStateSpace() != mStateSpace)
+  {
+    throw std::invalid_argument(
+        "Validity constraint does not match StateSpace.");
+  }
+
+  checkGroupName(_validityConstraintName, MAX_COLLISION_GROUP_NAME_LENGTH);
+
+  if (mMaxDistanceBtwValidityChecks <= 0)
+  {
+    std::stringstream ss;
+    ss << "Maximum distance between validity checks must be positive, got "
+       << mMaxDistanceBtwValidityChecks << ".";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (mFilename.empty())
+    throw std::invalid_argument("Filename is empty.");
+
+  if (mNumNeighbors == 0)
+    throw std::invalid_argument("Number of neighbors must be positive.");
+
+  mSampleGenerator = _sampler->createSampleGenerator();
+  mConstraints[0] = std::move(_validityConstraint);
+  mDimension = mStateSpace->getMetaSkeleton()->getNumDofs();
+  mSkeletonFingerprint
+      = getSkeletonFingerprint(*mStateSpace->getMetaSkeleton());
+  mNearestNeighbors = distance::createNearestNeighbors(mDistanceMetric);
+
+  try
+  {
+    open(_validityConstraintName);
+    load();
+  }
+  catch (...)
+  {
+    for (auto state : mStates)
+      mStateSpace->freeState(state);
+    close();
+    throw;
+  }
+}
+
+//==============================================================================
+PersistentRoadmap::~PersistentRoadmap()
+{
+  clearQuery();
+  mNearestNeighbors->clear();
+  for (auto state : mStates)
+    mStateSpace->freeState(state);
+  close();
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::addCollisionGroup(
+    const std::string& _name, constraint::TestablePtr _constraint)
+{
+  checkGroupName(_name, MAX_COLLISION_GROUP_NAME_LENGTH);
+
+  if (!_constraint)
+    throw std::invalid_argument("Collision group constraint is nullptr.");
+
+  if (_constraint->getStateSpace() != mStateSpace)
+  {
+    throw std::invalid_argument(
+        "Collision group constraint does not match StateSpace.");
+  }
+
+  std::size_t group = findCollisionGroup(_name);
+  if (group < MAX_COLLISION_GROUPS && mConstraints[group])
+  {
+    std::stringstream ss;
+    ss << "Collision group '" << _name << "' is already registered.";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (group == MAX_COLLISION_GROUPS)
+  {
+    // Claim an unused slot of the file, which no edge has validity for.
+    for (group = 1; group < MAX_COLLISION_GROUPS; ++group)
+    {
+      if (mHeader->mGroupNames[group][0] == '\0')
+        break;
+    }
+
+    if (group == MAX_COLLISION_GROUPS)
+    {
+      std::stringstream ss;
+      ss << "Roadmap file '" << mFilename << "' already has "
+         << MAX_COLLISION_GROUPS - 1 << " collision groups.";
+      throw std::invalid_argument(ss.str());
+    }
+
+    std::strncpy(
+        mHeader->mGroupNames[group],
+        _name.c_str(),
+        MAX_COLLISION_GROUP_NAME_LENGTH + 1);
+    forgetGroups(getGroupBit(group));
+  }
+
+  mConstraints[group] = std::move(_constraint);
+  mRegisteredGroups |= getGroupBit(group);
+  return group;
+}
+
+//==============================================================================
+void PersistentRoadmap::invalidateCollisionGroup(const std::string& _name)
+{
+  const std::size_t group = findCollisionGroup(_name);
+  if (group == MAX_COLLISION_GROUPS)
+  {
+    std::stringstream ss;
+    ss << "Roadmap file '" << mFilename << "' has no collision group '"
+       << _name << "'.";
+    throw std::invalid_argument(ss.str());
+  }
+
+  forgetGroups(getGroupBit(group));
+}
+
+//==============================================================================
+void PersistentRoadmap::invalidateAll()
+{
+  forgetGroups(std::numeric_limits<std::uint64_t>::max());
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::grow(std::size_t _numVertices)
+{
+  auto state = mStateSpace->createState();
+  std::size_t numAdded = 0;
+
+  for (std::size_t i = 0; i < _numVertices; ++i)
+  {
+    if (!mSampleGenerator->canSample())
+      break;
+
+    if (!mSampleGenerator->sample(state))
+      continue;
+
+    const auto neighbors = mNearestNeighbors->nearestK(state, mNumNeighbors);
+    if (!neighbors.empty() && neighbors.front().second <= 0.)
+      continue;
+
+    const std::size_t vertex = addVertex(state);
+    for (const auto& neighbor : neighbors)
+      addEdge(neighbor.first, vertex, neighbor.second);
+
+    ++numAdded;
+  }
+
+  return numAdded;
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr PersistentRoadmap::plan(
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    PlanningResult* _planningResult)
+{
+  if (!isValid(_start))
+  {
+    if (_planningResult)
+      _planningResult->message = "Start state is invalid";
+    return nullptr;
+  }
+
+  if (!isValid(_goal))
+  {
+    if (_planningResult)
+      _planningResult->message = "Goal state is invalid";
+    return nullptr;
+  }
+
+  trajectory::InterpolatedPtr trajectory;
+  try
+  {
+    const std::size_t start = addQueryVertex(_start);
+    const std::size_t goal = addQueryVertex(_goal);
+
+    // Also try to connect the start directly to the goal.
+    const std::size_t directEdge = mHeader->mNumEdges + mQueryEdges.size();
+    mQueryEdges.push_back(
+        Edge{start,
+             goal,
+             mDistanceMetric->distance(mStates[start], mStates[goal]),
+             0,
+             0});
+    mAdjacency[start].push_back(directEdge);
+    mAdjacency[goal].push_back(directEdge);
+
+    std::vector<std::size_t> vertices;
+    std::vector<std::size_t> edges;
+    while (findShortestPath(start, goal, vertices, edges))
+    {
+      bool isPathValid = true;
+      for (std::size_t i = 0; i < edges.size(); ++i)
+      {
+        if (!evaluateEdge(edges[i], vertices[i], vertices[i + 1]))
+        {
+          isPathValid = false;
+          break;
+        }
+      }
+
+      if (isPathValid)
+      {
+        trajectory = std::make_shared<trajectory::Interpolated>(
+            mStateSpace, mInterpolator);
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+          trajectory->addWaypoint(i, mStates[vertices[i]]);
+        break;
+      }
+    }
+  }
+  catch (...)
+  {
+    clearQuery();
+    throw;
+  }
+
+  clearQuery();
+
+  if (!trajectory && _planningResult)
+    _planningResult->message = "No valid path through the roadmap";
+
+  return trajectory;
+}
+
+//==============================================================================
+void PersistentRoadmap::flush()
+{
+  if (::msync(mData, mDataSize, MS_SYNC) != 0)
+    throw makeFileError("Failed flushing", mFilename);
+}
+
+//==============================================================================
+const std::string& PersistentRoadmap::getFilename() const
+{
+  return mFilename;
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::getNumVertices() const
+{
+  return mHeader->mNumVertices;
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::getNumEdges() const
+{
+  return mHeader->mNumEdges;
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::getNumValidEdges() const
+{
+  const Edge* edges = getEdges();
+  return std::count_if(
+      edges, edges + mHeader->mNumEdges, [this](const Edge& _edge) {
+        return (_edge.mValidGroups & mRegisteredGroups) == mRegisteredGroups
+               && !isKnownInvalid(_edge);
+      });
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::getNumEdgeChecks() const
+{
+  return mNumEdgeChecks;
+}
+
+//==============================================================================
+void PersistentRoadmap::open(const std::string& _validityConstraintName)
+{
+  mFileDescriptor = ::open(mFilename.c_str(), O_RDWR | O_CREAT, 0644);
+  if (mFileDescriptor < 0)
+    throw makeFileError("Failed opening", mFilename);
+
+  // Every roadmap writes to its file, so the lock is exclusive. It is
+  // released when the file is closed.
+  if (::flock(mFileDescriptor, LOCK_EX | LOCK_NB) != 0)
+  {
+    if (errno != EWOULDBLOCK)
+      throw makeFileError("Failed locking", mFilename);
+
+    std::stringstream ss;
+    ss << "Roadmap file '" << mFilename << "' is open in another roadmap.";
+    throw std::runtime_error(ss.str());
+  }
+
+  struct stat fileStatus;
+  if (::fstat(mFileDescriptor, &fileStatus) != 0)
+    throw makeFileError("Failed reading the size of", mFilename);
+
+  const std::size_t fileSize = fileStatus.st_size;
+  if (fileSize == 0)
+  {
+    map(getFileSize(0, 0));
+    std::memset(mHeader, 0, sizeof(FileHeader));
+    std::memcpy(mHeader->mMagic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    mHeader->mVersion = FILE_VERSION;
+    mHeader->mDimension = mDimension;
+    mHeader->mSkeletonFingerprint = mSkeletonFingerprint;
+    std::strncpy(
+        mHeader->mGroupNames[0],
+        _validityConstraintName.c_str(),
+        MAX_COLLISION_GROUP_NAME_LENGTH + 1);
+    return;
+  }
+
+  std::stringstream ss;
+  ss << "Roadmap file '" << mFilename << "' ";
+
+  if (fileSize < sizeof(FileHeader))
+  {
+    ss << "is not a roadmap file.";
+    throw std::runtime_error(ss.str());
+  }
+
+  map(fileSize);
+
+  if (std::memcmp(mHeader->mMagic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+  {
+    ss << "is not a roadmap file.";
+    throw std::runtime_error(ss.str());
+  }
+
+  if (mHeader->mVersion != FILE_VERSION)
+  {
+    ss << "has version " << mHeader->mVersion << ", expected "
+       << FILE_VERSION << ".";
+    throw std::runtime_error(ss.str());
+  }
+
+  if (mHeader->mDimension != mDimension)
+  {
+    ss << "has " << mHeader->mDimension << " DOFs, but the StateSpace has "
+       << mDimension << ".";
+    throw std::runtime_error(ss.str());
+  }
+
+  if (mHeader->mNumVertices > mHeader->mVertexCapacity
+      || mHeader->mNumEdges > mHeader->mEdgeCapacity
+      || getFileSize(mHeader->mVertexCapacity, mHeader->mEdgeCapacity)
+             > fileSize)
+  {
+    ss << "is truncated.";
+    throw std::runtime_error(ss.str());
+  }
+
+  if (mHeader->mSkeletonFingerprint != mSkeletonFingerprint)
+  {
+    ss << "holds a roadmap of another skeleton, whose DOFs have different "
+          "names or joint types.";
+    throw std::runtime_error(ss.str());
+  }
+
+  // The validity against group zero is only reused for the same constraint.
+  if (_validityConstraintName != mHeader->mGroupNames[0])
+  {
+    forgetGroups(getGroupBit(0));
+    std::strncpy(
+        mHeader->mGroupNames[0],
+        _validityConstraintName.c_str(),
+        MAX_COLLISION_GROUP_NAME_LENGTH + 1);
+  }
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::getFileSize(
+    std::size_t _vertexCapacity, std::size_t _edgeCapacity) const
+{
+  return sizeof(FileHeader) + _vertexCapacity * mDimension * sizeof(double)
+         + _edgeCapacity * sizeof(Edge);
+}
+
+//==============================================================================
+void PersistentRoadmap::map(std::size_t _size)
+{
+  if (mData)
+  {
+    ::munmap(mData, mDataSize);
+    mData = nullptr;
+    mHeader = nullptr;
+  }
+
+  struct stat fileStatus;
+  if (::fstat(mFileDescriptor, &fileStatus) != 0)
+    throw makeFileError("Failed reading the size of", mFilename);
+
+  if (static_cast<std::size_t>(fileStatus.st_size) < _size
+      && ::ftruncate(mFileDescriptor, _size) != 0)
+  {
+    throw makeFileError("Failed growing", mFilename);
+  }
+
+  void* data = ::mmap(
+      nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, mFileDescriptor, 0);
+  if (data == MAP_FAILED)
+    throw makeFileError("Failed mapping", mFilename);
+
+  mData = data;
+  mDataSize = _size;
+  mHeader = static_cast<FileHeader*>(mData);
+}
+
+//==============================================================================
+void PersistentRoadmap::reserve(
+    std::size_t _vertexCapacity, std::size_t _edgeCapacity)
+{
+  const std::size_t oldVertexCapacity = mHeader->mVertexCapacity;
+  const std::size_t numEdges = mHeader->mNumEdges;
+
+  map(getFileSize(_vertexCapacity, _edgeCapacity));
+
+  if (_vertexCapacity != oldVertexCapacity)
+  {
+    // The edges follow the vertices, so make room for the new vertices.
+    const auto vertices = static_cast<char*>(mData) + sizeof(FileHeader);
+    std::memmove(
+        vertices + _vertexCapacity * mDimension * sizeof(double),
+        vertices + oldVertexCapacity * mDimension * sizeof(double),
+        numEdges * sizeof(Edge));
+  }
+
+  mHeader->mVertexCapacity = _vertexCapacity;
+  mHeader->mEdgeCapacity = _edgeCapacity;
+}
+
+//==============================================================================
+void PersistentRoadmap::close()
+{
+  if (mData)
+  {
+    ::msync(mData, mDataSize, MS_SYNC);
+    ::munmap(mData, mDataSize);
+    mData = nullptr;
+    mHeader = nullptr;
+  }
+
+  if (mFileDescriptor >= 0)
+  {
+    ::close(mFileDescriptor);
+    mFileDescriptor = -1;
+  }
+}
+
+//==============================================================================
+double* PersistentRoadmap::getPositions(std::size_t _vertex) const
+{
+  const auto vertices = reinterpret_cast<double*>(
+      static_cast<char*>(mData) + sizeof(FileHeader));
+  return vertices + _vertex * mDimension;
+}
+
+//==============================================================================
+PersistentRoadmap::Edge* PersistentRoadmap::getEdges() const
+{
+  return reinterpret_cast<Edge*>(getPositions(mHeader->mVertexCapacity));
+}
+
+//==============================================================================
+PersistentRoadmap::Edge& PersistentRoadmap::getEdge(std::size_t _edge)
+{
+  if (_edge < mHeader->mNumEdges)
+    return getEdges()[_edge];
+  return mQueryEdges[_edge - mHeader->mNumEdges];
+}
+
+//==============================================================================
+const PersistentRoadmap::Edge& PersistentRoadmap::getEdge(
+    std::size_t _edge) const
+{
+  if (_edge < mHeader->mNumEdges)
+    return getEdges()[_edge];
+  return mQueryEdges[_edge - mHeader->mNumEdges];
+}
+
+//==============================================================================
+void PersistentRoadmap::load()
+{
+  const std::size_t numVertices = mHeader->mNumVertices;
+  const std::size_t numEdges = mHeader->mNumEdges;
+
+  mStates.reserve(numVertices);
+  Eigen::VectorXd positions(mDimension);
+  for (std::size_t vertex = 0; vertex < numVertices; ++vertex)
+  {
+    const double* vertexPositions = getPositions(vertex);
+    std::copy(vertexPositions, vertexPositions + mDimension, positions.data());
+
+    auto state = mStateSpace->allocateState();
+    mStates.push_back(state);
+    mStateSpace->convertPositionsToState(
+        positions, static_cast<statespace::CartesianProduct::State*>(state));
+    mNearestNeighbors->add(state);
+  }
+
+  mAdjacency.assign(numVertices, std::vector<std::size_t>());
+  const Edge* edges = getEdges();
+  for (std::size_t edge = 0; edge < numEdges; ++edge)
+  {
+    const std::size_t source = edges[edge].mSource;
+    const std::size_t target = edges[edge].mTarget;
+    if (source >= numVertices || target >= numVertices)
+    {
+      std::stringstream ss;
+      ss << "Roadmap file '" << mFilename << "' is corrupt: edge " << edge
+         << " has no vertex " << std::max(source, target) << ".";
+      throw std::runtime_error(ss.str());
+    }
+
+    mAdjacency[source].push_back(edge);
+    mAdjacency[target].push_back(edge);
+  }
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::addVertex(
+    const statespace::StateSpace::State* _state)
+{
+  const std::size_t vertex = mHeader->mNumVertices;
+  if (vertex == mHeader->mVertexCapacity)
+  {
+    reserve(
+        std::max(2 * mHeader->mVertexCapacity, MIN_CAPACITY),
+        mHeader->mEdgeCapacity);
+  }
+
+  Eigen::VectorXd positions;
+  mStateSpace->convertStateToPositions(
+      static_cast<const statespace::CartesianProduct::State*>(_state),
+      positions);
+  std::copy(
+      positions.data(), positions.data() + mDimension, getPositions(vertex));
+
+  auto state = mStateSpace->allocateState();
+  mStates.push_back(state);
+  mStateSpace->copyState(_state, state);
+  mAdjacency.emplace_back();
+  mNearestNeighbors->add(state);
+
+  ++mHeader->mNumVertices;
+  return vertex;
+}
+
+//==============================================================================
+void PersistentRoadmap::addEdge(
+    std::size_t _source, std::size_t _target, double _length)
+{
+  const std::size_t edge = mHeader->mNumEdges;
+  if (edge == mHeader->mEdgeCapacity)
+  {
+    reserve(
+        mHeader->mVertexCapacity,
+        std::max(2 * mHeader->mEdgeCapacity, MIN_CAPACITY));
+  }
+
+  getEdges()[edge] = Edge{_source, _target, _length, 0, 0};
+  mAdjacency[_source].push_back(edge);
+  mAdjacency[_target].push_back(edge);
+
+  ++mHeader->mNumEdges;
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::addQueryVertex(
+    const statespace::StateSpace::State* _state)
+{
+  const std::size_t vertex = mStates.size();
+
+  auto state = mStateSpace->allocateState();
+  mStates.push_back(state);
+  mStateSpace->copyState(_state, state);
+  mAdjacency.emplace_back();
+
+  const auto neighbors = mNearestNeighbors->nearestK(state, mNumNeighbors);
+  for (const auto& neighbor : neighbors)
+  {
+    const std::size_t edge = mHeader->mNumEdges + mQueryEdges.size();
+    mQueryEdges.push_back(Edge{neighbor.first, vertex, neighbor.second, 0, 0});
+    mAdjacency[neighbor.first].push_back(edge);
+    mAdjacency[vertex].push_back(edge);
+  }
+
+  return vertex;
+}
+
+//==============================================================================
+void PersistentRoadmap::clearQuery()
+{
+  const std::size_t numVertices = mHeader->mNumVertices;
+  const std::size_t numEdges = mHeader->mNumEdges;
+
+  for (const auto& edge : mQueryEdges)
+  {
+    if (edge.mSource >= numVertices)
+      continue;
+
+    auto& edges = mAdjacency[edge.mSource];
+    edges.erase(
+        std::remove_if(
+            edges.begin(),
+            edges.end(),
+            [numEdges](std::size_t _edge) { return _edge >= numEdges; }),
+        edges.end());
+  }
+  mQueryEdges.clear();
+
+  for (std::size_t vertex = numVertices; vertex < mStates.size(); ++vertex)
+    mStateSpace->freeState(mStates[vertex]);
+  mStates.resize(numVertices);
+  mAdjacency.resize(numVertices);
+}
+
+//==============================================================================
+bool PersistentRoadmap::findShortestPath(
+    std::size_t _start,
+    std::size_t _goal,
+    std::vector<std::size_t>& _vertices,
+    std::vector<std::size_t>& _edges) const
+{
+  // A* search; the distance to the goal is a consistent heuristic because
+  // edge lengths are distances under the same metric.
+  const std::size_t numVertices = mStates.size();
+  const std::size_t noEdge = std::numeric_limits<std::size_t>::max();
+  std::vector<double> costs(
+      numVertices, std::numeric_limits<double>::infinity());
+  std::vector<std::size_t> parentEdges(numVertices, noEdge);
+  std::vector<bool> isClosed(numVertices, false);
+
+  using QueueEntry = std::pair<double, std::size_t>;
+  std::priority_queue<
+      QueueEntry,
+      std::vector<QueueEntry>,
+      std::greater<QueueEntry>>
+      queue;
+
+  costs[_start] = 0.;
+  queue.emplace(0., _start);
+
+  while (!queue.empty())
+  {
+    const std::size_t vertex = queue.top().second;
+    queue.pop();
+
+    if (vertex == _goal)
+      break;
+
+    if (isClosed[vertex])
+      continue;
+    isClosed[vertex] = true;
+
+    for (const std::size_t edgeIndex : mAdjacency[vertex])
+    {
+      const Edge& edge = getEdge(edgeIndex);
+      if (isKnownInvalid(edge))
+        continue;
+
+      const std::size_t neighbor
+          = edge.mSource == vertex ? edge.mTarget : edge.mSource;
+      const double cost = costs[vertex] + edge.mLength;
+      if (isClosed[neighbor] || cost >= costs[neighbor])
+        continue;
+
+      costs[neighbor] = cost;
+      parentEdges[neighbor] = edgeIndex;
+      queue.emplace(
+          cost + mDistanceMetric->distance(mStates[neighbor], mStates[_goal]),
+          neighbor);
+    }
+  }
+
+  if (parentEdges[_goal] == noEdge)
+    return false;
+
+  _vertices.clear();
+  _edges.clear();
+  for (std::size_t vertex = _goal; vertex != _start;)
+  {
+    const Edge& edge = getEdge(parentEdges[vertex]);
+    _vertices.push_back(vertex);
+    _edges.push_back(parentEdges[vertex]);
+    vertex = edge.mSource == vertex ? edge.mTarget : edge.mSource;
+  }
+  _vertices.push_back(_start);
+
+  std::reverse(_vertices.begin(), _vertices.end());
+  std::reverse(_edges.begin(), _edges.end());
+  return true;
+}
+
+//==============================================================================
+void PersistentRoadmap::forgetGroups(std::uint64_t _groups)
+{
+  Edge* edges = getEdges();
+  for (std::size_t edge = 0; edge < mHeader->mNumEdges; ++edge)
+  {
+    edges[edge].mValidGroups &= ~_groups;
+    edges[edge].mInvalidGroups &= ~_groups;
+  }
+
+  for (auto& edge : mQueryEdges)
+  {
+    edge.mValidGroups &= ~_groups;
+    edge.mInvalidGroups &= ~_groups;
+  }
+}
+
+//==============================================================================
+bool PersistentRoadmap::isKnownInvalid(const Edge& _edge) const
+{
+  return (_edge.mInvalidGroups & mRegisteredGroups) != 0;
+}
+
+//==============================================================================
+bool PersistentRoadmap::evaluateEdge(
+    std::size_t _edge, std::size_t _from, std::size_t _to)
+{
+  Edge& edge = getEdge(_edge);
+  if (isKnownInvalid(edge))
+    return false;
+
+  const std::uint64_t pendingGroups = mRegisteredGroups & ~edge.mValidGroups;
+  if (pendingGroups == 0)
+    return true;
+
+  ++mNumEdgeChecks;
+
+  const double resolution
+      = edge.mLength > mMaxDistanceBtwValidityChecks
+            ? mMaxDistanceBtwValidityChecks / edge.mLength
+            : 1.;
+  const common::VanDerCorput vdc{1, true, true, resolution};
+  auto state = mStateSpace->createState();
+
+  for (const auto alpha : vdc)
+  {
+    mInterpolator->interpolate(mStates[_from], mStates[_to], alpha, state);
+
+    for (std::size_t group = 0; group < MAX_COLLISION_GROUPS; ++group)
+    {
+      if (!(pendingGroups & getGroupBit(group)))
+        continue;
+
+      if (!mConstraints[group]->isSatisfied(state))
+      {
+        edge.mInvalidGroups |= getGroupBit(group);
+        return false;
+      }
+    }
+  }
+
+  edge.mValidGroups |= pendingGroups;
+  return true;
+}
+
+//==============================================================================
+bool PersistentRoadmap::isValid(
+    const statespace::StateSpace::State* _state) const
+{
+  for (std::size_t group = 0; group < MAX_COLLISION_GROUPS; ++group)
+  {
+    if ((mRegisteredGroups & getGroupBit(group))
+        && !mConstraints[group]->isSatisfied(_state))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//==============================================================================
+std::size_t PersistentRoadmap::findCollisionGroup(
+    const std::string& _name) const
+{
+  // Unused slots have empty names.
+  if (_name.empty())
+    return MAX_COLLISION_GROUPS;
+
+  for (std::size_t group = 0; group < MAX_COLLISION_GROUPS; ++group)
+  {
+    if (_name == mHeader->mGroupNames[group])
+      return group;
+  }
+  return MAX_COLLISION_GROUPS;
+}
+
+} // namespace planner
+} // namespace aikido
@@ -0,0 +1,262 @@
+#include <aikido/planner/ompl/AnytimePlanner.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <ompl/base/PlannerTerminationCondition.h>
+#include <ompl/base/objectives/PathLengthOptimizationObjective.h>
+#include <ompl/geometric/PathGeometric.h>
+#include <aikido/planner/ompl/InformedPathLengthObjective.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+//==============================================================================
+AnytimePlanner::AnytimePlanner(
+    ::ompl::base::PlannerPtr _planner,
+    ::ompl::base::ProblemDefinitionPtr _pdef,
+    statespace::StateSpacePtr _sspace,
+    statespace::InterpolatorPtr _interpolator,
+    SolutionCallback _callback,
+    double _reportPeriod)
+  : mPlanner(std::move(_planner))
+  , mProblemDefinition(std::move(_pdef))
+  , mStateSpace(std::move(_sspace))
+  , mInterpolator(std::move(_interpolator))
+  , mCallback(std::move(_callback))
+  , mReportPeriod(_reportPeriod)
+  , mRunning(false)
+  , mCancelled(false)
+  , mImproved(false)
+{
+  if (!mPlanner)
+  {
+    throw std::invalid_argument("Planner is nullptr.");
+  }
+
+  if (!mProblemDefinition)
+  {
+    throw std::invalid_argument("ProblemDefinition is nullptr.");
+  }
+
+  if (!mStateSpace)
+  {
+    throw std::invalid_argument("StateSpace is nullptr.");
+  }
+
+  if (!mInterpolator)
+  {
+    throw std::invalid_argument("Interpolator is nullptr.");
+  }
+
+  if (mInterpolator->getStateSpace() != mStateSpace)
+  {
+    throw std::invalid_argument(
+        "StateSpace of interpolator not equal to planning StateSpace");
+  }
+
+  if (mReportPeriod <= 0.)
+  {
+    std::stringstream msg;
+    msg << "Report period must be positive, got " << mReportPeriod << ".";
+    throw std::invalid_argument(msg.str());
+  }
+}
+
+//==============================================================================
+AnytimePlanner::~AnytimePlanner()
+{
+  cancel();
+  if (mThread.joinable())
+    mThread.join();
+}
+
+//==============================================================================
+void AnytimePlanner::start(double _maxPlanTime)
+{
+  if (mRunning)
+  {
+    throw std::runtime_error("AnytimePlanner is already running.");
+  }
+
+  // Collect the previous run, whose errors were not received with wait().
+  if (mThread.joinable())
+    mThread.join();
+  mException = nullptr;
+
+  if (!mProblemDefinition->hasOptimizationObjective())
+  {
+    const auto si = mProblemDefinition->getSpaceInformation();
+#if OMPL_VERSION_AT_LEAST(1, 2, 0)
+    mProblemDefinition->setOptimizationObjective(
+        ompl_make_shared<InformedPathLengthObjective>(si));
+#else
+    mProblemDefinition->setOptimizationObjective(
+        ompl_make_shared<::ompl::base::PathLengthOptimizationObjective>(si));
+#endif
+  }
+
+  if (mPlanner->getProblemDefinition() != mProblemDefinition)
+    mPlanner->setProblemDefinition(mProblemDefinition);
+  if (!mPlanner->isSetup())
+    mPlanner->setup();
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBestSolution = nullptr;
+    mBestCost = mProblemDefinition->getOptimizationObjective()->infiniteCost();
+  }
+
+  mCancelled = false;
+  mRunning = true;
+  mThread = std::thread(&AnytimePlanner::plan, this, _maxPlanTime);
+}
+
+//==============================================================================
+void AnytimePlanner::cancel()
+{
+  mCancelled = true;
+}
+
+//==============================================================================
+bool AnytimePlanner::isRunning() const
+{
+  return mRunning;
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr AnytimePlanner::wait(double* _cost)
+{
+  if (mThread.joinable())
+    mThread.join();
+
+  if (mException)
+  {
+    auto exception = mException;
+    mException = nullptr;
+    std::rethrow_exception(exception);
+  }
+
+  return getBestSolution(_cost);
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr AnytimePlanner::getBestSolution(double* _cost) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (_cost)
+    *_cost = mBestCost.value();
+  return mBestSolution;
+}
+
+//==============================================================================
+void AnytimePlanner::plan(double _maxPlanTime)
+{
+  using Clock = std::chrono::steady_clock;
+
+#if OMPL_VERSION_AT_LEAST(1, 1, 0)
+  // Planners that report intermediate solutions end the slice early, so that
+  // the solution is delivered without waiting for the report period.
+  mProblemDefinition->setIntermediateSolutionCallback(
+      [this](
+          const ::ompl::base::Planner* /*_planner*/,
+          const std::vector<const ::ompl::base::State*>& /*_states*/,
+          const ::ompl::base::Cost /*_cost*/) { mImproved = true; });
+#endif
+
+  try
+  {
+    const auto endTime
+        = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                             std::chrono::duration<double>(_maxPlanTime));
+    const ::ompl::base::PlannerTerminationCondition interrupted(
+        [this]() { return mCancelled || mImproved; });
+
+    while (!mCancelled && Clock::now() < endTime)
+    {
+      const double sliceTime = std::min(
+          mReportPeriod,
+          std::chrono::duration<double>(endTime - Clock::now()).count());
+
+      // The ProblemDefinition only needs the solution of this slice, which
+      // the planner adds again if it didn't improve.
+      mProblemDefinition->clearSolutionPaths();
+      mImproved = false;
+      const auto status = mPlanner->solve(
+          ::ompl::base::plannerOrTerminationCondition(
+              ::ompl::base::timedPlannerTerminationCondition(sliceTime),
+              interrupted));
+
+      if (status != ::ompl::base::PlannerStatus::TIMEOUT
+          && status != ::ompl::base::PlannerStatus::APPROXIMATE_SOLUTION
+          && status != ::ompl::base::PlannerStatus::EXACT_SOLUTION)
+        break;
+
+      if (reportSolution())
+        break;
+
+      // Planners that don't optimize are done after the first solution.
+      if (!mPlanner->getSpecs().optimizingPaths && getBestSolution())
+        break;
+    }
+  }
+  catch (...)
+  {
+    mException = std::current_exception();
+  }
+
+#if OMPL_VERSION_AT_LEAST(1, 1, 0)
+  mProblemDefinition->setIntermediateSolutionCallback(
+      ::ompl::base::ReportIntermediateSolutionFn());
+#endif
+
+  mRunning = false;
+}
+
+//==============================================================================
+bool AnytimePlanner::reportSolution()
+{
+  const auto objective = mProblemDefinition->getOptimizationObjective();
+
+  if (!mProblemDefinition->hasSolution()
+      || mProblemDefinition->hasApproximateSolution())
+    return false;
+
+  auto path = ompl_dynamic_pointer_cast<::ompl::geometric::PathGeometric>(
+      mProblemDefinition->getSolutionPath());
+  if (!path)
+  {
+    throw std::invalid_argument(
+        "Path is not of type PathGeometric. Cannot convert to aikido "
+        "Trajectory");
+  }
+
+  // Only an improved solution is converted to a trajectory.
+  const auto cost = path->cost(objective);
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mBestSolution && !objective->isCostBetterThan(cost, mBestCost))
+      return objective->isSatisfied(mBestCost);
+  }
+
+  trajectory::InterpolatedPtr trajectory
+      = toInterpolatedTrajectory(*path, mInterpolator);
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBestSolution = trajectory;
+    mBestCost = cost;
+  }
+
+  if (mCallback)
+    mCallback(std::move(trajectory), cost.value());
+
+  return objective->isSatisfied(cost);
+}
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
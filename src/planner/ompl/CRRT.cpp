@@ -3,6 +3,7 @@
 #include <ompl/tools/config/SelfConfig.h>
 #include <aikido/planner/ompl/CRRT.hpp>
 #include <aikido/planner/ompl/GeometricStateSpace.hpp>
+#include <aikido/planner/ompl/NearestNeighborsAdapter.hpp>
 
 namespace aikido {
 namespace planner {
@@ -16,6 +17,7 @@ CRRT::CRRT(const ::ompl::base::SpaceInformationPtr& _si) : CRRT(_si, "CRRT")
 CRRT::CRRT(
     const ::ompl::base::SpaceInformationPtr& _si, const std::string& name)
   : ::ompl::base::Planner(_si, name)
+  , mMotionPool(_si)
   , mGoalBias(0.05)
   , mMaxDistance(0.1)
   , mLastGoalMotion(nullptr)
@@ -161,6 +163,18 @@ double CRRT::getMinStateDifference() const
   return mMinStepsize;
 }
 
+//==============================================================================
+void CRRT::setNearestNeighbors(distance::DistanceMetricPtr _metric)
+{
+  mStartTree.reset(
+      new NearestNeighborsAdapter<Motion*>(
+          std::move(_metric), [](Motion* const& _motion) {
+            return static_cast<const GeometricStateSpace::StateType*>(
+                       _motion->state)
+                ->mState;
+          }));
+}
+
 //==============================================================================
 void CRRT::setup()
 {
@@ -182,19 +196,7 @@ void CRRT::setup()
 //==============================================================================
 void CRRT::freeMemory()
 {
-  if (mStartTree)
-  {
-    std::vector<Motion*> motions;
-    mStartTree->list(motions);
-    for (std::size_t i = 0; i < motions.size(); ++i)
-    {
-      if (motions[i]->state)
-      {
-        si_->freeState(motions[i]->state);
-      }
-      delete motions[i];
-    }
-  }
+  mMotionPool.reset();
 }
 
 //==============================================================================
@@ -208,7 +210,7 @@ void CRRT::freeMemory()
 
   while (const ::ompl::base::State* st = pis_.nextStart())
   {
-    Motion* motion = new Motion(si_);
+    Motion* motion = mMotionPool.allocate();
     si_->copyState(motion->state, st);
     mStartTree->add(motion);
   }
@@ -318,6 +320,36 @@ CRRT::Motion* CRRT::constrainedExtend(
     double& dist,
     bool& foundgoal)
 {
+  return constrainedExtend(
+      ptc,
+      si_,
+      mCons,
+      mMotionPool,
+      tree,
+      nmotion,
+      gstate,
+      xstate,
+      goal,
+      returnlast,
+      dist,
+      foundgoal);
+}
+
+//==============================================================================
+CRRT::Motion* CRRT::constrainedExtend(
+    const ::ompl::base::PlannerTerminationCondition& ptc,
+    const ::ompl::base::SpaceInformationPtr& si,
+    const constraint::ProjectablePtr& cons,
+    MotionPool& pool,
+    TreeData& tree,
+    Motion* nmotion,
+    ::ompl::base::State* gstate,
+    ::ompl::base::State* xstate,
+    ::ompl::base::Goal* goal,
+    bool returnlast,
+    double& dist,
+    bool& foundgoal)
+{
 
   // Set up the current parent motion
   Motion* cmotion = nmotion;
@@ -326,7 +358,7 @@ CRRT::Motion* CRRT::constrainedExtend(
 
   // Compute the current and previous distance to the goal state
   double prevDistToTarget = std::numeric_limits<double>::infinity();
-  double distToTarget = si_->distance(cmotion->state, gstate);
+  double distToTarget = si->distance(cmotion->state, gstate);
 
   // Loop while time remaining
   foundgoal = false;
@@ -339,34 +371,42 @@ CRRT::Motion* CRRT::constrainedExtend(
       break;
     }
 
-    // Take a step towards the goal state
+    // Take a step towards the goal state. The step ends in the state of a
+    // pooled motion, which is returned to the pool if the step fails.
     double stepLength
         = std::min(mMaxDistance, std::min(mMaxStepsize, distToTarget));
-    si_->getStateSpace()->interpolate(
-        cmotion->state, gstate, stepLength / distToTarget, xstate);
+    Motion* motion = pool.allocate();
 
-    if (mCons)
+    if (cons)
     {
-      // Project the endpoint of the step
+      // Project the endpoint of the step from xstate into the motion, which
+      // avoids the temporary copy of the in-place projection
+      si->getStateSpace()->interpolate(
+          cmotion->state, gstate, stepLength / distToTarget, xstate);
       auto xst = xstate->as<GeometricStateSpace::StateType>();
-      if (!mCons->project(xst->mState))
+      auto mst = motion->state->as<GeometricStateSpace::StateType>();
+      if (!cons->project(xst->mState, mst->mState))
       {
         // Can't project back to constraint anymore, return
+        pool.releaseLast();
         break;
       }
     }
+    else
+    {
+      si->getStateSpace()->interpolate(
+          cmotion->state, gstate, stepLength / distToTarget, motion->state);
+    }
 
-    if (si_->checkMotion(cmotion->state, xstate))
+    if (si->checkMotion(cmotion->state, motion->state))
     {
       // Add the motion to the tree
-      Motion* motion = new Motion(si_);
-      si_->copyState(motion->state, xstate);
       motion->parent = cmotion;
       tree->add(motion);
 
       cmotion = motion;
-      double newdist = 0.0;
-      bool satisfied = goal->isSatisfied(motion->state, &newdist);
+      double newdist = std::numeric_limits<double>::infinity();
+      bool satisfied = goal && goal->isSatisfied(motion->state, &newdist);
       if (satisfied)
       {
         dist = newdist;
@@ -388,10 +428,11 @@ CRRT::Motion* CRRT::constrainedExtend(
     else
     {
       // Extension failed validity check
+      pool.releaseLast();
       break;
     }
     prevDistToTarget = distToTarget;
-    distToTarget = si_->distance(cmotion->state, gstate);
+    distToTarget = si->distance(cmotion->state, gstate);
   }
 
   return bestmotion;
@@ -405,6 +446,52 @@ CRRT::Motion* CRRT::constrainedExtend(
           solveTime)); //, std::min(solveTime/100., 0.1)));
 }
 
+//==============================================================================
+CRRT::MotionPool::MotionPool(const ::ompl::base::SpaceInformationPtr& _si)
+  : mSi(_si), mNumUsed(0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+CRRT::MotionPool::~MotionPool()
+{
+  for (auto& motion : mMotions)
+    mSi->freeState(motion.state);
+}
+
+//==============================================================================
+CRRT::Motion* CRRT::MotionPool::allocate()
+{
+  if (mNumUsed == mMotions.size())
+    mMotions.emplace_back(mSi);
+
+  Motion* motion = &mMotions[mNumUsed++];
+  motion->parent = nullptr;
+  return motion;
+}
+
+//==============================================================================
+void CRRT::MotionPool::releaseLast()
+{
+  if (mNumUsed == 0)
+    throw std::logic_error("No motion to release.");
+
+  --mNumUsed;
+}
+
+//==============================================================================
+void CRRT::MotionPool::reset()
+{
+  mNumUsed = 0;
+}
+
+//==============================================================================
+std::size_t CRRT::MotionPool::size() const
+{
+  return mNumUsed;
+}
+
 //==============================================================================
 double CRRT::distanceFunction(const Motion* a, const Motion* b) const
 {
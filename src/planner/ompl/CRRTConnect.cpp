@@ -1,16 +1,158 @@
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <ompl/base/goals/GoalSampleableRegion.h>
 #include <ompl/tools/config/SelfConfig.h>
 #include <aikido/planner/ompl/BackwardCompatibility.hpp>
 #include <aikido/planner/ompl/CRRTConnect.hpp>
 #include <aikido/planner/ompl/GeometricStateSpace.hpp>
+#include <aikido/planner/ompl/NearestNeighborsAdapter.hpp>
+#include "detail/StateSpaceConversion.hpp"
 
 namespace aikido {
 namespace planner {
 namespace ompl {
+namespace {
+
+//==============================================================================
+/// Serializes every access to an OMPL NearestNeighbors data structure, so a
+/// tree can be grown by one thread while another thread queries it.
+template <typename T>
+class LockedNearestNeighbors : public ::ompl::NearestNeighbors<T>
+{
+public:
+  using NearestNeighborsPtr = ompl_shared_ptr<::ompl::NearestNeighbors<T>>;
+
+  /// Constructor.
+  /// \param _nn The data structure to serialize access to
+  explicit LockedNearestNeighbors(NearestNeighborsPtr _nn)
+    : mNearestNeighbors(std::move(_nn))
+  {
+    // Do nothing
+  }
+
+  // Documentation inherited.
+  bool reportsSortedResults() const override
+  {
+    return mNearestNeighbors->reportsSortedResults();
+  }
+
+  // Documentation inherited.
+  void clear() override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNearestNeighbors->clear();
+  }
+
+  // Documentation inherited.
+  void add(const T& _data) override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNearestNeighbors->add(_data);
+  }
+
+  // Documentation inherited.
+  void add(const std::vector<T>& _data) override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNearestNeighbors->add(_data);
+  }
+
+  // Documentation inherited.
+  bool remove(const T& _data) override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNearestNeighbors->remove(_data);
+  }
+
+  // Documentation inherited.
+  T nearest(const T& _data) const override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNearestNeighbors->nearest(_data);
+  }
+
+  // Documentation inherited.
+  void nearestK(const T& _data, std::size_t _k, std::vector<T>& _nbh)
+      const override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNearestNeighbors->nearestK(_data, _k, _nbh);
+  }
+
+  // Documentation inherited.
+  void nearestR(const T& _data, double _radius, std::vector<T>& _nbh)
+      const override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNearestNeighbors->nearestR(_data, _radius, _nbh);
+  }
+
+  // Documentation inherited.
+  std::size_t size() const override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNearestNeighbors->size();
+  }
+
+  // Documentation inherited.
+  void list(std::vector<T>& _data) const override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNearestNeighbors->list(_data);
+  }
+
+private:
+  NearestNeighborsPtr mNearestNeighbors;
+
+  /// Nearest neighbor queries may modify internal buffers, so they are
+  /// serialized with modifications and with each other.
+  mutable std::mutex mMutex;
+};
+
+//==============================================================================
+/// Returns the aikido state of a motion.
+template <typename Motion>
+const statespace::StateSpace::State* getMotionState(Motion* const& _motion)
+{
+  return static_cast<const GeometricStateSpace::StateType*>(_motion->state)
+      ->mState;
+}
+
+//==============================================================================
+/// Converts a state of one GeometricStateSpace into a state of another, whose
+/// aikido StateSpace has the same structure.
+void convertState(
+    const GeometricStateSpace& _from,
+    const ::ompl::base::State* _in,
+    const GeometricStateSpace& _to,
+    ::ompl::base::State* _out)
+{
+  detail::convertState(
+      *_from.getAikidoStateSpace(),
+      static_cast<const GeometricStateSpace::StateType*>(_in)->mState,
+      *_to.getAikidoStateSpace(),
+      static_cast<GeometricStateSpace::StateType*>(_out)->mState);
+}
+
+//==============================================================================
+/// Returns the distance metric of the GeometricStateSpace of a
+/// SpaceInformation.
+distance::DistanceMetricPtr getDistanceMetric(
+    const ::ompl::base::SpaceInformationPtr& _si)
+{
+  return ompl_dynamic_pointer_cast<GeometricStateSpace>(_si->getStateSpace())
+      ->getDistanceMetric();
+}
+
+} // namespace
 
 //==============================================================================
 CRRTConnect::CRRTConnect(const ::ompl::base::SpaceInformationPtr& _si)
-  : CRRT(_si, "CRRTConnect"), mConnectionRadius(1e-4)
+  : CRRT(_si, "CRRTConnect")
+  , mConnectionRadius(1e-4)
 {
 
   specs_.recognizedGoal = ::ompl::base::GOAL_SAMPLEABLE_REGION;
@@ -30,6 +172,19 @@ CRRTConnect::~CRRTConnect()
   clear();
 }
 
+//==============================================================================
+void CRRTConnect::setNearestNeighbors(distance::DistanceMetricPtr _metric)
+{
+  auto goalTreeMetric = mGoalTreeSi ? getDistanceMetric(mGoalTreeSi) : _metric;
+
+  mStartTree.reset(
+      new NearestNeighborsAdapter<Motion*>(
+          std::move(_metric), &getMotionState<Motion>));
+  mGoalTree.reset(
+      new NearestNeighborsAdapter<Motion*>(
+          std::move(goalTreeMetric), &getMotionState<Motion>));
+}
+
 //==============================================================================
 void CRRTConnect::setup()
 {
@@ -50,28 +205,21 @@ void CRRTConnect::setup()
           OMPL_PLACEHOLDER(_2)));
   mGoalTree->setDistanceFunction(
       ompl_bind(
-          &CRRTConnect::distanceFunction,
+          &CRRTConnect::goalTreeDistanceFunction,
           this,
           OMPL_PLACEHOLDER(_1),
           OMPL_PLACEHOLDER(_2)));
+
+  if (mGoalTreeSi && !mGoalTreeSi->isSetup())
+    mGoalTreeSi->setup();
 }
 
 //==============================================================================
 void CRRTConnect::freeMemory()
 {
   CRRT::freeMemory();
-
-  if (mGoalTree)
-  {
-    std::vector<Motion*> motions;
-    mGoalTree->list(motions);
-    for (std::size_t i = 0; i < motions.size(); ++i)
-    {
-      if (motions[i]->state)
-        si_->freeState(motions[i]->state);
-      delete motions[i];
-    }
-  }
+  if (mGoalTreeMotionPool)
+    mGoalTreeMotionPool->reset();
 }
 
 //==============================================================================
@@ -96,6 +244,69 @@ double CRRTConnect::getConnectionRadius() const
   return mConnectionRadius;
 }
 
+//==============================================================================
+void CRRTConnect::setThreaded(
+    ::ompl::base::SpaceInformationPtr _goalTreeSi,
+    constraint::ProjectablePtr _goalTreeConstraint)
+{
+  if (_goalTreeSi)
+  {
+    if (_goalTreeSi == si_)
+    {
+      throw std::invalid_argument(
+          "SpaceInformation of the goal tree must not be shared with the "
+          "planner");
+    }
+
+    auto sspace
+        = ompl_dynamic_pointer_cast<GeometricStateSpace>(si_->getStateSpace());
+    if (!sspace)
+    {
+      throw std::invalid_argument(
+          "SpaceInformation of the planner does not use a GeometricStateSpace");
+    }
+
+    auto goalTreeSspace = ompl_dynamic_pointer_cast<GeometricStateSpace>(
+        _goalTreeSi->getStateSpace());
+    if (!goalTreeSspace)
+    {
+      throw std::invalid_argument(
+          "SpaceInformation of the goal tree does not use a "
+          "GeometricStateSpace");
+    }
+    detail::checkConvertible(
+        *sspace->getAikidoStateSpace(),
+        *goalTreeSspace->getAikidoStateSpace());
+  }
+
+  // The motions of the goal tree are states of the previous SpaceInformation.
+  clear();
+
+  mGoalTreeSi = std::move(_goalTreeSi);
+  mGoalTreeCons = std::move(_goalTreeConstraint);
+  mGoalTreeMotionPool.reset(
+      mGoalTreeSi ? new MotionPool(mGoalTreeSi) : nullptr);
+
+  // An aikido index of the goal tree must use the DistanceMetric of the
+  // StateSpace of the goal tree.
+  if (ompl_dynamic_pointer_cast<NearestNeighborsAdapter<Motion*>>(mGoalTree))
+  {
+    mGoalTree.reset(
+        new NearestNeighborsAdapter<Motion*>(
+            getDistanceMetric(mGoalTreeSi ? mGoalTreeSi : si_),
+            &getMotionState<Motion>));
+  }
+
+  if (mGoalTreeSi && isSetup() && !mGoalTreeSi->isSetup())
+    mGoalTreeSi->setup();
+}
+
+//==============================================================================
+bool CRRTConnect::isThreaded() const
+{
+  return mGoalTreeSi != nullptr;
+}
+
 //==============================================================================
 ::ompl::base::PlannerStatus CRRTConnect::solve(
     const ::ompl::base::PlannerTerminationCondition& ptc)
@@ -113,7 +324,7 @@ double CRRTConnect::getConnectionRadius() const
 
   while (const ::ompl::base::State* st = pis_.nextStart())
   {
-    Motion* motion = new Motion(si_);
+    Motion* motion = mMotionPool.allocate();
     si_->copyState(motion->state, st);
     mStartTree->add(motion);
   }
@@ -128,6 +339,13 @@ double CRRTConnect::getConnectionRadius() const
     return ::ompl::base::PlannerStatus::INVALID_GOAL;
   }
 
+  if (mGoalTreeSi)
+  {
+    return solveThreaded(ptc, goal)
+               ? ::ompl::base::PlannerStatus::EXACT_SOLUTION
+               : ::ompl::base::PlannerStatus::TIMEOUT;
+  }
+
   if (!mSampler)
     mSampler = si_->allocStateSampler();
 
@@ -155,7 +373,7 @@ double CRRTConnect::getConnectionRadius() const
         const ::ompl::base::State* st = pis_.nextGoal(ptc);
         if (si_->isValid(st))
         {
-          Motion* motion = new Motion(si_);
+          Motion* motion = mMotionPool.allocate();
           si_->copyState(motion->state, st);
           mGoalTree->add(motion);
         }
@@ -210,61 +428,282 @@ double CRRTConnect::getConnectionRadius() const
     double treedist = si_->distance(newmotion->state, lastmotion->state);
     if (treedist <= mConnectionRadius)
     {
-      if (treedist < 1e-6)
-      {
-        // The start and goal trees hit the same point, remove one of them
-        // to avoid having a duplicate state on the path
-        if (startMotion->parent)
-          startMotion = startMotion->parent;
-        else
-          goalMotion = goalMotion->parent;
-      }
+      if (!addSolutionPath(startMotion, goalMotion, treedist, goal))
+        continue;
 
-      mConnectionPoint = std::make_pair(startMotion->state, goalMotion->state);
+      solved = true;
+      break;
+    }
+  }
 
-      /* construct the solution path */
-      Motion* solution = startMotion;
-      std::vector<Motion*> mpath1;
-      while (solution != nullptr)
-      {
-        mpath1.push_back(solution);
-        solution = solution->parent;
-      }
+  si_->freeState(xstate);
+  si_->freeState(rstate);
 
-      solution = goalMotion;
-      std::vector<Motion*> mpath2;
-      while (solution != nullptr)
-      {
-        mpath2.push_back(solution);
-        solution = solution->parent;
-      }
+  return solved ? ::ompl::base::PlannerStatus::EXACT_SOLUTION
+                : ::ompl::base::PlannerStatus::TIMEOUT;
+}
 
-      // Double check that the start and goal pair are valid
-      if (mpath1.size() > 0 && mpath2.size() > 0)
+//==============================================================================
+bool CRRTConnect::solveThreaded(
+    const ::ompl::base::PlannerTerminationCondition& _ptc,
+    ::ompl::base::GoalSampleableRegion* _goal)
+{
+  // A connection, or any exception, terminates both threads.
+  std::atomic<bool> done(false);
+  const auto ptc = ::ompl::base::plannerOrTerminationCondition(
+      _ptc,
+      ::ompl::base::PlannerTerminationCondition(
+          [&done]() { return done.load(); }));
+
+  // Each thread grows its own tree, but looks up connection targets in the
+  // other one.
+  TreeData startTree(new LockedNearestNeighbors<Motion*>(mStartTree));
+  TreeData goalTree(new LockedNearestNeighbors<Motion*>(mGoalTree));
+
+  const auto startTreeSspace
+      = ompl_dynamic_pointer_cast<GeometricStateSpace>(si_->getStateSpace());
+  const auto goalTreeSspace = ompl_dynamic_pointer_cast<GeometricStateSpace>(
+      mGoalTreeSi->getStateSpace());
+
+  // Goals sampled by the thread of the start tree, which are not yet added to
+  // the goal tree. They are states of the planner.
+  std::mutex goalMutex;
+  std::vector<::ompl::base::State*> sampledGoals;
+
+  std::mutex resultMutex;
+  bool solved = false;
+  std::exception_ptr exception;
+
+  const auto grow = [&](bool _isStartTree) {
+    const auto& si = _isStartTree ? si_ : mGoalTreeSi;
+    const auto& otherSi = _isStartTree ? mGoalTreeSi : si_;
+    const auto& sspace = _isStartTree ? startTreeSspace : goalTreeSspace;
+    const auto& otherSspace = _isStartTree ? goalTreeSspace : startTreeSspace;
+    const auto& cons = _isStartTree ? mCons : mGoalTreeCons;
+    MotionPool& pool = _isStartTree ? mMotionPool : *mGoalTreeMotionPool;
+    TreeData& tree = _isStartTree ? startTree : goalTree;
+    TreeData& otherTree = _isStartTree ? goalTree : startTree;
+
+    ::ompl::base::StateSamplerPtr sampler = si->allocStateSampler();
+    ::ompl::base::State* xstate = si->allocState();
+    auto rmotion = std::unique_ptr<Motion>(new Motion(si));
+
+    // A motion of this tree converted into the other tree, and the nearest
+    // motion of the other tree converted back.
+    auto qmotion = std::unique_ptr<Motion>(new Motion(otherSi));
+    ::ompl::base::State* tstate = si->allocState();
+    std::size_t numSampledGoals = 0;
+
+    try
+    {
+      while (ptc == false)
       {
-        if (!goal->isStartGoalPairValid(
-                mpath1.front()->state, mpath2.back()->state))
+        if (_isStartTree
+            && (numSampledGoals == 0
+                || pis_.getSampledGoalsCount() < otherTree->size() / 2))
+        {
+          while (ptc == false)
+          {
+            const ::ompl::base::State* st = pis_.nextGoal(ptc);
+            if (st && si->isValid(st))
+            {
+              std::lock_guard<std::mutex> lock(goalMutex);
+              sampledGoals.push_back(si->cloneState(st));
+              ++numSampledGoals;
+            }
+            if (numSampledGoals > 0)
+              break;
+          }
+        }
+
+        if (!_isStartTree)
+        {
+          std::lock_guard<std::mutex> lock(goalMutex);
+          for (const auto st : sampledGoals)
+          {
+            Motion* motion = pool.allocate();
+            convertState(*otherSspace, st, *sspace, motion->state);
+            if (si->isValid(motion->state))
+              tree->add(motion);
+            else
+              pool.releaseLast();
+            otherSi->freeState(st);
+          }
+          sampledGoals.clear();
+        }
+
+        if (tree->size() == 0)
+        {
+          std::this_thread::yield();
+          continue;
+        }
+
+        sampler->sampleUniform(rmotion->state);
+        if (!si->isValid(rmotion->state))
           continue;
+
+        // Grow the tree toward the random sample
+        double bestdist = std::numeric_limits<double>::infinity();
+        bool foundgoal = false;
+        Motion* nmotion = tree->nearest(rmotion.get());
+        Motion* lastmotion = constrainedExtend(
+            ptc,
+            si,
+            cons,
+            pool,
+            tree,
+            nmotion,
+            rmotion->state,
+            xstate,
+            nullptr,
+            true,
+            bestdist,
+            foundgoal);
+
+        if (lastmotion == nmotion || otherTree->size() == 0)
+          continue;
+
+        // Grow the tree toward the nearest motion of the other tree
+        convertState(*sspace, lastmotion->state, *otherSspace, qmotion->state);
+        Motion* target = otherTree->nearest(qmotion.get());
+        convertState(*otherSspace, target->state, *sspace, tstate);
+        Motion* newmotion = constrainedExtend(
+            ptc,
+            si,
+            cons,
+            pool,
+            tree,
+            lastmotion,
+            tstate,
+            xstate,
+            nullptr,
+            true,
+            bestdist,
+            foundgoal);
+
+        double treedist = si->distance(newmotion->state, tstate);
+        if (treedist > mConnectionRadius)
+          continue;
+
+        std::lock_guard<std::mutex> lock(resultMutex);
+        if (done)
+          break;
+
+        Motion* startMotion = _isStartTree ? newmotion : target;
+        Motion* goalMotion = _isStartTree ? target : newmotion;
+        if (addSolutionPath(startMotion, goalMotion, treedist, _goal))
+        {
+          solved = true;
+          done = true;
+        }
       }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(resultMutex);
+      if (!exception)
+        exception = std::current_exception();
+      done = true;
+    }
 
-      auto path = ompl_make_shared<::ompl::geometric::PathGeometric>(si_);
-      path->getStates().reserve(mpath1.size() + mpath2.size());
-      for (int i = mpath1.size() - 1; i >= 0; --i)
-        path->append(mpath1[i]->state);
-      for (std::size_t i = 0; i < mpath2.size(); ++i)
-        path->append(mpath2[i]->state);
+    si->freeState(tstate);
+    otherSi->freeState(qmotion->state);
+    si->freeState(xstate);
+    si->freeState(rmotion->state);
+  };
 
-      pdef_->addSolutionPath(path, false, 0.0);
-      solved = true;
-      break;
+  std::thread goalTreeThread(grow, false);
+  grow(true);
+  goalTreeThread.join();
+
+  for (const auto st : sampledGoals)
+    si_->freeState(st);
+
+  if (exception)
+    std::rethrow_exception(exception);
+
+  return solved;
+}
+
+//==============================================================================
+double CRRTConnect::goalTreeDistanceFunction(
+    const Motion* a, const Motion* b) const
+{
+  return (mGoalTreeSi ? mGoalTreeSi : si_)->distance(a->state, b->state);
+}
+
+//==============================================================================
+bool CRRTConnect::addSolutionPath(
+    Motion* _startMotion,
+    Motion* _goalMotion,
+    double _treeDistance,
+    ::ompl::base::GoalSampleableRegion* _goal)
+{
+  if (_treeDistance < 1e-6)
+  {
+    // The start and goal trees hit the same point, remove one of them
+    // to avoid having a duplicate state on the path
+    if (_startMotion->parent)
+      _startMotion = _startMotion->parent;
+    else
+      _goalMotion = _goalMotion->parent;
+  }
+
+  mConnectionPoint = std::make_pair(_startMotion->state, _goalMotion->state);
+
+  /* construct the solution path */
+  Motion* solution = _startMotion;
+  std::vector<Motion*> mpath1;
+  while (solution != nullptr)
+  {
+    mpath1.push_back(solution);
+    solution = solution->parent;
+  }
+
+  solution = _goalMotion;
+  std::vector<Motion*> mpath2;
+  while (solution != nullptr)
+  {
+    mpath2.push_back(solution);
+    solution = solution->parent;
+  }
+
+  auto path = ompl_make_shared<::ompl::geometric::PathGeometric>(si_);
+  path->getStates().reserve(mpath1.size() + mpath2.size());
+  for (int i = mpath1.size() - 1; i >= 0; --i)
+    path->append(mpath1[i]->state);
+
+  if (mGoalTreeSi)
+  {
+    // The motions of the goal tree are states of its own SpaceInformation.
+    const auto sspace
+        = ompl_dynamic_pointer_cast<GeometricStateSpace>(si_->getStateSpace());
+    const auto goalTreeSspace = ompl_dynamic_pointer_cast<GeometricStateSpace>(
+        mGoalTreeSi->getStateSpace());
+    ::ompl::base::State* state = si_->allocState();
+    for (std::size_t i = 0; i < mpath2.size(); ++i)
+    {
+      convertState(*goalTreeSspace, mpath2[i]->state, *sspace, state);
+      path->append(state);
     }
+    si_->freeState(state);
+  }
+  else
+  {
+    for (std::size_t i = 0; i < mpath2.size(); ++i)
+      path->append(mpath2[i]->state);
   }
 
-  si_->freeState(xstate);
-  si_->freeState(rstate);
+  // Double check that the start and goal pair are valid
+  if (mpath1.size() > 0 && mpath2.size() > 0)
+  {
+    if (!_goal->isStartGoalPairValid(
+            path->getState(0), path->getState(path->getStateCount() - 1)))
+      return false;
+  }
 
-  return solved ? ::ompl::base::PlannerStatus::EXACT_SOLUTION
-                : ::ompl::base::PlannerStatus::TIMEOUT;
+  pdef_->addSolutionPath(path, false, 0.0);
+  return true;
 }
 
 //==============================================================================
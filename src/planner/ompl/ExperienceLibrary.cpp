@@ -0,0 +1,638 @@
+#include "aikido/planner/ompl/ExperienceLibrary.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include "aikido/common/VanDerCorput.hpp"
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'A', 'I', 'K', 'I', 'D', 'O', 'X', 'L'};
+constexpr std::uint32_t FILE_VERSION = 1;
+
+//==============================================================================
+template <typename T>
+void writeValues(std::ostream& _out, const T* _values, std::size_t _count)
+{
+  _out.write(reinterpret_cast<const char*>(_values), sizeof(T) * _count);
+}
+
+//==============================================================================
+template <typename T>
+void readValues(
+    std::istream& _in,
+    T* _values,
+    std::size_t _count,
+    const std::string& _filename)
+{
+  _in.read(reinterpret_cast<char*>(_values), sizeof(T) * _count);
+  if (!_in)
+  {
+    std::stringstream ss;
+    ss << "Experience library file '" << _filename << "' is truncated.";
+    throw std::runtime_error(ss.str());
+  }
+}
+
+} // namespace
+
+//==============================================================================
+ExperienceLibrary::ExperienceLibrary(
+    statespace::StateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator,
+    distance::DistanceMetricPtr _dmetric,
+    std::size_t _capacity)
+  : mStateSpace(std::move(_stateSpace))
+  , mInterpolator(std::move(_interpolator))
+  , mDistanceMetric(std::move(_dmetric))
+  , mCapacity(_capacity)
+  , mClock(0)
+{
+  if (!mStateSpace)
+    throw std::invalid_argument("StateSpace is nullptr.");
+
+  if (!mInterpolator)
+    throw std::invalid_argument("Interpolator is nullptr.");
+
+  if (mInterpolator->getStateSpace() != mStateSpace)
+    throw std::invalid_argument("Interpolator does not match StateSpace.");
+
+  if (!mDistanceMetric)
+    throw std::invalid_argument("DistanceMetric is nullptr.");
+
+  if (mDistanceMetric->getStateSpace() != mStateSpace)
+    throw std::invalid_argument("DistanceMetric does not match StateSpace.");
+
+  if (mCapacity == 0)
+    throw std::invalid_argument("Capacity must be positive.");
+}
+
+//==============================================================================
+statespace::StateSpacePtr ExperienceLibrary::getStateSpace() const
+{
+  return mStateSpace;
+}
+
+//==============================================================================
+statespace::InterpolatorPtr ExperienceLibrary::getInterpolator() const
+{
+  return mInterpolator;
+}
+
+//==============================================================================
+distance::DistanceMetricPtr ExperienceLibrary::getDistanceMetric() const
+{
+  return mDistanceMetric;
+}
+
+//==============================================================================
+void ExperienceLibrary::setCapacity(std::size_t _capacity)
+{
+  if (_capacity == 0)
+    throw std::invalid_argument("Capacity must be positive.");
+
+  mCapacity = _capacity;
+  evict(mCapacity);
+}
+
+//==============================================================================
+std::size_t ExperienceLibrary::getCapacity() const
+{
+  return mCapacity;
+}
+
+//==============================================================================
+std::size_t ExperienceLibrary::size() const
+{
+  return mEntries.size();
+}
+
+//==============================================================================
+void ExperienceLibrary::clear()
+{
+  mEntries.clear();
+}
+
+//==============================================================================
+void ExperienceLibrary::addPath(const trajectory::Interpolated& _path)
+{
+  if (_path.getStateSpace() != mStateSpace)
+    throw std::invalid_argument("Path does not match StateSpace.");
+
+  if (_path.getNumWaypoints() < 2)
+  {
+    std::stringstream ss;
+    ss << "Path must have at least two waypoints, got "
+       << _path.getNumWaypoints() << ".";
+    throw std::invalid_argument(ss.str());
+  }
+
+  auto path = std::make_shared<trajectory::Interpolated>(
+      mStateSpace, mInterpolator);
+  for (std::size_t i = 0; i < _path.getNumWaypoints(); ++i)
+    path->addWaypoint(_path.getWaypointTime(i), _path.getWaypoint(i));
+
+  evict(mCapacity - 1);
+  mEntries.push_back(Entry{std::move(path), ++mClock});
+}
+
+//==============================================================================
+std::vector<std::shared_ptr<const trajectory::Interpolated>>
+ExperienceLibrary::retrieve(
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    std::size_t _numPaths) const
+{
+  const auto nearest = findNearest(
+      [&](const trajectory::Interpolated& _path) {
+        return mDistanceMetric->distance(_start, _path.getWaypoint(0))
+               + mDistanceMetric->distance(
+                     _goal, _path.getWaypoint(_path.getNumWaypoints() - 1));
+      },
+      _numPaths);
+
+  std::vector<std::shared_ptr<const trajectory::Interpolated>> paths;
+  paths.reserve(nearest.size());
+  for (const auto index : nearest)
+    paths.push_back(mEntries[index].mPath);
+  return paths;
+}
+
+//==============================================================================
+std::vector<std::shared_ptr<const trajectory::Interpolated>>
+ExperienceLibrary::retrieve(
+    const statespace::StateSpace::State* _start,
+    const constraint::Testable& _goalTestable,
+    std::size_t _numPaths) const
+{
+  const auto nearest = findNearest(
+      [&](const trajectory::Interpolated& _path) {
+        if (!_goalTestable.isSatisfied(
+                _path.getWaypoint(_path.getNumWaypoints() - 1)))
+          return std::numeric_limits<double>::infinity();
+        return mDistanceMetric->distance(_start, _path.getWaypoint(0));
+      },
+      _numPaths);
+
+  std::vector<std::shared_ptr<const trajectory::Interpolated>> paths;
+  paths.reserve(nearest.size());
+  for (const auto index : nearest)
+    paths.push_back(mEntries[index].mPath);
+  return paths;
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr ExperienceLibrary::plan(
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    const LocalPlanner& _localPlanner,
+    constraint::TestablePtr _validityConstraint,
+    double _maxDistanceBtwValidityChecks,
+    double _maxRepairTime,
+    double _maxPlanTime,
+    std::size_t _numCandidates,
+    PlanningResult* _planningResult)
+{
+  if (!_localPlanner)
+    throw std::invalid_argument("Local planner is empty.");
+
+  if (!_validityConstraint)
+    throw std::invalid_argument("Validity constraint is nullptr.");
+
+  if (_validityConstraint->getStateSpace() != mStateSpace)
+  {
+    throw std::invalid_argument(
+        "Validity constraint does not match StateSpace.");
+  }
+
+  const auto candidates = findNearest(
+      [&](const trajectory::Interpolated& _path) {
+        return mDistanceMetric->distance(_start, _path.getWaypoint(0))
+               + mDistanceMetric->distance(
+                     _goal, _path.getWaypoint(_path.getNumWaypoints() - 1));
+      },
+      _numCandidates);
+
+  auto path = repairCandidates(
+      candidates,
+      _start,
+      _goal,
+      _localPlanner,
+      *_validityConstraint,
+      _maxDistanceBtwValidityChecks,
+      _maxRepairTime,
+      _planningResult);
+  if (path)
+    return path;
+
+  path = _localPlanner(_start, _goal, _maxPlanTime);
+  if (path)
+  {
+    addPath(*path);
+    if (_planningResult)
+      _planningResult->message = "Planned from scratch";
+  }
+  else if (_planningResult)
+  {
+    _planningResult->message = "Planning from scratch failed";
+  }
+  return path;
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr ExperienceLibrary::plan(
+    const statespace::StateSpace::State* _start,
+    const constraint::Testable& _goalTestable,
+    const LocalPlanner& _localPlanner,
+    constraint::TestablePtr _validityConstraint,
+    double _maxDistanceBtwValidityChecks,
+    double _maxRepairTime,
+    std::size_t _numCandidates,
+    PlanningResult* _planningResult)
+{
+  if (!_localPlanner)
+    throw std::invalid_argument("Local planner is empty.");
+
+  if (!_validityConstraint)
+    throw std::invalid_argument("Validity constraint is nullptr.");
+
+  if (_validityConstraint->getStateSpace() != mStateSpace)
+  {
+    throw std::invalid_argument(
+        "Validity constraint does not match StateSpace.");
+  }
+
+  auto candidates = findNearest(
+      [&](const trajectory::Interpolated& _path) {
+        if (!_goalTestable.isSatisfied(
+                _path.getWaypoint(_path.getNumWaypoints() - 1)))
+          return std::numeric_limits<double>::infinity();
+        return mDistanceMetric->distance(_start, _path.getWaypoint(0));
+      },
+      _numCandidates);
+
+  auto path = repairCandidates(
+      candidates,
+      _start,
+      nullptr,
+      _localPlanner,
+      *_validityConstraint,
+      _maxDistanceBtwValidityChecks,
+      _maxRepairTime,
+      _planningResult);
+  if (!path && _planningResult)
+    _planningResult->message = "No stored path to the goal region is valid";
+  return path;
+}
+
+//==============================================================================
+void ExperienceLibrary::save(const std::string& _filename) const
+{
+  std::ofstream out(_filename, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    std::stringstream ss;
+    ss << "Failed opening experience library file '" << _filename
+       << "' for writing.";
+    throw std::runtime_error(ss.str());
+  }
+
+  const std::uint32_t dimension
+      = static_cast<std::uint32_t>(mStateSpace->getDimension());
+  const std::uint64_t numPaths = mEntries.size();
+  writeValues(out, FILE_MAGIC, sizeof(FILE_MAGIC));
+  writeValues(out, &FILE_VERSION, 1);
+  writeValues(out, &dimension, 1);
+  writeValues(out, &numPaths, 1);
+
+  // Write the least recently used paths first, so that load() restores the
+  // eviction order.
+  std::vector<std::size_t> order(mEntries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](std::size_t _a, std::size_t _b) {
+    return mEntries[_a].mLastUsed < mEntries[_b].mLastUsed;
+  });
+
+  Eigen::VectorXd tangent;
+  for (const auto index : order)
+  {
+    const auto& path = *mEntries[index].mPath;
+    const std::uint64_t numWaypoints = path.getNumWaypoints();
+    writeValues(out, &numWaypoints, 1);
+
+    for (std::size_t i = 0; i < numWaypoints; ++i)
+    {
+      const double time = path.getWaypointTime(i);
+      mStateSpace->logMap(path.getWaypoint(i), tangent);
+      writeValues(out, &time, 1);
+      writeValues(out, tangent.data(), dimension);
+    }
+  }
+
+  if (!out)
+  {
+    std::stringstream ss;
+    ss << "Failed writing experience library file '" << _filename << "'.";
+    throw std::runtime_error(ss.str());
+  }
+}
+
+//==============================================================================
+void ExperienceLibrary::load(const std::string& _filename)
+{
+  std::ifstream in(_filename, std::ios::binary);
+  if (!in)
+  {
+    std::stringstream ss;
+    ss << "Failed opening experience library file '" << _filename << "'.";
+    throw std::runtime_error(ss.str());
+  }
+
+  char magic[sizeof(FILE_MAGIC)];
+  std::uint32_t version;
+  std::uint32_t dimension;
+  std::uint64_t numPaths;
+  readValues(in, magic, sizeof(magic), _filename);
+  if (std::memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+  {
+    std::stringstream ss;
+    ss << "File '" << _filename << "' is not an experience library.";
+    throw std::runtime_error(ss.str());
+  }
+
+  readValues(in, &version, 1, _filename);
+  if (version != FILE_VERSION)
+  {
+    std::stringstream ss;
+    ss << "Experience library file '" << _filename << "' has version "
+       << version << ", expected " << FILE_VERSION << ".";
+    throw std::runtime_error(ss.str());
+  }
+
+  readValues(in, &dimension, 1, _filename);
+  if (dimension != mStateSpace->getDimension())
+  {
+    std::stringstream ss;
+    ss << "Experience library file '" << _filename << "' has dimension "
+       << dimension << ", but the StateSpace has dimension "
+       << mStateSpace->getDimension() << ".";
+    throw std::runtime_error(ss.str());
+  }
+
+  readValues(in, &numPaths, 1, _filename);
+
+  // Read all paths before replacing the stored ones, so that a corrupt file
+  // leaves the library unchanged.
+  std::vector<Entry> entries;
+  Eigen::VectorXd tangent(dimension);
+  for (std::uint64_t i = 0; i < numPaths; ++i)
+  {
+    std::uint64_t numWaypoints;
+    readValues(in, &numWaypoints, 1, _filename);
+
+    // save() only writes paths accepted by addPath().
+    if (numWaypoints < 2)
+    {
+      std::stringstream ss;
+      ss << "Experience library file '" << _filename << "' is corrupt: path "
+         << i << " has " << numWaypoints << " waypoints.";
+      throw std::runtime_error(ss.str());
+    }
+
+    auto path = std::make_shared<trajectory::Interpolated>(
+        mStateSpace, mInterpolator);
+    for (std::uint64_t j = 0; j < numWaypoints; ++j)
+    {
+      double time;
+      readValues(in, &time, 1, _filename);
+      readValues(in, tangent.data(), dimension, _filename);
+
+      // The path adopts the state instead of copying it.
+      auto state = mStateSpace->allocateState();
+      mStateSpace->expMap(tangent, state);
+      path->adoptWaypoint(time, state);
+    }
+
+    entries.push_back(Entry{std::move(path), 0});
+  }
+
+  mEntries.clear();
+  for (auto& entry : entries)
+  {
+    entry.mLastUsed = ++mClock;
+    mEntries.push_back(std::move(entry));
+  }
+  evict(mCapacity);
+}
+
+//==============================================================================
+std::vector<std::size_t> ExperienceLibrary::findNearest(
+    const std::function<double(const trajectory::Interpolated&)>& _cost,
+    std::size_t _numPaths) const
+{
+  std::vector<std::pair<double, std::size_t>> costs;
+  costs.reserve(mEntries.size());
+  for (std::size_t i = 0; i < mEntries.size(); ++i)
+  {
+    const double cost = _cost(*mEntries[i].mPath);
+    if (cost < std::numeric_limits<double>::infinity())
+      costs.emplace_back(cost, i);
+  }
+
+  // Break ties in favor of the most recently used path, e.g. a repaired path
+  // over the stored path it was repaired from.
+  const std::size_t numPaths = std::min(_numPaths, costs.size());
+  std::partial_sort(
+      costs.begin(),
+      costs.begin() + numPaths,
+      costs.end(),
+      [this](
+          const std::pair<double, std::size_t>& _a,
+          const std::pair<double, std::size_t>& _b) {
+        if (_a.first != _b.first)
+          return _a.first < _b.first;
+        return mEntries[_a.second].mLastUsed > mEntries[_b.second].mLastUsed;
+      });
+
+  std::vector<std::size_t> nearest;
+  nearest.reserve(numPaths);
+  for (std::size_t i = 0; i < numPaths; ++i)
+    nearest.push_back(costs[i].second);
+  return nearest;
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr ExperienceLibrary::repair(
+    std::size_t _index,
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    const LocalPlanner& _localPlanner,
+    const constraint::Testable& _validityConstraint,
+    double _maxDistanceBtwValidityChecks,
+    double _maxRepairTime,
+    std::size_t& _numRepairs) const
+{
+  const auto& stored = *mEntries[_index].mPath;
+  const std::size_t numWaypoints = stored.getNumWaypoints();
+
+  // Replace the endpoints of the stored path with those of the query.
+  std::vector<const statespace::StateSpace::State*> waypoints;
+  waypoints.reserve(numWaypoints);
+  waypoints.push_back(_start);
+  for (std::size_t i = 1; i + 1 < numWaypoints; ++i)
+    waypoints.push_back(stored.getWaypoint(i));
+  waypoints.push_back(_goal ? _goal : stored.getWaypoint(numWaypoints - 1));
+
+  if (!_validityConstraint.isSatisfied(waypoints.front())
+      || !_validityConstraint.isSatisfied(waypoints.back()))
+  {
+    return nullptr;
+  }
+
+  auto path
+      = std::make_shared<trajectory::Interpolated>(mStateSpace, mInterpolator);
+  double time = 0.;
+  path->addWaypoint(time, waypoints.front());
+
+  _numRepairs = 0;
+  std::size_t i = 0;
+  while (i + 1 < numWaypoints)
+  {
+    std::size_t next = i + 1;
+    if (_validityConstraint.isSatisfied(waypoints[next])
+        && isSegmentValid(
+               waypoints[i],
+               waypoints[next],
+               _validityConstraint,
+               _maxDistanceBtwValidityChecks))
+    {
+      time += 1.;
+      path->addWaypoint(time, waypoints[next]);
+      i = next;
+      continue;
+    }
+
+    // Plan around the invalid portion, up to the next valid waypoint. The
+    // goal is valid, so there is one.
+    while (!_validityConstraint.isSatisfied(waypoints[next]))
+      ++next;
+
+    const auto local
+        = _localPlanner(waypoints[i], waypoints[next], _maxRepairTime);
+    ++_numRepairs;
+    if (!local || local->getNumWaypoints() == 0)
+      return nullptr;
+
+    for (std::size_t j = 1; j < local->getNumWaypoints(); ++j)
+    {
+      time += 1.;
+      path->addWaypoint(time, local->getWaypoint(j));
+    }
+    i = next;
+  }
+
+  return path;
+}
+
+//==============================================================================
+bool ExperienceLibrary::isSegmentValid(
+    const statespace::StateSpace::State* _from,
+    const statespace::StateSpace::State* _to,
+    const constraint::Testable& _validityConstraint,
+    double _maxDistanceBtwValidityChecks) const
+{
+  const double distance = mDistanceMetric->distance(_from, _to);
+  if (distance <= _maxDistanceBtwValidityChecks)
+    return true;
+
+  const common::VanDerCorput vdc{
+      1, false, false, _maxDistanceBtwValidityChecks / distance};
+  auto state = mStateSpace->createState();
+  for (const auto alpha : vdc)
+  {
+    mInterpolator->interpolate(_from, _to, alpha, state);
+    if (!_validityConstraint.isSatisfied(state))
+      return false;
+  }
+  return true;
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr ExperienceLibrary::repairCandidates(
+    const std::vector<std::size_t>& _candidates,
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    const LocalPlanner& _localPlanner,
+    const constraint::Testable& _validityConstraint,
+    double _maxDistanceBtwValidityChecks,
+    double _maxRepairTime,
+    PlanningResult* _planningResult)
+{
+  if (_maxDistanceBtwValidityChecks <= 0)
+  {
+    std::stringstream ss;
+    ss << "Maximum distance between validity checks must be positive, got "
+       << _maxDistanceBtwValidityChecks << ".";
+    throw std::invalid_argument(ss.str());
+  }
+
+  for (const auto index : _candidates)
+  {
+    std::size_t numRepairs = 0;
+    auto path = repair(
+        index,
+        _start,
+        _goal,
+        _localPlanner,
+        _validityConstraint,
+        _maxDistanceBtwValidityChecks,
+        _maxRepairTime,
+        numRepairs);
+    if (!path)
+      continue;
+
+    mEntries[index].mLastUsed = ++mClock;
+
+    // A path that needed repairs differs from the stored one, so store it as
+    // well; the stored path may become valid again.
+    if (numRepairs > 0)
+      addPath(*path);
+
+    if (_planningResult)
+    {
+      std::stringstream ss;
+      if (numRepairs > 0)
+        ss << "Repaired stored path with " << numRepairs << " local plans";
+      else
+        ss << "Reused stored path";
+      _planningResult->message = ss.str();
+    }
+    return path;
+  }
+
+  return nullptr;
+}
+
+//==============================================================================
+void ExperienceLibrary::evict(std::size_t _size)
+{
+  while (mEntries.size() > _size)
+  {
+    const auto leastRecentlyUsed = std::min_element(
+        mEntries.begin(), mEntries.end(), [](const Entry& _a, const Entry& _b) {
+          return _a.mLastUsed < _b.mLastUsed;
+        });
+    mEntries.erase(leastRecentlyUsed);
+  }
+}
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
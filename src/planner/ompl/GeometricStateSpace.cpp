@@ -1,8 +1,20 @@
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <new>
 #include <dart/common/StlHelpers.hpp>
+#include <aikido/constraint/CartesianProductTestable.hpp>
+#include <aikido/constraint/MetaSkeletonBoxConstraint.hpp>
 #include <aikido/constraint/Sampleable.hpp>
+#include <aikido/constraint/uniform/RnBoxConstraint.hpp>
+#include <aikido/distance/CartesianProductWeighted.hpp>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/distance/SO2Angular.hpp>
+#include <aikido/distance/SO3Angular.hpp>
 #include <aikido/planner/ompl/BackwardCompatibility.hpp>
 #include <aikido/planner/ompl/GeometricStateSpace.hpp>
 #include <aikido/planner/ompl/StateSampler.hpp>
+#include <aikido/statespace/dart/JointStateSpace.hpp>
 
 using dart::common::make_unique;
 
@@ -10,6 +22,162 @@ namespace aikido {
 namespace planner {
 namespace ompl {
 
+namespace {
+
+/// Number of StateTypes allocated at once when the pool is empty.
+constexpr std::size_t kNumBlocksPerChunk = 64;
+
+/// Size of the memory of a StateType in the pool, a multiple of the alignment
+/// of any scalar type.
+constexpr std::size_t kBlockSize
+    = (sizeof(GeometricStateSpace::StateType) + alignof(std::max_align_t) - 1)
+      / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+/// Maximum distance between two states of a space and its measure, i.e. its
+/// volume under the distance metric.
+struct SpaceSize
+{
+  double mExtent;
+  double mMeasure;
+};
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+//==============================================================================
+/// Reads the limits of _bounds into _lower and _upper if it is an
+/// RBoxConstraint<N>.
+template <int N>
+bool getBoxLimits(
+    const constraint::Testable* _bounds,
+    Eigen::VectorXd& _lower,
+    Eigen::VectorXd& _upper)
+{
+  const auto box = dynamic_cast<const constraint::RBoxConstraint<N>*>(_bounds);
+  if (!box)
+    return false;
+
+  _lower = box->getLowerLimits();
+  _upper = box->getUpperLimits();
+  return true;
+}
+
+//==============================================================================
+/// Returns the size of a real vector space with the Euclidean metric. The
+/// limits are read from _bounds or, if _bounds is nullptr, from the position
+/// limits of the joint that _space represents.
+SpaceSize computeRealVectorSize(
+    const statespace::StateSpace& _space, const constraint::Testable* _bounds)
+{
+  Eigen::VectorXd lower;
+  Eigen::VectorXd upper;
+
+  if (_bounds)
+  {
+    if (!getBoxLimits<1>(_bounds, lower, upper)
+        && !getBoxLimits<2>(_bounds, lower, upper)
+        && !getBoxLimits<3>(_bounds, lower, upper)
+        && !getBoxLimits<6>(_bounds, lower, upper)
+        && !getBoxLimits<Eigen::Dynamic>(_bounds, lower, upper))
+    {
+      return SpaceSize{kInfinity, kInfinity};
+    }
+  }
+  else if (const auto jointSpace
+           = dynamic_cast<const statespace::dart::JointStateSpace*>(&_space))
+  {
+    const auto joint = jointSpace->getJoint();
+    lower.resize(joint->getNumDofs());
+    upper.resize(joint->getNumDofs());
+    for (std::size_t i = 0; i < joint->getNumDofs(); ++i)
+    {
+      lower[i] = joint->getPositionLowerLimit(i);
+      upper[i] = joint->getPositionUpperLimit(i);
+    }
+  }
+  else
+  {
+    return SpaceSize{kInfinity, kInfinity};
+  }
+
+  const Eigen::VectorXd widths = upper - lower;
+  if (!widths.allFinite())
+    return SpaceSize{kInfinity, kInfinity};
+
+  return SpaceSize{widths.norm(), widths.prod()};
+}
+
+//==============================================================================
+/// Returns the size of _space under _metric, within _bounds. _bounds may be
+/// nullptr if the bounds of _space are the position limits of its joints.
+/// Spaces whose bounds or metric are not understood are unbounded.
+SpaceSize computeSize(
+    const statespace::StateSpace& _space,
+    const constraint::Testable* _bounds,
+    const distance::DistanceMetric& _metric)
+{
+  if (_space.getDimension() == 0)
+    return SpaceSize{0., 1.};
+
+  if (dynamic_cast<const distance::SO2Angular*>(&_metric))
+    return SpaceSize{M_PI, 2. * M_PI};
+
+  if (dynamic_cast<const distance::SO3Angular*>(&_metric))
+    return SpaceSize{M_PI, M_PI * M_PI};
+
+  if (dynamic_cast<const distance::R1Euclidean*>(&_metric)
+      || dynamic_cast<const distance::R2Euclidean*>(&_metric)
+      || dynamic_cast<const distance::R3Euclidean*>(&_metric)
+      || dynamic_cast<const distance::R6Euclidean*>(&_metric)
+      || dynamic_cast<const distance::RnEuclidean*>(&_metric))
+  {
+    return computeRealVectorSize(_space, _bounds);
+  }
+
+  const auto metric
+      = dynamic_cast<const distance::CartesianProductWeighted*>(&_metric);
+  const auto space = dynamic_cast<const statespace::CartesianProduct*>(&_space);
+  if (!metric || !space)
+    return SpaceSize{kInfinity, kInfinity};
+
+  // MetaSkeletonBoxConstraint holds the position limits of every joint.
+  const std::vector<constraint::TestablePtr>* subspaceBounds = nullptr;
+  if (const auto bounds
+      = dynamic_cast<const constraint::CartesianProductTestable*>(_bounds))
+  {
+    subspaceBounds = &bounds->getConstraints();
+  }
+  else if (!dynamic_cast<const constraint::MetaSkeletonBoxConstraint*>(
+               _bounds))
+  {
+    return SpaceSize{kInfinity, kInfinity};
+  }
+
+  // The metric is a weighted sum of the subspace metrics. Scaling the
+  // distance on a subspace of dimension n by w scales its measure by w^n.
+  SpaceSize size{0., 1.};
+  const auto& metrics = metric->getMetrics();
+  for (std::size_t i = 0; i < metrics.size(); ++i)
+  {
+    const auto& subspace = *space->getSubspace<>(i);
+    const auto subspaceSize = computeSize(
+        subspace,
+        subspaceBounds ? (*subspaceBounds)[i].get() : nullptr,
+        *metrics[i].first);
+    if (!std::isfinite(subspaceSize.mExtent)
+        || !std::isfinite(subspaceSize.mMeasure))
+      return SpaceSize{kInfinity, kInfinity};
+
+    const double weight = metrics[i].second;
+    size.mExtent += weight * subspaceSize.mExtent;
+    size.mMeasure *= std::pow(weight, subspace.getDimension())
+                     * subspaceSize.mMeasure;
+  }
+
+  return size;
+}
+
+} // namespace
+
 //==============================================================================
 GeometricStateSpace::StateType::StateType(statespace::StateSpace::State* _st)
   : mState(_st), mValid(true)
@@ -30,6 +198,8 @@ GeometricStateSpace::GeometricStateSpace(
   , mSampler(std::move(_sampler))
   , mBoundsConstraint(std::move(_boundsConstraint))
   , mBoundsProjection(std::move(_boundsProjection))
+  , mMaximumExtent(std::numeric_limits<double>::infinity())
+  , mMeasure(std::numeric_limits<double>::infinity())
 {
   if (mStateSpace == nullptr)
   {
@@ -85,6 +255,18 @@ GeometricStateSpace::GeometricStateSpace(
   {
     throw std::invalid_argument("BoundsProjection does not match StateSpace");
   }
+
+  const auto size
+      = computeSize(*mStateSpace, mBoundsConstraint.get(), *mDistance);
+  mMaximumExtent = size.mExtent;
+  mMeasure = size.mMeasure;
+}
+
+//==============================================================================
+GeometricStateSpace::~GeometricStateSpace()
+{
+  for (const auto state : mFreeStates)
+    mStateSpace->freeState(state);
 }
 
 //==============================================================================
@@ -96,13 +278,13 @@ unsigned int GeometricStateSpace::getDimension() const
 //==============================================================================
 double GeometricStateSpace::getMaximumExtent() const
 {
-  return std::numeric_limits<double>::infinity();
+  return mMaximumExtent;
 }
 
 //==============================================================================
 double GeometricStateSpace::getMeasure() const
 {
-  throw std::runtime_error("getMeasure not implemented.");
+  return mMeasure;
 }
 
 //==============================================================================
@@ -219,17 +401,41 @@ void GeometricStateSpace::interpolate(
 //==============================================================================
 ::ompl::base::State* GeometricStateSpace::allocState() const
 {
-  auto ast = mStateSpace->allocateState();
-  return new StateType(ast);
+  void* block;
+  statespace::StateSpace::State* ast = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mPoolMutex);
+
+    if (mFreeBlocks.empty())
+    {
+      mChunks.emplace_back(new char[kNumBlocksPerChunk * kBlockSize]);
+      for (std::size_t i = kNumBlocksPerChunk; i > 0; --i)
+        mFreeBlocks.push_back(mChunks.back().get() + (i - 1) * kBlockSize);
+    }
+
+    block = mFreeBlocks.back();
+    mFreeBlocks.pop_back();
+
+    if (!mFreeStates.empty())
+    {
+      ast = mFreeStates.back();
+      mFreeStates.pop_back();
+    }
+  }
+
+  if (ast == nullptr)
+    ast = mStateSpace->allocateState();
+
+  return new (block) StateType(ast);
 }
 
 //==============================================================================
 ::ompl::base::State* GeometricStateSpace::allocState(
     const aikido::statespace::StateSpace::State* _state) const
 {
-  auto newState = mStateSpace->allocateState();
-  mStateSpace->copyState(_state, newState);
-  return new StateType(newState);
+  auto newState = static_cast<StateType*>(allocState());
+  mStateSpace->copyState(_state, newState->mState);
+  return newState;
 }
 
 //==============================================================================
@@ -238,11 +444,13 @@ void GeometricStateSpace::freeState(::ompl::base::State* _state) const
   if (_state != nullptr)
   {
     auto st = static_cast<StateType*>(_state);
-    if (st->mState != nullptr)
-    {
-      mStateSpace->freeState(st->mState);
-    }
-    delete st;
+    const auto ast = st->mState;
+    st->~StateType();
+
+    std::lock_guard<std::mutex> lock(mPoolMutex);
+    if (ast != nullptr)
+      mFreeStates.push_back(ast);
+    mFreeBlocks.push_back(st);
   }
 }
 
@@ -251,6 +459,19 @@ statespace::StateSpacePtr GeometricStateSpace::getAikidoStateSpace() const
 {
   return mStateSpace;
 }
+
+//==============================================================================
+statespace::InterpolatorPtr GeometricStateSpace::getInterpolator() const
+{
+  return mInterpolator;
+}
+
+//==============================================================================
+distance::DistanceMetricPtr GeometricStateSpace::getDistanceMetric() const
+{
+  return mDistance;
+}
+
 }
 }
 }
@@ -1,5 +1,7 @@
+#include <chrono>
 #include <aikido/planner/ompl/GeometricStateSpace.hpp>
 #include <aikido/planner/ompl/GoalRegion.hpp>
+#include "detail/StateSpaceConversion.hpp"
 
 namespace aikido {
 namespace planner {
@@ -13,6 +15,10 @@ GoalRegion::GoalRegion(
   : ::ompl::base::GoalSampleableRegion(_si)
   , mTestable(std::move(_goalTestable))
   , mSampleGenerator(std::move(_generator))
+  , mNumPushed(0)
+  , mNumPopped(0)
+  , mSampling(false)
+  , mStopSampling(false)
 {
   if (_si == nullptr)
   {
@@ -36,10 +42,125 @@ GoalRegion::GoalRegion(
   }
 }
 
+//==============================================================================
+GoalRegion::~GoalRegion()
+{
+  // Exceptions from the background thread can't be reported here.
+  stopBackgroundSampling();
+}
+
+//==============================================================================
+void GoalRegion::startBackgroundSampling(
+    std::size_t _queueCapacity,
+    std::unique_ptr<constraint::SampleGenerator> _generator,
+    constraint::TestablePtr _goalTestable)
+{
+  if (_queueCapacity == 0)
+  {
+    throw std::invalid_argument("Goal queue capacity must be positive.");
+  }
+
+  if (_generator == nullptr)
+  {
+    throw std::invalid_argument("SampleGenerator is null");
+  }
+
+  if (_goalTestable == nullptr)
+  {
+    throw std::invalid_argument("Testable is null");
+  }
+
+  const auto stateSpace = _generator->getStateSpace();
+  if (_goalTestable->getStateSpace() != stateSpace)
+  {
+    throw std::invalid_argument(
+        "SampleGenerator and Testable defined on different statespaces.");
+  }
+
+  const auto planningStateSpace
+      = static_cast<const GeometricStateSpace*>(si_->getStateSpace().get())
+            ->getAikidoStateSpace();
+  if (stateSpace == planningStateSpace)
+  {
+    throw std::invalid_argument(
+        "Background goal sampling must not use the planning StateSpace.");
+  }
+  detail::checkConvertible(*stateSpace, *planningStateSpace);
+
+  if (isBackgroundSampling())
+  {
+    throw std::runtime_error("Background goal sampling is already running.");
+  }
+
+  mBackgroundSampleGenerator = std::move(_generator);
+  mBackgroundTestable = std::move(_goalTestable);
+
+  mQueue.reserve(_queueCapacity);
+  for (std::size_t i = 0; i < _queueCapacity; ++i)
+    mQueue.push_back(stateSpace->allocateState());
+
+  mNumPushed = 0;
+  mNumPopped = 0;
+  mSamplingException = nullptr;
+  mStopSampling = false;
+  mSampling = true;
+  mSamplingThread = std::thread(&GoalRegion::sampleInBackground, this);
+}
+
+//==============================================================================
+std::exception_ptr GoalRegion::stopBackgroundSampling()
+{
+  if (!isBackgroundSampling())
+    return nullptr;
+
+  mStopSampling = true;
+  mSamplingThread.join();
+  mSampling = false;
+
+  const auto stateSpace = mBackgroundSampleGenerator->getStateSpace();
+  for (auto state : mQueue)
+    stateSpace->freeState(state);
+  mQueue.clear();
+
+  mBackgroundSampleGenerator.reset();
+  mBackgroundTestable.reset();
+
+  auto exception = mSamplingException;
+  mSamplingException = nullptr;
+  return exception;
+}
+
+//==============================================================================
+bool GoalRegion::isBackgroundSampling() const
+{
+  return mSamplingThread.joinable();
+}
+
 //==============================================================================
 void GoalRegion::sampleGoal(::ompl::base::State* _state) const
 {
   auto state = static_cast<GeometricStateSpace::StateType*>(_state);
+
+  if (isBackgroundSampling())
+  {
+    const std::size_t numPopped = mNumPopped.load(std::memory_order_relaxed);
+    if (numPopped == mNumPushed.load(std::memory_order_acquire))
+    {
+      state->mValid = false;
+      return;
+    }
+
+    detail::convertState(
+        *mBackgroundSampleGenerator->getStateSpace(),
+        mQueue[numPopped % mQueue.size()],
+        *static_cast<const GeometricStateSpace*>(si_->getStateSpace().get())
+             ->getAikidoStateSpace(),
+        state->mState);
+    state->mValid = true;
+    mNumPopped.store(numPopped + 1, std::memory_order_release);
+    return;
+  }
+
   bool valid = false;
   if (mSampleGenerator->canSample())
   {
@@ -51,12 +172,22 @@ void GoalRegion::sampleGoal(::ompl::base::State* _state) const
 //==============================================================================
 unsigned int GoalRegion::maxSampleCount() const
 {
+  if (isBackgroundSampling())
+    return mNumPushed.load(std::memory_order_acquire);
+
   return mSampleGenerator->getNumSamples();
 }
 
 //==============================================================================
 bool GoalRegion::couldSample() const
 {
+  if (isBackgroundSampling())
+  {
+    return mSampling.load(std::memory_order_acquire)
+           || mNumPopped.load(std::memory_order_relaxed)
+                  != mNumPushed.load(std::memory_order_acquire);
+  }
+
   return mSampleGenerator->canSample();
 }
 
@@ -78,6 +209,36 @@ bool GoalRegion::isSatisfied(const ::ompl::base::State* _state) const
     return false;
   return mTestable->isSatisfied(state->mState);
 }
+
+//==============================================================================
+void GoalRegion::sampleInBackground()
+{
+  try
+  {
+    while (!mStopSampling && mBackgroundSampleGenerator->canSample())
+    {
+      const std::size_t numPushed = mNumPushed.load(std::memory_order_relaxed);
+      if (numPushed - mNumPopped.load(std::memory_order_acquire)
+          == mQueue.size())
+      {
+        // The queue is full; wait for the planner to pop a goal.
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+
+      auto state = mQueue[numPushed % mQueue.size()];
+      if (mBackgroundSampleGenerator->sample(state)
+          && mBackgroundTestable->isSatisfied(state))
+        mNumPushed.store(numPushed + 1, std::memory_order_release);
+    }
+  }
+  catch (...)
+  {
+    mSamplingException = std::current_exception();
+  }
+
+  mSampling.store(false, std::memory_order_release);
+}
 }
 }
 }
@@ -0,0 +1,33 @@
+#include <aikido/planner/ompl/InformedPathLengthObjective.hpp>
+
+#if OMPL_VERSION_AT_LEAST(1, 2, 0)
+
+#include <aikido/planner/ompl/TangentSpaceInformedSampler.hpp>
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+//==============================================================================
+InformedPathLengthObjective::InformedPathLengthObjective(
+    const ::ompl::base::SpaceInformationPtr& _si)
+  : ::ompl::base::PathLengthOptimizationObjective(_si)
+{
+  setDescription("Informed path length");
+}
+
+//==============================================================================
+::ompl::base::InformedSamplerPtr
+InformedPathLengthObjective::allocInformedStateSampler(
+    const ::ompl::base::ProblemDefinitionPtr& _problem,
+    unsigned int _maxNumberCalls) const
+{
+  return ompl_make_shared<TangentSpaceInformedSampler>(
+      _problem, _maxNumberCalls);
+}
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#endif // OMPL_VERSION_AT_LEAST(1, 2, 0)
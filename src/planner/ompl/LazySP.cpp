@@ -0,0 +1,653 @@
+#include <aikido/planner/ompl/LazySP.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <ompl/base/goals/GoalSampleableRegion.h>
+#include <ompl/datastructures/NearestNeighborsGNAT.h>
+#include <ompl/geometric/PathGeometric.h>
+#include <aikido/common/VanDerCorput.hpp>
+#include <aikido/planner/ompl/GeometricStateSpace.hpp>
+#include <aikido/planner/ompl/MotionValidator.hpp>
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+//==============================================================================
+LazySP::LazySP(const ::ompl::base::SpaceInformationPtr& _si)
+  : LazySP(_si, "LazySP")
+{
+}
+
+//==============================================================================
+LazySP::LazySP(
+    const ::ompl::base::SpaceInformationPtr& _si, const std::string& _name)
+  : ::ompl::base::Planner(_si, _name)
+  , mEdgeSelector(EdgeSelector::FORWARD)
+  , mMaxDistance(std::numeric_limits<double>::infinity())
+  , mNumNeighbors(10)
+  , mBatchSize(100)
+  , mNumEdgeChecks(0)
+  , mHasWorldState(false)
+{
+  auto ss
+      = ompl_dynamic_pointer_cast<GeometricStateSpace>(si_->getStateSpace());
+  if (!ss)
+  {
+    throw std::invalid_argument(
+        "LazySP algorithm requires a GeometricStateSpace");
+  }
+
+  specs_.approximateSolutions = false;
+  specs_.multithreaded = false;
+  specs_.optimizingPaths = false;
+
+  Planner::declareParam<double>(
+      "range", this, &LazySP::setRange, &LazySP::getRange, "0.:1.:10000.");
+  Planner::declareParam<unsigned int>(
+      "num_neighbors",
+      this,
+      &LazySP::setNumNeighbors,
+      &LazySP::getNumNeighbors,
+      "1:1:100");
+  Planner::declareParam<unsigned int>(
+      "batch_size",
+      this,
+      &LazySP::setBatchSize,
+      &LazySP::getBatchSize,
+      "1:1:10000");
+}
+
+//==============================================================================
+LazySP::~LazySP()
+{
+  clearRoadmap();
+}
+
+//==============================================================================
+void LazySP::getPlannerData(::ompl::base::PlannerData& _data) const
+{
+  ::ompl::base::Planner::getPlannerData(_data);
+
+  for (const auto vertex : mStartVertices)
+  {
+    _data.addStartVertex(
+        ::ompl::base::PlannerDataVertex(mVertices[vertex].mState));
+  }
+
+  for (const auto vertex : mGoalVertices)
+  {
+    _data.addGoalVertex(
+        ::ompl::base::PlannerDataVertex(mVertices[vertex].mState));
+  }
+
+  for (const auto& edge : mEdges)
+  {
+    if (edge.mStatus == Status::INVALID)
+      continue;
+
+    _data.addEdge(
+        ::ompl::base::PlannerDataVertex(mVertices[edge.mSource].mState),
+        ::ompl::base::PlannerDataVertex(mVertices[edge.mTarget].mState));
+  }
+}
+
+//==============================================================================
+::ompl::base::PlannerStatus LazySP::solve(
+    const ::ompl::base::PlannerTerminationCondition& _ptc)
+{
+  checkValidity();
+
+  auto goal = dynamic_cast<::ompl::base::GoalSampleableRegion*>(
+      pdef_->getGoal().get());
+  if (!goal)
+  {
+    return ::ompl::base::PlannerStatus::UNRECOGNIZED_GOAL_TYPE;
+  }
+
+  synchronizeWorld();
+
+  while (const ::ompl::base::State* st = pis_.nextStart())
+    mStartVertices.push_back(addVertex(st));
+
+  const bool validStart = std::any_of(
+      mStartVertices.begin(), mStartVertices.end(), [this](std::size_t _v) {
+        return evaluateVertex(_v);
+      });
+  if (!validStart)
+  {
+    return ::ompl::base::PlannerStatus::INVALID_START;
+  }
+
+  if (!goal->couldSample())
+  {
+    return ::ompl::base::PlannerStatus::INVALID_GOAL;
+  }
+
+  if (mGoalVertices.empty())
+  {
+    if (const ::ompl::base::State* st = pis_.nextGoal(_ptc))
+      mGoalVertices.push_back(addVertex(st));
+  }
+
+  if (!mSampler)
+    mSampler = si_->allocStateSampler();
+
+  std::vector<std::size_t> pathVertices;
+  std::vector<std::size_t> pathEdges;
+  while (_ptc == false)
+  {
+    if (!findShortestPath(pathVertices, pathEdges))
+    {
+      // The start and goal are disconnected: densify the roadmap and try
+      // another goal, if there are more.
+      growRoadmap(_ptc);
+      if (pis_.haveMoreGoalStates())
+      {
+        if (const ::ompl::base::State* st = pis_.nextGoal())
+          mGoalVertices.push_back(addVertex(st));
+      }
+      continue;
+    }
+
+    if (!evaluatePath(pathVertices, pathEdges))
+      continue;
+
+    auto path = ompl_make_shared<::ompl::geometric::PathGeometric>(si_);
+    for (const auto vertex : pathVertices)
+      path->append(mVertices[vertex].mState);
+    pdef_->addSolutionPath(path, false, 0.0, getName());
+
+    return ::ompl::base::PlannerStatus::EXACT_SOLUTION;
+  }
+
+  return ::ompl::base::PlannerStatus::TIMEOUT;
+}
+
+//==============================================================================
+void LazySP::clear()
+{
+  ::ompl::base::Planner::clear();
+  removeQueryVertices();
+}
+
+//==============================================================================
+void LazySP::clearRoadmap()
+{
+  clear();
+
+  for (auto& vertex : mVertices)
+    si_->freeState(vertex.mState);
+  mVertices.clear();
+  mEdges.clear();
+
+  if (mNearestNeighbors)
+    mNearestNeighbors->clear();
+}
+
+//==============================================================================
+void LazySP::clearValidityCache()
+{
+  for (auto& vertex : mVertices)
+    vertex.mStatus = Status::UNKNOWN;
+
+  for (auto& edge : mEdges)
+    edge.mStatus = Status::UNKNOWN;
+
+  auto motionValidator
+      = ompl_dynamic_pointer_cast<MotionValidator>(si_->getMotionValidator());
+  if (motionValidator)
+    motionValidator->clearEdgeCache();
+}
+
+//==============================================================================
+void LazySP::setWorld(
+    WorldPtr _world, std::vector<std::string> _ignoredSkeletons)
+{
+  mWorld = std::move(_world);
+  mIgnoredSkeletons = std::move(_ignoredSkeletons);
+  mHasWorldState = false;
+}
+
+//==============================================================================
+void LazySP::setEdgeSelector(EdgeSelector _selector)
+{
+  mEdgeSelector = _selector;
+}
+
+//==============================================================================
+LazySP::EdgeSelector LazySP::getEdgeSelector() const
+{
+  return mEdgeSelector;
+}
+
+//==============================================================================
+void LazySP::setRange(double _distance)
+{
+  mMaxDistance = _distance;
+}
+
+//==============================================================================
+double LazySP::getRange() const
+{
+  return mMaxDistance;
+}
+
+//==============================================================================
+void LazySP::setNumNeighbors(unsigned int _numNeighbors)
+{
+  mNumNeighbors = _numNeighbors;
+}
+
+//==============================================================================
+unsigned int LazySP::getNumNeighbors() const
+{
+  return mNumNeighbors;
+}
+
+//==============================================================================
+void LazySP::setBatchSize(unsigned int _batchSize)
+{
+  if (_batchSize == 0)
+  {
+    throw std::invalid_argument("Batch size must be >= 1");
+  }
+
+  mBatchSize = _batchSize;
+}
+
+//==============================================================================
+unsigned int LazySP::getBatchSize() const
+{
+  return mBatchSize;
+}
+
+//==============================================================================
+std::size_t LazySP::getNumVertices() const
+{
+  return mVertices.size();
+}
+
+//==============================================================================
+std::size_t LazySP::getNumEdges() const
+{
+  return mEdges.size();
+}
+
+//==============================================================================
+std::size_t LazySP::getNumEvaluatedEdges() const
+{
+  return std::count_if(mEdges.begin(), mEdges.end(), [](const Edge& _edge) {
+    return _edge.mStatus != Status::UNKNOWN;
+  });
+}
+
+//==============================================================================
+std::size_t LazySP::getNumEdgeChecks() const
+{
+  return mNumEdgeChecks;
+}
+
+//==============================================================================
+void LazySP::setup()
+{
+  ::ompl::base::Planner::setup();
+
+  if (!mNearestNeighbors)
+  {
+    mNearestNeighbors.reset(new ::ompl::NearestNeighborsGNAT<std::size_t>);
+    mNearestNeighbors->setDistanceFunction(
+        ompl_bind(
+            &LazySP::distanceFunction,
+            this,
+            OMPL_PLACEHOLDER(_1),
+            OMPL_PLACEHOLDER(_2)));
+  }
+}
+
+//==============================================================================
+std::size_t LazySP::addVertex(const ::ompl::base::State* _state)
+{
+  const std::size_t index = mVertices.size();
+
+  Vertex vertex;
+  vertex.mState = si_->cloneState(_state);
+  vertex.mStatus = Status::UNKNOWN;
+  mVertices.push_back(std::move(vertex));
+
+  std::vector<std::size_t> neighbors;
+  if (mNearestNeighbors->size() > 0)
+    mNearestNeighbors->nearestK(index, mNumNeighbors, neighbors);
+
+  for (const auto neighbor : neighbors)
+  {
+    const double length = distanceFunction(index, neighbor);
+    if (length > mMaxDistance)
+      continue;
+
+    Edge edge;
+    edge.mSource = index;
+    edge.mTarget = neighbor;
+    edge.mLength = length;
+    edge.mStatus = Status::UNKNOWN;
+
+    mVertices[index].mEdges.push_back(mEdges.size());
+    mVertices[neighbor].mEdges.push_back(mEdges.size());
+    mEdges.push_back(edge);
+  }
+
+  mNearestNeighbors->add(index);
+  return index;
+}
+
+//==============================================================================
+void LazySP::removeQueryVertices()
+{
+  constexpr std::size_t REMOVED = std::numeric_limits<std::size_t>::max();
+
+  std::vector<char> isRemoved(mVertices.size(), false);
+  std::size_t firstRemoved = mVertices.size();
+  const auto markRemoved = [&](std::vector<std::size_t>& _vertices) {
+    for (const auto vertex : _vertices)
+    {
+      isRemoved[vertex] = true;
+      firstRemoved = std::min(firstRemoved, vertex);
+    }
+    _vertices.clear();
+  };
+  markRemoved(mStartVertices);
+  markRemoved(mGoalVertices);
+
+  if (firstRemoved == mVertices.size())
+    return;
+
+  // Without a roadmap grown during the query, the query vertices are the last
+  // vertices, and are removed from the nearest neighbors structure one by
+  // one. Otherwise the vertices are renumbered and the structure is rebuilt.
+  const bool isTail = std::all_of(
+      isRemoved.begin() + firstRemoved, isRemoved.end(), [](char _removed) {
+        return _removed;
+      });
+  if (isTail && mNearestNeighbors)
+  {
+    for (std::size_t vertex = firstRemoved; vertex < mVertices.size();
+         ++vertex)
+      mNearestNeighbors->remove(vertex);
+  }
+
+  std::vector<std::size_t> vertexIndices(mVertices.size(), REMOVED);
+  std::size_t numVertices = 0;
+  for (std::size_t vertex = 0; vertex < mVertices.size(); ++vertex)
+  {
+    if (isRemoved[vertex])
+    {
+      si_->freeState(mVertices[vertex].mState);
+      continue;
+    }
+
+    vertexIndices[vertex] = numVertices;
+    if (numVertices != vertex)
+      mVertices[numVertices] = std::move(mVertices[vertex]);
+    ++numVertices;
+  }
+  mVertices.resize(numVertices);
+
+  std::vector<std::size_t> edgeIndices(mEdges.size(), REMOVED);
+  std::size_t numEdges = 0;
+  for (std::size_t index = 0; index < mEdges.size(); ++index)
+  {
+    Edge edge = mEdges[index];
+    edge.mSource = vertexIndices[edge.mSource];
+    edge.mTarget = vertexIndices[edge.mTarget];
+    if (edge.mSource == REMOVED || edge.mTarget == REMOVED)
+      continue;
+
+    edgeIndices[index] = numEdges;
+    mEdges[numEdges++] = edge;
+  }
+  mEdges.resize(numEdges);
+
+  for (auto& vertex : mVertices)
+  {
+    std::size_t numVertexEdges = 0;
+    for (const auto edge : vertex.mEdges)
+    {
+      if (edgeIndices[edge] != REMOVED)
+        vertex.mEdges[numVertexEdges++] = edgeIndices[edge];
+    }
+    vertex.mEdges.resize(numVertexEdges);
+  }
+
+  if (!isTail && mNearestNeighbors)
+  {
+    std::vector<std::size_t> vertices(mVertices.size());
+    std::iota(vertices.begin(), vertices.end(), 0);
+    mNearestNeighbors->clear();
+    if (!vertices.empty())
+      mNearestNeighbors->add(vertices);
+  }
+}
+
+//==============================================================================
+void LazySP::growRoadmap(const ::ompl::base::PlannerTerminationCondition& _ptc)
+{
+  ::ompl::base::State* state = si_->allocState();
+  for (unsigned int i = 0; i < mBatchSize && _ptc == false; ++i)
+  {
+    mSampler->sampleUniform(state);
+    addVertex(state);
+  }
+  si_->freeState(state);
+}
+
+//==============================================================================
+bool LazySP::findShortestPath(
+    std::vector<std::size_t>& _vertices, std::vector<std::size_t>& _edges) const
+{
+  constexpr std::size_t NO_EDGE = std::numeric_limits<std::size_t>::max();
+  using QueueEntry = std::pair<double, std::size_t>;
+
+  std::vector<char> isGoal(mVertices.size(), false);
+  for (const auto vertex : mGoalVertices)
+    isGoal[vertex] = true;
+
+  std::vector<double> distances(
+      mVertices.size(), std::numeric_limits<double>::infinity());
+  std::vector<std::size_t> parentEdges(mVertices.size(), NO_EDGE);
+  std::priority_queue<
+      QueueEntry,
+      std::vector<QueueEntry>,
+      std::greater<QueueEntry>>
+      queue;
+
+  for (const auto vertex : mStartVertices)
+  {
+    if (mVertices[vertex].mStatus == Status::INVALID)
+      continue;
+
+    distances[vertex] = 0.;
+    queue.emplace(0., vertex);
+  }
+
+  while (!queue.empty())
+  {
+    const double distance = queue.top().first;
+    std::size_t vertex = queue.top().second;
+    queue.pop();
+
+    if (distance > distances[vertex])
+      continue;
+
+    if (isGoal[vertex])
+    {
+      _vertices.clear();
+      _edges.clear();
+      _vertices.push_back(vertex);
+      while (parentEdges[vertex] != NO_EDGE)
+      {
+        const Edge& edge = mEdges[parentEdges[vertex]];
+        _edges.push_back(parentEdges[vertex]);
+        vertex = edge.mSource == vertex ? edge.mTarget : edge.mSource;
+        _vertices.push_back(vertex);
+      }
+      std::reverse(_vertices.begin(), _vertices.end());
+      std::reverse(_edges.begin(), _edges.end());
+      return true;
+    }
+
+    for (const auto edgeIndex : mVertices[vertex].mEdges)
+    {
+      const Edge& edge = mEdges[edgeIndex];
+      if (edge.mStatus == Status::INVALID)
+        continue;
+
+      const std::size_t other
+          = edge.mSource == vertex ? edge.mTarget : edge.mSource;
+      if (mVertices[other].mStatus == Status::INVALID)
+        continue;
+
+      const double otherDistance = distance + edge.mLength;
+      if (otherDistance < distances[other])
+      {
+        distances[other] = otherDistance;
+        parentEdges[other] = edgeIndex;
+        queue.emplace(otherDistance, other);
+      }
+    }
+  }
+
+  return false;
+}
+
+//==============================================================================
+std::vector<std::size_t> LazySP::getEdgeOrder(std::size_t _numEdges) const
+{
+  std::vector<std::size_t> order;
+  order.reserve(_numEdges);
+
+  switch (mEdgeSelector)
+  {
+    case EdgeSelector::FORWARD:
+      for (std::size_t i = 0; i < _numEdges; ++i)
+        order.push_back(i);
+      break;
+
+    case EdgeSelector::ALTERNATE:
+      for (std::size_t i = 0; i < (_numEdges + 1) / 2; ++i)
+      {
+        order.push_back(i);
+        if (_numEdges - 1 - i != i)
+          order.push_back(_numEdges - 1 - i);
+      }
+      break;
+
+    case EdgeSelector::BISECTION:
+    {
+      // Visit the edges at the VanDerCorput points of the path, skipping
+      // edges that were already visited.
+      std::vector<char> visited(_numEdges, false);
+      const common::VanDerCorput sequence{
+          1, false, false, 0.5 / static_cast<double>(_numEdges)};
+      for (const double t : sequence)
+      {
+        const auto edge = std::min(
+            static_cast<std::size_t>(t * _numEdges), _numEdges - 1);
+        if (!visited[edge])
+        {
+          visited[edge] = true;
+          order.push_back(edge);
+        }
+      }
+      for (std::size_t i = 0; i < _numEdges; ++i)
+      {
+        if (!visited[i])
+          order.push_back(i);
+      }
+      break;
+    }
+  }
+
+  return order;
+}
+
+//==============================================================================
+bool LazySP::evaluatePath(
+    const std::vector<std::size_t>& _vertices,
+    const std::vector<std::size_t>& _edges)
+{
+  for (const auto i : getEdgeOrder(_edges.size()))
+  {
+    if (!evaluateEdge(_edges[i], _vertices[i], _vertices[i + 1]))
+      return false;
+  }
+  return true;
+}
+
+//==============================================================================
+bool LazySP::evaluateVertex(std::size_t _vertex)
+{
+  Vertex& vertex = mVertices[_vertex];
+  if (vertex.mStatus == Status::UNKNOWN)
+  {
+    vertex.mStatus
+        = si_->isValid(vertex.mState) ? Status::VALID : Status::INVALID;
+  }
+  return vertex.mStatus == Status::VALID;
+}
+
+//==============================================================================
+bool LazySP::evaluateEdge(std::size_t _edge, std::size_t _from, std::size_t _to)
+{
+  Edge& edge = mEdges[_edge];
+  if (edge.mStatus == Status::UNKNOWN)
+  {
+    // An invalid endpoint invalidates all of its edges at once, so check the
+    // endpoints before the edge.
+    if (!evaluateVertex(_from) || !evaluateVertex(_to))
+      return false;
+
+    ++mNumEdgeChecks;
+    edge.mStatus
+        = si_->checkMotion(mVertices[_from].mState, mVertices[_to].mState)
+              ? Status::VALID
+              : Status::INVALID;
+  }
+  return edge.mStatus == Status::VALID;
+}
+
+//==============================================================================
+void LazySP::synchronizeWorld()
+{
+  if (!mWorld)
+    return;
+
+  World::State state;
+  {
+    std::lock_guard<std::mutex> lock(mWorld->getMutex());
+    state = mWorld->getState();
+  }
+
+  for (const auto& name : mIgnoredSkeletons)
+    state.configurations.erase(name);
+
+  if (!mHasWorldState || state != mWorldState)
+  {
+    clearValidityCache();
+    mWorldState = std::move(state);
+    mHasWorldState = true;
+  }
+}
+
+//==============================================================================
+double LazySP::distanceFunction(std::size_t _a, std::size_t _b) const
+{
+  return si_->distance(mVertices[_a].mState, mVertices[_b].mState);
+}
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
@@ -1,17 +1,37 @@
 #include <aikido/planner/ompl/MotionValidator.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <ompl/base/SpaceInformation.h>
 #include <aikido/common/StepSequence.hpp>
 #include <aikido/common/VanDerCorput.hpp>
+#include <aikido/planner/ompl/GeometricStateSpace.hpp>
 
 namespace aikido {
 namespace planner {
 namespace ompl {
+namespace {
+
+// Cached results are not invalidated when the constraints change, so caching
+// is opt-in.
+constexpr std::size_t DEFAULT_EDGE_CACHE_SIZE = 0;
+
+/// Segments with fewer samples are always checked serially.
+constexpr std::size_t MIN_PARALLEL_SAMPLES = 16;
+
+} // namespace
+
 MotionValidator::MotionValidator(
     const ::ompl::base::SpaceInformationPtr& _si,
     double _maxDistBtwValidityChecks)
   : ::ompl::base::MotionValidator(_si)
   , mSequenceResolution(_maxDistBtwValidityChecks)
+  , mEdgeCacheSize(DEFAULT_EDGE_CACHE_SIZE)
+  , mJobId(0)
+  , mNumBusyWorkers(0)
+  , mStopWorkers(false)
 {
   if (_si == nullptr)
   {
@@ -23,31 +43,128 @@ MotionValidator::MotionValidator(
     throw std::invalid_argument(
         "Max distance between validity checks must be >= 0.");
   }
+
+  initialize();
+}
+
+MotionValidator::MotionValidator(
+    const ::ompl::base::SpaceInformationPtr& _si,
+    constraint::MotionTestablePtr _motionTestable)
+  : ::ompl::base::MotionValidator(_si)
+  , mSequenceResolution(0.)
+  , mMotionTestable(std::move(_motionTestable))
+  , mEdgeCacheSize(DEFAULT_EDGE_CACHE_SIZE)
+  , mJobId(0)
+  , mNumBusyWorkers(0)
+  , mStopWorkers(false)
+{
+  if (_si == nullptr)
+  {
+    throw std::invalid_argument("SpaceInformation is nullptr.");
+  }
+
+  if (mMotionTestable == nullptr)
+  {
+    throw std::invalid_argument("MotionTestable is nullptr.");
+  }
+
+  auto stateSpace
+      = ompl_dynamic_pointer_cast<GeometricStateSpace>(_si->getStateSpace());
+  if (!stateSpace
+      || stateSpace->getAikidoStateSpace() != mMotionTestable->getStateSpace())
+  {
+    throw std::invalid_argument(
+        "MotionTestable does not match the planning StateSpace.");
+  }
+
+  // MotionTestable checks the geodesic between the endpoints, which is only
+  // the segment that the planner follows with a GeodesicInterpolator.
+  if (!std::dynamic_pointer_cast<statespace::GeodesicInterpolator>(
+          stateSpace->getInterpolator()))
+  {
+    throw std::invalid_argument(
+        "Interpolator of the planning StateSpace must be a "
+        "GeodesicInterpolator to check segments with a MotionTestable.");
+  }
+
+  initialize();
+}
+
+MotionValidator::~MotionValidator()
+{
+  stopWorkers();
+
+  for (const auto& scratch : mScratch)
+  {
+    si_->freeState(scratch->mState);
+    if (scratch->mRelativeState)
+      mAikidoStateSpace->freeState(scratch->mRelativeState);
+  }
+}
+
+void MotionValidator::initialize()
+{
+  auto stateSpace
+      = ompl_dynamic_pointer_cast<GeometricStateSpace>(si_->getStateSpace());
+  if (!stateSpace)
+    return;
+
+  mAikidoStateSpace = stateSpace->getAikidoStateSpace();
+  mGeodesicInterpolator
+      = std::dynamic_pointer_cast<statespace::GeodesicInterpolator>(
+          stateSpace->getInterpolator());
 }
 
 bool MotionValidator::checkMotion(
     const ::ompl::base::State* _s1, const ::ompl::base::State* _s2) const
 {
+  // Building the key copies both states, so skip it if caching is disabled.
+  std::string key;
+  if (mEdgeCacheSize > 0)
+    key = getEdgeKey(_s1, _s2);
+
+  EdgeResult result;
+  if (findEdge(key, result))
+    return result.mValid;
+
+  if (mMotionTestable)
+  {
+    result.mValid = checkMotionTestable(_s1, _s2, result.mLastValidTime);
+    storeEdge(key, result);
+    return result.mValid;
+  }
+
   double dist = si_->distance(_s1, _s2);
   aikido::common::VanDerCorput vdc{1,
                                    true,
                                    true, // include endpoints
                                    mSequenceResolution / dist};
 
-  auto stateSpace = si_->getStateSpace();
-  auto iState = stateSpace->allocState();
-
   bool valid = true;
-  for (double t : vdc)
+  if (mValidityCheckers.empty() || vdc.getLength() < MIN_PARALLEL_SAMPLES
+      || !checkMotionParallel(_s1, _s2, vdc, valid))
   {
-    stateSpace->interpolate(_s1, _s2, t, iState);
-    if (!si_->isValid(iState))
+    auto scratch = acquireScratch();
+    setSegment(*scratch, _s1, _s2);
+
+    for (double t : vdc)
     {
-      valid = false;
-      break;
+      interpolate(*scratch, _s1, _s2, t);
+      if (!si_->isValid(scratch->mState))
+      {
+        valid = false;
+        break;
+      }
     }
+    releaseScratch(std::move(scratch));
   }
-  stateSpace->freeState(iState);
+
+  // The samples are not checked in order, so the last valid time of an
+  // invalid segment is unknown.
+  result.mValid = valid;
+  result.mLastValidTime
+      = valid ? 1.0 : std::numeric_limits<double>::quiet_NaN();
+  storeEdge(key, result);
   return valid;
 }
 
@@ -56,39 +173,337 @@ bool MotionValidator::checkMotion(
     const ::ompl::base::State* _s2,
     std::pair<::ompl::base::State*, double>& _lastValid) const
 {
-  double dist = si_->distance(_s1, _s2);
-
-  // Allocate a sequence that steps from 0 to 1 by a stepsize that ensures no
-  // more than mSequenceResolution of distance between successive points
-  aikido::common::StepSequence seq(
-      mSequenceResolution / dist,
-      true); // include endpoints
-
-  auto stateSpace = si_->getStateSpace();
-  auto iState = stateSpace->allocState();
+  // Building the key copies both states, so skip it if caching is disabled.
+  std::string key;
+  if (mEdgeCacheSize > 0)
+    key = getEdgeKey(_s1, _s2);
 
-  bool valid = true;
-  double lastValidTime = 0.0;
-  for (double t : seq)
+  EdgeResult result;
+  if (!findEdge(key, result) || std::isnan(result.mLastValidTime))
   {
-    stateSpace->interpolate(_s1, _s2, t, iState);
-    if (!si_->isValid(iState))
+    if (mMotionTestable)
     {
-      valid = false;
-      break;
+      result.mValid = checkMotionTestable(_s1, _s2, result.mLastValidTime);
     }
-    lastValidTime = t;
+    else
+    {
+      double dist = si_->distance(_s1, _s2);
+
+      // Allocate a sequence that steps from 0 to 1 by a stepsize that ensures
+      // no more than mSequenceResolution of distance between successive
+      // points. Samples are checked in order, since the first invalid sample
+      // determines the last valid time.
+      aikido::common::StepSequence seq(
+          mSequenceResolution / dist,
+          true); // include endpoints
+
+      auto scratch = acquireScratch();
+      setSegment(*scratch, _s1, _s2);
+
+      result.mValid = true;
+      result.mLastValidTime = 0.0;
+      for (double t : seq)
+      {
+        interpolate(*scratch, _s1, _s2, t);
+        if (!si_->isValid(scratch->mState))
+        {
+          result.mValid = false;
+          break;
+        }
+        result.mLastValidTime = t;
+      }
+      releaseScratch(std::move(scratch));
+    }
+    storeEdge(key, result);
   }
-  stateSpace->freeState(iState);
 
   // Copy the last valid time and value into the return value
-  _lastValid.second = lastValidTime;
+  _lastValid.second = result.mLastValidTime;
   if (_lastValid.first)
   {
-    stateSpace->interpolate(_s1, _s2, _lastValid.second, _lastValid.first);
+    si_->getStateSpace()->interpolate(
+        _s1, _s2, _lastValid.second, _lastValid.first);
   }
 
-  return valid;
+  return result.mValid;
+}
+
+void MotionValidator::setEdgeCacheSize(std::size_t _size)
+{
+  std::lock_guard<std::mutex> lock(mEdgeCacheMutex);
+  mEdgeCacheSize = _size;
+  if (mEdgeCache.size() > mEdgeCacheSize)
+    mEdgeCache.clear();
+}
+
+std::size_t MotionValidator::getEdgeCacheSize() const
+{
+  std::lock_guard<std::mutex> lock(mEdgeCacheMutex);
+  return mEdgeCacheSize;
+}
+
+void MotionValidator::clearEdgeCache()
+{
+  std::lock_guard<std::mutex> lock(mEdgeCacheMutex);
+  mEdgeCache.clear();
+}
+
+void MotionValidator::setParallelValidityCheckers(
+    std::vector<::ompl::base::StateValidityCheckerPtr> _validityCheckers)
+{
+  for (const auto& validityChecker : _validityCheckers)
+  {
+    if (!validityChecker)
+      throw std::invalid_argument("StateValidityChecker is nullptr.");
+  }
+
+  std::lock_guard<std::mutex> jobLock(mJobMutex);
+  stopWorkers();
+
+  mValidityCheckers = std::move(_validityCheckers);
+  for (std::size_t i = 1; i < mValidityCheckers.size(); ++i)
+    mWorkers.emplace_back(&MotionValidator::runWorker, this, i, mJobId);
+}
+
+std::size_t MotionValidator::getNumParallelThreads() const
+{
+  return std::max<std::size_t>(1, mValidityCheckers.size());
+}
+
+bool MotionValidator::checkMotionParallel(
+    const ::ompl::base::State* _s1,
+    const ::ompl::base::State* _s2,
+    const aikido::common::VanDerCorput& _times,
+    bool& _valid) const
+{
+  std::unique_lock<std::mutex> jobLock(mJobMutex, std::try_to_lock);
+  if (!jobLock.owns_lock())
+    return false;
+
+  mJob.mS1 = _s1;
+  mJob.mS2 = _s2;
+  mJob.mTimes.clear();
+  for (double t : _times)
+    mJob.mTimes.push_back(t);
+  mJob.mNextSample = 0;
+  mJob.mInvalid = false;
+  mJob.mException = nullptr;
+
+  {
+    std::lock_guard<std::mutex> lock(mWorkerMutex);
+    ++mJobId;
+    mNumBusyWorkers = mWorkers.size();
+  }
+  mJobStarted.notify_all();
+
+  runJob(*mValidityCheckers[0]);
+
+  {
+    std::unique_lock<std::mutex> lock(mWorkerMutex);
+    mJobFinished.wait(lock, [this] { return mNumBusyWorkers == 0; });
+  }
+
+  if (mJob.mException)
+    std::rethrow_exception(mJob.mException);
+
+  _valid = !mJob.mInvalid;
+  return true;
+}
+
+void MotionValidator::runJob(
+    const ::ompl::base::StateValidityChecker& _validityChecker) const
+{
+  auto scratch = acquireScratch();
+  try
+  {
+    setSegment(*scratch, mJob.mS1, mJob.mS2);
+
+    // Samples are handed out in VanDerCorput order, so the workers check the
+    // segment coarse to fine together.
+    for (std::size_t i = mJob.mNextSample++;
+         i < mJob.mTimes.size() && !mJob.mInvalid;
+         i = mJob.mNextSample++)
+    {
+      interpolate(*scratch, mJob.mS1, mJob.mS2, mJob.mTimes[i]);
+      if (!_validityChecker.isValid(scratch->mState))
+        mJob.mInvalid = true;
+    }
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(mWorkerMutex);
+    if (!mJob.mException)
+      mJob.mException = std::current_exception();
+    mJob.mInvalid = true;
+  }
+  releaseScratch(std::move(scratch));
+}
+
+void MotionValidator::runWorker(std::size_t _index, std::size_t _jobId)
+{
+  std::size_t jobId = _jobId;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mWorkerMutex);
+      mJobStarted.wait(lock, [&] { return mStopWorkers || mJobId != jobId; });
+      if (mStopWorkers)
+        return;
+      jobId = mJobId;
+    }
+
+    runJob(*mValidityCheckers[_index]);
+
+    {
+      std::lock_guard<std::mutex> lock(mWorkerMutex);
+      --mNumBusyWorkers;
+    }
+    mJobFinished.notify_one();
+  }
+}
+
+void MotionValidator::stopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(mWorkerMutex);
+    mStopWorkers = true;
+  }
+  mJobStarted.notify_all();
+
+  for (auto& worker : mWorkers)
+    worker.join();
+  mWorkers.clear();
+
+  std::lock_guard<std::mutex> lock(mWorkerMutex);
+  mStopWorkers = false;
+}
+
+std::unique_ptr<MotionValidator::Scratch> MotionValidator::acquireScratch()
+    const
+{
+  {
+    std::lock_guard<std::mutex> lock(mScratchMutex);
+    if (!mScratch.empty())
+    {
+      auto scratch = std::move(mScratch.back());
+      mScratch.pop_back();
+      return scratch;
+    }
+  }
+
+  std::unique_ptr<Scratch> scratch(new Scratch);
+  scratch->mState = si_->allocState();
+  scratch->mRelativeState = mGeodesicInterpolator
+                                ? mAikidoStateSpace->allocateState()
+                                : nullptr;
+  return scratch;
+}
+
+void MotionValidator::releaseScratch(std::unique_ptr<Scratch> _scratch) const
+{
+  std::lock_guard<std::mutex> lock(mScratchMutex);
+  mScratch.push_back(std::move(_scratch));
+}
+
+void MotionValidator::setSegment(
+    Scratch& _scratch,
+    const ::ompl::base::State* _s1,
+    const ::ompl::base::State* _s2) const
+{
+  if (!mGeodesicInterpolator)
+    return;
+
+  const auto s1 = static_cast<const GeometricStateSpace::StateType*>(_s1);
+  const auto s2 = static_cast<const GeometricStateSpace::StateType*>(_s2);
+  _scratch.mTangent
+      = mGeodesicInterpolator->getTangentVector(s1->mState, s2->mState);
+}
+
+void MotionValidator::interpolate(
+    Scratch& _scratch,
+    const ::ompl::base::State* _s1,
+    const ::ompl::base::State* _s2,
+    double _t) const
+{
+  if (!mGeodesicInterpolator)
+  {
+    si_->getStateSpace()->interpolate(_s1, _s2, _t, _scratch.mState);
+    return;
+  }
+
+  // Same as GeodesicInterpolator::interpolate(), reusing the tangent vector.
+  const auto s1 = static_cast<const GeometricStateSpace::StateType*>(_s1);
+  auto state = static_cast<GeometricStateSpace::StateType*>(_scratch.mState);
+  mAikidoStateSpace->expMap(_t * _scratch.mTangent, _scratch.mRelativeState);
+  mAikidoStateSpace->compose(
+      s1->mState, _scratch.mRelativeState, state->mState);
+}
+
+std::string MotionValidator::getEdgeKey(
+    const ::ompl::base::State* _s1, const ::ompl::base::State* _s2) const
+{
+  // Segments are only cached if states can be compared by value.
+  if (!mAikidoStateSpace)
+    return std::string();
+
+  const auto s1 = static_cast<const GeometricStateSpace::StateType*>(_s1);
+  const auto s2 = static_cast<const GeometricStateSpace::StateType*>(_s2);
+  const std::size_t size = mAikidoStateSpace->getStateSizeInBytes();
+
+  std::string key(2 * size, '\0');
+  std::memcpy(&key[0], s1->mState, size);
+  std::memcpy(&key[size], s2->mState, size);
+  return key;
+}
+
+bool MotionValidator::findEdge(
+    const std::string& _key, EdgeResult& _result) const
+{
+  if (_key.empty())
+    return false;
+
+  std::lock_guard<std::mutex> lock(mEdgeCacheMutex);
+  const auto it = mEdgeCache.find(_key);
+  if (it == mEdgeCache.end())
+    return false;
+
+  _result = it->second;
+  return true;
+}
+
+void MotionValidator::storeEdge(
+    const std::string& _key, const EdgeResult& _result) const
+{
+  if (_key.empty())
+    return;
+
+  std::lock_guard<std::mutex> lock(mEdgeCacheMutex);
+  if (mEdgeCacheSize == 0)
+    return;
+
+  if (mEdgeCache.size() >= mEdgeCacheSize)
+    mEdgeCache.clear();
+  mEdgeCache[_key] = _result;
+}
+
+bool MotionValidator::checkMotionTestable(
+    const ::ompl::base::State* _s1,
+    const ::ompl::base::State* _s2,
+    double& _lastValidTime) const
+{
+  // The start state is assumed to be valid, so only the end state needs to be
+  // checked against the constraints that are not covered by mMotionTestable.
+  if (!si_->isValid(_s2))
+  {
+    // The end state may be invalid for reasons unrelated to mMotionTestable,
+    // so no part of the segment beyond _s1 is known to be valid.
+    _lastValidTime = 0.0;
+    return false;
+  }
+
+  const auto s1 = static_cast<const GeometricStateSpace::StateType*>(_s1);
+  const auto s2 = static_cast<const GeometricStateSpace::StateType*>(_s2);
+  return mMotionTestable->isSatisfied(s1->mState, s2->mState, _lastValidTime);
 }
 }
 }
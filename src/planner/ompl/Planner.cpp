@@ -1,15 +1,217 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <ompl/base/PlannerTerminationCondition.h>
+#include <aikido/common/VanDerCorput.hpp>
 #include <aikido/constraint/TestableIntersection.hpp>
 #include <aikido/planner/ompl/CRRT.hpp>
 #include <aikido/planner/ompl/CRRTConnect.hpp>
 #include <aikido/planner/ompl/GeometricStateSpace.hpp>
 #include <aikido/planner/ompl/MotionValidator.hpp>
 #include <aikido/planner/ompl/Planner.hpp>
+#include "detail/StateSpaceConversion.hpp"
 
 #include <dart/dart.hpp>
 
 namespace aikido {
 namespace planner {
 namespace ompl {
+namespace {
+
+//==============================================================================
+/// Converts the solution path of _pdef into an aikido trajectory. If
+/// _adoptStates is true, the trajectory takes over the aikido states of the
+/// path instead of copying them, and the path must not be used afterwards.
+trajectory::InterpolatedPtr getSolutionTrajectory(
+    const ::ompl::base::ProblemDefinitionPtr& _pdef,
+    statespace::StateSpacePtr _sspace,
+    statespace::InterpolatorPtr _interpolator,
+    bool _adoptStates = false)
+{
+  // Get the path
+  auto path = ompl_dynamic_pointer_cast<::ompl::geometric::PathGeometric>(
+      _pdef->getSolutionPath());
+  if (!path)
+  {
+    throw std::invalid_argument(
+        "Path is not of type PathGeometric. Cannot convert to aikido "
+        "Trajectory");
+  }
+
+  if (_adoptStates)
+    return toInterpolatedTrajectory(std::move(*path), std::move(_interpolator));
+
+  auto returnTraj = std::make_shared<trajectory::Interpolated>(
+      std::move(_sspace), std::move(_interpolator));
+
+  // Arbitrary timing
+  std::vector<double> times;
+  std::vector<const statespace::StateSpace::State*> states;
+  times.reserve(path->getStateCount());
+  states.reserve(path->getStateCount());
+  for (std::size_t idx = 0; idx < path->getStateCount(); ++idx)
+  {
+    times.push_back(idx);
+    states.push_back(
+        path->getState(idx)->as<GeometricStateSpace::StateType>()->mState);
+  }
+  returnTraj->addWaypoints(times, states);
+
+  return returnTraj;
+}
+
+//==============================================================================
+/// Number of shortcuts each worker of simplifyOMPLParallel attempts between
+/// two synchronizations with the other workers.
+constexpr std::size_t SHORTCUT_ATTEMPTS_PER_ROUND = 8;
+
+//==============================================================================
+/// A shortcut between two arc lengths of a path.
+struct Shortcut
+{
+  double mFirstArcLength;
+  double mLastArcLength;
+
+  /// Indices of the path segments that contain the ends of the shortcut
+  std::size_t mFirstSegment;
+  std::size_t mLastSegment;
+
+  /// Decrease of the path length by the shortcut
+  double mImprovement;
+};
+
+//==============================================================================
+/// A worker thread of simplifyOMPLParallel and the valid shortcuts it found
+/// in the current round.
+struct ShortcutWorker
+{
+  ShortcutWorker(
+      const statespace::StateSpace* _stateSpace,
+      std::unique_ptr<common::RNG> _rng,
+      constraint::TestablePtr _validityConstraint)
+    : mRng(std::move(_rng))
+    , mValidityConstraint(std::move(_validityConstraint))
+    , mConstraintSpace(mValidityConstraint->getStateSpace())
+    , mTestState(_stateSpace)
+    , mConstraintState(mConstraintSpace.get())
+    , mFirst(_stateSpace)
+    , mLast(_stateSpace)
+    , mNumAttempts(0)
+  {
+  }
+
+  std::unique_ptr<common::RNG> mRng;
+  constraint::TestablePtr mValidityConstraint;
+
+  /// StateSpace of mValidityConstraint, e.g. of a clone of the skeleton
+  statespace::StateSpacePtr mConstraintSpace;
+
+  /// Scratch states for validity checks, in the StateSpace of the path and in
+  /// mConstraintSpace
+  statespace::StateSpace::ScopedState mTestState;
+  statespace::StateSpace::ScopedState mConstraintState;
+
+  /// Scratch states for the ends of a shortcut
+  statespace::StateSpace::ScopedState mFirst;
+  statespace::StateSpace::ScopedState mLast;
+
+  /// Number of shortcuts to attempt in the current round
+  std::size_t mNumAttempts;
+
+  /// Valid shortcuts found in the current round
+  std::vector<Shortcut> mShortcuts;
+};
+
+//==============================================================================
+/// Threads that run a task together on every call to run(). The threads are
+/// created once, instead of once per run.
+class WorkerPool
+{
+public:
+  /// Starts _numThreads - 1 threads. The thread that calls run() runs the
+  /// task with index zero.
+  WorkerPool(std::size_t _numThreads, std::function<void(std::size_t)> _task)
+    : mTask(std::move(_task)), mRunId(0), mNumBusyWorkers(0), mStop(false)
+  {
+    for (std::size_t i = 1; i < _numThreads; ++i)
+      mWorkers.emplace_back(&WorkerPool::runWorker, this, i);
+  }
+
+  ~WorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mRunStarted.notify_all();
+
+    for (auto& worker : mWorkers)
+      worker.join();
+  }
+
+  /// Runs the task with every index, and waits until all of them finish.
+  void run()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      ++mRunId;
+      mNumBusyWorkers = mWorkers.size();
+    }
+    mRunStarted.notify_all();
+
+    mTask(0);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mRunFinished.wait(lock, [this] { return mNumBusyWorkers == 0; });
+  }
+
+private:
+  /// Main loop of the worker thread that runs the task with index _index.
+  void runWorker(std::size_t _index)
+  {
+    std::size_t runId = 0;
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mRunStarted.wait(lock, [&] { return mStop || mRunId != runId; });
+        if (mStop)
+          return;
+        runId = mRunId;
+      }
+
+      mTask(_index);
+
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mNumBusyWorkers;
+      }
+      mRunFinished.notify_one();
+    }
+  }
+
+  std::function<void(std::size_t)> mTask;
+  std::vector<std::thread> mWorkers;
+
+  /// Protects the fields below, which signal the workers.
+  std::mutex mMutex;
+  std::condition_variable mRunStarted;
+  std::condition_variable mRunFinished;
+  std::size_t mRunId;
+  std::size_t mNumBusyWorkers;
+  bool mStop;
+};
+
+} // namespace
 
 //==============================================================================
 ::ompl::base::SpaceInformationPtr getSpaceInformation(
@@ -174,30 +376,203 @@ trajectory::InterpolatedPtr planOMPL(
 
   if (solved)
   {
-    auto returnTraj = std::make_shared<trajectory::Interpolated>(
-        std::move(_sspace), std::move(_interpolator));
+    return getSolutionTrajectory(
+        _pdef, std::move(_sspace), std::move(_interpolator));
+  }
+  return nullptr;
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr planOMPLPortfolio(
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    const std::vector<PortfolioPlanner>& _planners,
+    statespace::StateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator,
+    const PortfolioComponentsFactory& _componentsFactory,
+    common::RNG* _rng,
+    double _maxPlanTime,
+    double _maxDistanceBtwValidityChecks,
+    PlanningResult* _planningResult)
+{
+  if (_planners.empty())
+  {
+    throw std::invalid_argument("Portfolio has no planners.");
+  }
 
-    // Get the path
-    auto path = ompl_dynamic_pointer_cast<::ompl::geometric::PathGeometric>(
-        _pdef->getSolutionPath());
-    if (!path)
+  for (const auto& portfolioPlanner : _planners)
+  {
+    if (!portfolioPlanner.mAllocator)
     {
-      throw std::invalid_argument(
-          "Path is not of type PathGeometric. Cannot convert to aikido "
-          "Trajectory");
+      std::stringstream msg;
+      msg << "Planner '" << portfolioPlanner.mName << "' has no allocator.";
+      throw std::invalid_argument(msg.str());
     }
+  }
+
+  if (!_stateSpace)
+  {
+    throw std::invalid_argument("StateSpace is nullptr.");
+  }
+
+  if (!_interpolator)
+  {
+    throw std::invalid_argument("Interpolator is nullptr.");
+  }
+
+  if (!_componentsFactory)
+  {
+    throw std::invalid_argument("PortfolioComponentsFactory is empty.");
+  }
+
+  if (_rng == nullptr)
+  {
+    throw std::invalid_argument("RNG is nullptr.");
+  }
 
-    for (std::size_t idx = 0; idx < path->getStateCount(); ++idx)
+  // Every planner gets its own StateSpace, constraints and RNG stream, so the
+  // planners share no mutable state.
+  const std::size_t numPlanners = _planners.size();
+  auto rngs = common::cloneRNGsFrom(*_rng, numPlanners);
+
+  std::vector<statespace::StateSpacePtr> stateSpaces;
+  std::vector<statespace::InterpolatorPtr> interpolators;
+  std::vector<::ompl::base::PlannerPtr> planners;
+  std::vector<::ompl::base::ProblemDefinitionPtr> pdefs;
+  stateSpaces.reserve(numPlanners);
+  interpolators.reserve(numPlanners);
+  planners.reserve(numPlanners);
+  pdefs.reserve(numPlanners);
+  for (std::size_t i = 0; i < numPlanners; ++i)
+  {
+    auto components = _componentsFactory(i, std::move(rngs[i]));
+    if (!components.mStateSpace)
+    {
+      std::stringstream msg;
+      msg << "StateSpace of planner '" << _planners[i].mName
+          << "' is nullptr.";
+      throw std::invalid_argument(msg.str());
+    }
+    detail::checkConvertible(*_stateSpace, *components.mStateSpace);
+
+    auto si = getSpaceInformation(
+        components.mStateSpace,
+        components.mInterpolator,
+        std::move(components.mDistanceMetric),
+        std::move(components.mSampler),
+        std::move(components.mValidityConstraint),
+        std::move(components.mBoundsConstraint),
+        std::move(components.mBoundsProjector),
+        _maxDistanceBtwValidityChecks);
+
+    auto pdef = ompl_make_shared<::ompl::base::ProblemDefinition>(si);
+    auto sspace
+        = ompl_static_pointer_cast<GeometricStateSpace>(si->getStateSpace());
+    auto start = sspace->allocState()->as<GeometricStateSpace::StateType>();
+    detail::convertState(
+        *_stateSpace, _start, *components.mStateSpace, start->mState);
+    pdef->addStartState(start); // copies
+    sspace->freeState(start);
+
+    if (_goal)
     {
-      const auto* st
-          = static_cast<GeometricStateSpace::StateType*>(path->getState(idx));
-      // Arbitrary timing
-      returnTraj->addWaypoint(idx, st->mState);
+      auto goal = sspace->allocState()->as<GeometricStateSpace::StateType>();
+      detail::convertState(
+          *_stateSpace, _goal, *components.mStateSpace, goal->mState);
+      pdef->setGoalState(goal); // copies
+      sspace->freeState(goal);
+    }
+    else
+    {
+      pdef->setGoal(getGoalRegion(
+          si,
+          std::move(components.mGoalTestable),
+          std::move(components.mGoalSampler)));
     }
 
-    return returnTraj;
+    auto planner = _planners[i].mAllocator(si);
+    planner->setProblemDefinition(pdef);
+    planner->setup();
+
+    stateSpaces.push_back(std::move(components.mStateSpace));
+    interpolators.push_back(std::move(components.mInterpolator));
+    planners.push_back(std::move(planner));
+    pdefs.push_back(std::move(pdef));
   }
-  return nullptr;
+
+  // The first exact solution terminates every planner. A planner that throws
+  // only stops itself, so that the others can still find a solution.
+  std::atomic<bool> done(false);
+  const auto ptc = ::ompl::base::plannerOrTerminationCondition(
+      ::ompl::base::timedPlannerTerminationCondition(_maxPlanTime),
+      ::ompl::base::PlannerTerminationCondition(
+          [&done]() { return done.load(); }));
+
+  std::mutex resultMutex;
+  std::size_t winner = numPlanners;
+  std::exception_ptr exception;
+  std::vector<double> plannerTimes(numPlanners, 0.);
+
+  const auto solve = [&](std::size_t _index) {
+    const auto startTime = std::chrono::steady_clock::now();
+    try
+    {
+      const auto status = planners[_index]->solve(ptc);
+      if (status == ::ompl::base::PlannerStatus::EXACT_SOLUTION)
+      {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        if (winner == numPlanners)
+          winner = _index;
+        done = true;
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(resultMutex);
+      if (!exception)
+        exception = std::current_exception();
+    }
+    plannerTimes[_index] = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - startTime)
+                               .count();
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numPlanners - 1);
+  for (std::size_t i = 1; i < numPlanners; ++i)
+    threads.emplace_back(solve, i);
+  solve(0);
+
+  for (auto& thread : threads)
+    thread.join();
+
+  if (winner == numPlanners && exception)
+    std::rethrow_exception(exception);
+
+  if (_planningResult)
+  {
+    _planningResult->plannerTimes = plannerTimes;
+    if (winner < numPlanners)
+    {
+      _planningResult->plannerName = _planners[winner].mName;
+      _planningResult->message = "Solved by " + _planners[winner].mName + ".";
+    }
+    else
+    {
+      _planningResult->plannerName.clear();
+      _planningResult->message = "No planner found a solution.";
+    }
+  }
+
+  if (winner == numPlanners)
+    return nullptr;
+
+  // The ProblemDefinitions are discarded, so the trajectory takes over the
+  // states of the solution path.
+  const auto trajectory = getSolutionTrajectory(
+      pdefs[winner], stateSpaces[winner], interpolators[winner], true);
+  return detail::convertTrajectory(
+      *trajectory, std::move(_stateSpace), std::move(_interpolator));
 }
 
 //==============================================================================
@@ -216,7 +591,8 @@ trajectory::InterpolatedPtr planCRRT(
     double _maxPlanTime,
     double _maxExtensionDistance,
     double _maxDistanceBtwProjections,
-    double _minStepsize)
+    double _minStepsize,
+    bool _useNativeNearestNeighbors)
 {
   if (_trajConstraint == nullptr)
   {
@@ -253,7 +629,7 @@ trajectory::InterpolatedPtr planCRRT(
   auto si = getSpaceInformation(
       _stateSpace,
       _interpolator,
-      std::move(_dmetric),
+      _dmetric,
       std::move(_sampler),
       std::move(_validityConstraint),
       std::move(_boundsConstraint),
@@ -276,6 +652,8 @@ trajectory::InterpolatedPtr planCRRT(
   planner->setRange(_maxExtensionDistance);
   planner->setProjectionResolution(_maxDistanceBtwProjections);
   planner->setMinStateDifference(_minStepsize);
+  if (_useNativeNearestNeighbors)
+    planner->setNearestNeighbors(std::move(_dmetric));
   return planOMPL(
       planner,
       pdef,
@@ -301,7 +679,8 @@ trajectory::InterpolatedPtr planCRRTConnect(
     double _maxExtensionDistance,
     double _maxDistanceBtwProjections,
     double _minStepsize,
-    double _minTreeConnectionDistance)
+    double _minTreeConnectionDistance,
+    bool _useNativeNearestNeighbors)
 {
   if (_trajConstraint == nullptr)
   {
@@ -343,7 +722,7 @@ trajectory::InterpolatedPtr planCRRTConnect(
   auto si = getSpaceInformation(
       _stateSpace,
       _interpolator,
-      std::move(_dmetric),
+      _dmetric,
       std::move(_sampler),
       std::move(_validityConstraint),
       std::move(_boundsConstraint),
@@ -367,6 +746,8 @@ trajectory::InterpolatedPtr planCRRTConnect(
   planner->setProjectionResolution(_maxDistanceBtwProjections);
   planner->setConnectionRadius(_minTreeConnectionDistance);
   planner->setMinStateDifference(_minStepsize);
+  if (_useNativeNearestNeighbors)
+    planner->setNearestNeighbors(std::move(_dmetric));
   return planOMPL(
       planner,
       pdef,
@@ -405,11 +786,32 @@ std::pair<std::unique_ptr<trajectory::Interpolated>, bool> simplifyOMPL(
       std::move(_boundsProjector),
       _maxDistanceBtwValidityChecks);
 
+  return simplifyOMPL(
+      si,
+      std::move(_interpolator),
+      _timeout,
+      _maxEmptySteps,
+      std::move(_originalTraj));
+}
+
+//==============================================================================
+std::pair<std::unique_ptr<trajectory::Interpolated>, bool> simplifyOMPL(
+    const ::ompl::base::SpaceInformationPtr& _si,
+    statespace::InterpolatorPtr _interpolator,
+    double _timeout,
+    std::size_t _maxEmptySteps,
+    trajectory::InterpolatedPtr _originalTraj)
+{
+  if (_timeout < 0)
+  {
+    throw std::invalid_argument("Timeout must be >= 0");
+  }
+
   // Step 2: Convert AIKIDO Interpolated Trajectory to OMPL path
-  auto path = toOMPLTrajectory(_originalTraj, si);
+  auto path = toOMPLTrajectory(_originalTraj, _si);
 
   // Step 3: Use the OMPL methods to simplify the path
-  ::ompl::geometric::PathSimplifier simplifier{si};
+  ::ompl::geometric::PathSimplifier simplifier{_si};
 
   // Flag for user to know if shorten was successful
   bool shorten_success = false;
@@ -439,12 +841,362 @@ std::pair<std::unique_ptr<trajectory::Interpolated>, bool> simplifyOMPL(
            && empty_steps <= _maxEmptySteps);
 
   // Step 4: Convert the simplified geomteric path to AIKIDO untimed trajectory
-  auto returnTraj = toInterpolatedTrajectory(path, _interpolator);
+  auto returnTraj = toInterpolatedTrajectory(std::move(path), _interpolator);
 
   // Step 5: Return trajectory and notify user if shortening was successful
   std::pair<std::unique_ptr<trajectory::Interpolated>, bool> returnPair;
   return std::make_pair(std::move(returnTraj), shorten_success);
 }
+
+//==============================================================================
+std::pair<std::unique_ptr<trajectory::Interpolated>, bool>
+simplifyOMPLParallel(
+    statespace::StateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator,
+    distance::DistanceMetricPtr _dmetric,
+    const std::vector<constraint::TestablePtr>& _validityConstraints,
+    constraint::TestablePtr _boundsConstraint,
+    common::RNG* _rng,
+    double _maxDistanceBtwValidityChecks,
+    double _timeout,
+    std::size_t _maxAttempts,
+    std::size_t _maxEmptySteps,
+    trajectory::InterpolatedPtr _originalTraj)
+{
+  if (_stateSpace == nullptr)
+  {
+    throw std::invalid_argument("StateSpace is nullptr.");
+  }
+
+  if (_interpolator == nullptr)
+  {
+    throw std::invalid_argument("Interpolator is nullptr.");
+  }
+
+  if (_interpolator->getStateSpace() != _stateSpace)
+  {
+    throw std::invalid_argument("Interpolator does not match StateSpace.");
+  }
+
+  if (_dmetric == nullptr)
+  {
+    throw std::invalid_argument("DistanceMetric is nullptr.");
+  }
+
+  if (_dmetric->getStateSpace() != _stateSpace)
+  {
+    throw std::invalid_argument("DistanceMetric does not match StateSpace.");
+  }
+
+  if (_validityConstraints.empty())
+  {
+    throw std::invalid_argument("No validity constraints given.");
+  }
+
+  for (const auto& validityConstraint : _validityConstraints)
+  {
+    if (validityConstraint == nullptr)
+    {
+      throw std::invalid_argument("ValidityConstraint is nullptr.");
+    }
+
+    if (validityConstraint->getStateSpace() == nullptr)
+    {
+      throw std::invalid_argument("StateSpace of ValidityConstraint is null.");
+    }
+
+    detail::checkConvertible(
+        *_stateSpace, *validityConstraint->getStateSpace());
+  }
+
+  if (_boundsConstraint == nullptr)
+  {
+    throw std::invalid_argument("BoundsConstraint is nullptr.");
+  }
+
+  if (_boundsConstraint->getStateSpace() != _stateSpace)
+  {
+    throw std::invalid_argument("BoundsConstraint does not match StateSpace.");
+  }
+
+  if (_rng == nullptr)
+  {
+    throw std::invalid_argument("RNG is nullptr.");
+  }
+
+  if (_maxDistanceBtwValidityChecks <= 0.)
+  {
+    throw std::invalid_argument(
+        "Maximum distance between validity checks must be positive.");
+  }
+
+  if (_timeout < 0)
+  {
+    throw std::invalid_argument("Timeout must be >= 0");
+  }
+
+  if (_originalTraj == nullptr)
+  {
+    throw std::invalid_argument("Trajectory is nullptr.");
+  }
+
+  if (_originalTraj->getStateSpace() != _stateSpace)
+  {
+    throw std::invalid_argument("Trajectory does not match StateSpace.");
+  }
+
+  const statespace::StateSpace* stateSpace = _stateSpace.get();
+
+  // Waypoints are timed by their index, as in toInterpolatedTrajectory().
+  auto path = dart::common::make_unique<trajectory::Interpolated>(
+      _stateSpace, _interpolator);
+  std::vector<double> times;
+  std::vector<const statespace::StateSpace::State*> states;
+  for (std::size_t idx = 0; idx < _originalTraj->getNumWaypoints(); ++idx)
+  {
+    times.push_back(idx);
+    states.push_back(_originalTraj->getWaypoint(idx));
+  }
+  path->addWaypoints(times, states);
+
+  // A path with a single segment cannot be shortcut.
+  if (path->getNumWaypoints() < 3)
+    return std::make_pair(std::move(path), false);
+
+  const std::size_t maxEmptySteps
+      = _maxEmptySteps ? _maxEmptySteps : path->getNumWaypoints();
+
+  // Arc length of the path at each waypoint.
+  std::vector<double> arcLengths;
+  const auto computeArcLengths = [&]() {
+    arcLengths.assign(1, 0.);
+    for (std::size_t idx = 1; idx < path->getNumWaypoints(); ++idx)
+    {
+      arcLengths.push_back(
+          arcLengths.back()
+          + _dmetric->distance(
+                path->getWaypoint(idx - 1), path->getWaypoint(idx)));
+    }
+  };
+  computeArcLengths();
+
+  // Returns the index of the segment that contains an arc length.
+  const auto findSegment = [&](double _arcLength) -> std::size_t {
+    const auto it
+        = std::upper_bound(arcLengths.begin(), arcLengths.end(), _arcLength);
+    return std::min<std::size_t>(
+        it - arcLengths.begin() - 1, arcLengths.size() - 2);
+  };
+
+  // Computes the state at an arc length within a segment.
+  const auto interpolateAt = [&](double _arcLength,
+                                 std::size_t _segment,
+                                 statespace::StateSpace::State* _state) {
+    const double segmentLength
+        = arcLengths[_segment + 1] - arcLengths[_segment];
+    double alpha = 0.;
+    if (segmentLength > 0.)
+    {
+      alpha = std::min(
+          (_arcLength - arcLengths[_segment]) / segmentLength, 1.);
+    }
+    _interpolator->interpolate(
+        path->getWaypoint(_segment),
+        path->getWaypoint(_segment + 1),
+        alpha,
+        _state);
+  };
+
+  // Workers are stored in a deque because ScopedState cannot be relocated.
+  const std::size_t numWorkers = _validityConstraints.size();
+  auto rngs = common::cloneRNGsFrom(*_rng, numWorkers);
+  std::deque<ShortcutWorker> workers;
+  for (std::size_t i = 0; i < numWorkers; ++i)
+  {
+    workers.emplace_back(
+        stateSpace, std::move(rngs[i]), _validityConstraints[i]);
+  }
+
+  // Checks a state with the constraint of _worker, in its StateSpace.
+  const auto isValid = [&](ShortcutWorker& _worker) {
+    if (!_boundsConstraint->isSatisfied(_worker.mTestState))
+      return false;
+
+    if (_worker.mConstraintSpace == _stateSpace)
+      return _worker.mValidityConstraint->isSatisfied(_worker.mTestState);
+
+    detail::convertState(
+        *_stateSpace,
+        _worker.mTestState,
+        *_worker.mConstraintSpace,
+        _worker.mConstraintState);
+    return _worker.mValidityConstraint->isSatisfied(_worker.mConstraintState);
+  };
+
+  // Attempts a random shortcut. Only reads the path, which is modified only
+  // between rounds, so workers can run concurrently.
+  const auto attempt = [&](ShortcutWorker& _worker) {
+    std::uniform_real_distribution<double> distribution(
+        0., arcLengths.back());
+    Shortcut shortcut;
+    shortcut.mFirstArcLength = distribution(*_worker.mRng);
+    shortcut.mLastArcLength = distribution(*_worker.mRng);
+    if (shortcut.mFirstArcLength > shortcut.mLastArcLength)
+      std::swap(shortcut.mFirstArcLength, shortcut.mLastArcLength);
+
+    shortcut.mFirstSegment = findSegment(shortcut.mFirstArcLength);
+    shortcut.mLastSegment = findSegment(shortcut.mLastArcLength);
+    if (shortcut.mFirstSegment == shortcut.mLastSegment)
+      return;
+
+    interpolateAt(
+        shortcut.mFirstArcLength, shortcut.mFirstSegment, _worker.mFirst);
+    interpolateAt(
+        shortcut.mLastArcLength, shortcut.mLastSegment, _worker.mLast);
+
+    // Ignore rounding errors along straight parts of the path.
+    const double pathLength
+        = shortcut.mLastArcLength - shortcut.mFirstArcLength;
+    const double length = _dmetric->distance(_worker.mFirst, _worker.mLast);
+    shortcut.mImprovement = pathLength - length;
+    if (shortcut.mImprovement <= 1e-6 * pathLength)
+      return;
+
+    const double resolution = length > _maxDistanceBtwValidityChecks
+                                  ? _maxDistanceBtwValidityChecks / length
+                                  : 1.;
+    const common::VanDerCorput vdc{1, true, true, resolution};
+    for (const auto alpha : vdc)
+    {
+      _interpolator->interpolate(
+          _worker.mFirst, _worker.mLast, alpha, _worker.mTestState);
+      if (!isValid(_worker))
+        return;
+    }
+
+    _worker.mShortcuts.push_back(shortcut);
+  };
+
+  std::mutex exceptionMutex;
+  std::exception_ptr exception;
+  WorkerPool pool(numWorkers, [&](std::size_t _index) {
+    auto& worker = workers[_index];
+    worker.mShortcuts.clear();
+    try
+    {
+      for (std::size_t i = 0; i < worker.mNumAttempts; ++i)
+        attempt(worker);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(exceptionMutex);
+      if (!exception)
+        exception = std::current_exception();
+    }
+  });
+
+  bool shorten_success = false;
+  std::size_t attempts = 0;
+  std::size_t empty_steps = 0;
+  const auto time_before = std::chrono::steady_clock::now();
+  const std::chrono::duration<double> time_limit(_timeout);
+
+  auto first = stateSpace->createState();
+  auto last = stateSpace->createState();
+
+  while (empty_steps <= maxEmptySteps
+         && (_maxAttempts == 0 || attempts < _maxAttempts)
+         && std::chrono::steady_clock::now() - time_before <= time_limit)
+  {
+    // The attempts of a round are split evenly between the workers. The last
+    // round of a budget only makes the attempts left, so the result does not
+    // depend on the timing of the threads.
+    std::size_t numAttempts = numWorkers * SHORTCUT_ATTEMPTS_PER_ROUND;
+    if (_maxAttempts != 0)
+      numAttempts = std::min(numAttempts, _maxAttempts - attempts);
+    for (std::size_t i = 0; i < numWorkers; ++i)
+    {
+      workers[i].mNumAttempts
+          = numAttempts / numWorkers + (i < numAttempts % numWorkers ? 1 : 0);
+    }
+
+    pool.run();
+    if (exception)
+      std::rethrow_exception(exception);
+
+    attempts += numAttempts;
+
+    // Accept shortcuts by decreasing improvement, skipping those that overlap
+    // an accepted shortcut. Ties are broken by worker and attempt order for
+    // determinism.
+    std::vector<const Shortcut*> candidates;
+    for (const auto& worker : workers)
+    {
+      for (const auto& shortcut : worker.mShortcuts)
+        candidates.push_back(&shortcut);
+    }
+    std::stable_sort(
+        candidates.begin(),
+        candidates.end(),
+        [](const Shortcut* _lhs, const Shortcut* _rhs) {
+          return _lhs->mImprovement > _rhs->mImprovement;
+        });
+
+    std::vector<const Shortcut*> accepted;
+    for (const auto* candidate : candidates)
+    {
+      const bool overlaps = std::any_of(
+          accepted.begin(), accepted.end(), [&](const Shortcut* _other) {
+            return candidate->mFirstSegment <= _other->mLastSegment
+                   && _other->mFirstSegment <= candidate->mLastSegment;
+          });
+      if (!overlaps)
+        accepted.push_back(candidate);
+    }
+
+    if (accepted.empty())
+    {
+      empty_steps += numAttempts;
+      continue;
+    }
+    empty_steps = 0;
+    shorten_success = true;
+
+    // Replace the segments of each accepted shortcut with the shortcut.
+    std::sort(
+        accepted.begin(),
+        accepted.end(),
+        [](const Shortcut* _lhs, const Shortcut* _rhs) {
+          return _lhs->mFirstSegment < _rhs->mFirstSegment;
+        });
+
+    auto shortenedPath = dart::common::make_unique<trajectory::Interpolated>(
+        _stateSpace, _interpolator);
+    const auto addWaypoint = [&](const statespace::StateSpace::State* _state) {
+      shortenedPath->addWaypoint(shortenedPath->getNumWaypoints(), _state);
+    };
+
+    std::size_t next = 0;
+    for (const auto* shortcut : accepted)
+    {
+      for (; next <= shortcut->mFirstSegment; ++next)
+        addWaypoint(path->getWaypoint(next));
+      interpolateAt(shortcut->mFirstArcLength, shortcut->mFirstSegment, first);
+      interpolateAt(shortcut->mLastArcLength, shortcut->mLastSegment, last);
+      addWaypoint(first);
+      addWaypoint(last);
+      next = shortcut->mLastSegment + 1;
+    }
+    for (; next < path->getNumWaypoints(); ++next)
+      addWaypoint(path->getWaypoint(next));
+
+    path = std::move(shortenedPath);
+    computeArcLengths();
+  }
+
+  return std::make_pair(std::move(path), shorten_success);
+}
+
 //==============================================================================
 
 // Following are helper functions.
@@ -463,12 +1215,12 @@ std::pair<std::unique_ptr<trajectory::Interpolated>, bool> simplifyOMPL(
 
   ::ompl::geometric::PathGeometric returnPath{std::move(_si)};
 
+  // The path takes ownership of the states, so that each waypoint is copied
+  // once instead of being cloned again by PathGeometric::append().
+  auto& states = returnPath.getStates();
+  states.reserve(_interpolatedTraj->getNumWaypoints());
   for (std::size_t idx = 0; idx < _interpolatedTraj->getNumWaypoints(); ++idx)
-  {
-    auto ompl_state = sspace->allocState(_interpolatedTraj->getWaypoint(idx));
-    returnPath.append(ompl_state);
-    sspace->freeState(ompl_state);
-  }
+    states.push_back(sspace->allocState(_interpolatedTraj->getWaypoint(idx)));
   return returnPath;
 }
 
@@ -479,6 +1231,11 @@ std::unique_ptr<trajectory::Interpolated> toInterpolatedTrajectory(
   auto returnInterpolated = dart::common::make_unique<trajectory::Interpolated>(
       _interpolator->getStateSpace(), std::move(_interpolator));
 
+  // Arbitrary timing
+  std::vector<double> times;
+  std::vector<const statespace::StateSpace::State*> states;
+  times.reserve(_path.getStateCount());
+  states.reserve(_path.getStateCount());
   for (std::size_t idx = 0; idx < _path.getStateCount(); ++idx)
   {
     // Note that following static_cast is guaranteed to be safe because
@@ -487,11 +1244,44 @@ std::unique_ptr<trajectory::Interpolated> toInterpolatedTrajectory(
     const auto* st = static_cast<const GeometricStateSpace::StateType*>(
         _path.getState(idx));
 
-    // Arbitrary timing
-    returnInterpolated->addWaypoint(idx, st->mState);
+    times.push_back(idx);
+    states.push_back(st->mState);
   }
+  returnInterpolated->addWaypoints(times, states);
   return returnInterpolated;
 }
+
+//==============================================================================
+std::unique_ptr<trajectory::Interpolated> toInterpolatedTrajectory(
+    ::ompl::geometric::PathGeometric&& _path,
+    statespace::InterpolatorPtr _interpolator)
+{
+  // Only states of the StateSpace of the trajectory can be taken over.
+  const auto sspace = ompl_dynamic_pointer_cast<GeometricStateSpace>(
+      _path.getSpaceInformation()->getStateSpace());
+  if (!sspace
+      || sspace->getAikidoStateSpace() != _interpolator->getStateSpace())
+  {
+    const ::ompl::geometric::PathGeometric& path = _path;
+    return toInterpolatedTrajectory(path, std::move(_interpolator));
+  }
+
+  auto returnInterpolated = dart::common::make_unique<trajectory::Interpolated>(
+      _interpolator->getStateSpace(), std::move(_interpolator));
+
+  // Arbitrary timing. The aikido states are allocated by the aikido
+  // StateSpace, so the trajectory can take them over from the OMPL states,
+  // which are then freed without them.
+  for (std::size_t idx = 0; idx < _path.getStateCount(); ++idx)
+  {
+    auto* st
+        = static_cast<GeometricStateSpace::StateType*>(_path.getState(idx));
+    returnInterpolated->adoptWaypoint(idx, st->mState);
+    st->mState = nullptr;
+  }
+  return returnInterpolated;
+}
+
 //==============================================================================
 
 } // ns ompl
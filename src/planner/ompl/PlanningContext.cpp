@@ -0,0 +1,212 @@
+#include <aikido/planner/ompl/PlanningContext.hpp>
+
+#include <ompl/geometric/PathGeometric.h>
+#include <aikido/planner/ompl/GoalRegion.hpp>
+#include <aikido/planner/ompl/MotionValidator.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+namespace {
+
+/// Maximum number of segments whose validity is cached between two queries.
+constexpr std::size_t kEdgeCacheSize = 4096;
+
+} // namespace
+
+//==============================================================================
+PlanningContext::PlanningContext(
+    statespace::StateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator,
+    distance::DistanceMetricPtr _dmetric,
+    constraint::SampleablePtr _sampler,
+    constraint::TestablePtr _validityConstraint,
+    constraint::TestablePtr _boundsConstraint,
+    constraint::ProjectablePtr _boundsProjector,
+    double _maxDistanceBtwValidityChecks)
+  : mStateSpace(_stateSpace), mInterpolator(_interpolator)
+{
+  mSpaceInformation = ompl::getSpaceInformation(
+      std::move(_stateSpace),
+      std::move(_interpolator),
+      std::move(_dmetric),
+      std::move(_sampler),
+      std::move(_validityConstraint),
+      std::move(_boundsConstraint),
+      std::move(_boundsProjector),
+      _maxDistanceBtwValidityChecks);
+  mSpaceInformation->setup();
+
+  // The cache is cleared on every query, so that it never outlives a change
+  // of the constraints.
+  auto motionValidator = ompl_dynamic_pointer_cast<MotionValidator>(
+      mSpaceInformation->getMotionValidator());
+  if (motionValidator)
+    motionValidator->setEdgeCacheSize(kEdgeCacheSize);
+
+  mGeometricStateSpace = ompl_static_pointer_cast<GeometricStateSpace>(
+      mSpaceInformation->getStateSpace());
+  mProblemDefinition
+      = ompl_make_shared<::ompl::base::ProblemDefinition>(mSpaceInformation);
+}
+
+//==============================================================================
+::ompl::base::SpaceInformationPtr PlanningContext::getSpaceInformation() const
+{
+  return mSpaceInformation;
+}
+
+//==============================================================================
+void PlanningContext::setPlanner(::ompl::base::PlannerPtr _planner)
+{
+  if (!_planner)
+  {
+    throw std::invalid_argument("Planner is nullptr.");
+  }
+
+  if (_planner->getSpaceInformation() != mSpaceInformation)
+  {
+    throw std::invalid_argument(
+        "Planner does not use the SpaceInformation of the PlanningContext.");
+  }
+
+  mPlanner = std::move(_planner);
+  mPlanner->setProblemDefinition(mProblemDefinition);
+}
+
+//==============================================================================
+::ompl::base::PlannerPtr PlanningContext::getPlanner() const
+{
+  return mPlanner;
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr PlanningContext::plan(
+    const statespace::StateSpace::State* _start,
+    const statespace::StateSpace::State* _goal,
+    double _maxPlanTime)
+{
+  resetProblem();
+
+  // ProblemDefinition clones states and keeps them internally
+  auto start = mGeometricStateSpace->allocState(_start);
+  auto goal = mGeometricStateSpace->allocState(_goal);
+  mProblemDefinition->setStartAndGoalStates(start, goal);
+  mGeometricStateSpace->freeState(start);
+  mGeometricStateSpace->freeState(goal);
+
+  return solve(_maxPlanTime);
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr PlanningContext::plan(
+    const statespace::StateSpace::State* _start,
+    constraint::TestablePtr _goalTestable,
+    constraint::SampleablePtr _goalSampler,
+    double _maxPlanTime)
+{
+  if (_goalTestable == nullptr)
+  {
+    throw std::invalid_argument("Testable goal is nullptr.");
+  }
+
+  if (_goalSampler == nullptr)
+  {
+    throw std::invalid_argument("Sampleable goal is nullptr.");
+  }
+
+  if (_goalTestable->getStateSpace() != mStateSpace)
+  {
+    throw std::invalid_argument("Testable goal does not match StateSpace");
+  }
+
+  if (_goalSampler->getStateSpace() != mStateSpace)
+  {
+    throw std::invalid_argument("Sampleable goal does not match StateSpace");
+  }
+
+  resetProblem();
+
+  auto start = mGeometricStateSpace->allocState(_start);
+  mProblemDefinition->addStartState(start); // copies
+  mGeometricStateSpace->freeState(start);
+
+  mProblemDefinition->setGoal(
+      ompl_make_shared<GoalRegion>(
+          mSpaceInformation,
+          std::move(_goalTestable),
+          _goalSampler->createSampleGenerator()));
+
+  return solve(_maxPlanTime);
+}
+
+//==============================================================================
+std::pair<std::unique_ptr<trajectory::Interpolated>, bool>
+PlanningContext::simplify(
+    double _timeout,
+    std::size_t _maxEmptySteps,
+    trajectory::InterpolatedPtr _originalTraj)
+{
+  clearEdgeCache();
+  return simplifyOMPL(
+      mSpaceInformation,
+      mInterpolator,
+      _timeout,
+      _maxEmptySteps,
+      std::move(_originalTraj));
+}
+
+//==============================================================================
+void PlanningContext::resetProblem()
+{
+  if (!mPlanner)
+  {
+    throw std::runtime_error("PlanningContext has no planner.");
+  }
+
+  mProblemDefinition->clearStartStates();
+  mProblemDefinition->clearGoal();
+  mProblemDefinition->clearSolutionPaths();
+
+  // Clearing keeps the data structures of the planner allocated.
+  if (mPlanner->isSetup())
+    mPlanner->clear();
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr PlanningContext::solve(double _maxPlanTime)
+{
+  clearEdgeCache();
+
+  if (!mPlanner->isSetup())
+    mPlanner->setup();
+
+  if (!mPlanner->solve(_maxPlanTime))
+    return nullptr;
+
+  auto path = ompl_dynamic_pointer_cast<::ompl::geometric::PathGeometric>(
+      mProblemDefinition->getSolutionPath());
+  if (!path)
+  {
+    throw std::invalid_argument(
+        "Path is not of type PathGeometric. Cannot convert to aikido "
+        "Trajectory");
+  }
+
+  return toInterpolatedTrajectory(*path, mInterpolator);
+}
+
+//==============================================================================
+void PlanningContext::clearEdgeCache()
+{
+  auto motionValidator = ompl_dynamic_pointer_cast<MotionValidator>(
+      mSpaceInformation->getMotionValidator());
+  if (motionValidator)
+    motionValidator->clearEdgeCache();
+}
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
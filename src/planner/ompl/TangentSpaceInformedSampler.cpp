@@ -0,0 +1,276 @@
+#include <aikido/planner/ompl/TangentSpaceInformedSampler.hpp>
+
+#if OMPL_VERSION_AT_LEAST(1, 2, 0)
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <ompl/base/goals/GoalState.h>
+#include <aikido/distance/CartesianProductWeighted.hpp>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/planner/ompl/GeometricStateSpace.hpp>
+#include <aikido/statespace/CartesianProduct.hpp>
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+
+namespace {
+
+//==============================================================================
+/// Appends the scale of every tangent coordinate of the space of _metric to
+/// _weights, such that the distance between two states is at least the
+/// weighted norm of the tangent vector between them. Returns false if the
+/// metric is not supported.
+///
+/// Only Euclidean metrics are supported. On SO2 and SO3, a state can be
+/// closer through wrap-around or curvature than its tangent vector at the
+/// start suggests, so the hyperspheroid would miss part of the informed set.
+bool appendTangentWeights(
+    const distance::DistanceMetric& _metric,
+    double _scale,
+    std::vector<double>& _weights)
+{
+  const auto& space = *_metric.getStateSpace();
+
+  if (dynamic_cast<const distance::R0Euclidean*>(&_metric)
+      || dynamic_cast<const distance::R1Euclidean*>(&_metric)
+      || dynamic_cast<const distance::R2Euclidean*>(&_metric)
+      || dynamic_cast<const distance::R3Euclidean*>(&_metric)
+      || dynamic_cast<const distance::R6Euclidean*>(&_metric)
+      || dynamic_cast<const distance::RnEuclidean*>(&_metric))
+  {
+    _weights.insert(_weights.end(), space.getDimension(), _scale);
+    return true;
+  }
+
+  // A weighted sum of distances is at least the norm of the weighted
+  // distances, so the tangent coordinates of a subspace are scaled by its
+  // weight.
+  if (const auto metric
+      = dynamic_cast<const distance::CartesianProductWeighted*>(&_metric))
+  {
+    for (const auto& subspaceMetric : metric->getMetrics())
+    {
+      if (!appendTangentWeights(
+              *subspaceMetric.first, _scale * subspaceMetric.second, _weights))
+        return false;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+} // namespace
+
+//==============================================================================
+TangentSpaceInformedSampler::TangentSpaceInformedSampler(
+    const ::ompl::base::ProblemDefinitionPtr& _problem,
+    unsigned int _maxNumberCalls)
+  : ::ompl::base::InformedSampler(_problem, _maxNumberCalls)
+  , mSpaceInformation(_problem->getSpaceInformation())
+  , mObjective(_problem->getOptimizationObjective())
+  , mUniformSampler(mSpaceInformation->allocStateSampler())
+  , mStart(nullptr)
+  , mGoal(nullptr)
+  , mIsInformed(false)
+  , mTangentState(nullptr)
+{
+  const auto space = ompl_dynamic_pointer_cast<GeometricStateSpace>(
+      mSpaceInformation->getStateSpace());
+  if (!space)
+  {
+    throw std::invalid_argument(
+        "TangentSpaceInformedSampler requires a GeometricStateSpace.");
+  }
+
+  mStateSpace = space->getAikidoStateSpace();
+  mTangentState = mStateSpace->allocateState();
+
+  const auto goal
+      = dynamic_cast<const ::ompl::base::GoalState*>(_problem->getGoal().get());
+  if (_problem->getStartStateCount() != 1 || !goal)
+    return;
+
+  std::vector<double> weights;
+  if (!appendTangentWeights(*space->getDistanceMetric(), 1., weights))
+    return;
+
+  // Coordinates with no weight are not bounded by the cost.
+  mWeights = Eigen::Map<Eigen::VectorXd>(weights.data(), weights.size());
+  if (mWeights.size() == 0 || (mWeights.array() <= 0.).any())
+    return;
+
+  mStart = mSpaceInformation->cloneState(_problem->getStartState(0));
+  mGoal = mSpaceInformation->cloneState(goal->getState());
+
+  // Tangent vector from the start to the goal.
+  const auto start = mStart->as<GeometricStateSpace::StateType>()->mState;
+  const auto goalState = mGoal->as<GeometricStateSpace::StateType>()->mState;
+  mStateSpace->getInverse(start, mTangentState);
+  mStateSpace->compose(mTangentState, goalState);
+  Eigen::VectorXd tangent;
+  mStateSpace->logMap(mTangentState, tangent);
+  mGoalTangent = mWeights.cwiseProduct(tangent);
+
+  // Householder reflection that maps the first axis onto the axis through
+  // the foci. The hyperspheroid is symmetric, so a reflection is as good as
+  // a rotation.
+  const auto dimension = mWeights.size();
+  mRotation = Eigen::MatrixXd::Identity(dimension, dimension);
+  const double focalDistance = mGoalTangent.norm();
+  if (focalDistance > 0.)
+  {
+    Eigen::VectorXd axis = -mGoalTangent / focalDistance;
+    axis[0] += 1.;
+    const double axisNorm = axis.squaredNorm();
+    if (axisNorm > 1e-12)
+      mRotation -= 2. * axis * axis.transpose() / axisNorm;
+  }
+
+  mIsInformed = true;
+}
+
+//==============================================================================
+TangentSpaceInformedSampler::~TangentSpaceInformedSampler()
+{
+  if (mStart)
+    mSpaceInformation->freeState(mStart);
+  if (mGoal)
+    mSpaceInformation->freeState(mGoal);
+  if (mTangentState)
+    mStateSpace->freeState(mTangentState);
+}
+
+//==============================================================================
+bool TangentSpaceInformedSampler::sampleUniform(
+    ::ompl::base::State* _state, const ::ompl::base::Cost& _maxCost)
+{
+  if (mIsInformed && std::isfinite(_maxCost.value()))
+    return sampleInformed(_state, _maxCost.value());
+
+  for (unsigned int i = 0; i < getMaxNumberOfIters(); ++i)
+  {
+    mUniformSampler->sampleUniform(_state);
+    if (!_state->as<GeometricStateSpace::StateType>()->mValid)
+      continue;
+
+    if (!std::isfinite(_maxCost.value())
+        || mObjective->isCostBetterThan(heuristicSolnCost(_state), _maxCost))
+      return true;
+  }
+  return false;
+}
+
+//==============================================================================
+bool TangentSpaceInformedSampler::sampleUniform(
+    ::ompl::base::State* _state,
+    const ::ompl::base::Cost& _minCost,
+    const ::ompl::base::Cost& _maxCost)
+{
+  for (unsigned int i = 0; i < getMaxNumberOfIters(); ++i)
+  {
+    if (!sampleUniform(_state, _maxCost))
+      continue;
+
+    const auto cost = mIsInformed ? computeHeuristicCost(_state)
+                                  : heuristicSolnCost(_state);
+    if (!mObjective->isCostBetterThan(cost, _minCost))
+      return true;
+  }
+  return false;
+}
+
+//==============================================================================
+bool TangentSpaceInformedSampler::hasInformedMeasure() const
+{
+  return mIsInformed;
+}
+
+//==============================================================================
+double TangentSpaceInformedSampler::getInformedMeasure(
+    const ::ompl::base::Cost& _currentCost) const
+{
+  const double spaceMeasure = mSpaceInformation->getSpaceMeasure();
+  const double maxCost = _currentCost.value();
+  if (!mIsInformed || !std::isfinite(maxCost))
+    return spaceMeasure;
+
+  const double focalDistance = mGoalTangent.norm();
+  if (maxCost <= focalDistance)
+    return 0.;
+
+  // Volume of the unit ball scaled by the semi-axes of the hyperspheroid,
+  // then mapped back to unweighted tangent coordinates.
+  const double dimension = mWeights.size();
+  const double unitBallMeasure = std::pow(M_PI, dimension / 2.)
+                                 / std::tgamma(dimension / 2. + 1.);
+  const double conjugateRadius
+      = std::sqrt(maxCost * maxCost - focalDistance * focalDistance) / 2.;
+  const double measure = unitBallMeasure * maxCost / 2.
+                         * std::pow(conjugateRadius, dimension - 1.)
+                         / mWeights.prod();
+  return std::min(measure, spaceMeasure);
+}
+
+//==============================================================================
+::ompl::base::Cost TangentSpaceInformedSampler::computeHeuristicCost(
+    const ::ompl::base::State* _state) const
+{
+  return mObjective->combineCosts(
+      mObjective->motionCostHeuristic(mStart, _state),
+      mObjective->motionCostHeuristic(_state, mGoal));
+}
+
+//==============================================================================
+bool TangentSpaceInformedSampler::sampleInformed(
+    ::ompl::base::State* _state, double _maxCost)
+{
+  const double focalDistance = mGoalTangent.norm();
+  if (_maxCost <= focalDistance)
+    return false;
+
+  const auto dimension = mWeights.size();
+  const double transverseRadius = _maxCost / 2.;
+  const double conjugateRadius
+      = std::sqrt(_maxCost * _maxCost - focalDistance * focalDistance) / 2.;
+
+  const auto start = mStart->as<GeometricStateSpace::StateType>()->mState;
+  auto state = _state->as<GeometricStateSpace::StateType>();
+  const ::ompl::base::Cost maxCost(_maxCost);
+
+  Eigen::VectorXd ball(dimension);
+  for (unsigned int i = 0; i < getMaxNumberOfIters(); ++i)
+  {
+    // Uniform sample in the unit ball.
+    for (Eigen::Index j = 0; j < dimension; ++j)
+      ball[j] = mRng.gaussian01();
+    const double norm = ball.norm();
+    if (norm == 0.)
+      continue;
+    ball *= std::pow(mRng.uniform01(), 1. / dimension) / norm;
+
+    // Stretch it into the hyperspheroid, whose foci are the origin and
+    // mGoalTangent, then map it to a state.
+    ball[0] *= transverseRadius;
+    ball.tail(dimension - 1) *= conjugateRadius;
+    const Eigen::VectorXd tangent
+        = (mRotation * ball + mGoalTangent / 2.).cwiseQuotient(mWeights);
+
+    mStateSpace->expMap(tangent, mTangentState);
+    mStateSpace->compose(start, mTangentState, state->mState);
+    state->mValid = true;
+
+    if (mSpaceInformation->satisfiesBounds(_state)
+        && mObjective->isCostBetterThan(computeHeuristicCost(_state), maxCost))
+      return true;
+  }
+  return false;
+}
+
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#endif // OMPL_VERSION_AT_LEAST(1, 2, 0)
@@ -0,0 +1,94 @@
+#include "StateSpaceConversion.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+#include <vector>
+#include <aikido/statespace/CartesianProduct.hpp>
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+namespace detail {
+
+//==============================================================================
+void checkConvertible(
+    const statespace::StateSpace& _from, const statespace::StateSpace& _to)
+{
+  if (&_from == &_to)
+    return;
+
+  if (_from.getDimension() != _to.getDimension()
+      || _from.getStateSizeInBytes() != _to.getStateSizeInBytes())
+  {
+    std::stringstream msg;
+    msg << "StateSpaces have different structures: dimension "
+        << _from.getDimension() << " and " << _to.getDimension()
+        << ", state size " << _from.getStateSizeInBytes() << " and "
+        << _to.getStateSizeInBytes() << " bytes.";
+    throw std::invalid_argument(msg.str());
+  }
+
+  const auto from = dynamic_cast<const statespace::CartesianProduct*>(&_from);
+  const auto to = dynamic_cast<const statespace::CartesianProduct*>(&_to);
+  if (!from && !to)
+  {
+    if (typeid(_from) != typeid(_to))
+    {
+      throw std::invalid_argument("StateSpaces are of different types.");
+    }
+    return;
+  }
+
+  if (!from || !to || from->getNumSubspaces() != to->getNumSubspaces())
+  {
+    throw std::invalid_argument(
+        "StateSpaces have different numbers of subspaces.");
+  }
+
+  for (std::size_t i = 0; i < from->getNumSubspaces(); ++i)
+    checkConvertible(*from->getSubspace<>(i), *to->getSubspace<>(i));
+}
+
+//==============================================================================
+void convertState(
+    const statespace::StateSpace& _from,
+    const statespace::StateSpace::State* _in,
+    const statespace::StateSpace& _to,
+    statespace::StateSpace::State* _out)
+{
+  if (&_from == &_to)
+  {
+    _to.copyState(_in, _out);
+    return;
+  }
+
+  Eigen::VectorXd tangent;
+  _from.logMap(_in, tangent);
+  _to.expMap(tangent, _out);
+}
+
+//==============================================================================
+trajectory::InterpolatedPtr convertTrajectory(
+    const trajectory::Interpolated& _trajectory,
+    statespace::StateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator)
+{
+  const auto& from = *_trajectory.getStateSpace();
+  checkConvertible(from, *_stateSpace);
+
+  auto converted = std::make_shared<trajectory::Interpolated>(
+      _stateSpace, std::move(_interpolator));
+  for (std::size_t i = 0; i < _trajectory.getNumWaypoints(); ++i)
+  {
+    auto state = _stateSpace->allocateState();
+    convertState(from, _trajectory.getWaypoint(i), *_stateSpace, state);
+    converted->adoptWaypoint(_trajectory.getWaypointTime(i), state);
+  }
+  return converted;
+}
+
+} // namespace detail
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
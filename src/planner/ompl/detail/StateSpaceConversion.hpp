@@ -0,0 +1,55 @@
+#ifndef AIKIDO_PLANNER_OMPL_DETAIL_STATESPACECONVERSION_HPP_
+#define AIKIDO_PLANNER_OMPL_DETAIL_STATESPACECONVERSION_HPP_
+
+#include <aikido/statespace/Interpolator.hpp>
+#include <aikido/statespace/StateSpace.hpp>
+#include <aikido/trajectory/Interpolated.hpp>
+
+namespace aikido {
+namespace planner {
+namespace ompl {
+namespace detail {
+
+/// Checks that states of one StateSpace can be converted into another, i.e.
+/// that both StateSpaces have the same structure. This is the case for two
+/// MetaSkeletonStateSpaces of clones of the same skeleton.
+///
+/// \param _from StateSpace of the converted states
+/// \param _to StateSpace that the states are converted into
+/// \throw std::invalid_argument if the StateSpaces have different structures.
+void checkConvertible(
+    const statespace::StateSpace& _from, const statespace::StateSpace& _to);
+
+/// Converts a state into a StateSpace of the same structure through the
+/// tangent space, i.e. logMap() of \c _from followed by expMap() of \c _to.
+/// The state is copied if both StateSpaces are the same.
+///
+/// \param _from StateSpace of \c _in
+/// \param _in State to convert
+/// \param _to StateSpace of \c _out, checked with checkConvertible()
+/// \param[out] _out Converted state
+void convertState(
+    const statespace::StateSpace& _from,
+    const statespace::StateSpace::State* _in,
+    const statespace::StateSpace& _to,
+    statespace::StateSpace::State* _out);
+
+/// Converts the waypoints of a trajectory into a StateSpace of the same
+/// structure, keeping the waypoint times.
+///
+/// \param _trajectory Trajectory to convert
+/// \param _stateSpace StateSpace of the returned trajectory, checked with
+/// checkConvertible()
+/// \param _interpolator Interpolator of the returned trajectory
+/// \return Trajectory with the converted waypoints
+trajectory::InterpolatedPtr convertTrajectory(
+    const trajectory::Interpolated& _trajectory,
+    statespace::StateSpacePtr _stateSpace,
+    statespace::InterpolatorPtr _interpolator);
+
+} // namespace detail
+} // namespace ompl
+} // namespace planner
+} // namespace aikido
+
+#endif // AIKIDO_PLANNER_OMPL_DETAIL_STATESPACECONVERSION_HPP_
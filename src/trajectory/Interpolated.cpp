@@ -1,5 +1,7 @@
 #include <aikido/trajectory/Interpolated.hpp>
 
+#include <sstream>
+
 using aikido::statespace::GeodesicInterpolator;
 
 namespace aikido {
@@ -147,10 +149,48 @@ void Interpolated::addWaypoint(double _t, const State* _state)
 {
   State* state = mStateSpace->allocateState();
   mStateSpace->copyState(_state, state);
+  insertWaypoint(_t, state);
+}
 
-  // Maintain a sorted list of waypoints
-  auto it = std::lower_bound(mWaypoints.begin(), mWaypoints.end(), _t);
-  mWaypoints.insert(it, Waypoint(_t, state));
+//==============================================================================
+void Interpolated::addWaypoints(
+    const std::vector<double>& _times, const std::vector<const State*>& _states)
+{
+  if (_times.size() != _states.size())
+  {
+    std::stringstream msg;
+    msg << "Number of times (" << _times.size()
+        << ") does not match number of states (" << _states.size() << ").";
+    throw std::invalid_argument(msg.str());
+  }
+
+  for (std::size_t i = 0; i < _times.size(); ++i)
+  {
+    const bool isAfterPrevious
+        = i > 0 ? _times[i - 1] < _times[i]
+                : mWaypoints.empty() || mWaypoints.back().t < _times[i];
+    if (!isAfterPrevious)
+    {
+      std::stringstream msg;
+      msg << "Time " << _times[i] << " of waypoint " << i
+          << " is not after the previous waypoint.";
+      throw std::invalid_argument(msg.str());
+    }
+  }
+
+  mWaypoints.reserve(mWaypoints.size() + _states.size());
+  for (std::size_t i = 0; i < _states.size(); ++i)
+  {
+    State* state = mStateSpace->allocateState();
+    mStateSpace->copyState(_states[i], state);
+    mWaypoints.emplace_back(_times[i], state);
+  }
+}
+
+//==============================================================================
+void Interpolated::adoptWaypoint(double _t, State* _state)
+{
+  insertWaypoint(_t, _state);
 }
 
 //==============================================================================
@@ -191,6 +231,21 @@ int Interpolated::getWaypointIndexAfterTime(double _t) const
   return std::distance(mWaypoints.begin(), it);
 }
 
+//==============================================================================
+void Interpolated::insertWaypoint(double _t, State* _state)
+{
+  // Waypoints are usually added in order, which needs no search.
+  if (mWaypoints.empty() || mWaypoints.back().t < _t)
+  {
+    mWaypoints.emplace_back(_t, _state);
+    return;
+  }
+
+  // Maintain a sorted list of waypoints
+  auto it = std::lower_bound(mWaypoints.begin(), mWaypoints.end(), _t);
+  mWaypoints.insert(it, Waypoint(_t, _state));
+}
+
 //==============================================================================
 Interpolated::Waypoint::Waypoint(
     double _t, aikido::statespace::StateSpace::State* _state)
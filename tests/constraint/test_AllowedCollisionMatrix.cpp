@@ -0,0 +1,254 @@
+#include <sstream>
+#include <dart/dart.hpp>
+#include <gtest/gtest.h>
+#include <aikido/constraint/AllowedCollisionMatrix.hpp>
+#include <aikido/constraint/CollisionFree.hpp>
+#include <aikido/constraint/JointStateSpaceHelpers.hpp>
+#include <aikido/common/RNG.hpp>
+
+using aikido::constraint::AllowedCollisionMatrix;
+using aikido::constraint::CollisionFree;
+using aikido::constraint::CollisionPairType;
+using aikido::constraint::computeAllowedCollisionMatrix;
+using aikido::constraint::createSampleableBounds;
+using aikido::common::RNGWrapper;
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+using aikido::statespace::dart::MetaSkeletonStateSpacePtr;
+
+using namespace dart::dynamics;
+using namespace dart::collision;
+
+//==============================================================================
+TEST(AllowedCollisionMatrix, SetAndGetPairType)
+{
+  AllowedCollisionMatrix matrix;
+  EXPECT_EQ(0u, matrix.getNumPairs());
+  EXPECT_EQ(CollisionPairType::SOMETIMES, matrix.getPairType("a", "b"));
+  EXPECT_TRUE(matrix.needsCheck("a", "b"));
+
+  matrix.setPairType("b", "a", CollisionPairType::NEVER);
+  matrix.setPairType("a", "c", CollisionPairType::ADJACENT);
+  matrix.setPairType("b", "c", CollisionPairType::SOMETIMES);
+
+  EXPECT_EQ(3u, matrix.getNumPairs());
+  EXPECT_EQ(CollisionPairType::NEVER, matrix.getPairType("a", "b"));
+  EXPECT_EQ(CollisionPairType::NEVER, matrix.getPairType("b", "a"));
+  EXPECT_EQ(CollisionPairType::ADJACENT, matrix.getPairType("c", "a"));
+  EXPECT_FALSE(matrix.needsCheck("a", "b"));
+  EXPECT_FALSE(matrix.needsCheck("a", "c"));
+  EXPECT_TRUE(matrix.needsCheck("c", "b"));
+
+  matrix.setPairType("a", "b", CollisionPairType::ALWAYS);
+  EXPECT_EQ(3u, matrix.getNumPairs());
+  EXPECT_EQ(CollisionPairType::ALWAYS, matrix.getPairType("a", "b"));
+
+  const auto always = matrix.getPairs(CollisionPairType::ALWAYS);
+  ASSERT_EQ(1u, always.size());
+  EXPECT_EQ("a", always[0].first);
+  EXPECT_EQ("b", always[0].second);
+}
+
+//==============================================================================
+TEST(AllowedCollisionMatrix, SetPairTypeThrowsOnSameBodyNode)
+{
+  AllowedCollisionMatrix matrix;
+  EXPECT_THROW(
+      matrix.setPairType("a", "a", CollisionPairType::NEVER),
+      std::invalid_argument);
+}
+
+//==============================================================================
+TEST(AllowedCollisionMatrix, BinaryRoundTrip)
+{
+  AllowedCollisionMatrix matrix;
+  matrix.setPairType("link1", "link2", CollisionPairType::ADJACENT);
+  matrix.setPairType("link1", "link3", CollisionPairType::NEVER);
+  matrix.setPairType("link2", "link3", CollisionPairType::SOMETIMES);
+  matrix.setPairType("link3", "link4", CollisionPairType::ALWAYS);
+
+  std::stringstream stream;
+  matrix.saveBinary(stream);
+
+  const auto loaded = AllowedCollisionMatrix::loadBinary(stream);
+  EXPECT_EQ(4u, loaded.getNumPairs());
+  EXPECT_EQ(CollisionPairType::ADJACENT, loaded.getPairType("link2", "link1"));
+  EXPECT_EQ(CollisionPairType::NEVER, loaded.getPairType("link1", "link3"));
+  EXPECT_EQ(CollisionPairType::SOMETIMES, loaded.getPairType("link2", "link3"));
+  EXPECT_EQ(CollisionPairType::ALWAYS, loaded.getPairType("link3", "link4"));
+}
+
+//==============================================================================
+TEST(AllowedCollisionMatrix, LoadBinaryThrowsOnInvalidData)
+{
+  std::stringstream empty;
+  EXPECT_THROW(AllowedCollisionMatrix::loadBinary(empty), std::runtime_error);
+
+  std::stringstream garbage("this is not a matrix");
+  EXPECT_THROW(
+      AllowedCollisionMatrix::loadBinary(garbage), std::runtime_error);
+
+  AllowedCollisionMatrix matrix;
+  matrix.setPairType("link1", "link2", CollisionPairType::NEVER);
+  std::stringstream stream;
+  matrix.saveBinary(stream);
+
+  std::string truncated = stream.str();
+  truncated.resize(truncated.size() - 3);
+  std::stringstream truncatedStream(truncated);
+  EXPECT_THROW(
+      AllowedCollisionMatrix::loadBinary(truncatedStream), std::runtime_error);
+}
+
+//==============================================================================
+class ComputeAllowedCollisionMatrixTest : public ::testing::Test
+{
+protected:
+  static BodyNode* createBox(
+      const SkeletonPtr& _skeleton,
+      const std::string& _name,
+      const Eigen::Vector3d& _translation)
+  {
+    WeldJoint::Properties properties;
+    properties.mName = _name + "_joint";
+    properties.mT_ParentBodyToJoint.translation() = _translation;
+
+    auto bodyNode
+        = _skeleton
+              ->createJointAndBodyNodePair<WeldJoint>(nullptr, properties)
+              .second;
+    bodyNode->setName(_name);
+    bodyNode->createShapeNodeWith<CollisionAspect>(
+        std::make_shared<BoxShape>(Eigen::Vector3d::Ones()));
+    return bodyNode;
+  }
+
+  void SetUp() override
+  {
+    mSkeleton = Skeleton::create("Robot");
+
+    // Two overlapping boxes that always collide.
+    createBox(mSkeleton, "base", Eigen::Vector3d::Zero());
+    createBox(mSkeleton, "overlap", Eigen::Vector3d(0.5, 0., 0.));
+
+    // A box that never collides with anything.
+    createBox(mSkeleton, "far", Eigen::Vector3d(100., 0., 0.));
+
+    // A box sliding along the x-axis that sometimes collides with the boxes
+    // above, with a box rigidly attached to it.
+    PrismaticJoint::Properties sliderProperties;
+    sliderProperties.mName = "slider_joint";
+    sliderProperties.mAxis = Eigen::Vector3d::UnitX();
+    auto slider = mSkeleton
+                      ->createJointAndBodyNodePair<PrismaticJoint>(
+                          nullptr, sliderProperties)
+                      .second;
+    slider->setName("slider");
+    slider->createShapeNodeWith<CollisionAspect>(
+        std::make_shared<BoxShape>(Eigen::Vector3d::Ones()));
+    slider->getParentJoint()->setPositionLowerLimit(0, -5.);
+    slider->getParentJoint()->setPositionUpperLimit(0, 5.);
+
+    WeldJoint::Properties attachedProperties;
+    attachedProperties.mName = "attached_joint";
+    attachedProperties.mT_ParentBodyToJoint.translation()
+        = Eigen::Vector3d(0., 0., 10.);
+    auto attached = slider
+                        ->createChildJointAndBodyNodePair<WeldJoint>(
+                            attachedProperties)
+                        .second;
+    attached->setName("attached");
+    attached->createShapeNodeWith<CollisionAspect>(
+        std::make_shared<BoxShape>(Eigen::Vector3d::Ones()));
+
+    mStateSpace = std::make_shared<MetaSkeletonStateSpace>(mSkeleton);
+    mCollisionDetector = FCLCollisionDetector::create();
+  }
+
+  AllowedCollisionMatrix computeMatrix(std::size_t _numSamples)
+  {
+    auto sampleable = createSampleableBounds(
+        mStateSpace, dart::common::make_unique<RNGWrapper<std::mt19937>>(0));
+    return computeAllowedCollisionMatrix(
+        mStateSpace, mCollisionDetector, *sampleable, _numSamples);
+  }
+
+  SkeletonPtr mSkeleton;
+  MetaSkeletonStateSpacePtr mStateSpace;
+  CollisionDetectorPtr mCollisionDetector;
+};
+
+//==============================================================================
+TEST_F(ComputeAllowedCollisionMatrixTest, ThrowsOnInvalidArguments)
+{
+  auto sampleable = createSampleableBounds(
+      mStateSpace, dart::common::make_unique<RNGWrapper<std::mt19937>>(0));
+
+  EXPECT_THROW(
+      computeAllowedCollisionMatrix(
+          nullptr, mCollisionDetector, *sampleable, 10),
+      std::invalid_argument);
+  EXPECT_THROW(
+      computeAllowedCollisionMatrix(mStateSpace, nullptr, *sampleable, 10),
+      std::invalid_argument);
+  EXPECT_THROW(
+      computeAllowedCollisionMatrix(
+          mStateSpace, mCollisionDetector, *sampleable, 0),
+      std::invalid_argument);
+}
+
+//==============================================================================
+TEST_F(ComputeAllowedCollisionMatrixTest, ClassifiesPairs)
+{
+  const Eigen::VectorXd positions = mSkeleton->getPositions();
+  const auto matrix = computeMatrix(200);
+
+  // Every pair of the 5 body nodes is classified.
+  EXPECT_EQ(10u, matrix.getNumPairs());
+
+  EXPECT_EQ(CollisionPairType::ALWAYS, matrix.getPairType("base", "overlap"));
+  EXPECT_EQ(CollisionPairType::NEVER, matrix.getPairType("base", "far"));
+  EXPECT_EQ(CollisionPairType::NEVER, matrix.getPairType("far", "slider"));
+  EXPECT_EQ(CollisionPairType::NEVER, matrix.getPairType("base", "attached"));
+  EXPECT_EQ(CollisionPairType::SOMETIMES, matrix.getPairType("base", "slider"));
+  EXPECT_EQ(
+      CollisionPairType::SOMETIMES, matrix.getPairType("overlap", "slider"));
+  EXPECT_EQ(
+      CollisionPairType::ADJACENT, matrix.getPairType("slider", "attached"));
+
+  // The positions of the skeleton are restored.
+  EXPECT_TRUE(positions.isApprox(mSkeleton->getPositions()));
+}
+
+//==============================================================================
+TEST_F(ComputeAllowedCollisionMatrixTest, CollisionFreeChecksSometimesPairs)
+{
+  mSkeleton->enableSelfCollisionCheck();
+
+  CollisionFree constraint(mStateSpace, mCollisionDetector);
+  constraint.addSelfCheck(
+      mCollisionDetector->createCollisionGroupAsSharedPtr(mSkeleton.get()));
+
+  auto state = mStateSpace->createState();
+  Eigen::VectorXd positions(1);
+  positions[0] = 4.;
+  mStateSpace->convertPositionsToState(positions, state);
+
+  // "base" and "overlap" always collide.
+  EXPECT_FALSE(constraint.isSatisfied(state));
+
+  auto matrix = std::make_shared<AllowedCollisionMatrix>(computeMatrix(200));
+  constraint.setAllowedCollisionMatrix(matrix);
+  EXPECT_EQ(matrix, constraint.getAllowedCollisionMatrix());
+  EXPECT_TRUE(constraint.isSatisfied(state));
+
+  // "slider" collides with "base".
+  positions[0] = 0.;
+  mStateSpace->convertPositionsToState(positions, state);
+  EXPECT_FALSE(constraint.isSatisfied(state));
+
+  positions[0] = 4.;
+  mStateSpace->convertPositionsToState(positions, state);
+  constraint.setAllowedCollisionMatrix(nullptr);
+  EXPECT_EQ(nullptr, constraint.getAllowedCollisionMatrix());
+  EXPECT_FALSE(constraint.isSatisfied(state));
+}
@@ -0,0 +1,150 @@
+#include <dart/dart.hpp>
+#include <gtest/gtest.h>
+#include <aikido/constraint/ContinuousCollisionFree.hpp>
+#include <aikido/statespace/dart/MetaSkeletonStateSpace.hpp>
+
+using aikido::constraint::ContinuousCollisionFree;
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+using aikido::statespace::dart::MetaSkeletonStateSpacePtr;
+
+using namespace dart::dynamics;
+using namespace dart::collision;
+
+class ContinuousCollisionFreeTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Manipulator with a single link that rotates about the z-axis at a
+    // distance of 1 from the joint.
+    mManipulator = Skeleton::create("Manipulator");
+
+    RevoluteJoint::Properties properties;
+    properties.mAxis = Eigen::Vector3d::UnitZ();
+    properties.mName = "Joint1";
+    auto link = mManipulator
+                    ->createJointAndBodyNodePair<RevoluteJoint>(
+                        nullptr, properties)
+                    .second;
+
+    std::shared_ptr<BoxShape> linkShape(
+        new BoxShape(Eigen::Vector3d(0.1, 0.1, 0.1)));
+    auto linkShapeNode = link->createShapeNodeWith<
+        VisualAspect,
+        CollisionAspect,
+        DynamicsAspect>(linkShape);
+    linkShapeNode->setRelativeTranslation(Eigen::Vector3d(1., 0., 0.));
+
+    // Thin obstacle that the link passes through at an angle of pi / 2.
+    mObstacle = Skeleton::create("Obstacle");
+    auto obstacleNode
+        = mObstacle->createJointAndBodyNodePair<WeldJoint>().second;
+    std::shared_ptr<BoxShape> obstacleShape(
+        new BoxShape(Eigen::Vector3d(0.05, 0.05, 1.)));
+    auto obstacleShapeNode = obstacleNode->createShapeNodeWith<
+        VisualAspect,
+        CollisionAspect,
+        DynamicsAspect>(obstacleShape);
+    obstacleShapeNode->setRelativeTranslation(Eigen::Vector3d(0., 1., 0.));
+
+    mCollisionDetector = FCLCollisionDetector::create();
+    mObstacleGroup = mCollisionDetector->createCollisionGroup(obstacleNode);
+
+    mStateSpace = std::make_shared<MetaSkeletonStateSpace>(mManipulator);
+  }
+
+  ::testing::AssertionResult checkSegment(
+      const ContinuousCollisionFree& _constraint,
+      double _from,
+      double _to,
+      double& _lastValid)
+  {
+    auto from = mStateSpace->createState();
+    auto to = mStateSpace->createState();
+    mStateSpace->convertPositionsToState(
+        Eigen::VectorXd::Constant(1, _from), from);
+    mStateSpace->convertPositionsToState(
+        Eigen::VectorXd::Constant(1, _to), to);
+
+    if (_constraint.isSatisfied(from, to, _lastValid))
+      return ::testing::AssertionSuccess();
+    else
+      return ::testing::AssertionFailure();
+  }
+
+  SkeletonPtr mManipulator, mObstacle;
+  CollisionDetectorPtr mCollisionDetector;
+  std::shared_ptr<CollisionGroup> mObstacleGroup;
+  MetaSkeletonStateSpacePtr mStateSpace;
+};
+
+TEST_F(ContinuousCollisionFreeTest, ConstructorThrowsOnNullStateSpace)
+{
+  EXPECT_THROW(
+      ContinuousCollisionFree(nullptr, mCollisionDetector),
+      std::invalid_argument);
+}
+
+TEST_F(ContinuousCollisionFreeTest, ConstructorThrowsOnNullCollisionDetector)
+{
+  EXPECT_THROW(
+      ContinuousCollisionFree(mStateSpace, nullptr), std::invalid_argument);
+}
+
+TEST_F(ContinuousCollisionFreeTest, ConstructorThrowsOnInvalidTolerance)
+{
+  EXPECT_THROW(
+      ContinuousCollisionFree(mStateSpace, mCollisionDetector, 0.),
+      std::invalid_argument);
+}
+
+TEST_F(ContinuousCollisionFreeTest, ConstructorThrowsOnUnsupportedJoint)
+{
+  auto skeleton = Skeleton::create("Ball");
+  skeleton->createJointAndBodyNodePair<BallJoint>();
+  auto stateSpace = std::make_shared<MetaSkeletonStateSpace>(skeleton);
+
+  EXPECT_THROW(
+      ContinuousCollisionFree(stateSpace, mCollisionDetector),
+      std::invalid_argument);
+}
+
+TEST_F(ContinuousCollisionFreeTest, GetStateSpace)
+{
+  ContinuousCollisionFree constraint(mStateSpace, mCollisionDetector);
+  EXPECT_EQ(mStateSpace, constraint.getStateSpace());
+  EXPECT_EQ(1u, constraint.getNumMovingBodyNodes());
+}
+
+TEST_F(ContinuousCollisionFreeTest, SegmentAwayFromObstacle_IsSatisfied)
+{
+  ContinuousCollisionFree constraint(mStateSpace, mCollisionDetector);
+  constraint.addPairwiseCheck(mObstacleGroup);
+
+  double lastValid;
+  EXPECT_TRUE(checkSegment(constraint, 0., -M_PI_2, lastValid));
+  EXPECT_DOUBLE_EQ(1., lastValid);
+}
+
+TEST_F(ContinuousCollisionFreeTest, SegmentThroughObstacle_IsNotSatisfied)
+{
+  ContinuousCollisionFree constraint(mStateSpace, mCollisionDetector);
+  constraint.addPairwiseCheck(mObstacleGroup);
+
+  // Both endpoints are free, but the link sweeps through the obstacle.
+  double lastValid;
+  EXPECT_FALSE(checkSegment(constraint, 0., 0.9 * M_PI, lastValid));
+  EXPECT_LT(0., lastValid);
+  EXPECT_GT(0.5 / 0.9, lastValid);
+}
+
+TEST_F(ContinuousCollisionFreeTest, RemovePairwiseCheck)
+{
+  ContinuousCollisionFree constraint(mStateSpace, mCollisionDetector);
+  constraint.addPairwiseCheck(mObstacleGroup);
+  constraint.removePairwiseCheck(mObstacleGroup);
+
+  double lastValid;
+  EXPECT_TRUE(checkSegment(constraint, 0., 0.9 * M_PI, lastValid));
+  EXPECT_DOUBLE_EQ(1., lastValid);
+}
@@ -35,3 +35,23 @@ TEST(Differentiable, GetValueAndJacobianDefault)
   EXPECT_TRUE(valExpected.isApprox(val));
   EXPECT_TRUE(jacExpected.isApprox(jac));
 }
+
+TEST(Differentiable, GetJacobianSparseDefault)
+{
+  PolynomialConstraint<1> p(Eigen::Vector3d(1, 2, 3));
+
+  Eigen::VectorXd v(1);
+  v(0) = -2;
+
+  R1 rvss;
+  auto s1 = rvss.createState();
+  s1.setValue(v);
+
+  Eigen::MatrixXd jacExpected;
+  p.getJacobian(s1, jacExpected);
+
+  Eigen::SparseMatrix<double> jac;
+  p.getJacobianSparse(s1, jac);
+
+  EXPECT_TRUE(jacExpected.isApprox(Eigen::MatrixXd(jac)));
+}
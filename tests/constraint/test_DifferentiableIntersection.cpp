@@ -181,3 +181,35 @@ TEST(DifferentiableIntersection, GetStateSpace)
 
   EXPECT_EQ(space, rvss);
 }
+
+TEST(DifferentiableIntersection, GetJacobianSparseMatchesJacobian)
+{
+  std::vector<DifferentiablePtr> constraints;
+  std::shared_ptr<R1> rvss(new R1());
+
+  // constraint1: 1 + 2x + 3x^2
+  constraints.push_back(
+      std::make_shared<PolynomialConstraint<1>>(
+          Eigen::Vector3d(1, 2, 3), rvss));
+
+  // constraint2: 4 + 5x
+  constraints.push_back(
+      std::make_shared<PolynomialConstraint<1>>(Eigen::Vector2d(4, 5), rvss));
+
+  auto s1 = rvss->createState();
+  Eigen::VectorXd v(1);
+  v(0) = -2;
+  s1.setValue(v);
+
+  DifferentiableIntersection stacked(constraints, rvss);
+
+  Eigen::MatrixXd jacobian;
+  stacked.getJacobian(s1, jacobian);
+
+  Eigen::SparseMatrix<double> sparseJacobian;
+  stacked.getJacobianSparse(s1, sparseJacobian);
+
+  EXPECT_EQ(2, sparseJacobian.rows());
+  EXPECT_EQ(1, sparseJacobian.cols());
+  EXPECT_TRUE(jacobian.isApprox(Eigen::MatrixXd(sparseJacobian)));
+}
@@ -139,3 +139,23 @@ TEST_F(DifferentiableSubspaceTest, ConstraintValueAndJacobian)
   EXPECT_TRUE(val.isApprox(expectedVal));
   EXPECT_TRUE(jac.isApprox(expectedJac));
 }
+
+TEST_F(DifferentiableSubspaceTest, ConstraintJacobianSparse)
+{
+  auto st = cs->createState();
+  auto subSpace = cs->getSubspace<R1>(1);
+  auto subState = cs->getSubStateHandle<R1>(st, 1);
+
+  subSpace->setValue(subState, aikido::tests::make_vector(2));
+
+  // The sparse jacobian has the shape of the dense one.
+  Eigen::MatrixXd jacobian;
+  ds->getJacobian(st, jacobian);
+
+  Eigen::SparseMatrix<double> sparseJacobian;
+  ds->getJacobianSparse(st, sparseJacobian);
+
+  EXPECT_EQ(jacobian.rows(), sparseJacobian.rows());
+  EXPECT_EQ(jacobian.cols(), sparseJacobian.cols());
+  EXPECT_TRUE(jacobian.isApprox(Eigen::MatrixXd(sparseJacobian)));
+}
@@ -0,0 +1,158 @@
+#include <dart/common/StlHelpers.hpp>
+#include <dart/dynamics/dynamics.hpp>
+#include <gtest/gtest.h>
+#include <aikido/constraint/JointStateSpaceHelpers.hpp>
+#include <aikido/constraint/MetaSkeletonBoxConstraint.hpp>
+#include <aikido/statespace/dart/MetaSkeletonStateSpace.hpp>
+
+using dart::common::make_unique;
+using dart::dynamics::BallJoint;
+using dart::dynamics::BodyNode;
+using dart::dynamics::PrismaticJoint;
+using dart::dynamics::RevoluteJoint;
+using dart::dynamics::Skeleton;
+using dart::dynamics::SkeletonPtr;
+using aikido::constraint::MetaSkeletonBoxConstraint;
+using aikido::constraint::SampleGenerator;
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+using aikido::common::RNGWrapper;
+
+//==============================================================================
+class MetaSkeletonBoxConstraintTests : public ::testing::Test
+{
+protected:
+  static constexpr int NUM_SAMPLES{1000};
+
+  void SetUp() override
+  {
+    // Chain: limited revolute, limited prismatic, continuous revolute,
+    // limited revolute. The continuous joint splits the limited DOFs into two
+    // segments.
+    mSkeleton = Skeleton::create();
+
+    auto pair1 = mSkeleton->createJointAndBodyNodePair<RevoluteJoint>();
+    pair1.first->setPositionLowerLimit(0, -1.);
+    pair1.first->setPositionUpperLimit(0, 1.);
+
+    auto pair2 = pair1.second->createChildJointAndBodyNodePair<PrismaticJoint>();
+    pair2.first->setPositionLowerLimit(0, 0.);
+    pair2.first->setPositionUpperLimit(0, 0.5);
+
+    // Revolute joints without limits are SO2Joints.
+    auto pair3 = pair2.second->createChildJointAndBodyNodePair<RevoluteJoint>();
+
+    auto pair4 = pair3.second->createChildJointAndBodyNodePair<RevoluteJoint>();
+    pair4.first->setPositionLowerLimit(0, -2.);
+    pair4.first->setPositionUpperLimit(0, 2.);
+
+    mStateSpace = std::make_shared<MetaSkeletonStateSpace>(mSkeleton);
+  }
+
+  SkeletonPtr mSkeleton;
+  std::shared_ptr<MetaSkeletonStateSpace> mStateSpace;
+};
+
+//==============================================================================
+TEST_F(MetaSkeletonBoxConstraintTests, ConstructorThrowsOnNullStateSpace)
+{
+  EXPECT_THROW(MetaSkeletonBoxConstraint(nullptr), std::invalid_argument);
+}
+
+//==============================================================================
+TEST_F(MetaSkeletonBoxConstraintTests, ConstructorThrowsOnUnsupportedJoint)
+{
+  auto skeleton = Skeleton::create();
+  skeleton->createJointAndBodyNodePair<BallJoint>();
+  auto space = std::make_shared<MetaSkeletonStateSpace>(skeleton);
+
+  EXPECT_FALSE(MetaSkeletonBoxConstraint::isCompatible(*space));
+  EXPECT_THROW(MetaSkeletonBoxConstraint(space, nullptr), std::invalid_argument);
+}
+
+//==============================================================================
+TEST_F(MetaSkeletonBoxConstraintTests, SkipsUnlimitedJoints)
+{
+  MetaSkeletonBoxConstraint constraint(mStateSpace);
+
+  EXPECT_EQ(mStateSpace, constraint.getStateSpace());
+  EXPECT_EQ(3u, constraint.getNumLimitedDofs());
+  EXPECT_TRUE(constraint.getLowerLimits().isApprox(Eigen::Vector3d(-1, 0, -2)));
+  EXPECT_TRUE(constraint.getUpperLimits().isApprox(Eigen::Vector3d(1, 0.5, 2)));
+}
+
+//==============================================================================
+TEST_F(MetaSkeletonBoxConstraintTests, IsSatisfied)
+{
+  MetaSkeletonBoxConstraint constraint(mStateSpace);
+  auto state = mStateSpace->createState();
+
+  mStateSpace->convertPositionsToState(
+      Eigen::Vector4d(0.5, 0.25, 10., -1.5), state);
+  EXPECT_TRUE(constraint.isSatisfied(state));
+
+  mStateSpace->convertPositionsToState(
+      Eigen::Vector4d(1.5, 0.25, 0., 0.), state);
+  EXPECT_FALSE(constraint.isSatisfied(state));
+
+  mStateSpace->convertPositionsToState(
+      Eigen::Vector4d(0., 0.25, 0., -2.5), state);
+  EXPECT_FALSE(constraint.isSatisfied(state));
+}
+
+//==============================================================================
+TEST_F(MetaSkeletonBoxConstraintTests, Project)
+{
+  MetaSkeletonBoxConstraint constraint(mStateSpace);
+  auto inState = mStateSpace->createState();
+  auto outState = mStateSpace->createState();
+
+  mStateSpace->convertPositionsToState(
+      Eigen::Vector4d(1.5, -0.25, 3., -2.5), inState);
+  EXPECT_TRUE(constraint.project(inState, outState));
+  EXPECT_TRUE(constraint.isSatisfied(outState));
+
+  Eigen::VectorXd positions;
+  mStateSpace->convertStateToPositions(outState, positions);
+  EXPECT_TRUE(positions.isApprox(Eigen::Vector4d(1., 0., 3., -2.)));
+
+  // In-place projection.
+  EXPECT_TRUE(constraint.project(inState));
+  EXPECT_TRUE(constraint.isSatisfied(inState));
+}
+
+//==============================================================================
+TEST_F(MetaSkeletonBoxConstraintTests, Sample)
+{
+  MetaSkeletonBoxConstraint constraint(
+      mStateSpace, make_unique<RNGWrapper<std::default_random_engine>>(0));
+  ASSERT_TRUE(constraint.isBounded());
+
+  const auto generator = constraint.createSampleGenerator();
+  ASSERT_TRUE(!!generator);
+  EXPECT_EQ(mStateSpace, generator->getStateSpace());
+
+  auto state = mStateSpace->createState();
+
+  for (std::size_t isample = 0; isample < NUM_SAMPLES; ++isample)
+  {
+    ASSERT_TRUE(generator->canSample());
+    ASSERT_EQ(SampleGenerator::NO_LIMIT, generator->getNumSamples());
+    ASSERT_TRUE(generator->sample(state));
+    ASSERT_TRUE(constraint.isSatisfied(state));
+  }
+}
+
+//==============================================================================
+TEST_F(MetaSkeletonBoxConstraintTests, HelpersReturnFusedConstraint)
+{
+  auto rng = make_unique<RNGWrapper<std::default_random_engine>>(0);
+
+  auto testable = aikido::constraint::createTestableBounds(mStateSpace);
+  auto projectable = aikido::constraint::createProjectableBounds(mStateSpace);
+  auto sampleable
+      = aikido::constraint::createSampleableBounds(mStateSpace, std::move(rng));
+
+  EXPECT_TRUE(!!dynamic_cast<MetaSkeletonBoxConstraint*>(testable.get()));
+  EXPECT_TRUE(!!dynamic_cast<MetaSkeletonBoxConstraint*>(projectable.get()));
+  EXPECT_TRUE(!!dynamic_cast<MetaSkeletonBoxConstraint*>(sampleable.get()));
+}
@@ -148,6 +148,45 @@ TEST(NewtonsMethodProjectable, ProjectPolynomialSecondOrder)
   EXPECT_TRUE(expected.isApprox(projected, 1e-5));
 }
 
+TEST(NewtonsMethodProjectable, ProjectPolynomialSecondOrderSparse)
+{
+  // Constraint: x^2 - 1 = 0.
+  NewtonsMethodProjectable projector(
+      std::make_shared<PolynomialConstraint<1>>(Eigen::Vector3d(-1, 0, 1)),
+      std::vector<double>({1e-6}),
+      10,
+      1e-8,
+      true);
+
+  // Project x = -2. Should get -1 as projected solution.
+  Eigen::VectorXd v(1);
+  v(0) = -2;
+
+  R1 rvss;
+  auto seedState = rvss.createState();
+  seedState.setValue(v);
+
+  auto out = rvss.createState();
+  EXPECT_TRUE(projector.project(seedState, out));
+  Eigen::VectorXd projected = rvss.getValue(out);
+
+  Eigen::VectorXd expected(1);
+  expected(0) = -1;
+
+  EXPECT_TRUE(expected.isApprox(projected, 1e-5));
+
+  // Project x = 1.5. Should get 1 as projected solution.
+  v(0) = 1.5;
+  seedState.setValue(v);
+
+  EXPECT_TRUE(projector.project(seedState, out));
+  projected = rvss.getValue(out);
+
+  expected(0) = 1;
+
+  EXPECT_TRUE(expected.isApprox(projected, 1e-5));
+}
+
 TEST(NewtonsMethodProjectable, ProjectTSRTranslation)
 {
   std::shared_ptr<TSR> tsr = std::make_shared<TSR>();
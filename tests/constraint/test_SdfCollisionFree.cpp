@@ -0,0 +1,170 @@
+#include <dart/dart.hpp>
+#include <gtest/gtest.h>
+#include <aikido/constraint/CollisionFree.hpp>
+#include <aikido/constraint/SdfCollisionFree.hpp>
+#include <aikido/statespace/dart/MetaSkeletonStateSpace.hpp>
+
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+using aikido::statespace::dart::MetaSkeletonStateSpacePtr;
+using aikido::constraint::CollisionFree;
+using aikido::constraint::SdfCollisionFree;
+
+using namespace dart::dynamics;
+using namespace dart::collision;
+
+class SdfCollisionFreeTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Manipulator with a single 1 m long link that rotates in the xz-plane.
+    mManipulator = Skeleton::create("Manipulator");
+
+    RevoluteJoint::Properties properties;
+    properties.mAxis = Eigen::Vector3d::UnitY();
+    properties.mName = "Joint1";
+    auto link
+        = mManipulator
+              ->createJointAndBodyNodePair<RevoluteJoint>(nullptr, properties)
+              .second;
+
+    std::shared_ptr<BoxShape> linkShape(
+        new BoxShape(Eigen::Vector3d(0.1, 0.1, 1.0)));
+    auto linkShapeNode
+        = link->createShapeNodeWith<VisualAspect, CollisionAspect>(linkShape);
+    linkShapeNode->setRelativeTranslation(Eigen::Vector3d(0., 0., 0.5));
+
+    // Obstacle in the way of the link at its zero position.
+    mBox = Skeleton::create("Box");
+    auto boxNode = mBox->createJointAndBodyNodePair<FreeJoint>().second;
+    std::shared_ptr<BoxShape> boxShape(
+        new BoxShape(Eigen::Vector3d(0.2, 0.2, 0.2)));
+    boxNode->createShapeNodeWith<VisualAspect, CollisionAspect>(boxShape);
+
+    Eigen::Vector6d boxPositions(Eigen::Vector6d::Zero());
+    boxPositions.tail<3>() = Eigen::Vector3d(0., 0., 0.8);
+    mBox->setPositions(boxPositions);
+
+    mStateSpace = std::make_shared<MetaSkeletonStateSpace>(mManipulator);
+    mEnvironment.emplace_back(mBox);
+
+    mCollisionDetector = FCLCollisionDetector::create();
+    mFallback = std::make_shared<CollisionFree>(mStateSpace, mCollisionDetector);
+    mFallback->addPairwiseCheck(
+        mCollisionDetector->createCollisionGroupAsSharedPtr(
+            mManipulator.get()),
+        mCollisionDetector->createCollisionGroupAsSharedPtr(mBox.get()));
+  }
+
+  void setAngle(
+      double _angle, MetaSkeletonStateSpace::State* _state) const
+  {
+    Eigen::VectorXd positions(1);
+    positions[0] = _angle;
+    mStateSpace->convertPositionsToState(positions, _state);
+  }
+
+  SkeletonPtr mManipulator, mBox;
+  std::vector<ConstSkeletonPtr> mEnvironment;
+  MetaSkeletonStateSpacePtr mStateSpace;
+  CollisionDetectorPtr mCollisionDetector;
+  std::shared_ptr<CollisionFree> mFallback;
+};
+
+TEST_F(SdfCollisionFreeTest, ConstructorThrowsOnNullStateSpace)
+{
+  EXPECT_THROW(
+      SdfCollisionFree(nullptr, mEnvironment, 0.02, 0.05),
+      std::invalid_argument);
+}
+
+TEST_F(SdfCollisionFreeTest, ConstructorThrowsOnInvalidParameters)
+{
+  EXPECT_THROW(
+      SdfCollisionFree(mStateSpace, mEnvironment, 0., 0.05),
+      std::invalid_argument);
+  EXPECT_THROW(
+      SdfCollisionFree(mStateSpace, mEnvironment, 0.02, 0.),
+      std::invalid_argument);
+  EXPECT_THROW(
+      SdfCollisionFree(mStateSpace, mEnvironment, 0.02, 0.05, -1.),
+      std::invalid_argument);
+
+  std::vector<ConstSkeletonPtr> environment{nullptr};
+  EXPECT_THROW(
+      SdfCollisionFree(mStateSpace, environment, 0.02, 0.05),
+      std::invalid_argument);
+}
+
+TEST_F(SdfCollisionFreeTest, ConstructorThrowsOnMismatchedFallback)
+{
+  auto otherStateSpace = std::make_shared<MetaSkeletonStateSpace>(mBox);
+  auto fallback
+      = std::make_shared<CollisionFree>(otherStateSpace, mCollisionDetector);
+
+  EXPECT_THROW(
+      SdfCollisionFree(mStateSpace, mEnvironment, 0.02, 0.05, 0., fallback),
+      std::invalid_argument);
+}
+
+TEST_F(SdfCollisionFreeTest, GetStateSpaceMatchStateSpace)
+{
+  SdfCollisionFree constraint(mStateSpace, mEnvironment, 0.02, 0.05);
+  EXPECT_EQ(mStateSpace, constraint.getStateSpace());
+}
+
+TEST_F(SdfCollisionFreeTest, CoversLinkWithSpheres)
+{
+  SdfCollisionFree constraint(mStateSpace, mEnvironment, 0.02, 0.05);
+
+  // The 0.1 x 0.1 x 1.0 link is split into 2 x 2 x 20 cells.
+  EXPECT_EQ(80u, constraint.getNumSpheres());
+}
+
+TEST_F(SdfCollisionFreeTest, EmptyEnvironment_IsSatisfiedReturnsTrue)
+{
+  SdfCollisionFree constraint(
+      mStateSpace, std::vector<ConstSkeletonPtr>(), 0.02, 0.05);
+
+  auto state = mStateSpace->createState();
+  setAngle(0., state);
+  EXPECT_TRUE(constraint.isSatisfied(state));
+}
+
+TEST_F(SdfCollisionFreeTest, IsSatisfied)
+{
+  SdfCollisionFree constraint(mStateSpace, mEnvironment, 0.02, 0.05);
+  auto state = mStateSpace->createState();
+
+  setAngle(0., state);
+  EXPECT_FALSE(constraint.isSatisfied(state));
+
+  setAngle(M_PI_2, state);
+  EXPECT_TRUE(constraint.isSatisfied(state));
+
+  setAngle(M_PI, state);
+  EXPECT_TRUE(constraint.isSatisfied(state));
+}
+
+TEST_F(SdfCollisionFreeTest, MarginRejectsStatesWithoutFallback)
+{
+  SdfCollisionFree constraint(mStateSpace, mEnvironment, 0.02, 0.05, 1.);
+  auto state = mStateSpace->createState();
+
+  // The link is collision free but within the margin of the box.
+  setAngle(M_PI_2, state);
+  EXPECT_FALSE(constraint.isSatisfied(state));
+}
+
+TEST_F(SdfCollisionFreeTest, FallbackDecidesWithinMargin)
+{
+  SdfCollisionFree constraint(
+      mStateSpace, mEnvironment, 0.02, 0.05, 1., mFallback);
+  auto state = mStateSpace->createState();
+
+  setAngle(M_PI_2, state);
+  EXPECT_TRUE(constraint.isSatisfied(state));
+
+  setAngle(0., state);
+  EXPECT_FALSE(constraint.isSatisfied(state));
+}
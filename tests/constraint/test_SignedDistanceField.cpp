@@ -0,0 +1,209 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <gtest/gtest.h>
+#include <aikido/constraint/SignedDistanceField.hpp>
+
+using aikido::constraint::SignedDistanceField;
+
+//==============================================================================
+TEST(SignedDistanceField, ConstructorThrowsOnInvalidResolution)
+{
+  EXPECT_THROW(
+      SignedDistanceField(
+          Eigen::Vector3d::Zero(), 0., Eigen::Vector3i(1, 1, 1)),
+      std::invalid_argument);
+  EXPECT_THROW(
+      SignedDistanceField(
+          Eigen::Vector3d::Zero(), -1., Eigen::Vector3i(1, 1, 1)),
+      std::invalid_argument);
+}
+
+//==============================================================================
+TEST(SignedDistanceField, ConstructorThrowsOnEmptyGrid)
+{
+  EXPECT_THROW(
+      SignedDistanceField(
+          Eigen::Vector3d::Zero(), 1., Eigen::Vector3i(1, 0, 1)),
+      std::invalid_argument);
+}
+
+//==============================================================================
+TEST(SignedDistanceField, VoxelIndexAndCenter)
+{
+  SignedDistanceField sdf(
+      Eigen::Vector3d(-1., 0., 1.), 0.5, Eigen::Vector3i(4, 4, 4));
+
+  EXPECT_TRUE(
+      Eigen::Vector3i(0, 0, 0)
+      == sdf.getVoxelIndex(Eigen::Vector3d(-1., 0., 1.)));
+  EXPECT_TRUE(
+      Eigen::Vector3i(1, 2, 3)
+      == sdf.getVoxelIndex(Eigen::Vector3d(-0.4, 1.1, 2.9)));
+
+  // Points outside of the grid are clamped.
+  EXPECT_TRUE(
+      Eigen::Vector3i(0, 3, 3)
+      == sdf.getVoxelIndex(Eigen::Vector3d(-10., 10., 10.)));
+
+  EXPECT_TRUE(Eigen::Vector3d(-0.25, 1.25, 2.75)
+                  .isApprox(sdf.getVoxelCenter(Eigen::Vector3i(1, 2, 3))));
+
+  EXPECT_TRUE(sdf.isValidIndex(Eigen::Vector3i(3, 3, 3)));
+  EXPECT_FALSE(sdf.isValidIndex(Eigen::Vector3i(4, 0, 0)));
+  EXPECT_FALSE(sdf.isValidIndex(Eigen::Vector3i(0, -1, 0)));
+  EXPECT_THROW(
+      sdf.setOccupied(Eigen::Vector3i(0, 4, 0)), std::out_of_range);
+}
+
+//==============================================================================
+TEST(SignedDistanceField, EmptyGridIsInfinitelyFar)
+{
+  SignedDistanceField sdf(
+      Eigen::Vector3d::Zero(), 0.1, Eigen::Vector3i(3, 4, 5));
+  sdf.update();
+
+  EXPECT_EQ(
+      std::numeric_limits<double>::infinity(),
+      sdf.getSignedDistance(Eigen::Vector3i(1, 1, 1)));
+  EXPECT_EQ(
+      std::numeric_limits<double>::infinity(),
+      sdf.getDistanceLowerBound(Eigen::Vector3d(0.1, 0.2, 0.3)));
+}
+
+//==============================================================================
+TEST(SignedDistanceField, SingleOccupiedVoxel)
+{
+  SignedDistanceField sdf(
+      Eigen::Vector3d::Zero(), 0.5, Eigen::Vector3i(7, 5, 6));
+  const Eigen::Vector3i occupied(3, 1, 4);
+  sdf.setOccupied(occupied);
+  sdf.update();
+
+  EXPECT_TRUE(sdf.isOccupied(occupied));
+  EXPECT_DOUBLE_EQ(-0.5, sdf.getSignedDistance(occupied));
+
+  for (int x = 0; x < 7; ++x)
+  {
+    for (int y = 0; y < 5; ++y)
+    {
+      for (int z = 0; z < 6; ++z)
+      {
+        const Eigen::Vector3i index(x, y, z);
+        if (index == occupied)
+          continue;
+
+        const double expected = 0.5 * (index - occupied).cast<double>().norm();
+        EXPECT_NEAR(expected, sdf.getSignedDistance(index), 1e-5);
+      }
+    }
+  }
+}
+
+//==============================================================================
+TEST(SignedDistanceField, MatchesBruteForce)
+{
+  const Eigen::Vector3i size(9, 6, 7);
+  SignedDistanceField sdf(Eigen::Vector3d(1., 2., 3.), 0.25, size);
+
+  std::mt19937 rng(42);
+  std::bernoulli_distribution occupiedDistribution(0.1);
+
+  std::vector<Eigen::Vector3i> occupied;
+  std::vector<Eigen::Vector3i> free;
+  for (int x = 0; x < size[0]; ++x)
+  {
+    for (int y = 0; y < size[1]; ++y)
+    {
+      for (int z = 0; z < size[2]; ++z)
+      {
+        const Eigen::Vector3i index(x, y, z);
+        if (occupiedDistribution(rng))
+        {
+          sdf.setOccupied(index);
+          occupied.push_back(index);
+        }
+        else
+        {
+          free.push_back(index);
+        }
+      }
+    }
+  }
+  sdf.update();
+
+  ASSERT_FALSE(occupied.empty());
+  ASSERT_FALSE(free.empty());
+
+  for (const auto& index : free)
+  {
+    double expected = std::numeric_limits<double>::infinity();
+    for (const auto& other : occupied)
+      expected = std::min(expected, (index - other).cast<double>().norm());
+    EXPECT_NEAR(0.25 * expected, sdf.getSignedDistance(index), 1e-5);
+  }
+
+  for (const auto& index : occupied)
+  {
+    double expected = std::numeric_limits<double>::infinity();
+    for (const auto& other : free)
+      expected = std::min(expected, (index - other).cast<double>().norm());
+    EXPECT_NEAR(-0.25 * expected, sdf.getSignedDistance(index), 1e-5);
+  }
+}
+
+//==============================================================================
+TEST(SignedDistanceField, DistanceLowerBoundIsConservative)
+{
+  // Voxelize a sphere conservatively: a voxel is occupied if its center lies
+  // within half a diagonal of the sphere.
+  const double resolution = 0.1;
+  const Eigen::Vector3d center(0.52, 0.47, 0.5);
+  const double radius = 0.2;
+
+  SignedDistanceField sdf(
+      Eigen::Vector3d::Zero(), resolution, Eigen::Vector3i(10, 10, 10));
+  const double halfDiagonal = 0.5 * std::sqrt(3.) * resolution;
+
+  for (int x = 0; x < 10; ++x)
+  {
+    for (int y = 0; y < 10; ++y)
+    {
+      for (int z = 0; z < 10; ++z)
+      {
+        const Eigen::Vector3i index(x, y, z);
+        const double distance
+            = (sdf.getVoxelCenter(index) - center).norm() - radius;
+        if (distance <= halfDiagonal)
+          sdf.setOccupied(index);
+      }
+    }
+  }
+  sdf.update();
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> coordinate(-0.5, 1.5);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const Eigen::Vector3d point(
+        coordinate(rng), coordinate(rng), coordinate(rng));
+    const double exact = std::max(0., (point - center).norm() - radius);
+    EXPECT_LE(sdf.getDistanceLowerBound(point), exact);
+  }
+
+  // Far from the sphere the bound is not trivially loose.
+  const Eigen::Vector3d far(0.05, 0.05, 0.05);
+  EXPECT_GT(sdf.getDistanceLowerBound(far), 0.);
+}
+
+//==============================================================================
+TEST(SignedDistanceField, DistanceLowerBoundOutsideOfGrid)
+{
+  SignedDistanceField sdf(
+      Eigen::Vector3d::Zero(), 0.1, Eigen::Vector3i(2, 2, 2));
+  sdf.setOccupied(Eigen::Vector3i(0, 0, 0));
+  sdf.update();
+
+  EXPECT_NEAR(
+      1.8, sdf.getDistanceLowerBound(Eigen::Vector3d(2., 0.1, 0.1)), 1e-9);
+}
@@ -210,3 +210,89 @@ TEST(CartesianProductWeightedDistance, DistanceCustomWeights)
   EXPECT_DOUBLE_EQ(
       2 * 0.5 + 4 * 0.5 + 3 * vdiff.norm(), dmetric.distance(state1, state2));
 }
+
+TEST(CartesianProductWeightedDistance, FlattenedOnlyForEuclideanAndSO2)
+{
+  auto so2 = std::make_shared<SO2>();
+  auto rv3 = std::make_shared<R3>();
+  auto so3 = std::make_shared<SO3>();
+
+  CartesianProductWeighted flatMetric(
+      std::make_shared<CartesianProduct>(
+          std::vector<std::shared_ptr<StateSpace>>{so2, rv3}),
+      {std::make_shared<SO2Angular>(so2), std::make_shared<R3Euclidean>(rv3)});
+  EXPECT_TRUE(flatMetric.isFlattened());
+
+  CartesianProductWeighted mixedMetric(
+      std::make_shared<CartesianProduct>(
+          std::vector<std::shared_ptr<StateSpace>>{so2, so3}),
+      {std::make_shared<SO2Angular>(so2), std::make_shared<SO3Angular>(so3)});
+  EXPECT_FALSE(mixedMetric.isFlattened());
+}
+
+TEST(CartesianProductWeightedDistance, FlattenedMatchesComponentMetrics)
+{
+  auto so2a = std::make_shared<SO2>();
+  auto r1 = std::make_shared<R1>();
+  auto so2b = std::make_shared<SO2>();
+  auto rv3 = std::make_shared<R3>();
+  std::vector<std::shared_ptr<StateSpace>> spaces = {so2a, r1, so2b, rv3};
+  auto space = std::make_shared<CartesianProduct>(spaces);
+
+  std::vector<std::pair<DistanceMetricPtr, double>> metrics
+      = {std::make_pair(std::make_shared<SO2Angular>(so2a), 2.),
+         std::make_pair(std::make_shared<R1Euclidean>(r1), 0.5),
+         std::make_pair(std::make_shared<SO2Angular>(so2b), 1.),
+         std::make_pair(std::make_shared<R3Euclidean>(rv3), 3.)};
+  CartesianProductWeighted dmetric(space, metrics);
+  ASSERT_TRUE(dmetric.isFlattened());
+
+  auto state1 = space->createState();
+  auto state2 = space->createState();
+
+  const std::vector<std::pair<double, double>> angles
+      = {{0.1, 0.2}, {3., -3.}, {-7., 7.5}, {20., -0.3}, {M_PI, -M_PI}};
+  for (const auto& angle : angles)
+  {
+    state1.getSubStateHandle<SO2>(0).setAngle(angle.first);
+    state1.getSubStateHandle<R1>(1).setValue(Eigen::Matrix<double, 1, 1>(4.));
+    state1.getSubStateHandle<SO2>(2).setAngle(angle.second);
+    state1.getSubStateHandle<R3>(3).setValue(Eigen::Vector3d(3, 4, 5));
+
+    state2.getSubStateHandle<SO2>(0).setAngle(angle.second);
+    state2.getSubStateHandle<R1>(1).setValue(Eigen::Matrix<double, 1, 1>(-1.));
+    state2.getSubStateHandle<SO2>(2).setAngle(-angle.first);
+    state2.getSubStateHandle<R3>(3).setValue(Eigen::Vector3d(1, 2, 3));
+
+    double expected = 0.;
+    for (std::size_t i = 0; i < metrics.size(); ++i)
+    {
+      expected += metrics[i].second
+                  * metrics[i].first->distance(
+                        space->getSubState<>(state1, i),
+                        space->getSubState<>(state2, i));
+    }
+
+    EXPECT_NEAR(expected, dmetric.distance(state1, state2), 1e-12);
+    EXPECT_NEAR(
+        expected * expected, dmetric.distanceSquared(state1, state2), 1e-10);
+  }
+}
+
+TEST(CartesianProductWeightedDistance, DistanceSquaredSingleEuclidean)
+{
+  auto rv3 = std::make_shared<R3>();
+  auto space = std::make_shared<CartesianProduct>(
+      std::vector<std::shared_ptr<StateSpace>>{rv3});
+
+  CartesianProductWeighted dmetric(
+      space, {std::make_pair(std::make_shared<R3Euclidean>(rv3), 2.)});
+
+  auto state1 = space->createState();
+  auto state2 = space->createState();
+  state1.getSubStateHandle<R3>(0).setValue(Eigen::Vector3d(3, 4, 5));
+  state2.getSubStateHandle<R3>(0).setValue(Eigen::Vector3d(1, 2, 3));
+
+  EXPECT_DOUBLE_EQ(4. * 12., dmetric.distanceSquared(state1, state2));
+  EXPECT_DOUBLE_EQ(2. * std::sqrt(12.), dmetric.distance(state1, state2));
+}
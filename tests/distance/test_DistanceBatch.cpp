@@ -0,0 +1,236 @@
+#include <aikido/distance/CartesianProductWeighted.hpp>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/distance/SE2Weighted.hpp>
+#include <aikido/distance/SO2Angular.hpp>
+#include <aikido/distance/SO3Angular.hpp>
+#include <aikido/statespace/CartesianProduct.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace aikido::distance;
+using namespace aikido::statespace;
+
+namespace {
+
+constexpr std::size_t NUM_STATES = 17;
+
+/// Allocates NUM_STATES states of a space back to back in a single buffer.
+class StateBuffer
+{
+public:
+  explicit StateBuffer(StateSpacePtr _space)
+    : mSpace(std::move(_space))
+    , mBuffer(NUM_STATES * mSpace->getStateSizeInBytes() / sizeof(double) + 1)
+  {
+    for (std::size_t i = 0; i < NUM_STATES; ++i)
+      mStates.push_back(mSpace->allocateStateInBuffer(getState(i)));
+  }
+
+  ~StateBuffer()
+  {
+    for (auto state : mStates)
+      mSpace->freeStateInBuffer(state);
+  }
+
+  void* getState(std::size_t _index)
+  {
+    return reinterpret_cast<unsigned char*>(mBuffer.data())
+           + _index * mSpace->getStateSizeInBytes();
+  }
+
+  StateSpacePtr mSpace;
+  std::vector<double> mBuffer;
+  std::vector<StateSpace::State*> mStates;
+};
+
+/// Checks that both batch functions match pairwise distances.
+void checkBatch(
+    const DistanceMetric& _metric,
+    const StateSpace::State* _query,
+    StateBuffer& _states)
+{
+  std::vector<const StateSpace::State*> states(
+      _states.mStates.begin(), _states.mStates.end());
+
+  std::vector<double> distances(NUM_STATES);
+  std::vector<double> bufferDistances(NUM_STATES);
+  _metric.distanceBatch(_query, states.data(), NUM_STATES, distances.data());
+  _metric.distanceBatchInBuffer(
+      _query, _states.mBuffer.data(), NUM_STATES, bufferDistances.data());
+
+  for (std::size_t i = 0; i < NUM_STATES; ++i)
+  {
+    const double expected = _metric.distance(_query, states[i]);
+    EXPECT_NEAR(expected, distances[i], 1e-12);
+    EXPECT_NEAR(expected, bufferDistances[i], 1e-12);
+  }
+}
+
+} // namespace
+
+//==============================================================================
+TEST(DistanceBatch, RnEuclidean)
+{
+  auto space = std::make_shared<Rn>(4);
+  RnEuclidean metric(space);
+
+  StateBuffer states(space);
+  for (std::size_t i = 0; i < NUM_STATES; ++i)
+  {
+    space->setValue(
+        static_cast<Rn::State*>(states.mStates[i]), Eigen::Vector4d::Random());
+  }
+
+  auto query = space->createState();
+  query.setValue(Eigen::Vector4d::Random());
+
+  checkBatch(metric, query, states);
+}
+
+//==============================================================================
+TEST(DistanceBatch, SO2Angular)
+{
+  auto space = std::make_shared<SO2>();
+  SO2Angular metric(space);
+
+  StateBuffer states(space);
+  for (std::size_t i = 0; i < NUM_STATES; ++i)
+  {
+    space->setAngle(
+        static_cast<SO2::State*>(states.mStates[i]), 2. * i - 15.);
+  }
+
+  auto query = space->createState();
+  query.setAngle(0.3);
+
+  checkBatch(metric, query, states);
+}
+
+//==============================================================================
+TEST(DistanceBatch, SO3Angular)
+{
+  auto space = std::make_shared<SO3>();
+  SO3Angular metric(space);
+
+  StateBuffer states(space);
+  for (std::size_t i = 0; i < NUM_STATES; ++i)
+  {
+    space->setQuaternion(
+        static_cast<SO3::State*>(states.mStates[i]),
+        Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized());
+  }
+
+  auto query = space->createState();
+  query.setQuaternion(
+      Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized());
+
+  checkBatch(metric, query, states);
+}
+
+//==============================================================================
+TEST(DistanceBatch, SE2Weighted)
+{
+  auto space = std::make_shared<SE2>();
+  SE2Weighted metric(space, Eigen::Vector2d(2., 0.5));
+
+  StateBuffer states(space);
+  for (std::size_t i = 0; i < NUM_STATES; ++i)
+  {
+    SE2::State::Isometry2d pose = SE2::State::Isometry2d::Identity();
+    pose.rotate(Eigen::Rotation2Dd(0.4 * i - 3.));
+    pose.pretranslate(Eigen::Vector2d::Random());
+    space->setIsometry(static_cast<SE2::State*>(states.mStates[i]), pose);
+  }
+
+  auto query = space->createState();
+  SE2::State::Isometry2d pose = SE2::State::Isometry2d::Identity();
+  pose.rotate(Eigen::Rotation2Dd(2.5));
+  query.setIsometry(pose);
+
+  checkBatch(metric, query, states);
+}
+
+//==============================================================================
+TEST(DistanceBatch, CartesianProductWeighted)
+{
+  auto so2 = std::make_shared<SO2>();
+  auto rv3 = std::make_shared<R3>();
+  auto r1 = std::make_shared<R1>();
+  auto so3 = std::make_shared<SO3>();
+
+  auto flatSpace = std::make_shared<CartesianProduct>(
+      std::vector<StateSpacePtr>{so2, rv3, r1});
+  CartesianProductWeighted flatMetric(
+      flatSpace,
+      {std::make_pair(std::make_shared<SO2Angular>(so2), 2.),
+       std::make_pair(std::make_shared<R3Euclidean>(rv3), 3.),
+       std::make_pair(std::make_shared<R1Euclidean>(r1), 0.5)});
+  ASSERT_TRUE(flatMetric.isFlattened());
+
+  auto mixedSpace = std::make_shared<CartesianProduct>(
+      std::vector<StateSpacePtr>{so2, so3});
+  CartesianProductWeighted mixedMetric(
+      mixedSpace,
+      {std::make_pair(std::make_shared<SO2Angular>(so2), 2.),
+       std::make_pair(std::make_shared<SO3Angular>(so3), 3.)});
+  ASSERT_FALSE(mixedMetric.isFlattened());
+
+  for (auto metric : {&flatMetric, &mixedMetric})
+  {
+    auto space = std::dynamic_pointer_cast<CartesianProduct>(
+        metric->getStateSpace());
+
+    StateBuffer states(space);
+    Eigen::VectorXd tangent(space->getDimension());
+    for (std::size_t i = 0; i < NUM_STATES; ++i)
+    {
+      tangent.setRandom();
+      space->expMap(4. * tangent, states.mStates[i]);
+    }
+
+    auto query = space->createState();
+    tangent.setRandom();
+    space->expMap(tangent, query);
+
+    checkBatch(*metric, query, states);
+  }
+}
+
+//==============================================================================
+TEST(DistanceBatch, FindKNearest)
+{
+  auto space = std::make_shared<SO2>();
+  SO2Angular metric(space);
+
+  const std::vector<double> angles = {3., 0.5, -0.2, 0.2, 2. * M_PI + 0.1};
+  std::vector<SO2::ScopedState> states;
+  std::vector<const StateSpace::State*> statePointers;
+  for (const auto angle : angles)
+  {
+    states.emplace_back(space->createState());
+    states.back().setAngle(angle);
+  }
+  for (const auto& state : states)
+    statePointers.push_back(state);
+
+  auto query = space->createState();
+  query.setAngle(0.);
+
+  std::vector<double> distances;
+  const auto nearest = findKNearest(
+      metric, query, statePointers.data(), states.size(), 3, &distances);
+
+  ASSERT_EQ(3u, nearest.size());
+  EXPECT_EQ(4u, nearest[0]);
+  EXPECT_EQ(2u, nearest[1]);
+  EXPECT_EQ(3u, nearest[2]);
+  ASSERT_EQ(3u, distances.size());
+  EXPECT_NEAR(0.1, distances[0], 1e-12);
+  EXPECT_DOUBLE_EQ(0.2, distances[1]);
+  EXPECT_DOUBLE_EQ(0.2, distances[2]);
+
+  EXPECT_EQ(
+      states.size(),
+      findKNearest(metric, query, statePointers.data(), states.size(), 10)
+          .size());
+}
@@ -0,0 +1,223 @@
+#include <aikido/distance/CartesianProductWeighted.hpp>
+#include <aikido/distance/GNATNearestNeighbors.hpp>
+#include <aikido/distance/KdTreeNearestNeighbors.hpp>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/distance/SE2Weighted.hpp>
+#include <aikido/distance/SO2Angular.hpp>
+#include <aikido/distance/SO3Angular.hpp>
+#include <aikido/statespace/CartesianProduct.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace aikido::distance;
+using namespace aikido::statespace;
+
+namespace {
+
+constexpr std::size_t NUM_STATES = 500;
+constexpr std::size_t NUM_QUERIES = 20;
+
+/// Owns states sampled from a space with expMap.
+class RandomStates
+{
+public:
+  RandomStates(StateSpacePtr _space, std::size_t _numStates, double _scale)
+    : mSpace(std::move(_space))
+  {
+    Eigen::VectorXd tangent(mSpace->getDimension());
+    for (std::size_t i = 0; i < _numStates; ++i)
+    {
+      tangent.setRandom();
+      auto state = mSpace->allocateState();
+      mSpace->expMap(_scale * tangent, state);
+      mStates.push_back(state);
+    }
+  }
+
+  ~RandomStates()
+  {
+    for (auto state : mStates)
+      mSpace->freeState(const_cast<StateSpace::State*>(state));
+  }
+
+  StateSpacePtr mSpace;
+  std::vector<const StateSpace::State*> mStates;
+};
+
+/// Checks all queries of _index against brute force search.
+void checkAgainstBruteForce(
+    NearestNeighbors& _index, const RandomStates& _states)
+{
+  const auto metric = _index.getDistanceMetric();
+  const auto space = metric->getStateSpace();
+
+  for (const auto state : _states.mStates)
+    _index.add(state);
+  ASSERT_EQ(_states.mStates.size(), _index.size());
+
+  RandomStates queries(space, NUM_QUERIES, 4.);
+  for (const auto query : queries.mStates)
+  {
+    std::vector<double> distances;
+    const auto expected = findKNearest(
+        *metric,
+        query,
+        _states.mStates.data(),
+        _states.mStates.size(),
+        _states.mStates.size(),
+        &distances);
+
+    const auto nearest = _index.nearest(query);
+    EXPECT_EQ(expected[0], nearest.first);
+    EXPECT_NEAR(distances[0], nearest.second, 1e-9);
+
+    const auto nearestK = _index.nearestK(query, 10);
+    ASSERT_EQ(10u, nearestK.size());
+    for (std::size_t i = 0; i < nearestK.size(); ++i)
+    {
+      EXPECT_EQ(expected[i], nearestK[i].first);
+      EXPECT_NEAR(distances[i], nearestK[i].second, 1e-9);
+    }
+
+    // Stay clear of rounding differences at the boundary.
+    const double radius = 0.5 * (distances[25] + distances[26]);
+    const auto nearestR = _index.nearestR(query, radius);
+    ASSERT_EQ(26u, nearestR.size());
+    for (std::size_t i = 0; i < nearestR.size(); ++i)
+      EXPECT_EQ(expected[i], nearestR[i].first);
+  }
+}
+
+} // namespace
+
+//==============================================================================
+TEST(NearestNeighbors, KdTreeRnEuclidean)
+{
+  auto space = std::make_shared<R3>();
+  KdTreeNearestNeighbors index(std::make_shared<R3Euclidean>(space));
+
+  checkAgainstBruteForce(index, RandomStates(space, NUM_STATES, 1.));
+}
+
+//==============================================================================
+TEST(NearestNeighbors, KdTreeSO2Angular)
+{
+  auto space = std::make_shared<SO2>();
+  KdTreeNearestNeighbors index(std::make_shared<SO2Angular>(space));
+
+  // Angles are spread over several turns, so many neighbors are only close
+  // across the +/- pi boundary.
+  checkAgainstBruteForce(index, RandomStates(space, NUM_STATES, 10.));
+}
+
+//==============================================================================
+TEST(NearestNeighbors, KdTreeCartesianProductWeighted)
+{
+  auto so2 = std::make_shared<SO2>();
+  auto r2 = std::make_shared<R2>();
+  auto space = std::make_shared<CartesianProduct>(
+      std::vector<StateSpacePtr>{so2, r2, so2});
+
+  auto metric = std::make_shared<CartesianProductWeighted>(
+      space,
+      std::vector<std::pair<DistanceMetricPtr, double>>{
+          std::make_pair(std::make_shared<SO2Angular>(so2), 2.),
+          std::make_pair(std::make_shared<R2Euclidean>(r2), 1.),
+          std::make_pair(std::make_shared<SO2Angular>(so2), 0.5)});
+  ASSERT_TRUE(KdTreeNearestNeighbors::isSupported(*metric));
+
+  KdTreeNearestNeighbors index(metric);
+  checkAgainstBruteForce(index, RandomStates(space, NUM_STATES, 4.));
+}
+
+//==============================================================================
+TEST(NearestNeighbors, KdTreeDuplicateStates)
+{
+  auto space = std::make_shared<R2>();
+  KdTreeNearestNeighbors index(std::make_shared<R2Euclidean>(space));
+
+  auto state = space->createState();
+  state.setValue(Eigen::Vector2d(1., 2.));
+  for (std::size_t i = 0; i < 100; ++i)
+    index.add(state);
+
+  const auto neighbors = index.nearestK(state, 3);
+  ASSERT_EQ(3u, neighbors.size());
+  for (std::size_t i = 0; i < neighbors.size(); ++i)
+  {
+    EXPECT_EQ(i, neighbors[i].first);
+    EXPECT_DOUBLE_EQ(0., neighbors[i].second);
+  }
+}
+
+//==============================================================================
+TEST(NearestNeighbors, KdTreeThrowsOnUnsupportedMetric)
+{
+  auto space = std::make_shared<SO3>();
+  auto metric = std::make_shared<SO3Angular>(space);
+
+  EXPECT_FALSE(KdTreeNearestNeighbors::isSupported(*metric));
+  EXPECT_THROW(KdTreeNearestNeighbors index(metric), std::invalid_argument);
+  EXPECT_THROW(KdTreeNearestNeighbors index(nullptr), std::invalid_argument);
+}
+
+//==============================================================================
+TEST(NearestNeighbors, GNATSO3Angular)
+{
+  auto space = std::make_shared<SO3>();
+  GNATNearestNeighbors index(std::make_shared<SO3Angular>(space));
+
+  checkAgainstBruteForce(index, RandomStates(space, NUM_STATES, 2.));
+}
+
+//==============================================================================
+TEST(NearestNeighbors, GNATSE2Weighted)
+{
+  auto space = std::make_shared<SE2>();
+  GNATNearestNeighbors index(
+      std::make_shared<SE2Weighted>(space, Eigen::Vector2d(2., 0.5)), 4, 8);
+
+  checkAgainstBruteForce(index, RandomStates(space, NUM_STATES, 3.));
+}
+
+//==============================================================================
+TEST(NearestNeighbors, GNATThrowsOnInvalidArguments)
+{
+  auto metric = std::make_shared<SO2Angular>(std::make_shared<SO2>());
+
+  EXPECT_THROW(GNATNearestNeighbors(nullptr), std::invalid_argument);
+  EXPECT_THROW(GNATNearestNeighbors(metric, 1), std::invalid_argument);
+  EXPECT_THROW(GNATNearestNeighbors(metric, 8, 4), std::invalid_argument);
+}
+
+//==============================================================================
+TEST(NearestNeighbors, EmptyIndex)
+{
+  auto space = std::make_shared<SO2>();
+  auto index = createNearestNeighbors(std::make_shared<SO2Angular>(space));
+
+  auto query = space->createState();
+  EXPECT_THROW(index->nearest(query), std::runtime_error);
+  EXPECT_TRUE(index->nearestK(query, 5).empty());
+  EXPECT_TRUE(index->nearestR(query, 10.).empty());
+
+  index->add(query);
+  index->clear();
+  EXPECT_EQ(0u, index->size());
+  EXPECT_THROW(index->nearest(query), std::runtime_error);
+}
+
+//==============================================================================
+TEST(NearestNeighbors, CreateNearestNeighbors)
+{
+  auto so2 = std::make_shared<SO2>();
+  auto so3 = std::make_shared<SO3>();
+
+  auto kdTree = createNearestNeighbors(std::make_shared<SO2Angular>(so2));
+  EXPECT_TRUE(dynamic_cast<KdTreeNearestNeighbors*>(kdTree.get()));
+
+  auto gnat = createNearestNeighbors(std::make_shared<SO3Angular>(so3));
+  EXPECT_TRUE(dynamic_cast<GNATNearestNeighbors*>(gnat.get()));
+
+  EXPECT_THROW(createNearestNeighbors(nullptr), std::invalid_argument);
+}
@@ -0,0 +1,198 @@
+#include <aikido/distance/KdTreeNearestNeighbors.hpp>
+#include <aikido/distance/RandomizedKdForestNearestNeighbors.hpp>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/distance/SO3Angular.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace aikido::distance;
+using namespace aikido::statespace;
+
+namespace {
+
+/// Owns states sampled from a space with expMap.
+class RandomStates
+{
+public:
+  RandomStates(StateSpacePtr _space, std::size_t _numStates)
+    : mSpace(std::move(_space))
+  {
+    Eigen::VectorXd tangent(mSpace->getDimension());
+    for (std::size_t i = 0; i < _numStates; ++i)
+    {
+      tangent.setRandom();
+      auto state = mSpace->allocateState();
+      mSpace->expMap(tangent, state);
+      mStates.push_back(state);
+    }
+  }
+
+  ~RandomStates()
+  {
+    for (auto state : mStates)
+      mSpace->freeState(const_cast<StateSpace::State*>(state));
+  }
+
+  StateSpacePtr mSpace;
+  std::vector<const StateSpace::State*> mStates;
+};
+
+/// Returns the fraction of _expected that is contained in _actual.
+double computeRecall(
+    const std::vector<NearestNeighbors::Neighbor>& _expected,
+    const std::vector<NearestNeighbors::Neighbor>& _actual)
+{
+  std::size_t numFound = 0;
+  for (const auto& expected : _expected)
+  {
+    for (const auto& actual : _actual)
+    {
+      if (actual.first == expected.first)
+      {
+        ++numFound;
+        break;
+      }
+    }
+  }
+  return static_cast<double>(numFound) / _expected.size();
+}
+
+} // namespace
+
+//==============================================================================
+TEST(RandomizedKdForestNearestNeighbors, ThrowsOnInvalidArguments)
+{
+  auto metric = std::make_shared<R3Euclidean>(std::make_shared<R3>());
+
+  EXPECT_THROW(
+      RandomizedKdForestNearestNeighbors(nullptr), std::invalid_argument);
+  EXPECT_THROW(
+      RandomizedKdForestNearestNeighbors(metric, 0), std::invalid_argument);
+  EXPECT_THROW(
+      RandomizedKdForestNearestNeighbors(metric, 4, 0), std::invalid_argument);
+
+  RandomizedKdForestNearestNeighbors index(metric);
+  EXPECT_THROW(index.setMaxChecks(0), std::invalid_argument);
+}
+
+//==============================================================================
+TEST(RandomizedKdForestNearestNeighbors, ExactWithEnoughChecks)
+{
+  auto space = std::make_shared<R3>();
+  auto metric = std::make_shared<R3Euclidean>(space);
+  RandomStates states(space, 3000);
+  RandomStates queries(space, 20);
+
+  RandomizedKdForestNearestNeighbors index(metric, 4, states.mStates.size());
+  KdTreeNearestNeighbors exact(metric);
+  for (const auto state : states.mStates)
+  {
+    index.add(state);
+    exact.add(state);
+  }
+  EXPECT_EQ(states.mStates.size(), index.size());
+
+  for (const auto query : queries.mStates)
+  {
+    const auto expected = exact.nearestK(query, 5);
+    const auto actual = index.nearestK(query, 5);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      EXPECT_EQ(expected[i].first, actual[i].first);
+      EXPECT_DOUBLE_EQ(expected[i].second, actual[i].second);
+    }
+
+    EXPECT_EQ(expected[0].first, index.nearest(query).first);
+    EXPECT_EQ(
+        exact.nearestR(query, 0.3).size(), index.nearestR(query, 0.3).size());
+  }
+}
+
+//==============================================================================
+TEST(RandomizedKdForestNearestNeighbors, RecallImprovesWithChecks)
+{
+  auto space = std::make_shared<SO3>();
+  auto metric = std::make_shared<SO3Angular>(space);
+  RandomStates states(space, 5000);
+  RandomStates queries(space, 50);
+
+  RandomizedKdForestNearestNeighbors index(metric, 4, 1);
+  for (const auto state : states.mStates)
+    index.add(state);
+  index.build();
+
+  std::vector<std::vector<NearestNeighbors::Neighbor>> expected;
+  for (const auto query : queries.mStates)
+  {
+    std::vector<double> distances;
+    const auto indices = findKNearest(
+        *metric,
+        query,
+        states.mStates.data(),
+        states.mStates.size(),
+        10,
+        &distances);
+
+    expected.emplace_back();
+    for (std::size_t i = 0; i < indices.size(); ++i)
+      expected.back().emplace_back(indices[i], distances[i]);
+  }
+
+  double previousRecall = 0.;
+  for (const std::size_t maxChecks : {16, 128, 1024})
+  {
+    index.setMaxChecks(maxChecks);
+    EXPECT_EQ(maxChecks, index.getMaxChecks());
+
+    double recall = 0.;
+    for (std::size_t i = 0; i < queries.mStates.size(); ++i)
+    {
+      recall += computeRecall(
+          expected[i], index.nearestK(queries.mStates[i], 10));
+    }
+    recall /= queries.mStates.size();
+
+    EXPECT_GE(recall, previousRecall);
+    previousRecall = recall;
+  }
+  EXPECT_GT(previousRecall, 0.9);
+}
+
+//==============================================================================
+TEST(RandomizedKdForestNearestNeighbors, BatchMatchesSingleQueries)
+{
+  auto space = std::make_shared<R3>();
+  auto metric = std::make_shared<R3Euclidean>(space);
+  RandomStates states(space, 2000);
+  RandomStates queries(space, 33);
+
+  RandomizedKdForestNearestNeighbors index(metric, 2, 64, 4);
+  for (const auto state : states.mStates)
+    index.add(state);
+
+  const auto batch
+      = index.nearestKBatch(queries.mStates.data(), queries.mStates.size(), 3);
+  ASSERT_EQ(queries.mStates.size(), batch.size());
+  for (std::size_t i = 0; i < queries.mStates.size(); ++i)
+    EXPECT_EQ(index.nearestK(queries.mStates[i], 3), batch[i]);
+}
+
+//==============================================================================
+TEST(RandomizedKdForestNearestNeighbors, EmptyIndex)
+{
+  auto space = std::make_shared<R3>();
+  RandomizedKdForestNearestNeighbors index(
+      std::make_shared<R3Euclidean>(space));
+
+  auto query = space->createState();
+  EXPECT_THROW(index.nearest(query), std::runtime_error);
+  EXPECT_TRUE(index.nearestK(query, 3).empty());
+
+  index.add(query);
+  EXPECT_EQ(0u, index.nearest(query).first);
+
+  index.clear();
+  EXPECT_EQ(0u, index.size());
+  EXPECT_THROW(index.nearest(query), std::runtime_error);
+}
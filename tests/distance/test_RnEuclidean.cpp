@@ -64,3 +64,17 @@ TEST(REuclidean, DistanceRx)
   RnEuclidean dmetric(rvss);
   EXPECT_DOUBLE_EQ(std::sqrt(84), dmetric.distance(state1, state2));
 }
+
+//==============================================================================
+TEST(REuclidean, DistanceSquaredRx)
+{
+  auto rvss = std::make_shared<Rn>(3);
+  RnEuclidean dmetric(rvss);
+
+  auto state1 = rvss->createState();
+  auto state2 = rvss->createState();
+  state1.setValue(Eigen::Vector3d(1, 2, 3));
+  state2.setValue(Eigen::Vector3d(2, 4, 5));
+
+  EXPECT_DOUBLE_EQ(9., dmetric.distanceSquared(state1, state2));
+}
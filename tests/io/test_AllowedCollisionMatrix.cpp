@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <aikido/io/AllowedCollisionMatrix.hpp>
+
+using aikido::constraint::AllowedCollisionMatrix;
+using aikido::constraint::CollisionPairType;
+
+//==============================================================================
+TEST(AllowedCollisionMatrixYaml, RoundTrip)
+{
+  AllowedCollisionMatrix matrix;
+  matrix.setPairType("link1", "link2", CollisionPairType::ADJACENT);
+  matrix.setPairType("link1", "link3", CollisionPairType::NEVER);
+  matrix.setPairType("link2", "link3", CollisionPairType::SOMETIMES);
+  matrix.setPairType("link3", "link4", CollisionPairType::ALWAYS);
+
+  std::stringstream stream;
+  stream << YAML::Node(matrix);
+
+  const auto loaded = YAML::Load(stream.str()).as<AllowedCollisionMatrix>();
+  EXPECT_EQ(4u, loaded.getNumPairs());
+  EXPECT_EQ(CollisionPairType::ADJACENT, loaded.getPairType("link2", "link1"));
+  EXPECT_EQ(CollisionPairType::NEVER, loaded.getPairType("link1", "link3"));
+  EXPECT_EQ(CollisionPairType::SOMETIMES, loaded.getPairType("link2", "link3"));
+  EXPECT_EQ(CollisionPairType::ALWAYS, loaded.getPairType("link3", "link4"));
+}
+
+//==============================================================================
+TEST(AllowedCollisionMatrixYaml, Load)
+{
+  const std::string yaml
+      = "never: [[link1, link3]]\n"
+        "adjacent: [[link2, link1], [link2, link3]]\n";
+
+  const auto matrix = YAML::Load(yaml).as<AllowedCollisionMatrix>();
+  EXPECT_EQ(3u, matrix.getNumPairs());
+  EXPECT_EQ(CollisionPairType::NEVER, matrix.getPairType("link1", "link3"));
+  EXPECT_EQ(CollisionPairType::ADJACENT, matrix.getPairType("link1", "link2"));
+  EXPECT_EQ(CollisionPairType::ADJACENT, matrix.getPairType("link3", "link2"));
+}
+
+//==============================================================================
+TEST(AllowedCollisionMatrixYaml, Validity)
+{
+  EXPECT_THROW(
+      YAML::Load("[link1, link2]").as<AllowedCollisionMatrix>(),
+      YAML::RepresentationException);
+  EXPECT_THROW(
+      YAML::Load("unknown: [[link1, link2]]").as<AllowedCollisionMatrix>(),
+      YAML::RepresentationException);
+  EXPECT_THROW(
+      YAML::Load("never: [[link1, link2, link3]]").as<AllowedCollisionMatrix>(),
+      YAML::RepresentationException);
+  EXPECT_THROW(
+      YAML::Load("never: [[link1, link1]]").as<AllowedCollisionMatrix>(),
+      YAML::RepresentationException);
+}
@@ -0,0 +1,167 @@
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <ompl/geometric/planners/rrt/RRTConnect.h>
+#include <ompl/geometric/planners/rrt/RRTstar.h>
+#include <aikido/planner/ompl/AnytimePlanner.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+#include "../../constraint/MockConstraints.hpp"
+#include "OMPLTestHelpers.hpp"
+
+using aikido::planner::ompl::AnytimePlanner;
+using aikido::planner::ompl::ompl_make_shared;
+
+class AnytimePlannerTest : public PlannerTest
+{
+public:
+  void SetUp() override
+  {
+    PlannerTest::SetUp();
+
+    si = aikido::planner::ompl::getSpaceInformation(
+        stateSpace,
+        interpolator,
+        dmetric,
+        sampler,
+        collConstraint,
+        boundsConstraint,
+        boundsProjection,
+        0.1);
+    pdef = ompl_make_shared<::ompl::base::ProblemDefinition>(si);
+  }
+
+  /// Sets the start and goal of the ProblemDefinition.
+  void setStartAndGoal(
+      const Eigen::Vector3d& _startPose, const Eigen::Vector3d& _goalPose)
+  {
+    auto start = si->allocState();
+    setTranslationalState(_startPose, stateSpace, start);
+    auto goal = si->allocState();
+    setTranslationalState(_goalPose, stateSpace, goal);
+    pdef->setStartAndGoalStates(start, goal);
+    si->freeState(start);
+    si->freeState(goal);
+  }
+
+  /// Returns an AnytimePlanner that records the reported costs.
+  std::unique_ptr<AnytimePlanner> createPlanner(
+      const ::ompl::base::PlannerPtr& _planner)
+  {
+    return std::unique_ptr<AnytimePlanner>(new AnytimePlanner(
+        _planner,
+        pdef,
+        stateSpace,
+        interpolator,
+        [this](aikido::trajectory::InterpolatedPtr _trajectory, double _cost) {
+          EXPECT_NE(nullptr, _trajectory);
+          std::lock_guard<std::mutex> lock(mutex);
+          costs.push_back(_cost);
+        }));
+  }
+
+  ::ompl::base::SpaceInformationPtr si;
+  ::ompl::base::ProblemDefinitionPtr pdef;
+
+  std::mutex mutex;
+  std::vector<double> costs;
+};
+
+TEST_F(AnytimePlannerTest, ConstructorThrowsOnInvalidArguments)
+{
+  auto planner = ompl_make_shared<::ompl::geometric::RRTstar>(si);
+  EXPECT_THROW(
+      AnytimePlanner(nullptr, pdef, stateSpace, interpolator),
+      std::invalid_argument);
+  EXPECT_THROW(
+      AnytimePlanner(planner, nullptr, stateSpace, interpolator),
+      std::invalid_argument);
+  EXPECT_THROW(
+      AnytimePlanner(planner, pdef, nullptr, interpolator),
+      std::invalid_argument);
+  EXPECT_THROW(
+      AnytimePlanner(planner, pdef, stateSpace, nullptr),
+      std::invalid_argument);
+  EXPECT_THROW(
+      AnytimePlanner(
+          planner,
+          pdef,
+          stateSpace,
+          interpolator,
+          AnytimePlanner::SolutionCallback(),
+          0.),
+      std::invalid_argument);
+}
+
+TEST_F(AnytimePlannerTest, StreamsImprovingSolutions)
+{
+  const Eigen::Vector3d startPose(-5, -5, 0);
+  const Eigen::Vector3d goalPose(5, 5, 0);
+  setStartAndGoal(startPose, goalPose);
+
+  auto planner
+      = createPlanner(ompl_make_shared<::ompl::geometric::RRTstar>(si));
+  planner->start(2.0);
+  EXPECT_THROW(planner->start(2.0), std::runtime_error);
+
+  double cost;
+  auto traj = planner->wait(&cost);
+  EXPECT_FALSE(planner->isRunning());
+  ASSERT_NE(nullptr, traj);
+
+  ASSERT_FALSE(costs.empty());
+  for (std::size_t i = 1; i < costs.size(); ++i)
+    EXPECT_LT(costs[i], costs[i - 1]);
+  EXPECT_DOUBLE_EQ(costs.back(), cost);
+
+  auto state = stateSpace->createState();
+  traj->evaluate(0, state);
+  EXPECT_TRUE(state.getSubStateHandle<R3>(0).getValue().isApprox(startPose));
+  traj->evaluate(traj->getEndTime(), state);
+  EXPECT_TRUE(state.getSubStateHandle<R3>(0).getValue().isApprox(goalPose));
+}
+
+TEST_F(AnytimePlannerTest, CancelStopsPlanning)
+{
+  setStartAndGoal(Eigen::Vector3d(-5, -5, 0), Eigen::Vector3d(5, 5, 0));
+
+  auto planner
+      = createPlanner(ompl_make_shared<::ompl::geometric::RRTstar>(si));
+  const auto startTime = std::chrono::steady_clock::now();
+  planner->start(60.0);
+  EXPECT_TRUE(planner->isRunning());
+  planner->cancel();
+  planner->wait();
+
+  EXPECT_FALSE(planner->isRunning());
+  EXPECT_LT(
+      std::chrono::steady_clock::now() - startTime, std::chrono::seconds(5));
+}
+
+TEST_F(AnytimePlannerTest, StopsAfterFirstSolutionOfNonOptimizingPlanner)
+{
+  setStartAndGoal(Eigen::Vector3d(-5, -5, 0), Eigen::Vector3d(5, 5, 0));
+
+  auto planner
+      = createPlanner(ompl_make_shared<::ompl::geometric::RRTConnect>(si));
+  const auto startTime = std::chrono::steady_clock::now();
+  planner->start(60.0);
+
+  EXPECT_NE(nullptr, planner->wait());
+  EXPECT_EQ(1u, costs.size());
+  EXPECT_LT(
+      std::chrono::steady_clock::now() - startTime, std::chrono::seconds(5));
+}
+
+TEST_F(AnytimePlannerTest, ReturnsNullptrForInvalidStart)
+{
+  // The start is in collision.
+  setStartAndGoal(Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(5, 5, 0));
+
+  auto planner
+      = createPlanner(ompl_make_shared<::ompl::geometric::RRTstar>(si));
+  planner->start(1.0);
+
+  EXPECT_EQ(nullptr, planner->wait());
+  EXPECT_TRUE(costs.empty());
+}
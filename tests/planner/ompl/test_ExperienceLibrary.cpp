@@ -0,0 +1,256 @@
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+#include <ompl/geometric/planners/rrt/RRTConnect.h>
+#include <aikido/planner/ompl/ExperienceLibrary.hpp>
+#include "../../constraint/MockConstraints.hpp"
+#include "OMPLTestHelpers.hpp"
+
+using aikido::planner::PlanningResult;
+using aikido::planner::ompl::ExperienceLibrary;
+using aikido::planner::ompl::planOMPLWithExperience;
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+
+class ExperienceLibraryTest : public PlannerTest
+{
+public:
+  void SetUp() override
+  {
+    PlannerTest::SetUp();
+    library = std::make_shared<ExperienceLibrary>(
+        stateSpace, interpolator, dmetric);
+  }
+
+  MetaSkeletonStateSpace::ScopedState createState(double _x, double _y)
+  {
+    auto state = stateSpace->createState();
+    stateSpace->getSubStateHandle<R3>(state, 0).setValue(
+        Eigen::Vector3d(_x, _y, 0));
+    return state;
+  }
+
+  /// Creates a path through the given (x, y) positions.
+  aikido::trajectory::InterpolatedPtr createPath(
+      const std::vector<Eigen::Vector2d>& _positions)
+  {
+    auto path = std::make_shared<aikido::trajectory::Interpolated>(
+        stateSpace, interpolator);
+    for (std::size_t i = 0; i < _positions.size(); ++i)
+      path->addWaypoint(i, createState(_positions[i][0], _positions[i][1]));
+    return path;
+  }
+
+  aikido::trajectory::InterpolatedPtr plan(
+      const Eigen::Vector2d& _start,
+      const Eigen::Vector2d& _goal,
+      PlanningResult* _result)
+  {
+    auto start = createState(_start[0], _start[1]);
+    auto goal = createState(_goal[0], _goal[1]);
+    return planOMPLWithExperience<ompl::geometric::RRTConnect>(
+        *library,
+        start,
+        goal,
+        sampler,
+        collConstraint,
+        boundsConstraint,
+        boundsProjection,
+        1.0,
+        5.0,
+        0.1,
+        3,
+        _result);
+  }
+
+  /// Checks that _path is valid and goes from _start to _goal.
+  void checkPath(
+      const aikido::trajectory::InterpolatedPtr& _path,
+      const Eigen::Vector2d& _start,
+      const Eigen::Vector2d& _goal)
+  {
+    ASSERT_NE(nullptr, _path);
+
+    auto state = stateSpace->createState();
+    _path->evaluate(_path->getStartTime(), state);
+    EXPECT_TRUE(
+        state.getSubStateHandle<R3>(0).getValue().head<2>().isApprox(_start));
+    _path->evaluate(_path->getEndTime(), state);
+    EXPECT_TRUE(
+        state.getSubStateHandle<R3>(0).getValue().head<2>().isApprox(_goal));
+
+    for (double t = _path->getStartTime(); t < _path->getEndTime(); t += 0.01)
+    {
+      _path->evaluate(t, state);
+      EXPECT_TRUE(collConstraint->isSatisfied(state));
+    }
+  }
+
+  std::shared_ptr<ExperienceLibrary> library;
+};
+
+TEST_F(ExperienceLibraryTest, ThrowsOnInvalidArguments)
+{
+  EXPECT_THROW(
+      ExperienceLibrary(nullptr, interpolator, dmetric),
+      std::invalid_argument);
+  EXPECT_THROW(
+      ExperienceLibrary(stateSpace, interpolator, dmetric, 0),
+      std::invalid_argument);
+  EXPECT_THROW(library->setCapacity(0), std::invalid_argument);
+  EXPECT_THROW(
+      library->addPath(*createPath({Eigen::Vector2d(1, 1)})),
+      std::invalid_argument);
+}
+
+TEST_F(ExperienceLibraryTest, ReusesPlannedPath)
+{
+  const Eigen::Vector2d start(-4, -4);
+  const Eigen::Vector2d goal(4, 4);
+
+  PlanningResult result;
+  checkPath(plan(start, goal, &result), start, goal);
+  EXPECT_EQ("Planned from scratch", result.message);
+  EXPECT_EQ(1u, library->size());
+
+  checkPath(plan(start, goal, &result), start, goal);
+  EXPECT_EQ("Reused stored path", result.message);
+  EXPECT_EQ(1u, library->size());
+
+  // A nearby query reuses the path with new endpoints.
+  const Eigen::Vector2d nearbyGoal(4, 4.2);
+  checkPath(plan(start, nearbyGoal, &result), start, nearbyGoal);
+  EXPECT_EQ("Reused stored path", result.message);
+}
+
+TEST_F(ExperienceLibraryTest, RepairsInvalidSegments)
+{
+  // The middle segment crosses the obstacle at the origin.
+  library->addPath(*createPath({Eigen::Vector2d(-4, -4),
+                                Eigen::Vector2d(-1, -1),
+                                Eigen::Vector2d(1, 1),
+                                Eigen::Vector2d(4, 4)}));
+
+  const Eigen::Vector2d start(-4, -4);
+  const Eigen::Vector2d goal(4, 4);
+
+  PlanningResult result;
+  checkPath(plan(start, goal, &result), start, goal);
+  EXPECT_EQ("Repaired stored path with 1 local plans", result.message);
+  EXPECT_EQ(2u, library->size());
+
+  // The repaired path is preferred by the next query.
+  checkPath(plan(start, goal, &result), start, goal);
+  EXPECT_EQ("Reused stored path", result.message);
+}
+
+TEST_F(ExperienceLibraryTest, RetrievesByGoalRegion)
+{
+  library->addPath(*createPath({Eigen::Vector2d(-4, -4),
+                                Eigen::Vector2d(-4, 4)}));
+  library->addPath(*createPath({Eigen::Vector2d(4, -4),
+                                Eigen::Vector2d(4, 4)}));
+
+  // Only the second path ends in the goal region x = 4.
+  auto goalRegion = std::make_shared<MockProjectionConstraint>(
+      stateSpace, sampler, 4);
+  auto start = createState(-4, -4);
+  const auto paths = library->retrieve(start, *goalRegion, 2);
+  ASSERT_EQ(1u, paths.size());
+
+  auto state = stateSpace->createState();
+  paths[0]->evaluate(0, state);
+  EXPECT_TRUE(state.getSubStateHandle<R3>(0).getValue().isApprox(
+      Eigen::Vector3d(4, -4, 0)));
+}
+
+TEST_F(ExperienceLibraryTest, EvictsLeastRecentlyUsedPath)
+{
+  library->setCapacity(2);
+  library->addPath(*createPath({Eigen::Vector2d(-4, -4),
+                                Eigen::Vector2d(-4, 4)}));
+  library->addPath(*createPath({Eigen::Vector2d(4, -4),
+                                Eigen::Vector2d(4, 4)}));
+
+  // Reusing the first path makes the second one the least recently used.
+  PlanningResult result;
+  checkPath(
+      plan(Eigen::Vector2d(-4, -4), Eigen::Vector2d(-4, 4), &result),
+      Eigen::Vector2d(-4, -4),
+      Eigen::Vector2d(-4, 4));
+  EXPECT_EQ("Reused stored path", result.message);
+
+  library->addPath(*createPath({Eigen::Vector2d(-4, 4),
+                                Eigen::Vector2d(4, 4)}));
+  EXPECT_EQ(2u, library->size());
+
+  auto start = createState(4, -4);
+  auto goal = createState(4, 4);
+  for (const auto& path : library->retrieve(start, goal, 2))
+  {
+    auto state = stateSpace->createState();
+    path->evaluate(0, state);
+    EXPECT_FALSE(state.getSubStateHandle<R3>(0).getValue().isApprox(
+        Eigen::Vector3d(4, -4, 0)));
+  }
+}
+
+TEST_F(ExperienceLibraryTest, SavesAndLoadsPaths)
+{
+  const std::string filename = "/tmp/aikido_test_ExperienceLibrary_"
+                               + std::to_string(::getpid()) + ".bin";
+
+  library->addPath(*createPath({Eigen::Vector2d(-4, -4),
+                                Eigen::Vector2d(-4, 4),
+                                Eigen::Vector2d(4, 4)}));
+  library->addPath(*createPath({Eigen::Vector2d(4, -4),
+                                Eigen::Vector2d(4, 4)}));
+  library->save(filename);
+
+  ExperienceLibrary loaded(stateSpace, interpolator, dmetric);
+  loaded.load(filename);
+  std::remove(filename.c_str());
+  ASSERT_EQ(2u, loaded.size());
+
+  auto start = createState(-4, -4);
+  auto goal = createState(4, 4);
+  const auto paths = loaded.retrieve(start, goal, 1);
+  ASSERT_EQ(1u, paths.size());
+  ASSERT_EQ(3u, paths[0]->getNumWaypoints());
+
+  auto state = stateSpace->createState();
+  paths[0]->evaluate(1, state);
+  EXPECT_TRUE(state.getSubStateHandle<R3>(0).getValue().isApprox(
+      Eigen::Vector3d(-4, 4, 0)));
+
+  EXPECT_THROW(loaded.load(filename), std::runtime_error);
+}
+
+TEST_F(ExperienceLibraryTest, LoadThrowsOnPathWithoutTwoWaypoints)
+{
+  const std::string filename = "/tmp/aikido_test_ExperienceLibrary_"
+                               + std::to_string(::getpid()) + ".bin";
+
+  library->addPath(*createPath({Eigen::Vector2d(4, -4),
+                                Eigen::Vector2d(4, 4)}));
+  library->save(filename);
+
+  // Overwrite the number of waypoints of the path, which follows the magic
+  // number, version, dimension and number of paths.
+  {
+    std::fstream file(
+        filename, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(8 + 4 + 4 + 8);
+    const std::uint64_t numWaypoints = 1;
+    file.write(
+        reinterpret_cast<const char*>(&numWaypoints), sizeof(numWaypoints));
+  }
+
+  ExperienceLibrary loaded(stateSpace, interpolator, dmetric);
+  loaded.addPath(*createPath({Eigen::Vector2d(4, -4),
+                              Eigen::Vector2d(4, 4)}));
+  EXPECT_THROW(loaded.load(filename), std::runtime_error);
+  std::remove(filename.c_str());
+
+  // The library is unchanged.
+  EXPECT_EQ(1u, loaded.size());
+}
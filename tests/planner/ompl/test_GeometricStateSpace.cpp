@@ -1,7 +1,20 @@
+#include <cmath>
+#include <aikido/constraint/CartesianProductProjectable.hpp>
+#include <aikido/constraint/CartesianProductSampleable.hpp>
+#include <aikido/constraint/CartesianProductTestable.hpp>
+#include <aikido/constraint/Satisfied.hpp>
+#include <aikido/constraint/uniform/RnBoxConstraint.hpp>
+#include <aikido/constraint/uniform/SO2UniformSampler.hpp>
+#include <aikido/distance/CartesianProductWeighted.hpp>
+#include <aikido/distance/RnEuclidean.hpp>
+#include <aikido/distance/SO2Angular.hpp>
 #include <aikido/planner/ompl/GeometricStateSpace.hpp>
+#include <aikido/statespace/SO2.hpp>
 #include "OMPLTestHelpers.hpp"
 
 using aikido::planner::ompl::GeometricStateSpace;
+using aikido::statespace::R2;
+using aikido::statespace::SO2;
 using StateSpace = aikido::statespace::dart::MetaSkeletonStateSpace;
 
 class GeometricStateSpaceTest : public PlannerTest
@@ -188,15 +201,71 @@ TEST_F(GeometricStateSpaceTest, Dimension)
 
 TEST_F(GeometricStateSpaceTest, GetMaximumExtent)
 {
+  // The robot translates in a 10 x 10 x 0 box.
   constructStateSpace();
-  EXPECT_DOUBLE_EQ(
-      gSpace->getMaximumExtent(), std::numeric_limits<double>::infinity());
+  EXPECT_DOUBLE_EQ(std::sqrt(200.), gSpace->getMaximumExtent());
 }
 
 TEST_F(GeometricStateSpaceTest, GetMeasure)
 {
   constructStateSpace();
-  EXPECT_THROW(gSpace->getMeasure(), std::runtime_error);
+  EXPECT_DOUBLE_EQ(0., gSpace->getMeasure());
+}
+
+TEST_F(GeometricStateSpaceTest, ExtentAndMeasureOfWeightedCartesianProduct)
+{
+  using aikido::distance::DistanceMetricPtr;
+
+  auto r2 = std::make_shared<R2>();
+  auto so2 = std::make_shared<SO2>();
+  auto space = std::make_shared<CartesianProduct>(
+      std::vector<aikido::statespace::StateSpacePtr>{r2, so2});
+  auto box = std::make_shared<aikido::constraint::R2BoxConstraint>(
+      r2, make_rng(), Eigen::Vector2d(0, 0), Eigen::Vector2d(3, 4));
+  auto so2Bounds = std::make_shared<aikido::constraint::Satisfied>(so2);
+  auto metric = std::make_shared<aikido::distance::CartesianProductWeighted>(
+      space,
+      std::vector<std::pair<DistanceMetricPtr, double>>{
+          {std::make_shared<aikido::distance::R2Euclidean>(r2), 1.},
+          {std::make_shared<aikido::distance::SO2Angular>(so2), 2.}});
+
+  GeometricStateSpace gs(
+      space,
+      std::make_shared<aikido::statespace::GeodesicInterpolator>(space),
+      metric,
+      std::make_shared<aikido::constraint::CartesianProductSampleable>(
+          space,
+          std::vector<aikido::constraint::SampleablePtr>{
+              box,
+              std::make_shared<aikido::constraint::SO2UniformSampler>(
+                  so2, make_rng())}),
+      std::make_shared<aikido::constraint::CartesianProductTestable>(
+          space, std::vector<aikido::constraint::TestablePtr>{box, so2Bounds}),
+      std::make_shared<aikido::constraint::CartesianProductProjectable>(
+          space,
+          std::vector<aikido::constraint::ProjectablePtr>{box, so2Bounds}));
+
+  // The diagonal of the box plus twice the largest angle. The SO2 measure
+  // is scaled by its weight.
+  EXPECT_DOUBLE_EQ(5. + 2. * M_PI, gs.getMaximumExtent());
+  EXPECT_DOUBLE_EQ(12. * 2. * 2. * M_PI, gs.getMeasure());
+}
+
+TEST_F(GeometricStateSpaceTest, ExtentAndMeasureOfUnboundedSpace)
+{
+  auto r2 = std::make_shared<R2>();
+  auto bounds = std::make_shared<aikido::constraint::Satisfied>(r2);
+
+  GeometricStateSpace gs(
+      r2,
+      std::make_shared<aikido::statespace::GeodesicInterpolator>(r2),
+      std::make_shared<aikido::distance::R2Euclidean>(r2),
+      std::make_shared<aikido::constraint::R2BoxConstraint>(
+          r2, make_rng(), Eigen::Vector2d(0, 0), Eigen::Vector2d(1, 1)),
+      bounds,
+      bounds);
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), gs.getMaximumExtent());
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), gs.getMeasure());
 }
 
 TEST_F(GeometricStateSpaceTest, EnforceBoundsProjection)
@@ -549,3 +618,31 @@ TEST_F(GeometricStateSpaceTest, DallocNullState)
   constructStateSpace();
   gSpace->freeState(nullptr);
 }
+
+TEST_F(GeometricStateSpaceTest, AllocStateReusesFreedMemory)
+{
+  constructStateSpace();
+
+  std::vector<::ompl::base::State*> states;
+  for (std::size_t i = 0; i < 100; ++i)
+    states.push_back(gSpace->allocState());
+
+  auto last = states.back();
+  auto lastAikidoState = last->as<GeometricStateSpace::StateType>()->mState;
+  gSpace->freeState(last);
+  states.pop_back();
+
+  auto reused = gSpace->allocState();
+  EXPECT_EQ(last, reused);
+  EXPECT_EQ(
+      lastAikidoState, reused->as<GeometricStateSpace::StateType>()->mState);
+  states.push_back(reused);
+
+  // The aikido state of a pooled state can still be freed by the caller.
+  auto first = states.front()->as<GeometricStateSpace::StateType>();
+  stateSpace->freeState(first->mState);
+  first->mState = stateSpace->allocateState();
+
+  for (const auto state : states)
+    gSpace->freeState(state);
+}
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <thread>
 #include <ompl/base/spaces/SO2StateSpace.h>
 #include <aikido/planner/ompl/GoalRegion.hpp>
 #include <aikido/planner/ompl/Planner.hpp>
@@ -30,9 +32,54 @@ public:
         boundsConstraint,
         boundsProjection,
         0.1);
+
+    // Background sampling uses a clone of the robot.
+    backgroundStateSpace = std::make_shared<StateSpace>(robot->clone());
+    backgroundSampler = aikido::constraint::createSampleableBounds(
+        backgroundStateSpace, make_rng());
+  }
+  /// Waits up to a second for _goalRegion to have _numSamples goal states.
+  void waitForSamples(const GoalRegion& _goalRegion, unsigned int _numSamples)
+  {
+    for (int i = 0; i < 1000 && _goalRegion.maxSampleCount() < _numSamples;
+         ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
   }
+
   std::shared_ptr<GeometricStateSpace> gSpace;
   ::ompl::base::SpaceInformationPtr si;
+  std::shared_ptr<StateSpace> backgroundStateSpace;
+  aikido::constraint::SampleablePtr backgroundSampler;
+};
+
+class ThrowingSampleGenerator : public aikido::constraint::SampleGenerator
+{
+public:
+  ThrowingSampleGenerator(aikido::statespace::StateSpacePtr sspace)
+    : mStateSpace(sspace)
+  {
+  }
+
+  aikido::statespace::StateSpacePtr getStateSpace() const override
+  {
+    return mStateSpace;
+  }
+
+  bool sample(aikido::statespace::StateSpace::State* /*_state*/) override
+  {
+    throw std::runtime_error("Sampling failed.");
+  }
+  int getNumSamples() const override
+  {
+    return 1000;
+  }
+  bool canSample() const override
+  {
+    return true;
+  }
+
+private:
+  aikido::statespace::StateSpacePtr mStateSpace;
 };
 
 TEST_F(GoalRegionTest, ThrowsOnNullSpaceInformation)
@@ -205,3 +252,151 @@ TEST_F(GoalRegionTest, GoalNotSatisfied)
   EXPECT_FALSE(gr.isSatisfied(state));
   si->freeState(state);
 }
+
+TEST_F(GoalRegionTest, BackgroundSamplingThrowsOnInvalidArguments)
+{
+  auto testable = std::make_shared<PassingConstraint>(stateSpace);
+  GoalRegion gr(si, std::move(testable), sampler->createSampleGenerator());
+  auto backgroundTestable
+      = std::make_shared<PassingConstraint>(backgroundStateSpace);
+  EXPECT_THROW(
+      gr.startBackgroundSampling(
+          0, backgroundSampler->createSampleGenerator(), backgroundTestable),
+      std::invalid_argument);
+  EXPECT_THROW(
+      gr.startBackgroundSampling(4, nullptr, backgroundTestable),
+      std::invalid_argument);
+  EXPECT_THROW(
+      gr.startBackgroundSampling(
+          4, backgroundSampler->createSampleGenerator(), nullptr),
+      std::invalid_argument);
+  EXPECT_THROW(
+      gr.startBackgroundSampling(
+          4,
+          backgroundSampler->createSampleGenerator(),
+          std::make_shared<PassingConstraint>(stateSpace)),
+      std::invalid_argument);
+
+  // The background thread must not share the planning StateSpace.
+  EXPECT_THROW(
+      gr.startBackgroundSampling(
+          4,
+          sampler->createSampleGenerator(),
+          std::make_shared<PassingConstraint>(stateSpace)),
+      std::invalid_argument);
+
+  // The StateSpace must have the structure of the planning StateSpace.
+  auto otherRobot = dart::dynamics::Skeleton::create("otherRobot");
+  otherRobot->createJointAndBodyNodePair<dart::dynamics::PrismaticJoint>();
+  auto otherStateSpace = std::make_shared<StateSpace>(otherRobot);
+  EXPECT_THROW(
+      gr.startBackgroundSampling(
+          4,
+          dart::common::make_unique<EmptySampleGenerator>(otherStateSpace),
+          std::make_shared<PassingConstraint>(otherStateSpace)),
+      std::invalid_argument);
+  EXPECT_FALSE(gr.isBackgroundSampling());
+
+  gr.startBackgroundSampling(
+      4, backgroundSampler->createSampleGenerator(), backgroundTestable);
+  EXPECT_THROW(
+      gr.startBackgroundSampling(
+          4, backgroundSampler->createSampleGenerator(), backgroundTestable),
+      std::runtime_error);
+}
+
+TEST_F(GoalRegionTest, BackgroundSamplingQueuesGoals)
+{
+  auto testable = std::make_shared<PassingConstraint>(stateSpace);
+  GoalRegion gr(si, std::move(testable), sampler->createSampleGenerator());
+  EXPECT_FALSE(gr.isBackgroundSampling());
+
+  gr.startBackgroundSampling(
+      4,
+      backgroundSampler->createSampleGenerator(),
+      std::make_shared<PassingConstraint>(backgroundStateSpace));
+  EXPECT_TRUE(gr.isBackgroundSampling());
+  EXPECT_TRUE(gr.couldSample());
+
+  // The queue fills up to its capacity.
+  waitForSamples(gr, 4);
+  EXPECT_EQ(4u, gr.maxSampleCount());
+
+  auto state1 = si->allocState()->as<GeometricStateSpace::StateType>();
+  auto state2 = si->allocState()->as<GeometricStateSpace::StateType>();
+  gr.sampleGoal(state1);
+  gr.sampleGoal(state2);
+  EXPECT_TRUE(state1->mValid);
+  EXPECT_TRUE(state2->mValid);
+  EXPECT_TRUE(gr.isSatisfied(state1));
+  EXPECT_FALSE(
+      getTranslationalState(stateSpace, state1)
+          .isApprox(getTranslationalState(stateSpace, state2)));
+
+  // Popping goals makes room for more.
+  waitForSamples(gr, 6);
+  EXPECT_EQ(6u, gr.maxSampleCount());
+
+  EXPECT_EQ(nullptr, gr.stopBackgroundSampling());
+  EXPECT_FALSE(gr.isBackgroundSampling());
+
+  // Goals are sampled synchronously again.
+  gr.sampleGoal(state1);
+  EXPECT_TRUE(state1->mValid);
+  si->freeState(state1);
+  si->freeState(state2);
+}
+
+TEST_F(GoalRegionTest, BackgroundSamplingSkipsInvalidGoals)
+{
+  auto testable = std::make_shared<PassingConstraint>(stateSpace);
+  GoalRegion gr(si, std::move(testable), sampler->createSampleGenerator());
+  gr.startBackgroundSampling(
+      4,
+      backgroundSampler->createSampleGenerator(),
+      std::make_shared<FailingConstraint>(backgroundStateSpace));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(0u, gr.maxSampleCount());
+  EXPECT_TRUE(gr.couldSample());
+
+  // An empty queue yields an invalid state without blocking.
+  auto state = si->allocState()->as<GeometricStateSpace::StateType>();
+  gr.sampleGoal(state);
+  EXPECT_FALSE(state->mValid);
+  si->freeState(state);
+}
+
+TEST_F(GoalRegionTest, BackgroundSamplingStopsWhenExhausted)
+{
+  auto testable = std::make_shared<PassingConstraint>(stateSpace);
+  GoalRegion gr(si, std::move(testable), sampler->createSampleGenerator());
+  gr.startBackgroundSampling(
+      4,
+      dart::common::make_unique<EmptySampleGenerator>(backgroundStateSpace),
+      std::make_shared<PassingConstraint>(backgroundStateSpace));
+
+  for (int i = 0; i < 1000 && gr.couldSample(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_FALSE(gr.couldSample());
+  EXPECT_EQ(0u, gr.maxSampleCount());
+}
+
+TEST_F(GoalRegionTest, BackgroundSamplingReturnsException)
+{
+  auto testable = std::make_shared<PassingConstraint>(stateSpace);
+  GoalRegion gr(si, std::move(testable), sampler->createSampleGenerator());
+  gr.startBackgroundSampling(
+      4,
+      dart::common::make_unique<ThrowingSampleGenerator>(backgroundStateSpace),
+      std::make_shared<PassingConstraint>(backgroundStateSpace));
+
+  // The exception ends sampling, and is returned instead of thrown.
+  for (int i = 0; i < 1000 && gr.couldSample(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_FALSE(gr.couldSample());
+
+  const auto exception = gr.stopBackgroundSampling();
+  ASSERT_NE(nullptr, exception);
+  EXPECT_THROW(std::rethrow_exception(exception), std::runtime_error);
+  EXPECT_EQ(nullptr, gr.stopBackgroundSampling());
+}
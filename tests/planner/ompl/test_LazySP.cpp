@@ -0,0 +1,191 @@
+#include <aikido/planner/ompl/LazySP.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+#include <aikido/planner/ompl/PlanningContext.hpp>
+#include "../../constraint/MockConstraints.hpp"
+#include "OMPLTestHelpers.hpp"
+
+using aikido::planner::ompl::LazySP;
+using aikido::planner::ompl::PlanningContext;
+
+class LazySPTest : public PlannerTest
+{
+public:
+  /// Plans with _context from startPose to goalPose and checks the
+  /// endpoints of the trajectory.
+  void planAndCheck(PlanningContext& _context)
+  {
+    auto startState = createState(startPose);
+    auto goalState = createState(goalPose);
+    checkTrajectory(_context.plan(startState, goalState, 5.0));
+  }
+
+  /// Checks that _traj goes from startPose to goalPose.
+  void checkTrajectory(const aikido::trajectory::InterpolatedPtr& _traj)
+  {
+    ASSERT_NE(nullptr, _traj);
+
+    auto s0 = stateSpace->createState();
+    _traj->evaluate(0, s0);
+    EXPECT_TRUE(s0.getSubStateHandle<R3>(0).getValue().isApprox(startPose));
+    _traj->evaluate(_traj->getDuration(), s0);
+    EXPECT_TRUE(s0.getSubStateHandle<R3>(0).getValue().isApprox(goalPose));
+  }
+
+  /// Creates a state of the robot at _position.
+  aikido::statespace::dart::MetaSkeletonStateSpace::ScopedState createState(
+      const Eigen::Vector3d& _position)
+  {
+    auto state = stateSpace->createState();
+    stateSpace->getSubStateHandle<R3>(state, 0).setValue(_position);
+    return state;
+  }
+
+  /// Creates a PlanningContext with a LazySP planner.
+  std::unique_ptr<PlanningContext> createContext()
+  {
+    std::unique_ptr<PlanningContext> context(new PlanningContext(
+        stateSpace,
+        interpolator,
+        dmetric,
+        sampler,
+        collConstraint,
+        boundsConstraint,
+        boundsProjection,
+        0.1));
+    context->setPlanner<LazySP>();
+    return context;
+  }
+
+  /// Returns the LazySP planner of _context.
+  static aikido::planner::ompl::ompl_shared_ptr<LazySP> getLazySP(
+      const PlanningContext& _context)
+  {
+    return aikido::planner::ompl::ompl_dynamic_pointer_cast<LazySP>(
+        _context.getPlanner());
+  }
+
+  Eigen::Vector3d startPose{-5, -5, 0};
+  Eigen::Vector3d goalPose{5, 5, 0};
+};
+
+TEST_F(LazySPTest, PlanToConfiguration)
+{
+  auto startState = createState(startPose);
+  auto goalState = createState(goalPose);
+  auto traj = aikido::planner::ompl::planOMPL<LazySP>(
+      startState,
+      goalState,
+      stateSpace,
+      interpolator,
+      std::move(dmetric),
+      std::move(sampler),
+      std::move(collConstraint),
+      std::move(boundsConstraint),
+      std::move(boundsProjection),
+      5.0,
+      0.1);
+  checkTrajectory(traj);
+}
+
+TEST_F(LazySPTest, SetBatchSizeThrowsOnZero)
+{
+  auto si = aikido::planner::ompl::getSpaceInformation(
+      stateSpace,
+      interpolator,
+      dmetric,
+      sampler,
+      collConstraint,
+      boundsConstraint,
+      boundsProjection,
+      0.1);
+  LazySP planner(si);
+  EXPECT_THROW(planner.setBatchSize(0), std::invalid_argument);
+}
+
+TEST_F(LazySPTest, EdgeSelectors)
+{
+  for (const auto selector : {LazySP::EdgeSelector::FORWARD,
+                              LazySP::EdgeSelector::ALTERNATE,
+                              LazySP::EdgeSelector::BISECTION})
+  {
+    auto context = createContext();
+    auto planner = getLazySP(*context);
+    planner->setEdgeSelector(selector);
+    EXPECT_EQ(selector, planner->getEdgeSelector());
+
+    planAndCheck(*context);
+
+    // Only edges on candidate paths are checked.
+    EXPECT_LT(0u, planner->getNumEdgeChecks());
+    EXPECT_LT(planner->getNumEdgeChecks(), planner->getNumEdges());
+  }
+}
+
+TEST_F(LazySPTest, RoadmapPersistsAcrossQueries)
+{
+  auto context = createContext();
+  auto planner = getLazySP(*context);
+
+  planAndCheck(*context);
+  const std::size_t numVertices = planner->getNumVertices();
+  const std::size_t numEvaluatedEdges = planner->getNumEvaluatedEdges();
+  EXPECT_LT(0u, numEvaluatedEdges);
+
+  // The start and goal of the first query are replaced by those of the second.
+  planAndCheck(*context);
+  EXPECT_LE(numVertices, planner->getNumVertices());
+  EXPECT_LT(0u, planner->getNumEvaluatedEdges());
+
+  planner->clearValidityCache();
+  EXPECT_EQ(0u, planner->getNumEvaluatedEdges());
+
+  planner->clearRoadmap();
+  EXPECT_EQ(0u, planner->getNumVertices());
+  EXPECT_EQ(0u, planner->getNumEdges());
+}
+
+TEST_F(LazySPTest, WorldChangeDiscardsValidityCache)
+{
+  auto world = std::make_shared<aikido::planner::World>("world");
+  world->addSkeleton(robot);
+  auto obstacle = createTranslationalRobot();
+  obstacle->setName("obstacle");
+  world->addSkeleton(obstacle);
+
+  auto context = createContext();
+  auto planner = getLazySP(*context);
+  planner->setWorld(world, {robot->getName()});
+
+  planAndCheck(*context);
+  const std::size_t numEdgeChecks = planner->getNumEdgeChecks();
+
+  // Moving the robot does not affect the cache.
+  robot->setPositions(Eigen::Vector3d(1, 2, 0));
+  planAndCheck(*context);
+  EXPECT_GT(planner->getNumEvaluatedEdges(), 0u);
+
+  // Moving another skeleton does, so the path is checked again.
+  obstacle->setPositions(Eigen::Vector3d(1, 2, 0));
+  const std::size_t numVertices = planner->getNumVertices();
+  planAndCheck(*context);
+  EXPECT_LE(numVertices, planner->getNumVertices());
+  EXPECT_LT(numEdgeChecks, planner->getNumEdgeChecks());
+}
+
+TEST_F(LazySPTest, ClearRemovesQueryVertices)
+{
+  auto context = createContext();
+  auto planner = getLazySP(*context);
+
+  planAndCheck(*context);
+  const std::size_t numVertices = planner->getNumVertices();
+  const std::size_t numEdges = planner->getNumEdges();
+
+  planner->clear();
+  EXPECT_EQ(numVertices - 2, planner->getNumVertices());
+  EXPECT_GT(numEdges, planner->getNumEdges());
+
+  // The renumbered roadmap is still usable.
+  planAndCheck(*context);
+  EXPECT_LE(numVertices, planner->getNumVertices());
+}
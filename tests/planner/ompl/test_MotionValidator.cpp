@@ -1,5 +1,8 @@
 #include <boost/make_shared.hpp>
 #include <gtest/gtest.h>
+#include <ompl/base/SpaceInformation.h>
+#include <aikido/constraint/JointStateSpaceHelpers.hpp>
+#include <aikido/distance/defaults.hpp>
 #include <aikido/planner/ompl/GeometricStateSpace.hpp>
 #include <aikido/planner/ompl/MotionValidator.hpp>
 #include <aikido/planner/ompl/StateValidityChecker.hpp>
@@ -11,6 +14,108 @@ using aikido::statespace::dart::MetaSkeletonStateSpace;
 using aikido::planner::ompl::MotionValidator;
 using aikido::planner::ompl::ompl_make_shared;
 
+/// MotionTestable that reports a fixed result for every segment.
+class FixedMotionTestable : public aikido::constraint::MotionTestable
+{
+public:
+  FixedMotionTestable(
+      aikido::statespace::StateSpacePtr _stateSpace,
+      bool _result,
+      double _lastValid)
+    : mStateSpace(std::move(_stateSpace))
+    , mResult(_result)
+    , mLastValid(_lastValid)
+    , mNumCalls(0)
+  {
+  }
+
+  aikido::statespace::StateSpacePtr getStateSpace() const override
+  {
+    return mStateSpace;
+  }
+
+  bool isSatisfied(
+      const aikido::statespace::StateSpace::State* /*_from*/,
+      const aikido::statespace::StateSpace::State* /*_to*/,
+      double& _lastValid) const override
+  {
+    ++mNumCalls;
+    _lastValid = mLastValid;
+    return mResult;
+  }
+
+  aikido::statespace::StateSpacePtr mStateSpace;
+  bool mResult;
+  double mLastValid;
+  mutable int mNumCalls;
+};
+
+/// Interpolator that follows the geodesic without being a
+/// GeodesicInterpolator.
+class ForwardingInterpolator : public aikido::statespace::Interpolator
+{
+public:
+  explicit ForwardingInterpolator(aikido::statespace::StateSpacePtr _stateSpace)
+    : mInterpolator(std::move(_stateSpace))
+  {
+  }
+
+  aikido::statespace::StateSpacePtr getStateSpace() const override
+  {
+    return mInterpolator.getStateSpace();
+  }
+
+  std::size_t getNumDerivatives() const override
+  {
+    return mInterpolator.getNumDerivatives();
+  }
+
+  void interpolate(
+      const aikido::statespace::StateSpace::State* _from,
+      const aikido::statespace::StateSpace::State* _to,
+      double _alpha,
+      aikido::statespace::StateSpace::State* _state) const override
+  {
+    mInterpolator.interpolate(_from, _to, _alpha, _state);
+  }
+
+  void getDerivative(
+      const aikido::statespace::StateSpace::State* _from,
+      const aikido::statespace::StateSpace::State* _to,
+      std::size_t _derivative,
+      double _alpha,
+      Eigen::VectorXd& _tangentVector) const override
+  {
+    mInterpolator.getDerivative(
+        _from, _to, _derivative, _alpha, _tangentVector);
+  }
+
+  aikido::statespace::GeodesicInterpolator mInterpolator;
+};
+
+/// StateValidityChecker that counts the states it checks.
+class CountingValidityChecker : public ::ompl::base::StateValidityChecker
+{
+public:
+  CountingValidityChecker(
+      const ::ompl::base::SpaceInformationPtr& _si,
+      ::ompl::base::StateValidityCheckerPtr _checker)
+    : ::ompl::base::StateValidityChecker(_si)
+    , mChecker(std::move(_checker))
+    , mNumCalls(0)
+  {
+  }
+
+  bool isValid(const ::ompl::base::State* _state) const override
+  {
+    ++mNumCalls;
+    return mChecker->isValid(_state);
+  }
+
+  ::ompl::base::StateValidityCheckerPtr mChecker;
+  mutable int mNumCalls;
+};
+
 /// This test creates a world with a translational robot
 /// and a .2x.2x.2 block obstacle at the origin
 class MotionValidatorTest : public ::testing::Test
@@ -130,3 +235,194 @@ TEST_F(MotionValidatorTest, BadValidationSmallResolution)
       = std::make_shared<aikido::planner::ompl::MotionValidator>(si, 0.5);
   EXPECT_TRUE(validator1->checkMotion(state1, state2));
 }
+
+TEST_F(MotionValidatorTest, ConstructorThrowsOnNullMotionTestable)
+{
+  EXPECT_THROW(
+      MotionValidator(si, aikido::constraint::MotionTestablePtr()),
+      std::invalid_argument);
+}
+
+TEST_F(MotionValidatorTest, ConstructorThrowsOnMotionTestableMismatch)
+{
+  auto otherStateSpace = std::make_shared<MetaSkeletonStateSpace>(
+      createTranslationalRobot());
+  auto motionTestable
+      = std::make_shared<FixedMotionTestable>(otherStateSpace, true, 1.0);
+  EXPECT_THROW(MotionValidator(si, motionTestable), std::invalid_argument);
+}
+
+TEST_F(MotionValidatorTest, ConstructorThrowsOnNonGeodesicInterpolator)
+{
+  auto sspace = ompl_make_shared<aikido::planner::ompl::GeometricStateSpace>(
+      stateSpace,
+      std::make_shared<ForwardingInterpolator>(stateSpace),
+      aikido::distance::createDistanceMetric(stateSpace),
+      aikido::constraint::createSampleableBounds(stateSpace, make_rng()),
+      aikido::constraint::createTestableBounds(stateSpace),
+      aikido::constraint::createProjectableBounds(stateSpace));
+  auto nonGeodesicSi = ompl_make_shared<::ompl::base::SpaceInformation>(sspace);
+  auto motionTestable
+      = std::make_shared<FixedMotionTestable>(stateSpace, true, 1.0);
+  EXPECT_THROW(
+      MotionValidator(nonGeodesicSi, motionTestable), std::invalid_argument);
+}
+
+TEST_F(MotionValidatorTest, MotionTestableValidation)
+{
+  auto motionTestable
+      = std::make_shared<FixedMotionTestable>(stateSpace, false, 0.25);
+  MotionValidator motionValidator(si, motionTestable);
+
+  // The segment crosses the obstacle, but only the motion testable decides.
+  setTranslationalState(Eigen::Vector3d(0, -5, 0), stateSpace, state1);
+  setTranslationalState(Eigen::Vector3d(0, 5, 0), stateSpace, state2);
+
+  std::pair<::ompl::base::State*, double> lastValid;
+  lastValid.first = si->allocState();
+  EXPECT_FALSE(motionValidator.checkMotion(state1, state2, lastValid));
+  EXPECT_DOUBLE_EQ(0.25, lastValid.second);
+  EXPECT_TRUE(
+      getTranslationalState(stateSpace, lastValid.first)
+          .isApprox(Eigen::Vector3d(0, -2.5, 0.)));
+  si->freeState(lastValid.first);
+
+  motionTestable->mResult = true;
+  motionTestable->mLastValid = 1.0;
+  motionValidator.clearEdgeCache();
+  EXPECT_TRUE(motionValidator.checkMotion(state1, state2));
+  EXPECT_EQ(2, motionTestable->mNumCalls);
+}
+
+TEST_F(MotionValidatorTest, MotionTestableChecksEndState)
+{
+  auto motionTestable
+      = std::make_shared<FixedMotionTestable>(stateSpace, true, 1.0);
+  MotionValidator motionValidator(si, motionTestable);
+
+  setTranslationalState(Eigen::Vector3d(0, -5, 0), stateSpace, state1);
+  setTranslationalState(Eigen::Vector3d(0, 0, 0), stateSpace, state2);
+
+  std::pair<::ompl::base::State*, double> lastValid;
+  lastValid.first = nullptr;
+  EXPECT_FALSE(motionValidator.checkMotion(state1, state2, lastValid));
+  EXPECT_DOUBLE_EQ(0.0, lastValid.second);
+  EXPECT_EQ(0, motionTestable->mNumCalls);
+}
+
+TEST_F(MotionValidatorTest, RepeatedCheckUsesEdgeCache)
+{
+  auto checker = ompl_make_shared<CountingValidityChecker>(
+      si, si->getStateValidityChecker());
+  si->setStateValidityChecker(checker);
+  MotionValidator motionValidator(si, 0.1);
+  motionValidator.setEdgeCacheSize(16);
+  EXPECT_EQ(16u, motionValidator.getEdgeCacheSize());
+
+  setTranslationalState(Eigen::Vector3d(-5, -5, 0), stateSpace, state1);
+  setTranslationalState(Eigen::Vector3d(-5, 5, 0), stateSpace, state2);
+  EXPECT_TRUE(motionValidator.checkMotion(state1, state2));
+  const int numCalls = checker->mNumCalls;
+  EXPECT_LT(0, numCalls);
+
+  EXPECT_TRUE(motionValidator.checkMotion(state1, state2));
+  std::pair<::ompl::base::State*, double> lastValid;
+  lastValid.first = nullptr;
+  EXPECT_TRUE(motionValidator.checkMotion(state1, state2, lastValid));
+  EXPECT_DOUBLE_EQ(1.0, lastValid.second);
+  EXPECT_EQ(numCalls, checker->mNumCalls);
+
+  motionValidator.clearEdgeCache();
+  EXPECT_TRUE(motionValidator.checkMotion(state1, state2));
+  EXPECT_EQ(2 * numCalls, checker->mNumCalls);
+}
+
+TEST_F(MotionValidatorTest, CachedFailedValidationLastValid)
+{
+  setTranslationalState(Eigen::Vector3d(0, -5, 0), stateSpace, state1);
+  setTranslationalState(Eigen::Vector3d(0, 5, 0), stateSpace, state2);
+
+  validator->setEdgeCacheSize(16);
+
+  // The last valid time is unknown after a check without it.
+  EXPECT_FALSE(validator->checkMotion(state1, state2));
+
+  std::pair<::ompl::base::State*, double> lastValid;
+  lastValid.first = si->allocState();
+  for (int i = 0; i < 2; ++i)
+  {
+    EXPECT_FALSE(validator->checkMotion(state1, state2, lastValid));
+    EXPECT_DOUBLE_EQ((5 - 0.2) / 10, lastValid.second);
+    EXPECT_TRUE(
+        getTranslationalState(stateSpace, lastValid.first)
+            .isApprox(Eigen::Vector3d(0, -0.2, 0.)));
+  }
+  si->freeState(lastValid.first);
+}
+
+TEST_F(MotionValidatorTest, EdgeCacheDisabledByDefault)
+{
+  auto checker = ompl_make_shared<CountingValidityChecker>(
+      si, si->getStateValidityChecker());
+  si->setStateValidityChecker(checker);
+  MotionValidator motionValidator(si, 0.1);
+  EXPECT_EQ(0u, motionValidator.getEdgeCacheSize());
+
+  setTranslationalState(Eigen::Vector3d(-5, -5, 0), stateSpace, state1);
+  setTranslationalState(Eigen::Vector3d(5, 5, 0), stateSpace, state2);
+  EXPECT_FALSE(motionValidator.checkMotion(state1, state2));
+  const int numCalls = checker->mNumCalls;
+  EXPECT_FALSE(motionValidator.checkMotion(state1, state2));
+  EXPECT_EQ(2 * numCalls, checker->mNumCalls);
+}
+
+TEST_F(MotionValidatorTest, SetParallelValidityCheckersThrowsOnNull)
+{
+  EXPECT_THROW(
+      validator->setParallelValidityCheckers({nullptr}),
+      std::invalid_argument);
+  EXPECT_EQ(1u, validator->getNumParallelThreads());
+}
+
+TEST_F(MotionValidatorTest, ParallelValidation)
+{
+  std::vector<::ompl::base::StateValidityCheckerPtr> checkers;
+  for (int i = 0; i < 4; ++i)
+  {
+    auto constraint = std::make_shared<MockTranslationalRobotConstraint>(
+        stateSpace,
+        Eigen::Vector3d(-0.1, -0.1, -0.1),
+        Eigen::Vector3d(0.1, 0.1, 0.1));
+    checkers.push_back(
+        ompl_make_shared<aikido::planner::ompl::StateValidityChecker>(
+            si, constraint));
+  }
+
+  MotionValidator motionValidator(si, 0.01);
+  motionValidator.setEdgeCacheSize(0);
+  motionValidator.setParallelValidityCheckers(checkers);
+  EXPECT_EQ(4u, motionValidator.getNumParallelThreads());
+
+  for (int i = 0; i < 10; ++i)
+  {
+    setTranslationalState(Eigen::Vector3d(-5, -5, 0), stateSpace, state1);
+    setTranslationalState(Eigen::Vector3d(-5, 5, 0), stateSpace, state2);
+    EXPECT_TRUE(motionValidator.checkMotion(state1, state2));
+
+    setTranslationalState(Eigen::Vector3d(-5, -5, 0), stateSpace, state1);
+    setTranslationalState(Eigen::Vector3d(5, 5, 0), stateSpace, state2);
+    EXPECT_FALSE(motionValidator.checkMotion(state1, state2));
+  }
+
+  // The last valid state is still found serially.
+  setTranslationalState(Eigen::Vector3d(0, -5, 0), stateSpace, state1);
+  setTranslationalState(Eigen::Vector3d(0, 5, 0), stateSpace, state2);
+  std::pair<::ompl::base::State*, double> lastValid;
+  lastValid.first = nullptr;
+  EXPECT_FALSE(motionValidator.checkMotion(state1, state2, lastValid));
+  EXPECT_NEAR((5 - 0.1) / 10, lastValid.second, 0.01);
+
+  motionValidator.setParallelValidityCheckers({});
+  EXPECT_EQ(1u, motionValidator.getNumParallelThreads());
+  EXPECT_FALSE(motionValidator.checkMotion(state1, state2));
+}
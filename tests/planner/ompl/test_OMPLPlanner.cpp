@@ -1,3 +1,4 @@
+#include <ompl/geometric/planners/rrt/RRT.h>
 #include <ompl/geometric/planners/rrt/RRTConnect.h>
 #include <aikido/common/StepSequence.hpp>
 #include <aikido/constraint/CartesianProductSampleable.hpp>
@@ -15,6 +16,7 @@ using StateSpace = aikido::statespace::dart::MetaSkeletonStateSpace;
 using aikido::planner::ompl::getSpaceInformation;
 using aikido::planner::ompl::CRRT;
 using aikido::planner::ompl::CRRTConnect;
+using aikido::planner::ompl::GeometricStateSpace;
 using aikido::planner::ompl::ompl_dynamic_pointer_cast;
 
 TEST_F(PlannerTest, PlanToConfiguration)
@@ -106,6 +108,201 @@ TEST_F(PlannerTest, PlanToGoalRegion)
   EXPECT_TRUE(goalTestable->isSatisfied(s0));
 }
 
+TEST_F(PlannerTest, PlanToGoalRegionWithBackgroundGoalSampling)
+{
+  auto startState = stateSpace->createState();
+  Eigen::Vector3d startPose(-5, -5, 0);
+  stateSpace->getSubStateHandle<R3>(startState, 0).setValue(startPose);
+
+  auto boxConstraint = std::make_shared<aikido::constraint::R3BoxConstraint>(
+      stateSpace->getSubspace<R3>(0),
+      make_rng(),
+      Eigen::Vector3d(4, 4, 0),
+      Eigen::Vector3d(5, 5, 0));
+  std::vector<std::shared_ptr<aikido::constraint::Sampleable>> sConstraints;
+  sConstraints.push_back(boxConstraint);
+  aikido::constraint::SampleablePtr goalSampleable
+      = std::make_shared<aikido::constraint::CartesianProductSampleable>(
+          stateSpace, sConstraints);
+  std::vector<std::shared_ptr<aikido::constraint::Testable>> tConstraints;
+  tConstraints.push_back(boxConstraint);
+  aikido::constraint::TestablePtr goalTestable
+      = std::make_shared<aikido::constraint::CartesianProductTestable>(
+          stateSpace, tConstraints);
+
+  // Goals are sampled in the background on a clone of the robot.
+  auto backgroundStateSpace = std::make_shared<StateSpace>(robot->clone());
+  auto backgroundBoxConstraint
+      = std::make_shared<aikido::constraint::R3BoxConstraint>(
+          backgroundStateSpace->getSubspace<R3>(0),
+          make_rng(),
+          Eigen::Vector3d(4, 4, 0),
+          Eigen::Vector3d(5, 5, 0));
+  std::vector<std::shared_ptr<aikido::constraint::Sampleable>>
+      backgroundSConstraints;
+  backgroundSConstraints.push_back(backgroundBoxConstraint);
+  std::vector<std::shared_ptr<aikido::constraint::Testable>>
+      backgroundTConstraints;
+  backgroundTConstraints.push_back(backgroundBoxConstraint);
+
+  // Plan
+  auto traj = aikido::planner::ompl::planOMPL<ompl::geometric::RRTConnect>(
+      startState,
+      goalTestable,
+      goalSampleable,
+      stateSpace,
+      interpolator,
+      std::move(dmetric),
+      std::move(sampler),
+      std::move(collConstraint),
+      std::move(boundsConstraint),
+      std::move(boundsProjection),
+      5.0,
+      0.1,
+      8,
+      std::make_shared<aikido::constraint::CartesianProductSampleable>(
+          backgroundStateSpace, backgroundSConstraints),
+      std::make_shared<aikido::constraint::CartesianProductTestable>(
+          backgroundStateSpace, backgroundTConstraints));
+  ASSERT_NE(nullptr, traj);
+
+  // Check the first and last waypoints
+  auto s0 = stateSpace->createState();
+  traj->evaluate(0, s0);
+  EXPECT_TRUE(s0.getSubStateHandle<R3>(0).getValue().isApprox(startPose));
+  traj->evaluate(traj->getDuration(), s0);
+  EXPECT_TRUE(goalTestable->isSatisfied(s0));
+}
+
+/// Creates the components of every planner of a portfolio on a clone of
+/// _robot, so that the planners don't share a skeleton.
+static aikido::planner::ompl::PortfolioComponentsFactory
+createPortfolioComponentsFactory(dart::dynamics::SkeletonPtr _robot)
+{
+  return [_robot](std::size_t, std::unique_ptr<RNG> _rng) {
+    auto stateSpace = std::make_shared<StateSpace>(_robot->clone());
+
+    aikido::planner::ompl::PortfolioComponents components;
+    components.mStateSpace = stateSpace;
+    components.mInterpolator
+        = std::make_shared<aikido::statespace::GeodesicInterpolator>(
+            stateSpace);
+    components.mDistanceMetric
+        = aikido::distance::createDistanceMetric(stateSpace);
+    components.mSampler = aikido::constraint::createSampleableBounds(
+        stateSpace, std::move(_rng));
+    components.mValidityConstraint
+        = std::make_shared<MockTranslationalRobotConstraint>(
+            stateSpace,
+            Eigen::Vector3d(-0.1, -0.1, -0.1),
+            Eigen::Vector3d(0.1, 0.1, 0.1));
+    components.mBoundsConstraint
+        = aikido::constraint::createTestableBounds(stateSpace);
+    components.mBoundsProjector
+        = aikido::constraint::createProjectableBounds(stateSpace);
+    return components;
+  };
+}
+
+TEST_F(PlannerTest, PlanPortfolioToConfiguration)
+{
+  Eigen::Vector3d startPose(-5, -5, 0);
+  Eigen::Vector3d goalPose(5, 5, 0);
+
+  auto startState = stateSpace->createState();
+  auto subState1 = stateSpace->getSubStateHandle<R3>(startState, 0);
+  subState1.setValue(startPose);
+
+  auto goalState = stateSpace->createState();
+  auto subState2 = stateSpace->getSubStateHandle<R3>(goalState, 0);
+  subState2.setValue(goalPose);
+
+  std::vector<aikido::planner::ompl::PortfolioPlanner> planners{
+      aikido::planner::ompl::createPortfolioPlanner<
+          ompl::geometric::RRTConnect>("RRTConnect"),
+      aikido::planner::ompl::createPortfolioPlanner<ompl::geometric::RRT>(
+          "RRT")};
+
+  // Plan
+  auto rng = make_rng();
+  aikido::planner::PlanningResult result;
+  auto traj = aikido::planner::ompl::planOMPLPortfolio(
+      startState,
+      goalState,
+      planners,
+      stateSpace,
+      interpolator,
+      createPortfolioComponentsFactory(robot),
+      rng.get(),
+      5.0,
+      0.1,
+      &result);
+  ASSERT_NE(nullptr, traj);
+  EXPECT_EQ(stateSpace, traj->getStateSpace());
+  EXPECT_TRUE(
+      result.plannerName == "RRTConnect" || result.plannerName == "RRT");
+  ASSERT_EQ(2u, result.plannerTimes.size());
+  EXPECT_LT(0., result.plannerTimes[0]);
+  EXPECT_LT(0., result.plannerTimes[1]);
+
+  // Check the first waypoint
+  auto s0 = stateSpace->createState();
+  traj->evaluate(0, s0);
+  auto r0 = s0.getSubStateHandle<R3>(0);
+  EXPECT_TRUE(r0.getValue().isApprox(startPose));
+
+  // Check the last waypoint
+  traj->evaluate(traj->getDuration(), s0);
+  r0 = s0.getSubStateHandle<R3>(0);
+  EXPECT_TRUE(r0.getValue().isApprox(goalPose));
+}
+
+TEST_F(PlannerTest, PlanPortfolioThrowsOnNoPlanners)
+{
+  auto startState = stateSpace->createState();
+  auto rng = make_rng();
+  EXPECT_THROW(
+      aikido::planner::ompl::planOMPLPortfolio(
+          startState,
+          startState,
+          {},
+          stateSpace,
+          interpolator,
+          createPortfolioComponentsFactory(robot),
+          rng.get(),
+          5.0,
+          0.1),
+      std::invalid_argument);
+}
+
+TEST_F(PlannerTest, PlanPortfolioThrowsOnDifferentStateSpaces)
+{
+  auto startState = stateSpace->createState();
+  std::vector<aikido::planner::ompl::PortfolioPlanner> planners{
+      aikido::planner::ompl::createPortfolioPlanner<
+          ompl::geometric::RRTConnect>("RRTConnect")};
+
+  // The planner plans for a robot with a different joint.
+  auto otherRobot = dart::dynamics::Skeleton::create("otherRobot");
+  otherRobot->createJointAndBodyNodePair<dart::dynamics::PrismaticJoint>();
+  otherRobot->setPositionLowerLimit(0, -5);
+  otherRobot->setPositionUpperLimit(0, 5);
+
+  auto rng = make_rng();
+  EXPECT_THROW(
+      aikido::planner::ompl::planOMPLPortfolio(
+          startState,
+          startState,
+          planners,
+          stateSpace,
+          interpolator,
+          createPortfolioComponentsFactory(otherRobot),
+          rng.get(),
+          5.0,
+          0.1),
+      std::invalid_argument);
+}
+
 TEST_F(PlannerTest, PlanConstrainedCRRTConnect)
 {
   double constraintVal = -2;
@@ -175,6 +372,158 @@ TEST_F(PlannerTest, PlanConstrainedCRRTConnect)
   }
 }
 
+TEST_F(PlannerTest, PlanConstrainedCRRTConnectThreaded)
+{
+  double constraintVal = -2;
+  Eigen::Vector3d startPose(constraintVal, -5, 0);
+
+  auto startState = stateSpace->createState();
+  auto subState1 = stateSpace->getSubStateHandle<R3>(startState, 0);
+  subState1.setValue(startPose);
+
+  auto boxConstraint = std::make_shared<aikido::constraint::R3BoxConstraint>(
+      stateSpace->getSubspace<R3>(0),
+      make_rng(),
+      Eigen::Vector3d(constraintVal - 1, 4, 0),
+      Eigen::Vector3d(constraintVal + 1, 5, 0));
+  std::vector<std::shared_ptr<aikido::constraint::Sampleable>> sConstraints;
+  sConstraints.push_back(boxConstraint);
+  aikido::constraint::SampleablePtr goalSampleable
+      = std::make_shared<aikido::constraint::CartesianProductSampleable>(
+          stateSpace, sConstraints);
+  std::vector<std::shared_ptr<aikido::constraint::Testable>> tConstraints;
+  tConstraints.push_back(boxConstraint);
+  aikido::constraint::TestablePtr goalTestable
+      = std::make_shared<aikido::constraint::CartesianProductTestable>(
+          stateSpace, tConstraints);
+
+  auto trajConstraint = std::make_shared<MockProjectionConstraint>(
+      stateSpace, goalSampleable, constraintVal);
+
+  // The goal tree is grown on a clone of the robot, so the threads share no
+  // skeleton, sampler or validity checker.
+  auto si = getSpaceInformation(
+      stateSpace,
+      interpolator,
+      dmetric,
+      sampler,
+      collConstraint,
+      boundsConstraint,
+      boundsProjection,
+      0.1);
+  auto goalTreeStateSpace = std::make_shared<StateSpace>(robot->clone());
+  auto goalTreeSi = getSpaceInformation(
+      goalTreeStateSpace,
+      std::make_shared<aikido::statespace::GeodesicInterpolator>(
+          goalTreeStateSpace),
+      aikido::distance::createDistanceMetric(goalTreeStateSpace),
+      aikido::constraint::createSampleableBounds(
+          goalTreeStateSpace, make_rng()),
+      std::make_shared<MockTranslationalRobotConstraint>(
+          goalTreeStateSpace,
+          Eigen::Vector3d(-0.1, -0.1, -0.1),
+          Eigen::Vector3d(0.1, 0.1, 0.1)),
+      aikido::constraint::createTestableBounds(goalTreeStateSpace),
+      aikido::constraint::createProjectableBounds(goalTreeStateSpace),
+      0.1);
+  auto goalTreeBoxConstraint
+      = std::make_shared<aikido::constraint::R3BoxConstraint>(
+          goalTreeStateSpace->getSubspace<R3>(0),
+          make_rng(),
+          Eigen::Vector3d(constraintVal - 1, 4, 0),
+          Eigen::Vector3d(constraintVal + 1, 5, 0));
+  std::vector<std::shared_ptr<aikido::constraint::Sampleable>>
+      goalTreeSConstraints;
+  goalTreeSConstraints.push_back(goalTreeBoxConstraint);
+
+  auto pdef = aikido::planner::ompl::ompl_make_shared<
+      ompl::base::ProblemDefinition>(si);
+  auto sspace
+      = ompl_dynamic_pointer_cast<GeometricStateSpace>(si->getStateSpace());
+  auto start = sspace->allocState(startState);
+  pdef->addStartState(start);
+  sspace->freeState(start);
+  pdef->setGoal(
+      aikido::planner::ompl::getGoalRegion(si, goalTestable, trajConstraint));
+
+  auto planner = aikido::planner::ompl::ompl_make_shared<CRRTConnect>(si);
+  EXPECT_FALSE(planner->isThreaded());
+  planner->setThreaded(
+      goalTreeSi,
+      std::make_shared<MockProjectionConstraint>(
+          goalTreeStateSpace,
+          std::make_shared<aikido::constraint::CartesianProductSampleable>(
+              goalTreeStateSpace, goalTreeSConstraints),
+          constraintVal));
+  EXPECT_TRUE(planner->isThreaded());
+  planner->setPathConstraint(trajConstraint);
+  planner->setRange(std::numeric_limits<double>::infinity());
+  planner->setProjectionResolution(0.1);
+  planner->setConnectionRadius(0.1);
+  planner->setMinStateDifference(0.05);
+  planner->setNearestNeighbors(dmetric);
+
+  auto traj = aikido::planner::ompl::planOMPL(
+      planner, pdef, stateSpace, interpolator, 5.0);
+  ASSERT_TRUE(traj != nullptr);
+
+  // Check the first waypoint
+  auto s0 = stateSpace->createState();
+  traj->evaluate(0, s0);
+  auto r0 = s0.getSubStateHandle<R3>(0);
+  EXPECT_TRUE(r0.getValue().isApprox(startPose));
+
+  // Check the last waypoint
+  traj->evaluate(traj->getEndTime(), s0);
+  EXPECT_TRUE(goalTestable->isSatisfied(s0));
+
+  // Check all intermediate waypoints adhere to constraint
+  aikido::common::StepSequence seq(
+      0.1, true, traj->getStartTime(), traj->getEndTime());
+  for (double t : seq)
+  {
+    traj->evaluate(t, s0);
+    EXPECT_TRUE(trajConstraint->isSatisfied(s0));
+  }
+}
+
+TEST_F(PlannerTest, CRRTConnectThrowsOnGoalTreeStateSpaceMismatch)
+{
+  auto si = getSpaceInformation(
+      stateSpace,
+      interpolator,
+      dmetric,
+      sampler,
+      collConstraint,
+      boundsConstraint,
+      boundsProjection,
+      0.1);
+
+  CRRTConnect planner(si);
+  EXPECT_THROW(planner.setThreaded(si, nullptr), std::invalid_argument);
+
+  // The goal tree plans for a robot with a different joint.
+  auto otherRobot = dart::dynamics::Skeleton::create("otherRobot");
+  otherRobot->createJointAndBodyNodePair<dart::dynamics::PrismaticJoint>();
+  otherRobot->setPositionLowerLimit(0, -5);
+  otherRobot->setPositionUpperLimit(0, 5);
+
+  auto otherStateSpace = std::make_shared<StateSpace>(otherRobot);
+  auto otherSi = getSpaceInformation(
+      otherStateSpace,
+      std::make_shared<aikido::statespace::GeodesicInterpolator>(
+          otherStateSpace),
+      aikido::distance::createDistanceMetric(otherStateSpace),
+      aikido::constraint::createSampleableBounds(otherStateSpace, make_rng()),
+      std::make_shared<PassingConstraint>(otherStateSpace),
+      aikido::constraint::createTestableBounds(otherStateSpace),
+      aikido::constraint::createProjectableBounds(otherStateSpace),
+      0.1);
+
+  EXPECT_THROW(planner.setThreaded(otherSi, nullptr), std::invalid_argument);
+  EXPECT_FALSE(planner.isThreaded());
+}
+
 TEST_F(PlannerTest, PlanConstrainedCRRT)
 {
   double constraintVal = -2;
@@ -1,3 +1,4 @@
+#include <limits>
 #include <dart/dart.hpp>
 #include <aikido/common/StepSequence.hpp>
 #include <aikido/constraint/CartesianProductSampleable.hpp>
@@ -182,4 +183,173 @@ TEST_F(SimplifierTest, ShortenTwoWayPointTraj)
 
   bool shorten_success = simplifiedPair.second;
   EXPECT_TRUE(!shorten_success);
-}
\ No newline at end of file
+}
+namespace {
+
+/// Creates one validity constraint per thread, each on a clone of _robot.
+std::vector<aikido::constraint::TestablePtr> createValidityConstraints(
+    const dart::dynamics::SkeletonPtr& _robot, std::size_t _numThreads)
+{
+  std::vector<aikido::constraint::TestablePtr> constraints;
+  for (std::size_t i = 0; i < _numThreads; ++i)
+  {
+    constraints.push_back(std::make_shared<MockTranslationalRobotConstraint>(
+        std::make_shared<StateSpace>(_robot->clone()),
+        Eigen::Vector3d(-0.1, -0.1, -0.1),
+        Eigen::Vector3d(0.1, 0.1, 0.1)));
+  }
+  return constraints;
+}
+
+} // namespace
+
+// Test that parallel shortcutting shortens the path around the obstacle
+TEST_F(SimplifierTest, ParallelShortensTrajectory)
+{
+  Eigen::Vector3d startPose(-5, -5, 0);
+  Eigen::Vector3d midwayPose(0, -2, 0);
+  Eigen::Vector3d goalPose(5, 5, 0);
+
+  auto traj = constructTrajectory(
+      stateSpace, interpolator, startPose, midwayPose, goalPose);
+
+  aikido::common::RNGWrapper<std::default_random_engine> rng(0);
+  auto simplifiedPair = aikido::planner::ompl::simplifyOMPLParallel(
+      stateSpace,
+      interpolator,
+      dmetric,
+      createValidityConstraints(robot, 4),
+      boundsConstraint,
+      &rng,
+      0.1,
+      5.0,
+      0,
+      20,
+      traj);
+
+  auto simplifiedTraj = std::move(simplifiedPair.first);
+  EXPECT_TRUE(simplifiedPair.second);
+  EXPECT_LT(
+      computeTrajLength(*simplifiedTraj, stateSpace, dmetric),
+      computeTrajLength(*traj, stateSpace, dmetric));
+
+  auto state = stateSpace->createState();
+  simplifiedTraj->evaluate(0, state);
+  EXPECT_EIGEN_EQUAL(
+      state.getSubStateHandle<R3>(0).getValue(), startPose, eigenTolerance);
+  simplifiedTraj->evaluate(simplifiedTraj->getEndTime(), state);
+  EXPECT_EIGEN_EQUAL(
+      state.getSubStateHandle<R3>(0).getValue(), goalPose, eigenTolerance);
+
+  for (double t = 0; t < simplifiedTraj->getEndTime(); t += 0.01)
+  {
+    simplifiedTraj->evaluate(t, state);
+    EXPECT_TRUE(collConstraint->isSatisfied(state));
+  }
+}
+
+// Test that a fixed attempt budget gives the same path for the same seed
+TEST_F(SimplifierTest, ParallelAttemptBudgetIsReproducible)
+{
+  Eigen::Vector3d startPose(-5, -5, 0);
+  Eigen::Vector3d midwayPose(0, -2, 0);
+  Eigen::Vector3d goalPose(5, 5, 0);
+
+  auto traj = constructTrajectory(
+      stateSpace, interpolator, startPose, midwayPose, goalPose);
+
+  std::vector<std::unique_ptr<aikido::trajectory::Interpolated>> results;
+  for (int i = 0; i < 2; ++i)
+  {
+    aikido::common::RNGWrapper<std::default_random_engine> rng(0);
+    results.push_back(
+        aikido::planner::ompl::simplifyOMPLParallel(
+            stateSpace,
+            interpolator,
+            dmetric,
+            createValidityConstraints(robot, 4),
+            boundsConstraint,
+            &rng,
+            0.1,
+            std::numeric_limits<double>::infinity(),
+            50,
+            0,
+            traj)
+            .first);
+  }
+
+  ASSERT_EQ(results[0]->getNumWaypoints(), results[1]->getNumWaypoints());
+  auto s0 = stateSpace->createState();
+  auto s1 = stateSpace->createState();
+  for (std::size_t i = 0; i < results[0]->getNumWaypoints(); ++i)
+  {
+    results[0]->evaluate(i, s0);
+    results[1]->evaluate(i, s1);
+    EXPECT_EIGEN_EQUAL(
+        s0.getSubStateHandle<R3>(0).getValue(),
+        s1.getSubStateHandle<R3>(0).getValue(),
+        eigenTolerance);
+  }
+}
+
+TEST_F(SimplifierTest, ParallelThrowsOnInvalidArguments)
+{
+  Eigen::Vector3d startPose(-5, -5, 0);
+  Eigen::Vector3d midwayPose(0, -2, 0);
+  Eigen::Vector3d goalPose(5, 5, 0);
+
+  auto traj = constructTrajectory(
+      stateSpace, interpolator, startPose, midwayPose, goalPose);
+
+  aikido::common::RNGWrapper<std::default_random_engine> rng(0);
+  EXPECT_THROW(
+      aikido::planner::ompl::simplifyOMPLParallel(
+          stateSpace,
+          interpolator,
+          dmetric,
+          {},
+          boundsConstraint,
+          &rng,
+          0.1,
+          5.0,
+          0,
+          0,
+          traj),
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      aikido::planner::ompl::simplifyOMPLParallel(
+          stateSpace,
+          interpolator,
+          dmetric,
+          createValidityConstraints(robot, 2),
+          boundsConstraint,
+          &rng,
+          0.1,
+          -1.0,
+          0,
+          0,
+          traj),
+      std::invalid_argument);
+
+  // The constraint is defined on a robot with another joint.
+  auto otherRobot = dart::dynamics::Skeleton::create("otherRobot");
+  otherRobot->createJointAndBodyNodePair<dart::dynamics::PrismaticJoint>();
+  EXPECT_THROW(
+      aikido::planner::ompl::simplifyOMPLParallel(
+          stateSpace,
+          interpolator,
+          dmetric,
+          {std::make_shared<MockTranslationalRobotConstraint>(
+              std::make_shared<StateSpace>(otherRobot),
+              Eigen::Vector3d(-0.1, -0.1, -0.1),
+              Eigen::Vector3d(0.1, 0.1, 0.1))},
+          boundsConstraint,
+          &rng,
+          0.1,
+          5.0,
+          0,
+          0,
+          traj),
+      std::invalid_argument);
+}
@@ -0,0 +1,172 @@
+#include <ompl/geometric/planners/rrt/RRTConnect.h>
+#include <aikido/constraint/CartesianProductSampleable.hpp>
+#include <aikido/constraint/CartesianProductTestable.hpp>
+#include <aikido/constraint/uniform/RnBoxConstraint.hpp>
+#include <aikido/planner/ompl/MotionValidator.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+#include <aikido/planner/ompl/PlanningContext.hpp>
+#include "../../constraint/MockConstraints.hpp"
+#include "OMPLTestHelpers.hpp"
+
+using aikido::planner::ompl::MotionValidator;
+using aikido::planner::ompl::PlanningContext;
+
+class PlanningContextTest : public PlannerTest
+{
+public:
+  void SetUp() override
+  {
+    PlannerTest::SetUp();
+    context = std::make_shared<PlanningContext>(
+        stateSpace,
+        interpolator,
+        dmetric,
+        sampler,
+        collConstraint,
+        boundsConstraint,
+        boundsProjection,
+        0.1);
+  }
+
+  /// Plans from _startPose to _goalPose and checks the endpoints.
+  void planAndCheck(
+      const Eigen::Vector3d& _startPose, const Eigen::Vector3d& _goalPose)
+  {
+    auto startState = stateSpace->createState();
+    stateSpace->getSubStateHandle<R3>(startState, 0).setValue(_startPose);
+    auto goalState = stateSpace->createState();
+    stateSpace->getSubStateHandle<R3>(goalState, 0).setValue(_goalPose);
+
+    auto traj = context->plan(startState, goalState, 5.0);
+    ASSERT_NE(nullptr, traj);
+
+    auto s0 = stateSpace->createState();
+    traj->evaluate(0, s0);
+    EXPECT_TRUE(s0.getSubStateHandle<R3>(0).getValue().isApprox(_startPose));
+    traj->evaluate(traj->getDuration(), s0);
+    EXPECT_TRUE(s0.getSubStateHandle<R3>(0).getValue().isApprox(_goalPose));
+  }
+
+  std::shared_ptr<PlanningContext> context;
+};
+
+TEST_F(PlanningContextTest, ConstructorThrowsOnNullStateSpace)
+{
+  EXPECT_THROW(
+      PlanningContext(
+          nullptr,
+          interpolator,
+          dmetric,
+          sampler,
+          collConstraint,
+          boundsConstraint,
+          boundsProjection,
+          0.1),
+      std::invalid_argument);
+}
+
+TEST_F(PlanningContextTest, SetPlannerThrowsOnNull)
+{
+  EXPECT_THROW(context->setPlanner(nullptr), std::invalid_argument);
+}
+
+TEST_F(PlanningContextTest, SetPlannerThrowsOnSpaceInformationMismatch)
+{
+  auto si = aikido::planner::ompl::getSpaceInformation(
+      stateSpace,
+      interpolator,
+      dmetric,
+      sampler,
+      collConstraint,
+      boundsConstraint,
+      boundsProjection,
+      0.1);
+  EXPECT_THROW(
+      context->setPlanner(
+          aikido::planner::ompl::ompl_make_shared<ompl::geometric::RRTConnect>(
+              si)),
+      std::invalid_argument);
+}
+
+TEST_F(PlanningContextTest, PlanThrowsWithoutPlanner)
+{
+  auto state = stateSpace->createState();
+  EXPECT_THROW(context->plan(state, state, 1.0), std::runtime_error);
+}
+
+TEST_F(PlanningContextTest, EnablesEdgeCache)
+{
+  auto motionValidator
+      = aikido::planner::ompl::ompl_dynamic_pointer_cast<MotionValidator>(
+          context->getSpaceInformation()->getMotionValidator());
+  ASSERT_NE(nullptr, motionValidator);
+  EXPECT_LT(0u, motionValidator->getEdgeCacheSize());
+}
+
+TEST_F(PlanningContextTest, PlanRepeatedlyReusesComponents)
+{
+  context->setPlanner<ompl::geometric::RRTConnect>();
+  const auto si = context->getSpaceInformation();
+  const auto planner = context->getPlanner();
+
+  planAndCheck(Eigen::Vector3d(-5, -5, 0), Eigen::Vector3d(5, 5, 0));
+  planAndCheck(Eigen::Vector3d(5, -5, 0), Eigen::Vector3d(-5, 5, 0));
+  planAndCheck(Eigen::Vector3d(-5, 5, 0), Eigen::Vector3d(5, -5, 0));
+
+  EXPECT_EQ(si, context->getSpaceInformation());
+  EXPECT_EQ(planner, context->getPlanner());
+}
+
+TEST_F(PlanningContextTest, PlanToGoalRegion)
+{
+  context->setPlanner<ompl::geometric::RRTConnect>();
+
+  auto startState = stateSpace->createState();
+  stateSpace->getSubStateHandle<R3>(startState, 0)
+      .setValue(Eigen::Vector3d(-5, -5, 0));
+
+  auto boxConstraint = std::make_shared<aikido::constraint::R3BoxConstraint>(
+      stateSpace->getSubspace<R3>(0),
+      make_rng(),
+      Eigen::Vector3d(4, 4, 0),
+      Eigen::Vector3d(5, 5, 0));
+  std::vector<std::shared_ptr<aikido::constraint::Sampleable>> sConstraints{
+      boxConstraint};
+  auto goalSampleable
+      = std::make_shared<aikido::constraint::CartesianProductSampleable>(
+          stateSpace, sConstraints);
+  std::vector<std::shared_ptr<aikido::constraint::Testable>> tConstraints{
+      boxConstraint};
+  auto goalTestable
+      = std::make_shared<aikido::constraint::CartesianProductTestable>(
+          stateSpace, tConstraints);
+
+  for (int i = 0; i < 2; ++i)
+  {
+    auto traj = context->plan(startState, goalTestable, goalSampleable, 5.0);
+    ASSERT_NE(nullptr, traj);
+
+    auto s0 = stateSpace->createState();
+    traj->evaluate(traj->getDuration(), s0);
+    EXPECT_TRUE(goalTestable->isSatisfied(s0));
+  }
+}
+
+TEST_F(PlanningContextTest, Simplify)
+{
+  context->setPlanner<ompl::geometric::RRTConnect>();
+
+  auto startState = stateSpace->createState();
+  stateSpace->getSubStateHandle<R3>(startState, 0)
+      .setValue(Eigen::Vector3d(-5, -5, 0));
+  auto goalState = stateSpace->createState();
+  stateSpace->getSubStateHandle<R3>(goalState, 0)
+      .setValue(Eigen::Vector3d(5, 5, 0));
+
+  auto traj = context->plan(startState, goalState, 5.0);
+  ASSERT_NE(nullptr, traj);
+
+  auto simplified = context->simplify(1.0, 10, traj);
+  ASSERT_NE(nullptr, simplified.first);
+  EXPECT_LE(simplified.first->getNumWaypoints(), traj->getNumWaypoints());
+}
@@ -0,0 +1,254 @@
+#include <cmath>
+#include <limits>
+#include <aikido/planner/ompl/BackwardCompatibility.hpp>
+#include "OMPLTestHelpers.hpp"
+
+#if OMPL_VERSION_AT_LEAST(1, 2, 0)
+
+#include <ompl/geometric/planners/rrt/InformedRRTstar.h>
+#include <aikido/planner/ompl/InformedPathLengthObjective.hpp>
+#include <aikido/planner/ompl/Planner.hpp>
+#include <aikido/planner/ompl/TangentSpaceInformedSampler.hpp>
+#include <aikido/statespace/SO2.hpp>
+#include "../../constraint/MockConstraints.hpp"
+
+using aikido::planner::ompl::InformedPathLengthObjective;
+using aikido::planner::ompl::ompl_make_shared;
+using aikido::planner::ompl::ompl_static_pointer_cast;
+using aikido::statespace::SO2;
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+using ::ompl::base::Cost;
+
+class TangentSpaceInformedSamplerTest : public PlannerTest
+{
+public:
+  void SetUp() override
+  {
+    PlannerTest::SetUp();
+
+    // Let the robot move vertically, so that the bounds have a volume.
+    robot->setPositionLowerLimit(2, -1);
+    robot->setPositionUpperLimit(2, 1);
+    sampler
+        = aikido::constraint::createSampleableBounds(stateSpace, make_rng());
+    boundsConstraint = aikido::constraint::createTestableBounds(stateSpace);
+    boundsProjection = aikido::constraint::createProjectableBounds(stateSpace);
+
+    si = aikido::planner::ompl::getSpaceInformation(
+        stateSpace,
+        interpolator,
+        dmetric,
+        sampler,
+        collConstraint,
+        boundsConstraint,
+        boundsProjection,
+        0.1);
+    gSpace = ompl_static_pointer_cast<GeometricStateSpace>(si->getStateSpace());
+
+    pdef = ompl_make_shared<::ompl::base::ProblemDefinition>(si);
+    pdef->setOptimizationObjective(
+        ompl_make_shared<InformedPathLengthObjective>(si));
+
+    start = createState(Eigen::Vector3d(-4, -4, 0));
+    goal = createState(Eigen::Vector3d(4, 4, 0));
+  }
+
+  void TearDown() override
+  {
+    si->freeState(start);
+    si->freeState(goal);
+  }
+
+  ::ompl::base::State* createState(const Eigen::Vector3d& _value)
+  {
+    auto state = si->allocState();
+    setTranslationalState(_value, stateSpace, state);
+    return state;
+  }
+
+  ::ompl::base::InformedSamplerPtr createSampler()
+  {
+    return pdef->getOptimizationObjective()->allocInformedStateSampler(
+        pdef, 100);
+  }
+
+  ::ompl::base::SpaceInformationPtr si;
+  std::shared_ptr<GeometricStateSpace> gSpace;
+  ::ompl::base::ProblemDefinitionPtr pdef;
+  ::ompl::base::State* start;
+  ::ompl::base::State* goal;
+};
+
+TEST_F(TangentSpaceInformedSamplerTest, SpaceHasFiniteMeasure)
+{
+  EXPECT_DOUBLE_EQ(std::sqrt(204.), gSpace->getMaximumExtent());
+  EXPECT_DOUBLE_EQ(200., gSpace->getMeasure());
+}
+
+TEST_F(TangentSpaceInformedSamplerTest, SamplesImproveSolution)
+{
+  pdef->setStartAndGoalStates(start, goal);
+  auto informedSampler = createSampler();
+  EXPECT_TRUE(informedSampler->hasInformedMeasure());
+
+  const double maxCost = 1.2 * si->distance(start, goal);
+  auto state = si->allocState();
+  for (int i = 0; i < 100; ++i)
+  {
+    ASSERT_TRUE(informedSampler->sampleUniform(state, Cost(maxCost)));
+    EXPECT_TRUE(si->satisfiesBounds(state));
+    EXPECT_LT(
+        si->distance(start, state) + si->distance(state, goal), maxCost);
+  }
+
+  // No path is shorter than the distance between the start and the goal.
+  const Cost tooLowCost(0.9 * si->distance(start, goal));
+  EXPECT_FALSE(informedSampler->sampleUniform(state, tooLowCost));
+  si->freeState(state);
+}
+
+TEST_F(TangentSpaceInformedSamplerTest, SamplesBetweenCosts)
+{
+  pdef->setStartAndGoalStates(start, goal);
+  auto informedSampler = createSampler();
+
+  const double distance = si->distance(start, goal);
+  auto state = si->allocState();
+  for (int i = 0; i < 20; ++i)
+  {
+    if (!informedSampler->sampleUniform(
+            state, Cost(1.1 * distance), Cost(1.2 * distance)))
+      continue;
+
+    const double cost
+        = si->distance(start, state) + si->distance(state, goal);
+    EXPECT_LE(1.1 * distance, cost);
+    EXPECT_GT(1.2 * distance, cost);
+  }
+  si->freeState(state);
+}
+
+TEST_F(TangentSpaceInformedSamplerTest, InformedMeasureShrinksWithCost)
+{
+  pdef->setStartAndGoalStates(start, goal);
+  auto informedSampler = createSampler();
+
+  const double distance = si->distance(start, goal);
+  const double spaceMeasure = gSpace->getMeasure();
+  EXPECT_DOUBLE_EQ(
+      spaceMeasure,
+      informedSampler->getInformedMeasure(
+          Cost(std::numeric_limits<double>::infinity())));
+  EXPECT_LE(
+      informedSampler->getInformedMeasure(Cost(2. * distance)), spaceMeasure);
+  EXPECT_LT(
+      informedSampler->getInformedMeasure(Cost(1.2 * distance)),
+      informedSampler->getInformedMeasure(Cost(2. * distance)));
+  EXPECT_DOUBLE_EQ(
+      0., informedSampler->getInformedMeasure(Cost(0.9 * distance)));
+}
+
+TEST_F(TangentSpaceInformedSamplerTest, SamplesUniformlyForGoalRegion)
+{
+  pdef->addStartState(start);
+  pdef->setGoal(
+      aikido::planner::ompl::getGoalRegion(
+          si, std::make_shared<PassingConstraint>(stateSpace), sampler));
+  auto informedSampler = createSampler();
+  EXPECT_FALSE(informedSampler->hasInformedMeasure());
+
+  auto state = si->allocState();
+  EXPECT_TRUE(informedSampler->sampleUniform(
+      state, Cost(std::numeric_limits<double>::infinity())));
+  EXPECT_TRUE(si->satisfiesBounds(state));
+  si->freeState(state);
+}
+
+TEST_F(TangentSpaceInformedSamplerTest, SamplesAcrossSO2WrapAround)
+{
+  auto revoluteRobot = dart::dynamics::Skeleton::create("revoluteRobot");
+  revoluteRobot->createJointAndBodyNodePair<dart::dynamics::RevoluteJoint>();
+  auto so2StateSpace = std::make_shared<MetaSkeletonStateSpace>(revoluteRobot);
+  auto so2Si = aikido::planner::ompl::getSpaceInformation(
+      so2StateSpace,
+      std::make_shared<aikido::statespace::GeodesicInterpolator>(
+          so2StateSpace),
+      aikido::distance::createDistanceMetric(so2StateSpace),
+      aikido::constraint::createSampleableBounds(so2StateSpace, make_rng()),
+      std::make_shared<PassingConstraint>(so2StateSpace),
+      aikido::constraint::createTestableBounds(so2StateSpace),
+      aikido::constraint::createProjectableBounds(so2StateSpace),
+      0.1);
+  auto so2Pdef = ompl_make_shared<::ompl::base::ProblemDefinition>(so2Si);
+  so2Pdef->setOptimizationObjective(
+      ompl_make_shared<InformedPathLengthObjective>(so2Si));
+
+  const auto getAngle = [&](const ::ompl::base::State* _state) {
+    auto cst = static_cast<const CartesianProduct::State*>(
+        _state->as<GeometricStateSpace::StateType>()->mState);
+    return so2StateSpace->getSubStateHandle<SO2>(cst, 0).getAngle();
+  };
+  const auto createSO2State = [&](double _angle) {
+    auto state = so2Si->allocState();
+    auto cst = static_cast<CartesianProduct::State*>(
+        state->as<GeometricStateSpace::StateType>()->mState);
+    so2StateSpace->getSubStateHandle<SO2>(cst, 0).setAngle(_angle);
+    return state;
+  };
+
+  auto so2Start = createSO2State(0.);
+  auto so2Goal = createSO2State(3.);
+  so2Pdef->setStartAndGoalStates(so2Start, so2Goal);
+  auto informedSampler
+      = so2Pdef->getOptimizationObjective()->allocInformedStateSampler(
+          so2Pdef, 100);
+  EXPECT_FALSE(informedSampler->hasInformedMeasure());
+
+  // Going around the other way is 2 pi - 3 < 3.4 long, so every state
+  // improves the solution, including those beyond the start, e.g. -3.
+  auto state = so2Si->allocState();
+  bool sampledBeyondStart = false;
+  for (int i = 0; i < 100; ++i)
+  {
+    ASSERT_TRUE(informedSampler->sampleUniform(state, Cost(3.4)));
+    if (getAngle(state) < -1.)
+      sampledBeyondStart = true;
+  }
+  EXPECT_TRUE(sampledBeyondStart);
+
+  so2Si->freeState(state);
+  so2Si->freeState(so2Start);
+  so2Si->freeState(so2Goal);
+}
+
+TEST_F(TangentSpaceInformedSamplerTest, PlansWithInformedRRTstar)
+{
+  auto startState = stateSpace->createState();
+  stateSpace->getSubStateHandle<R3>(startState, 0).setValue(
+      Eigen::Vector3d(-4, -4, 0));
+  auto goalState = stateSpace->createState();
+  stateSpace->getSubStateHandle<R3>(goalState, 0).setValue(
+      Eigen::Vector3d(4, 4, 0));
+
+  auto traj
+      = aikido::planner::ompl::planOMPL<::ompl::geometric::InformedRRTstar>(
+          startState,
+          goalState,
+          stateSpace,
+          interpolator,
+          dmetric,
+          sampler,
+          collConstraint,
+          boundsConstraint,
+          boundsProjection,
+          1.0,
+          0.1);
+  ASSERT_NE(nullptr, traj);
+
+  auto state = stateSpace->createState();
+  traj->evaluate(traj->getEndTime(), state);
+  EXPECT_TRUE(state.getSubStateHandle<R3>(0).getValue().isApprox(
+      Eigen::Vector3d(4, 4, 0)));
+}
+
+#endif // OMPL_VERSION_AT_LEAST(1, 2, 0)
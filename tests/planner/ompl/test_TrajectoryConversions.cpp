@@ -190,4 +190,58 @@ TEST_F(PlannerTest, InterpolatedStatesRemainUnchaged)
 
     EXPECT_EIGEN_EQUAL(stateInterpolated, stateOMPL, eigenTolerance);
   }
-}
\ No newline at end of file
+}
+// Tests that toInterpolatedTrajectory takes over the states of a moved path
+TEST_F(PlannerTest, InterpolatedAdoptsStatesOfMovedPath)
+{
+  Eigen::Vector3d startPose(-5, -5, 0);
+  Eigen::Vector3d midwayPose(0, -2, 0);
+  Eigen::Vector3d goalPose(5, 5, 0);
+
+  // Construct a test trajectory
+  auto traj = constructTrajectory(
+      stateSpace, interpolator, startPose, midwayPose, goalPose);
+
+  // Get the ompl state space
+  auto si = getSpaceInformation(
+      stateSpace,
+      interpolator,
+      std::move(dmetric),
+      std::move(sampler),
+      std::move(collConstraint),
+      std::move(boundsConstraint),
+      std::move(boundsProjection),
+      0.1);
+
+  auto omplTraj = aikido::planner::ompl::toOMPLTrajectory(traj, si);
+  std::vector<const aikido::statespace::StateSpace::State*> states;
+  for (std::size_t idx = 0; idx < omplTraj.getStateCount(); ++idx)
+  {
+    states.push_back(
+        omplTraj.getState(idx)
+            ->as<aikido::planner::ompl::GeometricStateSpace::StateType>()
+            ->mState);
+  }
+
+  auto interpolatedTraj = aikido::planner::ompl::toInterpolatedTrajectory(
+      std::move(omplTraj), interpolator);
+
+  // The path itself is left in place, without its aikido states.
+  ASSERT_EQ(states.size(), interpolatedTraj->getNumWaypoints());
+  for (std::size_t idx = 0; idx < interpolatedTraj->getNumWaypoints(); ++idx)
+  {
+    EXPECT_EQ(states[idx], interpolatedTraj->getWaypoint(idx));
+    EXPECT_EQ(
+        nullptr,
+        omplTraj.getState(idx)
+            ->as<aikido::planner::ompl::GeometricStateSpace::StateType>()
+            ->mState);
+  }
+
+  auto s0 = static_cast<const CartesianProduct::State*>(
+      interpolatedTraj->getWaypoint(1));
+  EXPECT_EIGEN_EQUAL(
+      midwayPose,
+      stateSpace->getSubStateHandle<R3>(s0, 0).getValue(),
+      eigenTolerance);
+}
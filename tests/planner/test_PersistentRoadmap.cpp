@@ -0,0 +1,393 @@
+#include <cstdio>
+#include <dart/dart.hpp>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <aikido/common/RNG.hpp>
+#include <aikido/constraint/JointStateSpaceHelpers.hpp>
+#include <aikido/distance/defaults.hpp>
+#include <aikido/planner/PersistentRoadmap.hpp>
+#include <aikido/statespace/GeodesicInterpolator.hpp>
+#include <aikido/statespace/Rn.hpp>
+#include <aikido/statespace/dart/MetaSkeletonStateSpace.hpp>
+#include "../constraint/MockConstraints.hpp"
+
+using std::make_shared;
+using aikido::planner::PersistentRoadmap;
+using aikido::planner::PlanningResult;
+using aikido::statespace::R3;
+using aikido::statespace::dart::MetaSkeletonStateSpace;
+using aikido::statespace::dart::MetaSkeletonStateSpacePtr;
+
+/// Rejects states inside a wall at x = 0 that leaves a gap for y > 3.
+class WallConstraint : public aikido::constraint::Testable
+{
+public:
+  explicit WallConstraint(MetaSkeletonStateSpacePtr _stateSpace)
+    : mStateSpace(std::move(_stateSpace)), mEnabled(true)
+  {
+  }
+
+  bool isSatisfied(
+      const aikido::statespace::StateSpace::State* _state) const override
+  {
+    Eigen::VectorXd positions;
+    mStateSpace->convertStateToPositions(
+        static_cast<const MetaSkeletonStateSpace::State*>(_state), positions);
+    return !mEnabled || std::abs(positions[0]) > 0.5 || positions[1] > 3.;
+  }
+
+  aikido::statespace::StateSpacePtr getStateSpace() const override
+  {
+    return mStateSpace;
+  }
+
+  MetaSkeletonStateSpacePtr mStateSpace;
+  bool mEnabled;
+};
+
+class PersistentRoadmapTest : public ::testing::Test
+{
+public:
+  PersistentRoadmapTest()
+    : filename("/tmp/aikido_test_PersistentRoadmap_"
+               + std::to_string(::getpid()) + ".bin")
+  {
+    std::remove(filename.c_str());
+
+    auto robot = dart::dynamics::Skeleton::create("robot");
+    robot->createJointAndBodyNodePair<dart::dynamics::TranslationalJoint>();
+    robot->setPositionLowerLimit(0, -5);
+    robot->setPositionUpperLimit(0, 5);
+    robot->setPositionLowerLimit(1, -5);
+    robot->setPositionUpperLimit(1, 5);
+    robot->setPositionLowerLimit(2, 0);
+    robot->setPositionUpperLimit(2, 0);
+
+    stateSpace = make_shared<MetaSkeletonStateSpace>(robot);
+    interpolator
+        = make_shared<aikido::statespace::GeodesicInterpolator>(stateSpace);
+    dmetric = aikido::distance::createDistanceMetric(stateSpace);
+    sampler = createSampler(0);
+    passingConstraint = make_shared<PassingConstraint>(stateSpace);
+    wall = make_shared<WallConstraint>(stateSpace);
+  }
+
+  ~PersistentRoadmapTest()
+  {
+    std::remove(filename.c_str());
+  }
+
+  std::shared_ptr<aikido::constraint::Sampleable> createSampler(int _seed)
+  {
+    return aikido::constraint::createSampleableBounds(
+        stateSpace,
+        dart::common::make_unique<
+            aikido::common::RNGWrapper<std::default_random_engine>>(_seed));
+  }
+
+  std::unique_ptr<PersistentRoadmap> createRoadmap(
+      const std::string& _validityConstraintName = "passing")
+  {
+    return dart::common::make_unique<PersistentRoadmap>(
+        stateSpace,
+        interpolator,
+        dmetric,
+        sampler,
+        passingConstraint,
+        _validityConstraintName,
+        0.1,
+        filename);
+  }
+
+  MetaSkeletonStateSpace::ScopedState createState(double _x, double _y)
+  {
+    auto state = stateSpace->createState();
+    stateSpace->getSubStateHandle<R3>(state, 0).setValue(
+        Eigen::Vector3d(_x, _y, 0));
+    return state;
+  }
+
+  void checkTrajectory(
+      const aikido::trajectory::InterpolatedPtr& _traj,
+      const Eigen::Vector3d& _start,
+      const Eigen::Vector3d& _goal)
+  {
+    ASSERT_NE(nullptr, _traj);
+
+    auto state = stateSpace->createState();
+    _traj->evaluate(_traj->getStartTime(), state);
+    EXPECT_TRUE(
+        stateSpace->getSubStateHandle<R3>(state, 0).getValue().isApprox(
+            _start));
+    _traj->evaluate(_traj->getEndTime(), state);
+    EXPECT_TRUE(
+        stateSpace->getSubStateHandle<R3>(state, 0).getValue().isApprox(
+            _goal));
+
+    for (double t = _traj->getStartTime(); t < _traj->getEndTime(); t += 0.01)
+    {
+      _traj->evaluate(t, state);
+      EXPECT_TRUE(wall->isSatisfied(state));
+    }
+  }
+
+  std::string filename;
+  MetaSkeletonStateSpacePtr stateSpace;
+  aikido::statespace::InterpolatorPtr interpolator;
+  aikido::distance::DistanceMetricPtr dmetric;
+  aikido::constraint::SampleablePtr sampler;
+  aikido::constraint::TestablePtr passingConstraint;
+  std::shared_ptr<WallConstraint> wall;
+};
+
+TEST_F(PersistentRoadmapTest, ThrowsOnInvalidArguments)
+{
+  EXPECT_THROW(
+      PersistentRoadmap(
+          nullptr,
+          interpolator,
+          dmetric,
+          sampler,
+          passingConstraint,
+          "passing",
+          0.1,
+          filename),
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      PersistentRoadmap(
+          stateSpace,
+          interpolator,
+          dmetric,
+          sampler,
+          nullptr,
+          "passing",
+          0.1,
+          filename),
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      PersistentRoadmap(
+          stateSpace,
+          interpolator,
+          dmetric,
+          sampler,
+          passingConstraint,
+          "passing",
+          0.,
+          filename),
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      PersistentRoadmap(
+          stateSpace,
+          interpolator,
+          dmetric,
+          sampler,
+          passingConstraint,
+          "",
+          0.1,
+          filename),
+      std::invalid_argument);
+
+  auto roadmap = createRoadmap();
+  EXPECT_THROW(roadmap->addCollisionGroup("", wall), std::invalid_argument);
+  EXPECT_THROW(
+      roadmap->addCollisionGroup("passing", wall), std::invalid_argument);
+  EXPECT_THROW(
+      roadmap->addCollisionGroup("wall", nullptr), std::invalid_argument);
+  roadmap->addCollisionGroup("wall", wall);
+  EXPECT_THROW(roadmap->addCollisionGroup("wall", wall), std::invalid_argument);
+  EXPECT_THROW(
+      roadmap->invalidateCollisionGroup("table"), std::invalid_argument);
+}
+
+TEST_F(PersistentRoadmapTest, PlansAroundCollisionGroup)
+{
+  auto roadmap = createRoadmap();
+  roadmap->addCollisionGroup("wall", wall);
+  EXPECT_EQ(300u, roadmap->grow(300));
+  EXPECT_EQ(300u, roadmap->getNumVertices());
+  EXPECT_LT(0u, roadmap->getNumEdges());
+  EXPECT_EQ(0u, roadmap->getNumValidEdges());
+
+  auto start = createState(-4, -4);
+  auto goal = createState(4, -4);
+  checkTrajectory(
+      roadmap->plan(start, goal),
+      Eigen::Vector3d(-4, -4, 0),
+      Eigen::Vector3d(4, -4, 0));
+
+  // Only edges on candidate paths are checked.
+  EXPECT_LT(0u, roadmap->getNumValidEdges());
+  EXPECT_LT(roadmap->getNumEdgeChecks(), roadmap->getNumEdges());
+
+  PlanningResult result;
+  auto blocked = createState(0, 0);
+  EXPECT_EQ(nullptr, roadmap->plan(start, blocked, &result));
+  EXPECT_EQ("Goal state is invalid", result.message);
+}
+
+TEST_F(PersistentRoadmapTest, ReopensRoadmapFromFile)
+{
+  std::size_t numEdges;
+  std::size_t numValidEdges;
+  {
+    auto roadmap = createRoadmap();
+    roadmap->addCollisionGroup("wall", wall);
+    roadmap->grow(300);
+    numEdges = roadmap->getNumEdges();
+
+    auto start = createState(-4, -4);
+    auto goal = createState(4, -4);
+    ASSERT_NE(nullptr, roadmap->plan(start, goal));
+    numValidEdges = roadmap->getNumValidEdges();
+  }
+
+  auto roadmap = createRoadmap();
+  EXPECT_EQ(300u, roadmap->getNumVertices());
+  EXPECT_EQ(numEdges, roadmap->getNumEdges());
+
+  // The cached validity against the wall is reused.
+  roadmap->addCollisionGroup("wall", wall);
+  EXPECT_EQ(numValidEdges, roadmap->getNumValidEdges());
+
+  // Connecting the start and goal checks new edges, but the roadmap edges of
+  // the previous path are not checked again.
+  auto start = createState(-4, -4);
+  auto goal = createState(4, -4);
+  checkTrajectory(
+      roadmap->plan(start, goal),
+      Eigen::Vector3d(-4, -4, 0),
+      Eigen::Vector3d(4, -4, 0));
+  EXPECT_GE(2 * 10 + 1u, roadmap->getNumEdgeChecks());
+
+  // New vertices are appended to the file.
+  roadmap.reset();
+  sampler = createSampler(1);
+  roadmap = createRoadmap();
+  EXPECT_EQ(100u, roadmap->grow(100));
+  EXPECT_EQ(400u, roadmap->getNumVertices());
+}
+
+TEST_F(PersistentRoadmapTest, ThrowsOnFileInUse)
+{
+  auto roadmap = createRoadmap();
+  EXPECT_THROW(createRoadmap(), std::runtime_error);
+
+  // The lock is released when the roadmap is destroyed.
+  roadmap.reset();
+  EXPECT_NO_THROW(createRoadmap());
+}
+
+TEST_F(PersistentRoadmapTest, InvalidatesOnlyCollisionGroup)
+{
+  auto roadmap = createRoadmap();
+  roadmap->addCollisionGroup("wall", wall);
+  roadmap->addCollisionGroup("table", passingConstraint);
+  roadmap->grow(300);
+
+  auto start = createState(-4, -4);
+  auto goal = createState(4, -4);
+  ASSERT_NE(nullptr, roadmap->plan(start, goal));
+  const std::size_t numChecks = roadmap->getNumEdgeChecks();
+  EXPECT_LT(0u, roadmap->getNumValidEdges());
+
+  // Edges that collide with the wall stay invalid, so they are not checked
+  // again when the table moves.
+  roadmap->invalidateCollisionGroup("table");
+  EXPECT_EQ(0u, roadmap->getNumValidEdges());
+  ASSERT_NE(nullptr, roadmap->plan(start, goal));
+  EXPECT_LT(roadmap->getNumEdgeChecks() - numChecks, numChecks);
+
+  // The valid edges must be checked against the wall again.
+  roadmap->invalidateCollisionGroup("wall");
+  EXPECT_EQ(0u, roadmap->getNumValidEdges());
+
+  // Without the wall, the straight path is valid.
+  wall->mEnabled = false;
+  auto traj = roadmap->plan(start, goal);
+  checkTrajectory(traj, Eigen::Vector3d(-4, -4, 0), Eigen::Vector3d(4, -4, 0));
+  EXPECT_EQ(2u, traj->getNumWaypoints());
+}
+
+TEST_F(PersistentRoadmapTest, ThrowsOnStateSpaceMismatch)
+{
+  createRoadmap()->grow(10);
+
+  auto skeleton = dart::dynamics::Skeleton::create("skeleton");
+  skeleton->createJointAndBodyNodePair<dart::dynamics::RevoluteJoint>();
+  auto otherStateSpace = make_shared<MetaSkeletonStateSpace>(skeleton);
+
+  EXPECT_THROW(
+      PersistentRoadmap(
+          otherStateSpace,
+          make_shared<aikido::statespace::GeodesicInterpolator>(
+              otherStateSpace),
+          aikido::distance::createDistanceMetric(otherStateSpace),
+          aikido::constraint::createSampleableBounds(
+              otherStateSpace,
+              dart::common::make_unique<
+                  aikido::common::RNGWrapper<std::default_random_engine>>(0)),
+          make_shared<PassingConstraint>(otherStateSpace),
+          "passing",
+          0.1,
+          filename),
+      std::runtime_error);
+}
+
+TEST_F(PersistentRoadmapTest, ThrowsOnSkeletonMismatch)
+{
+  createRoadmap()->grow(10);
+
+  // The skeleton has as many DOFs, but they have other names.
+  auto skeleton = dart::dynamics::Skeleton::create("skeleton");
+  skeleton->createJointAndBodyNodePair<dart::dynamics::TranslationalJoint>()
+      .first->setName("otherJoint");
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    skeleton->setPositionLowerLimit(i, -5);
+    skeleton->setPositionUpperLimit(i, 5);
+  }
+  auto otherStateSpace = make_shared<MetaSkeletonStateSpace>(skeleton);
+
+  EXPECT_THROW(
+      PersistentRoadmap(
+          otherStateSpace,
+          make_shared<aikido::statespace::GeodesicInterpolator>(
+              otherStateSpace),
+          aikido::distance::createDistanceMetric(otherStateSpace),
+          aikido::constraint::createSampleableBounds(
+              otherStateSpace,
+              dart::common::make_unique<
+                  aikido::common::RNGWrapper<std::default_random_engine>>(0)),
+          make_shared<PassingConstraint>(otherStateSpace),
+          "passing",
+          0.1,
+          filename),
+      std::runtime_error);
+}
+
+TEST_F(PersistentRoadmapTest, ForgetsGroupZeroOfAnotherName)
+{
+  // The wall forces the path through the roadmap.
+  std::size_t numValidEdges;
+  {
+    auto roadmap = createRoadmap();
+    roadmap->addCollisionGroup("wall", wall);
+    roadmap->grow(300);
+    ASSERT_NE(nullptr, roadmap->plan(createState(-4, -4), createState(4, -4)));
+    numValidEdges = roadmap->getNumValidEdges();
+    EXPECT_LT(0u, numValidEdges);
+  }
+
+  // The validity against group zero is reused for the same name only.
+  const auto reopen = [this](const std::string& _validityConstraintName) {
+    auto roadmap = createRoadmap(_validityConstraintName);
+    roadmap->addCollisionGroup("wall", wall);
+    return roadmap->getNumValidEdges();
+  };
+  EXPECT_EQ(numValidEdges, reopen("passing"));
+  EXPECT_EQ(0u, reopen("passing2"));
+  EXPECT_EQ(0u, reopen("passing"));
+}
@@ -84,3 +84,60 @@ TEST_F(InterpolatedTest, EvaluateDerivative)
   traj->evaluateDerivative(6, 1, tangentVector);
   EXPECT_TRUE(tangentVector.isApprox(Eigen::Vector2d(5. / 4, -2. / 4)));
 }
+
+TEST_F(InterpolatedTest, AddWaypointOutOfOrder)
+{
+  auto state = rvss->createState();
+  rvss->setValue(state, Eigen::Vector2d(1, 2));
+  traj->addWaypoint(2, state);
+
+  ASSERT_EQ(4u, traj->getNumWaypoints());
+  EXPECT_DOUBLE_EQ(1, traj->getWaypointTime(0));
+  EXPECT_DOUBLE_EQ(2, traj->getWaypointTime(1));
+  EXPECT_DOUBLE_EQ(3, traj->getWaypointTime(2));
+  EXPECT_TRUE(
+      rvss->getValue(static_cast<const R2::State*>(traj->getWaypoint(1)))
+          .isApprox(Eigen::Vector2d(1, 2)));
+}
+
+TEST_F(InterpolatedTest, AddWaypoints)
+{
+  auto s1 = rvss->createState();
+  rvss->setValue(s1, Eigen::Vector2d(9, 9));
+  auto s2 = rvss->createState();
+  rvss->setValue(s2, Eigen::Vector2d(10, 10));
+
+  traj->addWaypoints({8, 9}, {s1, s2});
+
+  ASSERT_EQ(5u, traj->getNumWaypoints());
+  EXPECT_DOUBLE_EQ(8, traj->getWaypointTime(3));
+  EXPECT_DOUBLE_EQ(9, traj->getEndTime());
+
+  // The states are copied.
+  rvss->setValue(s2, Eigen::Vector2d(0, 0));
+  auto istate = rvss->createState();
+  traj->evaluate(9, istate);
+  EXPECT_TRUE(rvss->getValue(istate).isApprox(Eigen::Vector2d(10, 10)));
+}
+
+TEST_F(InterpolatedTest, AddWaypointsThrowsOnInvalidArguments)
+{
+  auto s1 = rvss->createState();
+  auto s2 = rvss->createState();
+
+  EXPECT_THROW(traj->addWaypoints({8}, {s1, s2}), std::invalid_argument);
+  EXPECT_THROW(traj->addWaypoints({9, 8}, {s1, s2}), std::invalid_argument);
+  EXPECT_THROW(traj->addWaypoints({7, 8}, {s1, s2}), std::invalid_argument);
+  EXPECT_EQ(3u, traj->getNumWaypoints());
+}
+
+TEST_F(InterpolatedTest, AdoptWaypoint)
+{
+  auto state = rvss->allocateState();
+  rvss->setValue(static_cast<R2::State*>(state), Eigen::Vector2d(9, 9));
+  traj->adoptWaypoint(8, state);
+
+  ASSERT_EQ(4u, traj->getNumWaypoints());
+  EXPECT_EQ(state, traj->getWaypoint(3));
+  EXPECT_DOUBLE_EQ(8, traj->getEndTime());
+}